@@ -89,6 +89,9 @@ main()
 //	device.initialize(xpcc::can::BITRATE_125_KBPS);
 	device.setFilter(xpcc::accessor::asFlash(canFilter));
 
+	// use the priorities of the actions and events defined in the XML file
+	connector.setPriorityFunctions(robot::priority::action, robot::priority::event);
+
 	// Enable Interrupts
 	sei();
 
@@ -0,0 +1,206 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Bus load caused by acknowledges with and without ACK coalescing in
+ * xpcc::CanConnector.
+ *
+ * Two boards are connected by a simulated CAN bus. Components on board A
+ * call actions of components on board B. Board B acknowledges every packet
+ * the way xpcc::Dispatcher does: it fetches the packets received since the
+ * last update and sends one ACK per packet, the connector transmits them
+ * with its next update().
+ *
+ * The number of packets per update period and the number of different
+ * (source, destination) pairs are varied. All frames are counted in bits of
+ * an extended CAN frame without stuff bits.
+ */
+
+#include <deque>
+#include <random>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/architecture/interface/can.hpp>
+#include <xpcc/communication/xpcc/backend/can.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+static constexpr uint32_t packets = 100000;
+
+/// Length of an extended CAN frame in bits, without stuff bits
+static inline uint32_t
+getFrameBits(const xpcc::can::Message& message)
+{
+	return 67 + 8 * message.getLength();
+}
+
+/// One end of the bus, everything transmitted is received by the peer
+class FakeCanDriver : public xpcc::Can
+{
+public:
+	bool
+	isMessageAvailable()
+	{
+		return !receivedFrames.empty();
+	}
+
+	bool
+	getMessage(xpcc::can::Message& message)
+	{
+		if (!isMessageAvailable()) {
+			return false;
+		}
+		message = receivedFrames.front();
+		receivedFrames.pop_front();
+		return true;
+	}
+
+	bool
+	isReadyToSend()
+	{
+		return true;
+	}
+
+	bool
+	sendMessage(const xpcc::can::Message& message)
+	{
+		peer->receivedFrames.push_back(message);
+		transmittedFrames++;
+		transmittedBits += getFrameBits(message);
+		return true;
+	}
+
+	static BusState
+	getBusState()
+	{
+		return BusState::Connected;
+	}
+
+public:
+	FakeCanDriver *peer = nullptr;
+	std::deque<xpcc::can::Message> receivedFrames;
+	uint32_t transmittedFrames = 0;
+	uint64_t transmittedBits = 0;
+};
+
+typedef xpcc::CanConnector<FakeCanDriver> Connector;
+
+/// Board B, acknowledges the packets like xpcc::Dispatcher::update()
+static void
+updateReceiver(Connector& connector)
+{
+	connector.update();
+	while (connector.isPacketAvailable())
+	{
+		const xpcc::Header& header = connector.getPacketHeader();
+		if (!header.isAcknowledge && header.destination != 0)
+		{
+			connector.sendPacket(xpcc::Header(header.type, true,
+					header.source, header.destination, header.packetIdentifier),
+					xpcc::SmartPointer());
+		}
+		connector.dropPacket();
+	}
+}
+
+/// Board A, counts the received ACKs
+static uint32_t
+updateTransmitter(Connector& connector)
+{
+	uint32_t acknowledges = 0;
+	connector.update();
+	while (connector.isPacketAvailable())
+	{
+		if (connector.getPacketHeader().isAcknowledge) {
+			acknowledges++;
+		}
+		connector.dropPacket();
+	}
+	return acknowledges;
+}
+
+static void
+run(uint8_t packetsPerUpdate, uint8_t pairs, bool coalescing, uint64_t reference,
+		uint64_t& bits)
+{
+	FakeCanDriver driverA;
+	FakeCanDriver driverB;
+	driverA.peer = &driverB;
+	driverB.peer = &driverA;
+
+	Connector boardA(&driverA);
+	Connector boardB(&driverB);
+	boardA.setAcknowledgeCoalescing(coalescing);
+	boardB.setAcknowledgeCoalescing(coalescing);
+
+	std::minstd_rand random(42);
+	const uint8_t sizes[] = { 0, 1, 2, 4, 8 };
+	uint8_t packetIdentifier[256] = { 0 };
+
+	uint32_t sent = 0;
+	uint32_t acknowledges = 0;
+	while (sent < packets)
+	{
+		for (uint8_t i = 0; i < packetsPerUpdate && sent < packets; ++i, ++sent)
+		{
+			uint8_t pair = random() % pairs;
+			uint8_t source = 0x10 + pair / 4;
+			uint8_t destination = 0x20 + pair % 4;
+			uint8_t size = sizes[random() % sizeof(sizes)];
+
+			boardA.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false,
+					destination, source, packetIdentifier[pair]++),
+					(size > 0) ? xpcc::SmartPointer(size) : xpcc::SmartPointer());
+		}
+
+		acknowledges += updateTransmitter(boardA);
+		updateReceiver(boardB);
+	}
+
+	// deliver the remaining ACKs
+	for (uint8_t i = 0; i < 4; ++i)
+	{
+		acknowledges += updateTransmitter(boardA);
+		updateReceiver(boardB);
+	}
+
+	bits = driverA.transmittedBits + driverB.transmittedBits;
+	XPCC_LOG_INFO << packetsPerUpdate << ", " << pairs << ", "
+			<< (coalescing ? "on" : "off") << ", "
+			<< driverA.transmittedFrames << ", "
+			<< driverB.transmittedFrames << ", "
+			<< uint32_t(driverB.transmittedBits) << ", "
+			<< uint32_t(bits) << ", "
+			<< uint32_t(reference > 0 ? (100 - 100 * bits / reference) : 0) << xpcc::endl;
+
+	if (acknowledges != packets) {
+		XPCC_LOG_ERROR << "lost ACKs: " << (packets - acknowledges) << xpcc::endl;
+	}
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "packets per update, source/destination pairs, ACK coalescing, "
+			"data frames, ACK frames, ACK bits, bits on bus, bits saved [%]" << xpcc::endl;
+
+	for (uint8_t pairs : { 1, 2, 4, 8 })
+	{
+		for (uint8_t packetsPerUpdate : { 1, 2, 4, 8 })
+		{
+			uint64_t reference;
+			uint64_t bits;
+			run(packetsPerUpdate, pairs, false, 0, reference);
+			run(packetsPerUpdate, pairs, true, reference, bits);
+		}
+	}
+
+	return 0;
+}
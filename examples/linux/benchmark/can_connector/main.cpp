@@ -0,0 +1,214 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Throughput of xpcc::CanConnector for packets of 1 to 48 bytes.
+ *
+ * Several transmitting connectors share a simulated bus with a single
+ * receiving connector. Every transmitter queues one packet per round and
+ * sends one CAN frame per update(), so the fragments of the packets of
+ * different sources are interleaved on the bus and have to be reassembled
+ * concurrently.
+ */
+
+#include <chrono>
+#include <vector>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/architecture/interface/can.hpp>
+#include <xpcc/communication/xpcc/backend/can.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+static constexpr uint32_t packets = 200000;
+
+/// Frames transmitted by all drivers, read by the receiving driver
+class Bus
+{
+public:
+	static constexpr std::size_t size = 64;
+
+	bool
+	isFull() const
+	{
+		return (head - tail) >= size;
+	}
+
+	bool
+	isEmpty() const
+	{
+		return head == tail;
+	}
+
+	void
+	push(const xpcc::can::Message& message)
+	{
+		frames[head++ % size] = message;
+		transmittedFrames++;
+	}
+
+	const xpcc::can::Message&
+	pop()
+	{
+		return frames[tail++ % size];
+	}
+
+	uint32_t transmittedFrames = 0;
+
+private:
+	xpcc::can::Message frames[size];
+	std::size_t head = 0;
+	std::size_t tail = 0;
+};
+
+class FakeCanDriver : public xpcc::Can
+{
+public:
+	FakeCanDriver(Bus& bus, bool isReceiver) :
+		bus(bus), isReceiver(isReceiver)
+	{
+	}
+
+	bool
+	isMessageAvailable()
+	{
+		return isReceiver && !bus.isEmpty();
+	}
+
+	bool
+	getMessage(xpcc::can::Message& message)
+	{
+		if (!isMessageAvailable()) {
+			return false;
+		}
+		message = bus.pop();
+		return true;
+	}
+
+	bool
+	isReadyToSend()
+	{
+		return !bus.isFull();
+	}
+
+	bool
+	sendMessage(const xpcc::can::Message& message)
+	{
+		if (bus.isFull()) {
+			return false;
+		}
+		bus.push(message);
+		return true;
+	}
+
+	static BusState
+	getBusState()
+	{
+		return BusState::Connected;
+	}
+
+private:
+	Bus& bus;
+	bool isReceiver;
+};
+
+typedef xpcc::CanConnector<FakeCanDriver> Connector;
+
+static void
+run(uint8_t size, uint8_t sources)
+{
+	Bus bus;
+	FakeCanDriver receiverDriver(bus, true);
+	Connector receiver(&receiverDriver);
+
+	std::vector<FakeCanDriver> drivers(sources, FakeCanDriver(bus, false));
+	std::vector<Connector *> transmitters;
+	for (auto& driver : drivers) {
+		transmitters.push_back(new Connector(&driver));
+	}
+
+	uint8_t data[48];
+	for (uint8_t ii = 0; ii < sizeof(data); ++ii) {
+		data[ii] = ii;
+	}
+
+	uint32_t sent = 0;
+	uint32_t received = 0;
+	uint32_t corrupted = 0;
+	uint32_t idle = 0;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	while (received < packets && idle < 100)
+	{
+		uint32_t previous = received;
+		if (sent < packets)
+		{
+			for (uint8_t source = 0; source < sources; ++source)
+			{
+				xpcc::SmartPointer payload(size);
+				std::memcpy(payload.getPointer(), data, size);
+				transmitters[source]->sendPacket(xpcc::Header(
+						xpcc::Header::Type::REQUEST, false, 0x01, source + 2, sent),
+						payload);
+				sent++;
+			}
+		}
+
+		// one frame per transmitter and round
+		for (uint8_t frame = 0; frame < 8; ++frame)
+		{
+			for (auto transmitter : transmitters) {
+				transmitter->update();
+			}
+
+			receiver.update();
+			while (receiver.isPacketAvailable())
+			{
+				if (receiver.getPacketPayload().getSize() != size) {
+					corrupted++;
+				}
+				received++;
+				receiver.dropPacket();
+			}
+		}
+		idle = (sent >= packets && received == previous) ? idle + 1 : 0;
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	for (auto transmitter : transmitters) {
+		delete transmitter;
+	}
+
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	XPCC_LOG_INFO << size << ", " << sources << ", "
+			<< uint32_t(packets * 1e9 / ns) << ", "
+			<< uint32_t(bus.transmittedFrames * 1e9 / ns) << ", "
+			<< uint32_t(ns / packets) << xpcc::endl;
+
+	if (corrupted || received < packets) {
+		XPCC_LOG_ERROR << "corrupted packets: " << corrupted
+				<< ", lost packets: " << (packets - received) << xpcc::endl;
+	}
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "payload [byte], sources, packets/s, frames/s, ns per packet" << xpcc::endl;
+
+	for (uint8_t sources : { 1, 4 })
+	{
+		for (uint8_t size : { 1, 8, 14, 24, 48 }) {
+			run(size, sources);
+		}
+	}
+
+	return 0;
+}
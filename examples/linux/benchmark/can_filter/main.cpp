@@ -0,0 +1,282 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * CPU time a board spends on receiving xpcc packets over CAN with and
+ * without hardware acceptance filters.
+ *
+ * Ten seconds of traffic at 80% load of a 1 MBit/s bus are recorded from a
+ * transmitting xpcc::CanConnector: requests, responses and acknowledges for
+ * 24 components and 32 events with payloads of 0 to 24 bytes. The board
+ * under test owns two of the components and subscribes to four events.
+ *
+ * The frames the acceptance filters of the controller let pass are fed to a
+ * receiving connector, which reassembles the packets and drops everything
+ * not addressed to the board, as the postman does. Only this receive path is
+ * timed, the filtering itself is done by the hardware.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/architecture/interface/can.hpp>
+#include <xpcc/communication/xpcc/backend/can.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+static constexpr uint32_t bitrate = 1000000;
+static constexpr uint32_t busLoad = 80;		// percent
+static constexpr uint32_t seconds = 10;
+static constexpr uint32_t repetitions = 20;
+
+static const uint8_t components[] = { 0x10, 0x11 };
+static const uint8_t events[] = { 0x80, 0x81, 0x88, 0x90 };
+
+/// Transmits into a recording, receives from a list of frames
+class FakeCanDriver : public xpcc::Can
+{
+public:
+	static constexpr uint8_t numberOfFilters = 14;
+
+	bool
+	isMessageAvailable()
+	{
+		return (receiveIndex < receiveFrames.size());
+	}
+
+	bool
+	getMessage(xpcc::can::Message& message)
+	{
+		if (!isMessageAvailable()) {
+			return false;
+		}
+		message = receiveFrames[receiveIndex++];
+		return true;
+	}
+
+	bool
+	isReadyToSend()
+	{
+		return true;
+	}
+
+	bool
+	sendMessage(const xpcc::can::Message& message)
+	{
+		transmittedFrames.push_back(message);
+		return true;
+	}
+
+	static BusState
+	getBusState()
+	{
+		return BusState::Connected;
+	}
+
+	static uint8_t
+	getNumberOfFilters()
+	{
+		return numberOfFilters;
+	}
+
+	bool
+	setFilters(const Filter *filters, uint8_t count)
+	{
+		this->filters.assign(filters, filters + count);
+		return true;
+	}
+
+	bool
+	isAccepted(const xpcc::can::Message& message) const
+	{
+		for (const Filter& filter : filters)
+		{
+			if (filter.matches(message.getIdentifier())) {
+				return true;
+			}
+		}
+		return filters.empty();
+	}
+
+public:
+	std::vector<xpcc::can::Message> transmittedFrames;
+	std::vector<xpcc::can::Message> receiveFrames;
+	std::size_t receiveIndex = 0;
+	std::vector<Filter> filters;
+};
+
+/// Limits the number of hardware filters available to the connector
+template <uint8_t N>
+class LimitedCanDriver : public FakeCanDriver
+{
+public:
+	static constexpr uint8_t numberOfFilters = N;
+
+	static uint8_t
+	getNumberOfFilters()
+	{
+		return N;
+	}
+};
+
+/// Length of an extended CAN frame in bits, without stuff bits
+static inline uint32_t
+getFrameBits(const xpcc::can::Message& message)
+{
+	return 67 + 8 * message.getLength();
+}
+
+static std::vector<xpcc::can::Message>
+recordTraffic()
+{
+	FakeCanDriver driver;
+	xpcc::CanConnector<FakeCanDriver> transmitter(&driver);
+
+	std::minstd_rand random(42);
+	const uint8_t sizes[] = { 0, 2, 4, 8, 12, 24 };
+
+	const uint64_t bits = uint64_t(bitrate) * busLoad / 100 * seconds;
+	uint64_t recordedBits = 0;
+	std::size_t recordedFrames = 0;
+	while (recordedBits < bits)
+	{
+		uint8_t component = 0x10 + random() % 24;
+		uint8_t source = 0x10 + random() % 24;
+		uint8_t size = sizes[random() % sizeof(sizes)];
+		uint32_t kind = random() % 10;
+
+		xpcc::Header header;
+		if (kind < 4) {
+			header = xpcc::Header(xpcc::Header::Type::REQUEST, false, component, source, random() % 16);
+		}
+		else if (kind < 6) {
+			header = xpcc::Header(xpcc::Header::Type::REQUEST, true, component, source, random() % 16);
+			size = 0;
+		}
+		else if (kind < 8) {
+			header = xpcc::Header(xpcc::Header::Type::RESPONSE, false, component, source, random() % 16);
+		}
+		else {
+			header = xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, source, 0x80 + random() % 32);
+		}
+
+		transmitter.sendPacket(header,
+				(size > 0) ? xpcc::SmartPointer(size) : xpcc::SmartPointer());
+		for (uint8_t priority = 0; priority < transmitter.numberOfPriorities; ++priority)
+		{
+			while (transmitter.getStatistics(priority).queueDepth > 0) {
+				transmitter.update();
+			}
+		}
+
+		for (; recordedFrames < driver.transmittedFrames.size(); ++recordedFrames) {
+			recordedBits += getFrameBits(driver.transmittedFrames[recordedFrames]);
+		}
+	}
+	return driver.transmittedFrames;
+}
+
+static bool
+isForThisBoard(const xpcc::Header& header)
+{
+	const uint8_t *begin;
+	const uint8_t *end;
+	uint8_t identifier;
+	if (header.destination == 0)
+	{
+		begin = events;
+		end = events + sizeof(events);
+		identifier = header.packetIdentifier;
+	}
+	else
+	{
+		begin = components;
+		end = components + sizeof(components);
+		identifier = header.destination;
+	}
+	return std::find(begin, end, identifier) != end;
+}
+
+/// \return	CPU time per second of traffic in ns
+template <typename Driver>
+static double
+run(const char *name, const std::vector<xpcc::can::Message>& traffic,
+		bool useFilters, double reference)
+{
+	Driver driver;
+	xpcc::CanConnector<Driver> receiver(&driver);
+
+	uint8_t filters = 0;
+	if (useFilters)
+	{
+		filters = receiver.setFilters(components, sizeof(components),
+				events, sizeof(events));
+	}
+
+	// done by the CAN controller
+	for (const xpcc::can::Message& message : traffic)
+	{
+		if (driver.isAccepted(message)) {
+			driver.receiveFrames.push_back(message);
+		}
+	}
+
+	uint32_t packets = 0;
+	uint32_t delivered = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < repetitions; ++i)
+	{
+		driver.receiveIndex = 0;
+		while (driver.isMessageAvailable() || receiver.isPacketAvailable())
+		{
+			receiver.update();
+			while (receiver.isPacketAvailable())
+			{
+				packets++;
+				if (isForThisBoard(receiver.getPacketHeader())) {
+					delivered++;
+				}
+				receiver.dropPacket();
+			}
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count() / repetitions;
+	XPCC_LOG_INFO << name << ", " << filters << ", "
+			<< uint32_t(traffic.size() / seconds) << ", "
+			<< uint32_t(driver.receiveFrames.size() / seconds) << ", "
+			<< (packets / repetitions / seconds) << ", "
+			<< (delivered / repetitions / seconds) << ", "
+			<< uint32_t(ns / seconds / 1000) << ", "
+			<< uint32_t(reference > 0 ? (100 - 100 * ns / reference) : 0) << xpcc::endl;
+	return ns;
+}
+
+int
+main()
+{
+	std::vector<xpcc::can::Message> traffic = recordTraffic();
+
+	XPCC_LOG_INFO << "configuration, hardware filters, frames/s on bus, frames/s received, "
+			"packets/s received, packets/s for this board, CPU time per second of traffic [us], CPU time saved [%]" << xpcc::endl;
+
+	double reference = run<FakeCanDriver>("no filters", traffic, false, 0);
+	run< LimitedCanDriver<14> >("14 filters", traffic, true, reference);
+	run< LimitedCanDriver<4> >("4 filters", traffic, true, reference);
+	run< LimitedCanDriver<2> >("2 filters", traffic, true, reference);
+	run< LimitedCanDriver<1> >("1 filter", traffic, true, reference);
+
+	return 0;
+}
@@ -0,0 +1,189 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Receive throughput of the CAN232/CANUSB driver.
+ *
+ * First the Lawicel parser alone: the character by character conversion
+ * the driver used before against xpcc::CanLawicelFormatter::convertBuffer().
+ *
+ * Then the complete driver: a fake adapter on a pseudo terminal answers the
+ * initialization commands and afterwards sends all frames as fast as the
+ * terminal accepts them. The CPU time includes the fake adapter.
+ */
+
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/architecture/platform/driver/can/hosted/canusb.hpp>
+#include <xpcc/driver/can/can_lawicel_formatter.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+typedef std::chrono::steady_clock Clock;
+
+static constexpr uint32_t frames = 200000;
+
+/// Frames with standard and extended identifiers and 0 to 8 data bytes
+static std::string
+createStream()
+{
+	std::string stream;
+	char frame[32];
+	for (uint32_t i = 0; i < frames; ++i)
+	{
+		xpcc::can::Message message((i % 3 == 0) ? (i & 0x7ff) : (i * 7919) & 0x1fffffff, i % 9);
+		message.flags.extended = (i % 3 != 0);
+		for (uint8_t k = 0; k < message.length; ++k) {
+			message.data[k] = i + k;
+		}
+		xpcc::CanLawicelFormatter::convertToString(message, frame);
+		stream += frame;
+		// the adapter acknowledges transmitted frames
+		stream += (i % 16 == 0) ? "\rz\r" : "\r";
+	}
+	return stream;
+}
+
+static void
+report(const char *name, uint32_t received, Clock::time_point start,
+		std::clock_t cpuStart)
+{
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	double cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+	XPCC_LOG_INFO << name << ", " << received << ", "
+			<< uint32_t(received / seconds) << ", "
+			<< uint32_t(100 * cpu / seconds) << xpcc::endl;
+}
+
+static void
+parse(const std::string& stream)
+{
+	// previous implementation of the driver
+	{
+		Clock::time_point start = Clock::now();
+		std::clock_t cpuStart = std::clock();
+
+		uint32_t received = 0;
+		std::string line;
+		for (char a : stream)
+		{
+			if (a == 'T' || a == 't' || a == 'r' || a == 'R') {
+				line.clear();
+			}
+			line += a;
+
+			xpcc::can::Message message;
+			if (xpcc::CanLawicelFormatter::convertToCanMessage(line.c_str(), message)) {
+				received++;
+			}
+		}
+		report("per character", received, start, cpuStart);
+	}
+
+	{
+		Clock::time_point start = Clock::now();
+		std::clock_t cpuStart = std::clock();
+
+		uint32_t received = 0;
+		xpcc::CanLawicelFormatter::convertBuffer(stream.data(), stream.size(),
+				[&received](const xpcc::can::Message&) { received++; });
+		report("buffer", received, start, cpuStart);
+	}
+}
+
+/// Answer the initialization commands, then send the stream
+static void
+runAdapter(int master, const std::string& stream)
+{
+	std::string command;
+	char a;
+	while (read(master, &a, 1) == 1)
+	{
+		if (a != '\r') {
+			command += a;
+			continue;
+		}
+		if (write(master, "\r", 1) != 1) {
+			return;
+		}
+		if (command == "O") {
+			break;
+		}
+		command.clear();
+	}
+
+	const char *data = stream.data();
+	std::size_t remaining = stream.size();
+	while (remaining > 0)
+	{
+		ssize_t result = write(master, data, std::min<std::size_t>(remaining, 4096));
+		if (result <= 0) {
+			return;
+		}
+		data += result;
+		remaining -= result;
+	}
+}
+
+int
+main()
+{
+	const std::string stream = createStream();
+
+	XPCC_LOG_INFO << "method, frames, frames/s, cpu %" << xpcc::endl;
+	parse(stream);
+
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+		XPCC_LOG_ERROR << "Could not create a pseudo terminal" << xpcc::endl;
+		return 1;
+	}
+	std::thread adapter(runAdapter, master, std::cref(stream));
+
+	xpcc::hosted::CanUsb canUsb;
+	if (!canUsb.open(ptsname(master), 115200, xpcc::Can::Bitrate::MBps1)) {
+		XPCC_LOG_ERROR << "Could not open the fake adapter" << xpcc::endl;
+		return 1;
+	}
+
+	Clock::time_point start = Clock::now();
+	std::clock_t cpuStart = std::clock();
+	Clock::time_point lastMessage = start;
+
+	uint32_t received = 0;
+	while (received < frames &&
+			Clock::now() - lastMessage < std::chrono::seconds(1))
+	{
+		xpcc::can::Message message;
+		if (canUsb.getMessage(message)) {
+			received++;
+			lastMessage = Clock::now();
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+	report("pty driver", received, start, cpuStart);
+
+	adapter.join();
+	canUsb.close();
+	close(master);
+
+	return 0;
+}
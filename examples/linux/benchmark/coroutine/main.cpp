@@ -0,0 +1,303 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * The same sensor driver written with the RF_BEGIN()/RF_CALL() macros and
+ * as xpcc::co::Task coroutines.
+ *
+ * The driver reads a sample with three nesting levels: readSample() reads
+ * two registers with readRegister(), which waits for the transfer of a
+ * simulated bus. Each transfer takes 4 or 64 polls. While the bus is busy
+ * every run() of the macro implementation passes through all three levels,
+ * the coroutine polls the innermost wait condition only. With short
+ * transfers the time per run() includes starting the nested functions,
+ * for the coroutines allocating their frames. The third variant is a
+ * coroutine awaiting the macro driver with CO_CALL().
+ *
+ * The code size is the sum of the sizes of the functions of each driver
+ * in the symbol table of the benchmark. The memory is the size of the
+ * driver objects and the coroutine frames while a transfer is running.
+ *
+ * Requires a compiler with C++20 coroutines:
+ *   CXXFLAGS=-std=c++20 scons run
+ */
+
+#include <chrono>
+#include <cstring>
+
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/processing/resumable.hpp>
+#include <xpcc/processing/protothread.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+#if !defined(__cpp_impl_coroutine)
+#	error "Build with CXXFLAGS=-std=c++20"
+#endif
+
+typedef std::chrono::steady_clock Clock;
+typedef xpcc::co::FramePool<256, 8> Pool;
+
+static constexpr uint32_t samples = 200000;
+static uint8_t transferPolls;
+
+/// Simulated bus, the transfer completes after `transferPolls` checks
+struct Bus
+{
+	void
+	start(uint8_t reg)
+	{
+		busy = transferPolls;
+		data = reg * 3;
+	}
+
+	bool
+	isReady()
+	{
+		if (busy > 0) {
+			busy--;
+			return false;
+		}
+		return true;
+	}
+
+	uint8_t busy;
+	uint8_t data;
+};
+
+static Bus bus;
+
+// ----------------------------------------------------------------------------
+class MacroDriver : public xpcc::NestedResumable<3>
+{
+public:
+	__attribute__((noinline)) xpcc::ResumableResult<uint16_t>
+	readSample()
+	{
+		RF_BEGIN();
+
+		high = RF_CALL(readRegister(0x28));
+		low = RF_CALL(readRegister(0x29));
+
+		RF_END_RETURN(uint16_t((high << 8) | low));
+	}
+
+	__attribute__((noinline)) xpcc::ResumableResult<uint8_t>
+	readRegister(uint8_t reg)
+	{
+		RF_BEGIN();
+
+		if (!RF_CALL(transfer(reg))) {
+			RF_RETURN(0);
+		}
+
+		RF_END_RETURN(bus.data);
+	}
+
+	__attribute__((noinline)) xpcc::ResumableResult<bool>
+	transfer(uint8_t reg)
+	{
+		RF_BEGIN();
+
+		bus.start(reg);
+		RF_WAIT_UNTIL(bus.isReady());
+
+		RF_END_RETURN(true);
+	}
+
+private:
+	uint8_t high;
+	uint8_t low;
+};
+
+class MacroTask : public xpcc::pt::Protothread
+{
+public:
+	MacroTask(MacroDriver& driver) :
+		driver(driver), count(0), sum(0)
+	{
+	}
+
+	bool
+	run()
+	{
+		PT_BEGIN();
+
+		while (count < samples) {
+			sum += PT_CALL(driver.readSample());
+			count++;
+		}
+
+		PT_END();
+	}
+
+	MacroDriver& driver;
+	uint32_t count;
+	uint32_t sum;
+};
+
+// ----------------------------------------------------------------------------
+class CoroutineDriver
+{
+public:
+	__attribute__((noinline)) xpcc::co::Task<uint16_t, Pool>
+	readSample()
+	{
+		uint8_t high = co_await readRegister(0x28);
+		uint8_t low = co_await readRegister(0x29);
+
+		co_return uint16_t((high << 8) | low);
+	}
+
+	__attribute__((noinline)) xpcc::co::Task<uint8_t, Pool>
+	readRegister(uint8_t reg)
+	{
+		bool success = co_await transfer(reg);
+		if (!success) {
+			co_return 0;
+		}
+		co_return bus.data;
+	}
+
+	__attribute__((noinline)) xpcc::co::Task<bool, Pool>
+	transfer(uint8_t reg)
+	{
+		bus.start(reg);
+		co_await xpcc::co::waitUntil([]() { return bus.isReady(); });
+
+		co_return true;
+	}
+};
+
+static xpcc::co::Task<void, Pool>
+readCoroutine(CoroutineDriver& driver, uint32_t& sum)
+{
+	for (uint32_t i = 0; i < samples; ++i) {
+		sum += co_await driver.readSample();
+	}
+}
+
+static xpcc::co::Task<void, Pool>
+readMacroFromCoroutine(MacroDriver& driver, uint32_t& sum)
+{
+	for (uint32_t i = 0; i < samples; ++i) {
+		sum += CO_CALL(driver.readSample());
+	}
+}
+
+// ----------------------------------------------------------------------------
+/// Sum of the sizes of all functions whose symbol contains \p name
+static uint32_t
+getCodeSize(const char *name)
+{
+	int fd = open("/proc/self/exe", O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0) {
+		return 0;
+	}
+	void *map = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return 0;
+	}
+
+	uint32_t size = 0;
+	const uint8_t *base = static_cast<const uint8_t *>(map);
+	const Elf64_Ehdr *header = reinterpret_cast<const Elf64_Ehdr *>(base);
+	const Elf64_Shdr *sections = reinterpret_cast<const Elf64_Shdr *>(base + header->e_shoff);
+	for (uint16_t i = 0; i < header->e_shnum; ++i)
+	{
+		if (sections[i].sh_type != SHT_SYMTAB) {
+			continue;
+		}
+		const Elf64_Sym *symbols = reinterpret_cast<const Elf64_Sym *>(base + sections[i].sh_offset);
+		const char *names = reinterpret_cast<const char *>(base + sections[sections[i].sh_link].sh_offset);
+		for (uint32_t k = 0; k < sections[i].sh_size / sizeof(Elf64_Sym); ++k)
+		{
+			if (ELF64_ST_TYPE(symbols[k].st_info) == STT_FUNC &&
+				std::strstr(names + symbols[k].st_name, name) != nullptr) {
+				size += symbols[k].st_size;
+			}
+		}
+	}
+	munmap(map, status.st_size);
+	return size;
+}
+
+template< typename Function >
+static void
+measure(const char *name, uint32_t code, uint32_t memory, Function run)
+{
+	uint32_t runs = 0;
+	Clock::time_point start = Clock::now();
+	while (run()) {
+		runs++;
+	}
+	double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+	XPCC_LOG_INFO << name << ", " << transferPolls << ", " << runs << ", "
+			<< uint32_t(ns / runs * 10) / 10.f << ", "
+			<< uint32_t(ns / samples) << ", "
+			<< code << ", "
+			<< memory << xpcc::endl;
+}
+
+static void
+compare()
+{
+	{
+		MacroDriver driver;
+		MacroTask task(driver);
+		measure("macros", getCodeSize("11MacroDriver"), sizeof(driver) + sizeof(task),
+				[&]() { return task.run(); });
+	}
+
+	{
+		MacroDriver driver;
+		uint32_t sum = 0;
+		xpcc::co::Task<void, Pool> task = readMacroFromCoroutine(driver, sum);
+		task.run();
+		const uint32_t memory = sizeof(driver) + Pool::getFramesInUse() * Pool::getLargestFrame();
+		measure("coroutine awaiting macros",
+				getCodeSize("11MacroDriver") + getCodeSize("22readMacroFromCoroutine"), memory,
+				[&]() { return task.run(); });
+	}
+
+	{
+		CoroutineDriver driver;
+		uint32_t sum = 0;
+		xpcc::co::Task<void, Pool> task = readCoroutine(driver, sum);
+		task.run();
+		// outermost task, readSample(), readRegister() and transfer()
+		const uint32_t memory = Pool::getFramesInUse() * Pool::getLargestFrame();
+		measure("coroutine", getCodeSize("15CoroutineDriver"), memory,
+				[&]() { return task.run(); });
+	}
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "implementation, polls, run() calls, ns/run(), ns/sample, code bytes, RAM bytes" << xpcc::endl;
+
+	for (uint8_t polls : {4, 64})
+	{
+		transferPolls = polls;
+		compare();
+	}
+
+	return 0;
+}
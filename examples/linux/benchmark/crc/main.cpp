@@ -0,0 +1,126 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Throughput of the CRC implementations in bytes per CPU cycle.
+ *
+ * The CRC-8 of SAB/AMNB and the CRC-16 of SAB2/RPR are calculated over
+ * blocks of 8 to 1024 bytes, once byte by byte as the protocol interfaces
+ * do it while receiving and once for the whole block at once.
+ *
+ * Cycles are counted with the time stamp counter on x86, which runs at the
+ * nominal frequency of the CPU, elsewhere bytes per microsecond are
+ * reported instead.
+ */
+
+#include <chrono>
+#include <vector>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/math/utils/crc.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#if defined(XPCC__CPU_AMD64) || defined(XPCC__CPU_I386)
+#	include <x86intrin.h>
+#endif
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+using xpcc::crc::Engine;
+using xpcc::crc::Method;
+
+static constexpr uint32_t bytesPerRun = 32 * 1024 * 1024;
+
+static volatile uint32_t sink;
+
+static inline uint64_t
+getTicks()
+{
+#if defined(XPCC__CPU_AMD64) || defined(XPCC__CPU_I386)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <typename T, T Polynomial, Method M>
+static void
+run(const char *crc, const char *method, uint32_t tableSize,
+		const std::vector<uint8_t>& data, std::size_t blockSize)
+{
+	typedef Engine<T, Polynomial, M> Crc;
+	const std::size_t blocks = bytesPerRun / blockSize;
+
+	T result = 0;
+	uint64_t start = getTicks();
+	for (std::size_t block = 0; block < blocks; ++block)
+	{
+		const uint8_t *begin = &data[(block * blockSize) % data.size()];
+		T value = T(~0);
+		for (std::size_t i = 0; i < blockSize; ++i) {
+			value = Crc::update(value, begin[i]);
+		}
+		result ^= value;
+	}
+	uint64_t bytewise = getTicks() - start;
+
+	start = getTicks();
+	for (std::size_t block = 0; block < blocks; ++block)
+	{
+		const uint8_t *begin = &data[(block * blockSize) % data.size()];
+		result ^= Crc::update(T(~0), begin, blockSize);
+	}
+	uint64_t blockwise = getTicks() - start;
+	sink = result;
+
+	const double bytes = double(blocks) * blockSize;
+	XPCC_LOG_INFO << crc << ", " << method << ", " << tableSize << ", "
+			<< blockSize << ", "
+			<< uint32_t(1000 * bytes / bytewise) << ", "
+			<< uint32_t(1000 * bytes / blockwise) << xpcc::endl;
+}
+
+template <typename T, T Polynomial>
+static void
+runAll(const char *crc, const std::vector<uint8_t>& data, std::size_t blockSize)
+{
+	run<T, Polynomial, Method::Bitwise>(crc, "bitwise", 0, data, blockSize);
+	run<T, Polynomial, Method::Table16>(crc, "table16", 16 * sizeof(T), data, blockSize);
+	run<T, Polynomial, Method::Table256>(crc, "table256", 256 * sizeof(T), data, blockSize);
+	run<T, Polynomial, Method::SliceBy8>(crc, "slice-by-8", 8 * 256 * sizeof(T), data, blockSize);
+}
+
+int
+main()
+{
+	std::vector<uint8_t> data(64 * 1024);
+	uint32_t value = 1;
+	for (uint8_t& byte : data)
+	{
+		value = value * 1103515245 + 12345;
+		byte = value >> 16;
+	}
+
+#if defined(XPCC__CPU_AMD64) || defined(XPCC__CPU_I386)
+	XPCC_LOG_INFO << "crc, method, table size [byte], block size [byte], "
+			"byte-wise [bytes/1000 cycles], block [bytes/1000 cycles]" << xpcc::endl;
+#else
+	XPCC_LOG_INFO << "crc, method, table size [byte], block size [byte], "
+			"byte-wise [bytes/us], block [bytes/us]" << xpcc::endl;
+#endif
+
+	for (std::size_t blockSize : { 8, 64, 1024 })
+	{
+		runAll<uint8_t, 0x8C>("crc8", data, blockSize);
+		runAll<uint16_t, 0xA001>("crc16", data, blockSize);
+	}
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Throughput of the datagram backends on the local machine.
+ *
+ * One connector transmits packets with a 16 byte payload to a number of
+ * receiving connectors, all updated from a single thread. With a burst size
+ * of one the transmitter is updated after every packet, which results in
+ * one system call per packet as with the TIPC backend. Larger bursts are
+ * transmitted with a single sendmmsg() call.
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/communication/xpcc/backend/datagram.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+typedef std::chrono::steady_clock Clock;
+
+static constexpr uint32_t packets = 20000;
+
+struct Payload
+{
+	uint8_t data[16];
+};
+
+static void
+run(const char *name, xpcc::DatagramConnector& transmitter,
+		std::vector< std::unique_ptr<xpcc::DatagramConnector> >& receivers,
+		uint32_t burst)
+{
+	const xpcc::DatagramConnector::Statistics before = transmitter.getStatistics();
+	const uint32_t expected = packets * receivers.size();
+	uint32_t received = 0;
+	uint32_t sent = 0;
+	uint32_t idle = 0;
+
+	Clock::time_point start = Clock::now();
+	while (received < expected && idle < 1000)
+	{
+		uint32_t previous = received;
+		for (uint32_t i = 0; i < burst && sent < packets; ++i, ++sent)
+		{
+			Payload payload = Payload();
+			transmitter.sendPacket(
+					xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x01, 0x02, sent),
+					xpcc::SmartPointer(&payload));
+			if (burst == 1) {
+				transmitter.update();
+			}
+		}
+		transmitter.update();
+
+		for (auto& receiver : receivers)
+		{
+			receiver->update();
+			while (receiver->isPacketAvailable())
+			{
+				received++;
+				receiver->dropPacket();
+				receiver->update();
+			}
+		}
+
+		// lost packets are not retransmitted
+		idle = (sent == packets && received == previous) ? idle + 1 : 0;
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	const xpcc::DatagramConnector::Statistics& after = transmitter.getStatistics();
+	uint32_t calls = after.transmitCalls - before.transmitCalls;
+	uint32_t messages = after.transmittedPackets - before.transmittedPackets;
+
+	XPCC_LOG_INFO << name << ", " << receivers.size() << ", " << burst << ", "
+			<< uint32_t(received / seconds) << ", "
+			<< uint32_t(1000.0 * calls / messages) << ", "
+			<< (expected - received) << xpcc::endl;
+}
+
+int
+main()
+{
+	const uint32_t bursts[] = { 1, 8, 32 };
+	// the kernel queues only 10 datagrams per local socket by default,
+	// larger bursts would overflow the deferred messages of the connector
+	const uint32_t unixBursts[] = { 1, 4, 8 };
+
+	XPCC_LOG_INFO << "backend, receivers, burst, packets/s, sendmmsg calls per 1000 messages, lost" << xpcc::endl;
+
+	for (uint32_t count : { 1, 4 })
+	{
+		xpcc::UdpConnector transmitter("239.255.0.1", 24322);
+		std::vector< std::unique_ptr<xpcc::DatagramConnector> > receivers;
+		for (uint32_t i = 0; i < count; ++i) {
+			receivers.emplace_back(new xpcc::UdpConnector("239.255.0.1", 24322));
+		}
+		for (uint32_t burst : bursts) {
+			run("udp", transmitter, receivers, burst);
+		}
+	}
+
+	char name[] = "/tmp/xpcc_datagram_XXXXXX";
+	std::string directory = mkdtemp(name);
+	for (uint32_t count : { 1, 4, 16 })
+	{
+		std::vector< std::unique_ptr<xpcc::DatagramConnector> > receivers;
+		for (uint32_t i = 0; i < count; ++i) {
+			receivers.emplace_back(new xpcc::UnixConnector(directory.c_str(),
+					("receiver" + std::to_string(i)).c_str()));
+		}
+		xpcc::UnixConnector transmitter(directory.c_str(), "transmitter");
+		for (uint32_t burst : unixBursts) {
+			run("unix", transmitter, receivers, burst);
+		}
+	}
+	rmdir(directory.c_str());
+
+	return 0;
+}
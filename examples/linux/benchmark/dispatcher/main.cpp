@@ -0,0 +1,175 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Measures how the time the xpcc::Dispatcher needs to match an incoming
+ * response scales with the number of outstanding requests.
+ *
+ * A single local component keeps N requests with response callbacks to an
+ * external component in flight. For every response received the callback
+ * immediately calls the same action again, so the number of outstanding
+ * requests stays constant during the measurement.
+ */
+
+#include <chrono>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/communication.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+static constexpr uint8_t localComponent = 1;
+static constexpr uint8_t remoteComponent = 10;
+static constexpr uint16_t maxOutstanding = 256;
+static constexpr uint32_t iterations = 100000;
+
+/// Feeds one response per update() and discards everything transmitted
+class LoopbackBackend : public xpcc::BackendInterface
+{
+public:
+	virtual void
+	update()
+	{
+	}
+
+	virtual void
+	sendPacket(const xpcc::Header&, xpcc::SmartPointer)
+	{
+		++transmitted;
+	}
+
+	virtual bool
+	isPacketAvailable() const
+	{
+		return available;
+	}
+
+	virtual const xpcc::Header&
+	getPacketHeader() const
+	{
+		return header;
+	}
+
+	virtual const xpcc::SmartPointer
+	getPacketPayload() const
+	{
+		return payload;
+	}
+
+	virtual void
+	dropPacket()
+	{
+		available = false;
+	}
+
+	void
+	receiveResponse(uint8_t identifier)
+	{
+		header = xpcc::Header(xpcc::Header::Type::RESPONSE, false,
+				localComponent, remoteComponent, identifier);
+		available = true;
+	}
+
+	uint32_t transmitted = 0;
+
+private:
+	xpcc::Header header;
+	xpcc::SmartPointer payload;
+	bool available = false;
+};
+
+class LocalPostman : public xpcc::Postman
+{
+public:
+	virtual DeliverInfo
+	deliverPacket(const xpcc::Header&, const xpcc::SmartPointer&)
+	{
+		return OK;
+	}
+
+	virtual bool
+	isComponentAvailable(uint8_t component) const
+	{
+		return (component == localComponent);
+	}
+};
+
+class Caller : public xpcc::AbstractComponent
+{
+public:
+	Caller(xpcc::Dispatcher *dispatcher) :
+		xpcc::AbstractComponent(localComponent, dispatcher),
+		callback(this, &Caller::responseCallback)
+	{
+	}
+
+	void
+	call(uint8_t identifier)
+	{
+		this->callAction(remoteComponent, identifier, callback);
+	}
+
+	uint32_t responses = 0;
+
+private:
+	void
+	responseCallback(const xpcc::Header& header)
+	{
+		++responses;
+		this->call(header.packetIdentifier);
+	}
+
+	xpcc::ResponseCallback callback;
+};
+
+int
+main()
+{
+	XPCC_LOG_INFO << "outstanding requests, ns per packet" << xpcc::endl;
+
+	// the callback calls the next action before the answered request is
+	// released, so one additional entry is required
+	static_assert(xpcc::Dispatcher::maxPendingMessages > maxOutstanding,
+			"Increase XPCC__DISPATCHER_PENDING_MESSAGES in project.cfg");
+
+	for (uint16_t outstanding = 1; outstanding <= maxOutstanding; outstanding *= 2)
+	{
+		LoopbackBackend backend;
+		LocalPostman postman;
+		xpcc::Dispatcher dispatcher(&backend, &postman);
+		Caller caller(&dispatcher);
+
+		// The packet identifier is the action identifier, so every
+		// outstanding request needs its own action.
+		for (uint16_t ii = 0; ii < outstanding; ++ii) {
+			caller.call(ii);
+		}
+		dispatcher.update();
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t ii = 0; ii < iterations; ++ii)
+		{
+			// answer the requests in reverse order, the worst case for a
+			// linear search
+			backend.receiveResponse(outstanding - 1 - (ii % outstanding));
+			dispatcher.update();
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		XPCC_LOG_INFO << outstanding << ", " << uint32_t(ns / iterations) << xpcc::endl;
+
+		if (caller.responses != iterations) {
+			XPCC_LOG_ERROR << "lost responses: " << (iterations - caller.responses) << xpcc::endl;
+		}
+	}
+
+	return 0;
+}
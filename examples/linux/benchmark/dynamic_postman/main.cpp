@@ -0,0 +1,166 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Compares the packet delivery of xpcc::DynamicPostman (flat index tables)
+ * with the previous implementation based on nested std::map and
+ * std::multimap, for 10, 100 and 1000 registered handlers.
+ *
+ * Actions are spread over components with up to 100 actions each, event
+ * listeners are spread over 10 events.
+ */
+
+#include <chrono>
+#include <map>
+#include <functional>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/communication/xpcc/postman/dynamic_postman.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+static constexpr uint32_t iterations = 1000000;
+static constexpr uint8_t events = 10;
+
+/// Reference implementation with the previous map based lookup
+class MapPostman : public xpcc::Postman
+{
+public:
+	typedef std::function<void (const xpcc::ResponseHandle&)> ActionCallback;
+	typedef std::function<void (const xpcc::Header&)> EventCallback;
+
+	virtual DeliverInfo
+	deliverPacket(const xpcc::Header& header, const xpcc::SmartPointer&)
+	{
+		if (header.destination == 0)
+		{
+			auto range = eventMap.equal_range(header.packetIdentifier);
+			if (range.first == range.second) {
+				return NO_EVENT;
+			}
+			for (auto it = range.first; it != range.second; ++it) {
+				it->second(header);
+			}
+			return OK;
+		}
+
+		auto component = actionMap.find(header.destination);
+		if (component == actionMap.end()) {
+			return NO_COMPONENT;
+		}
+		auto action = component->second.find(header.packetIdentifier);
+		if (action == component->second.end()) {
+			return NO_ACTION;
+		}
+		action->second(xpcc::ResponseHandle(header));
+		return OK;
+	}
+
+	virtual bool
+	isComponentAvailable(uint8_t component) const
+	{
+		return (actionMap.find(component) != actionMap.end());
+	}
+
+	template< class C >
+	void
+	registerActionHandler(uint8_t componentId, uint8_t actionId, C *object,
+			void (C::*function)(const xpcc::ResponseHandle&))
+	{
+		actionMap[componentId][actionId] = std::bind(function, object, std::placeholders::_1);
+	}
+
+	template< class C >
+	void
+	registerEventListener(uint8_t eventId, C *object,
+			void (C::*function)(const xpcc::Header&))
+	{
+		eventMap.insert(std::make_pair(eventId,
+				EventCallback(std::bind(function, object, std::placeholders::_1))));
+	}
+
+private:
+	std::map<uint8_t, std::map<uint8_t, ActionCallback> > actionMap;
+	std::multimap<uint8_t, EventCallback> eventMap;
+};
+
+class Handler
+{
+public:
+	void
+	action(const xpcc::ResponseHandle&)
+	{
+		++calls;
+	}
+
+	void
+	event(const xpcc::Header&)
+	{
+		++calls;
+	}
+
+	uint32_t calls = 0;
+};
+
+template< class P >
+void
+measure(const char *name, uint16_t handlers)
+{
+	P postman;
+	Handler handler;
+
+	for (uint16_t ii = 0; ii < handlers; ++ii)
+	{
+		postman.registerActionHandler(1 + ii / 100, ii % 100, &handler, &Handler::action);
+		postman.registerEventListener(ii % events, &handler, &Handler::event);
+	}
+
+	xpcc::SmartPointer payload;
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0, 0, 0);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t ii = 0; ii < iterations; ++ii)
+	{
+		// cycle through all actions
+		uint16_t index = (ii * 7) % handlers;
+		header.destination = 1 + index / 100;
+		header.packetIdentifier = index % 100;
+		postman.deliverPacket(header, payload);
+	}
+	auto actions = std::chrono::high_resolution_clock::now() - start;
+
+	header.destination = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (uint32_t ii = 0; ii < iterations / handlers * 10; ++ii)
+	{
+		header.packetIdentifier = ii % events;
+		postman.deliverPacket(header, payload);
+	}
+	auto listeners = std::chrono::high_resolution_clock::now() - start;
+
+	uint32_t actionNs = std::chrono::duration_cast<std::chrono::nanoseconds>(actions).count() / iterations;
+	uint32_t eventNs = std::chrono::duration_cast<std::chrono::nanoseconds>(listeners).count() / (iterations / handlers * 10);
+
+	XPCC_LOG_INFO << name << ", " << handlers << ", " << actionNs << ", " << eventNs << xpcc::endl;
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "postman, handlers, ns per action, ns per event" << xpcc::endl;
+
+	for (uint16_t handlers : {10, 100, 1000})
+	{
+		measure<MapPostman>("map    ", handlers);
+		measure<xpcc::DynamicPostman>("dynamic", handlers);
+	}
+
+	return 0;
+}
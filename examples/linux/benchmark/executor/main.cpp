@@ -0,0 +1,169 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Main loop with 24 drivers waiting for bus transfers, polled or executed
+ * by xpcc::rf::Executor.
+ *
+ * Every driver starts a transfer of 50 to 500us and waits for it to
+ * complete. One second is simulated in steps of 10us, the completion
+ * interrupts are delivered at the beginning of each step. The polling
+ * loop calls every driver in every step, the executor only the drivers
+ * whose transfer completed. Steps in which the executor has nothing to do
+ * are the ones the core could sleep.
+ */
+
+#include <chrono>
+#include <ctime>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/processing/resumable.hpp>
+#include <xpcc/processing/protothread.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+static constexpr uint16_t numberOfDrivers = 24;
+static constexpr uint32_t step = 10;
+static constexpr uint32_t duration = 1000000;
+
+static uint32_t now;
+static uint32_t runs;
+
+class Driver : public xpcc::pt::Protothread, public xpcc::rf::Task,
+		private xpcc::NestedResumable<1>
+{
+public:
+	Driver() :
+		transfers(0), completionTime(0), complete(false), seed(0)
+	{
+	}
+
+	void
+	initialize(uint32_t seed)
+	{
+		this->seed = seed;
+	}
+
+	bool
+	run()
+	{
+		runs++;
+		PT_BEGIN();
+
+		while (true) {
+			PT_CALL(transfer());
+			transfers++;
+		}
+
+		PT_END();
+	}
+
+	/// Transfer complete interrupt
+	void
+	interrupt()
+	{
+		if (!complete && completionTime != 0 && now >= completionTime)
+		{
+			complete = true;
+			event.signal();
+		}
+	}
+
+	uint32_t transfers;
+
+private:
+	xpcc::ResumableResult<void>
+	transfer()
+	{
+		RF_BEGIN();
+
+		seed = seed * 1103515245 + 12345;
+		completionTime = now + 50 + (seed >> 16) % 450;
+		complete = false;
+
+		RF_WAIT_EVENT_UNTIL(event, complete);
+
+		RF_END();
+	}
+
+	xpcc::rf::Event event;
+	uint32_t completionTime;
+	bool complete;
+	uint32_t seed;
+};
+
+static void
+report(const char *name, const Driver *drivers, uint32_t idleSteps,
+		std::clock_t cpuStart)
+{
+	uint32_t transfers = 0;
+	for (uint16_t i = 0; i < numberOfDrivers; ++i) {
+		transfers += drivers[i].transfers;
+	}
+	const double cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+	XPCC_LOG_INFO << name << ", " << transfers << ", " << runs << ", "
+			<< (runs * 10 / transfers) / 10 << "." << (runs * 10 / transfers) % 10 << ", "
+			<< (idleSteps * 100 / (duration / step)) << ", "
+			<< uint32_t(cpu * 1000000) << xpcc::endl;
+}
+
+static void
+run(bool useExecutor)
+{
+	now = 0;
+	runs = 0;
+
+	Driver drivers[numberOfDrivers];
+	xpcc::rf::Executor executor;
+	for (uint16_t i = 0; i < numberOfDrivers; ++i)
+	{
+		drivers[i].initialize(i + 1);
+		if (useExecutor) {
+			executor.add(drivers[i]);
+		}
+	}
+
+	uint32_t idleSteps = 0;
+	std::clock_t cpuStart = std::clock();
+	for (now = step; now <= duration; now += step)
+	{
+		for (Driver& driver : drivers) {
+			driver.interrupt();
+		}
+
+		if (!useExecutor)
+		{
+			for (Driver& driver : drivers) {
+				driver.run();
+			}
+		}
+		else if (executor.isIdle()) {
+			// the core would sleep until the next interrupt
+			idleSteps++;
+		}
+		else {
+			executor.update();
+		}
+	}
+	report(useExecutor ? "executor" : "polling", drivers, idleSteps, cpuStart);
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "main loop, transfers, run() calls, calls per transfer, "
+			"idle steps %, cpu us" << xpcc::endl;
+
+	run(false);
+	run(true);
+
+	return 0;
+}
@@ -0,0 +1,211 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Throughput of the queues of xpcc::rtos with several threads.
+ *
+ * Producer threads append 4 million items in total to a queue of 1024
+ * items, consumer threads get them. The previous xpcc::rtos::Queue used
+ * a std::deque with a boost::timed_mutex and had no way to wait for space
+ * or items, the threads had to poll. It is compared to the current Queue
+ * with a ring buffer and condition variables and the lock-free SpscQueue
+ * and MpmcQueue.
+ *
+ * The CPU time includes the time spent polling and in system calls.
+ * With fewer cores than threads most handovers go through a sleeping
+ * thread, run it on a machine with at least as many cores as threads.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/processing/rtos.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+typedef std::chrono::steady_clock Clock;
+
+static constexpr uint32_t items = 4000000;
+static constexpr uint32_t length = 1024;
+
+/// Previous implementation of xpcc::rtos::Queue on hosted
+class DequeQueue
+{
+public:
+	bool
+	append(const uint32_t& item, uint32_t timeout)
+	{
+		if (!mutex.timed_lock(boost::posix_time::milliseconds(timeout))) {
+			return false;
+		}
+		if (deque.size() >= length) {
+			mutex.unlock();
+			return false;
+		}
+		deque.push_back(item);
+		mutex.unlock();
+		return true;
+	}
+
+	bool
+	get(uint32_t& item, uint32_t timeout)
+	{
+		if (!mutex.timed_lock(boost::posix_time::milliseconds(timeout))) {
+			return false;
+		}
+		if (deque.empty()) {
+			mutex.unlock();
+			return false;
+		}
+		item = deque.front();
+		deque.pop_front();
+		mutex.unlock();
+		return true;
+	}
+
+private:
+	boost::timed_mutex mutex;
+	std::deque<uint32_t> deque;
+};
+
+template< typename Queue >
+static void
+append(Queue& queue, uint32_t item)
+{
+	queue.append(item, -1);
+}
+
+/// The previous queue returned at once if full or empty
+static void
+append(DequeQueue& queue, uint32_t item)
+{
+	while (!queue.append(item, -1)) {
+		std::this_thread::yield();
+	}
+}
+
+template< typename Queue >
+static bool
+get(Queue& queue, uint32_t& item)
+{
+	return queue.get(item, 100);
+}
+
+static bool
+get(DequeQueue& queue, uint32_t& item)
+{
+	const Clock::time_point start = Clock::now();
+	while (!queue.get(item, -1))
+	{
+		if (Clock::now() - start > std::chrono::milliseconds(100)) {
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+template< typename Queue >
+static void
+run(const char *name, Queue& queue, uint32_t producers, uint32_t consumers)
+{
+	std::atomic<uint32_t> received(0);
+	std::atomic<uint64_t> sum(0);
+
+	const Clock::time_point start = Clock::now();
+	const std::clock_t cpuStart = std::clock();
+
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < producers; ++i)
+	{
+		threads.emplace_back([&queue, i, producers]() {
+			for (uint32_t k = i; k < items; k += producers) {
+				append(queue, k);
+			}
+		});
+	}
+	for (uint32_t i = 0; i < consumers; ++i)
+	{
+		threads.emplace_back([&]() {
+			uint32_t count = 0;
+			uint64_t localSum = 0;
+			uint32_t item;
+			while (received.load(std::memory_order_relaxed) + count < items &&
+					get(queue, item))
+			{
+				localSum += item;
+				count++;
+			}
+			received += count;
+			sum += localSum;
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	const double cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+	const bool valid = (received == items &&
+			sum == uint64_t(items) * (items - 1) / 2);
+
+	XPCC_LOG_INFO << name << ", " << producers << ", " << consumers << ", "
+			<< uint32_t(items / seconds / 1000) << ", "
+			<< uint32_t(100 * cpu / seconds) << ", "
+			<< (valid ? "ok" : "LOST ITEMS") << xpcc::endl;
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "queue, producers, consumers, kitems/s, cpu %, result" << xpcc::endl;
+
+	{
+		DequeQueue queue;
+		run("deque + mutex (previous)", queue, 1, 1);
+	}
+	{
+		xpcc::rtos::Queue<uint32_t> queue(length);
+		run("Queue", queue, 1, 1);
+	}
+	{
+		static xpcc::rtos::SpscQueue<uint32_t, length> queue;
+		run("SpscQueue", queue, 1, 1);
+	}
+	{
+		static xpcc::rtos::MpmcQueue<uint32_t, length> queue;
+		run("MpmcQueue", queue, 1, 1);
+	}
+
+	for (uint32_t threads : {2, 4})
+	{
+		{
+			DequeQueue queue;
+			run("deque + mutex (previous)", queue, threads, threads);
+		}
+		{
+			xpcc::rtos::Queue<uint32_t> queue(length);
+			run("Queue", queue, threads, threads);
+		}
+		{
+			static xpcc::rtos::MpmcQueue<uint32_t, length> queue;
+			run("MpmcQueue", queue, threads, threads);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,221 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Cost of xpcc::Scheduler::schedule() with 8 to 256 tasks.
+ *
+ * The previous implementation decremented the counter of every task on
+ * every tick and inserted the ready tasks into a sorted list. It is
+ * reproduced here and compared with the timer wheel. The tasks have
+ * periods between 1 and 1000 ticks and random priorities. Additionally
+ * the cost of adding and removing a task is measured.
+ *
+ * The time is measured with the time stamp counter on x86 (cycles), with
+ * the steady clock on other hosts (nanoseconds).
+ */
+
+#include <chrono>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#endif
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/processing/scheduler/scheduler.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+static inline uint64_t
+getTime()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static constexpr uint32_t ticks = 100000;
+static constexpr uint16_t maximumTasks = 256;
+
+static uint32_t executions = 0;
+
+// ----------------------------------------------------------------------------
+/// Previous implementation of xpcc::Scheduler
+class ListScheduler
+{
+public:
+	ListScheduler() :
+		taskList(0), readyList(0), currentPriority(0)
+	{
+	}
+
+	~ListScheduler()
+	{
+		while (taskList != 0) {
+			TaskListItem *next = taskList->nextTask;
+			delete taskList;
+			taskList = next;
+		}
+	}
+
+	void
+	scheduleTask(uint16_t period, uint8_t priority)
+	{
+		TaskListItem *item = new TaskListItem(period, priority);
+		item->nextTask = taskList;
+		taskList = item;
+	}
+
+	void
+	schedule()
+	{
+		TaskListItem *item = taskList;
+		do {
+			item->time--;
+			if (item->time == 0) {
+				item->time = item->period;
+
+				if ((readyList == 0) || (readyList->priority < item->priority)) {
+					item->nextReady = readyList;
+					readyList = item;
+				}
+				else {
+					TaskListItem *list = readyList;
+					while (1)
+					{
+						if ((list->nextReady == 0) ||
+							(list->nextReady->priority < item->priority))
+						{
+							item->nextReady = list->nextReady;
+							list->nextReady = item;
+							break;
+						}
+						list = list->nextReady;
+					}
+				}
+			}
+		}
+		while ((item = item->nextTask) != 0);
+
+		while (((item = readyList) != 0) && (item->priority > currentPriority))
+		{
+			readyList = item->nextReady;
+			executions++;
+		}
+	}
+
+private:
+	struct TaskListItem
+	{
+		TaskListItem(uint16_t period, uint8_t priority) :
+			nextTask(0), nextReady(0), period(period), time(period),
+			priority(priority)
+		{
+		}
+
+		TaskListItem *nextTask;
+		TaskListItem *nextReady;
+		uint16_t period;
+		uint16_t time;
+		uint8_t priority;
+	};
+
+	TaskListItem *taskList;
+	TaskListItem *readyList;
+	uint8_t currentPriority;
+};
+
+class EmptyTask : public xpcc::Scheduler::Task
+{
+public:
+	virtual void
+	run()
+	{
+		executions++;
+	}
+};
+
+static EmptyTask tasks[maximumTasks];
+static uint16_t periods[maximumTasks];
+static uint8_t priorities[maximumTasks];
+
+// ----------------------------------------------------------------------------
+static void
+run(uint16_t numberOfTasks)
+{
+	uint64_t listTime;
+	{
+		ListScheduler scheduler;
+		for (uint16_t i = 0; i < numberOfTasks; ++i) {
+			scheduler.scheduleTask(periods[i], priorities[i]);
+		}
+
+		executions = 0;
+		uint64_t start = getTime();
+		for (uint32_t i = 0; i < ticks; ++i) {
+			scheduler.schedule();
+		}
+		listTime = getTime() - start;
+	}
+	const uint32_t listExecutions = executions;
+
+	xpcc::Scheduler scheduler;
+	for (uint16_t i = 0; i < numberOfTasks; ++i) {
+		scheduler.scheduleTask(tasks[i], periods[i], priorities[i]);
+	}
+
+	executions = 0;
+	uint64_t start = getTime();
+	for (uint32_t i = 0; i < ticks; ++i) {
+		scheduler.schedule();
+	}
+	const uint64_t wheelTime = getTime() - start;
+
+	// remove and add every task again, with a different period
+	start = getTime();
+	for (uint16_t i = 0; i < numberOfTasks; ++i)
+	{
+		scheduler.removeTask(tasks[i]);
+		scheduler.scheduleTask(tasks[i], periods[numberOfTasks - 1 - i], priorities[i]);
+	}
+	const uint64_t changeTime = getTime() - start;
+
+	for (uint16_t i = 0; i < numberOfTasks; ++i) {
+		scheduler.removeTask(tasks[i]);
+	}
+
+	XPCC_LOG_INFO << numberOfTasks << ", "
+			<< uint32_t(listTime / ticks) << ", "
+			<< uint32_t(wheelTime / ticks) << ", "
+			<< uint32_t(changeTime / numberOfTasks) << ", "
+			<< listExecutions << ", " << executions << xpcc::endl;
+}
+
+int
+main()
+{
+	std::srand(42);
+	for (uint16_t i = 0; i < maximumTasks; ++i)
+	{
+		periods[i] = 1 + std::rand() % 1000;
+		priorities[i] = 1 + std::rand() % 255;
+	}
+
+	XPCC_LOG_INFO << "tasks, list per tick, wheel per tick, remove + add, "
+			"executions list, executions wheel" << xpcc::endl;
+	for (uint16_t numberOfTasks = 8; numberOfTasks <= maximumTasks; numberOfTasks *= 2) {
+		run(numberOfTasks);
+	}
+
+	return 0;
+}
@@ -0,0 +1,136 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Receive path of the SocketCAN driver at full 1 MBit/s bus load.
+ *
+ * A transmitter thread sends 7600 extended frames with 8 data bytes per
+ * second, about the maximum of a 1 MBit/s bus, for five seconds. The
+ * receiver either wakes up for every frame (poll), or runs a 1ms loop as
+ * a typical application calling Dispatcher::update() does and fetches
+ * the collected frames in batches.
+ *
+ * Requires a virtual CAN interface:
+ *   sudo modprobe vcan
+ *   sudo ip link add dev vcan0 type vcan
+ *   sudo ip link set up vcan0
+ *   scons run       (or: ./socketcan vcan1)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <poll.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/architecture/platform/driver/can/socketcan/socketcan.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+typedef std::chrono::steady_clock Clock;
+
+static constexpr uint32_t framesPerSecond = 7600;
+static constexpr uint32_t seconds = 5;
+
+static void
+transmit(const char *interface, std::atomic<bool>& done)
+{
+	xpcc::hosted::SocketCan can;
+	can.open(interface);
+
+	xpcc::can::Message message(0x12345678, 8);
+	Clock::time_point next = Clock::now();
+	const auto period = std::chrono::nanoseconds(1000000000 / framesPerSecond);
+	for (uint32_t i = 0; i < framesPerSecond * seconds; ++i)
+	{
+		message.data[0] = i;
+		while (!can.sendMessage(message)) {
+			usleep(100);
+		}
+		next += period;
+		std::this_thread::sleep_until(next);
+	}
+	usleep(10000);
+	done = true;
+}
+
+static uint64_t
+getThreadCpuTime()
+{
+	rusage usage;
+	getrusage(RUSAGE_THREAD, &usage);
+	return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ULL +
+			usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static void
+run(const char *name, const char *interface, bool wakeUpPerFrame)
+{
+	xpcc::hosted::SocketCan can;
+	if (!can.open(interface)) {
+		return;
+	}
+
+	std::atomic<bool> done(false);
+	uint64_t cpuStart = getThreadCpuTime();
+	std::thread transmitter(transmit, interface, std::ref(done));
+
+	uint32_t received = 0;
+	uint64_t latency = 0;
+	while (!done)
+	{
+		if (wakeUpPerFrame)
+		{
+			pollfd descriptor;
+			descriptor.fd = can.getFileDescriptor();
+			descriptor.events = POLLIN;
+			poll(&descriptor, 1, 10);
+		}
+		else {
+			usleep(1000);
+		}
+
+		xpcc::can::Message message;
+		while (can.getMessage(message))
+		{
+			timespec now;
+			clock_gettime(CLOCK_REALTIME, &now);
+			const timespec& timestamp = can.getTimestamp();
+			latency += (now.tv_sec - timestamp.tv_sec) * 1000000000LL +
+					(now.tv_nsec - timestamp.tv_nsec);
+			received++;
+		}
+	}
+	transmitter.join();
+
+	uint64_t cpu = getThreadCpuTime() - cpuStart;
+	const xpcc::hosted::SocketCan::Statistics& statistics = can.getStatistics();
+	XPCC_LOG_INFO << name << ", " << received << ", "
+			<< statistics.receiveCalls << ", "
+			<< uint32_t(cpu / seconds) << ", "
+			<< uint32_t(received ? latency / received / 1000 : 0) << ", "
+			<< statistics.droppedMessages << xpcc::endl;
+}
+
+int
+main(int argc, char *argv[])
+{
+	const char *interface = (argc > 1) ? argv[1] : "vcan0";
+
+	XPCC_LOG_INFO << "receiver, frames, recvmmsg calls, CPU us/s, latency us, dropped" << xpcc::endl;
+	run("wake up per frame", interface, true);
+	run("1ms loop", interface, false);
+
+	return 0;
+}
@@ -0,0 +1,173 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Wakeups of a battery powered sensor node with and without
+ * xpcc::GenericTickless.
+ *
+ * The node samples a sensor every 100ms and does some housekeeping every
+ * 5s from scheduler tasks. Its main loop toggles a LED every second,
+ * transmits the collected data every 10s and waits 50ms for the
+ * acknowledge of every transmission.
+ *
+ * Ten minutes are simulated with a virtual clock. With a 1ms tick the
+ * core wakes up on every tick, tickless only for the next deadline. Both
+ * variants must handle the same number of events.
+ */
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/architecture/driver/clock_dummy.hpp>
+#include <xpcc/processing/timer.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+typedef xpcc::ClockDummy Clock;
+typedef xpcc::GenericTimeout<Clock, xpcc::Timestamp> Timeout;
+typedef xpcc::GenericPeriodicTimer<Clock, xpcc::Timestamp> PeriodicTimer;
+typedef xpcc::GenericTickless<Clock, xpcc::Timestamp, 4> Tickless;
+
+static constexpr uint32_t duration = 10 * 60 * 1000;
+
+struct Events
+{
+	uint32_t samples;
+	uint32_t housekeeping;
+	uint32_t heartbeats;
+	uint32_t transmissions;
+	uint32_t acknowledgeTimeouts;
+};
+
+class CountingTask : public xpcc::Scheduler::Task
+{
+public:
+	CountingTask(uint32_t& counter) :
+		counter(counter)
+	{
+	}
+
+	virtual void
+	run()
+	{
+		counter++;
+	}
+
+private:
+	uint32_t& counter;
+};
+
+class Node
+{
+public:
+	Node() :
+		events(), sampleTask(events.samples),
+		housekeepingTask(events.housekeeping),
+		heartbeat(1000), transmission(10000)
+	{
+		scheduler.scheduleTask(sampleTask, 100, 100);
+		scheduler.scheduleTask(housekeepingTask, 5000, 10);
+	}
+
+	/// Poll the software timers of the main loop
+	void
+	update()
+	{
+		if (heartbeat.execute()) {
+			events.heartbeats++;
+		}
+		if (transmission.execute()) {
+			events.transmissions++;
+			acknowledge.restart(50);
+		}
+		if (acknowledge.execute()) {
+			events.acknowledgeTimeouts++;
+		}
+	}
+
+	Events events;
+	xpcc::Scheduler scheduler;
+	CountingTask sampleTask;
+	CountingTask housekeepingTask;
+
+	PeriodicTimer heartbeat;
+	PeriodicTimer transmission;
+	Timeout acknowledge;
+};
+
+static void
+report(const char *name, uint32_t wakeups, const Events& events)
+{
+	XPCC_LOG_INFO << name << ", " << wakeups << ", "
+			<< events.samples << ", " << events.housekeeping << ", "
+			<< events.heartbeats << ", " << events.transmissions << ", "
+			<< events.acknowledgeTimeouts << xpcc::endl;
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "mode, wakeups, samples, housekeeping, heartbeats, "
+			"transmissions, acknowledge timeouts" << xpcc::endl;
+
+	// SysTick interrupt every millisecond
+	uint32_t tickWakeups = 0;
+	{
+		Clock::setTime(0);
+		Node node;
+		while (Clock::now().getTime() < duration)
+		{
+			Clock::setTime(Clock::now().getTime() + 1);
+			tickWakeups++;
+			node.scheduler.schedule();
+			node.update();
+		}
+		report("1ms tick", tickWakeups, node.events);
+	}
+
+	uint32_t ticklessWakeups = 0;
+	{
+		Clock::setTime(0);
+		Node node;
+		Tickless tickless;
+		tickless.add(node.heartbeat);
+		tickless.add(node.transmission);
+		tickless.add(node.acknowledge);
+		tickless.attach(node.scheduler, 1);
+
+		auto sleepFor = [&ticklessWakeups](uint32_t time) {
+			if (Clock::now().getTime() + time > duration) {
+				time = duration - Clock::now().getTime();
+			}
+			Clock::setTime(Clock::now().getTime() + time);
+			ticklessWakeups++;
+		};
+
+		while (Clock::now().getTime() < duration)
+		{
+			node.update();
+			if (!tickless.sleep(sleepFor))
+			{
+				// next deadline too close, wait for it with the tick
+				if (tickless.getTimeUntilNextDeadline() > 0) {
+					sleepFor(1);
+				}
+			}
+		}
+		// handle the events of the last wakeup
+		tickless.update();
+		node.update();
+		report("tickless", ticklessWakeups, node.events);
+	}
+
+	XPCC_LOG_INFO << "avoided wakeups: " << (tickWakeups - ticklessWakeups)
+			<< " (" << uint32_t(100ULL * (tickWakeups - ticklessWakeups) / tickWakeups)
+			<< "%)" << xpcc::endl;
+
+	return 0;
+}
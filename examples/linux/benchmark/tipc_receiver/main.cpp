@@ -0,0 +1,206 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+/*
+ * Measures the latency from sending a packet until xpcc::tipc::Receiver
+ * reports it as available, compared with the previous implementation which
+ * polled the socket every millisecond and used a mutex protected queue.
+ *
+ * A local datagram socket pair stands in for the TIPC socket, so no TIPC
+ * enabled kernel is required. Packets are sent every 200us, the consumer
+ * waits on the eventfd of the receiver respectively checks hasPacket()
+ * continuously for the polling reference.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <xpcc/architecture.hpp>
+#include <xpcc/communication.hpp>
+#include <xpcc/communication/xpcc/backend/tipc/receiver.hpp>
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::INFO
+
+typedef std::chrono::steady_clock Clock;
+
+static constexpr uint32_t packets = 5000;
+static constexpr std::chrono::microseconds interval(200);
+static constexpr uint32_t ownPortId = 0xffffffff;
+
+/// Previous receiver: poll the socket every millisecond
+class PollingReceiver
+{
+public:
+	PollingReceiver(int socketDescriptor) :
+		socket(socketDescriptor), isAlive(true),
+		thread(&PollingReceiver::run, this)
+	{
+	}
+
+	~PollingReceiver()
+	{
+		isAlive = false;
+		thread.join();
+	}
+
+	bool
+	hasPacket() const
+	{
+		std::lock_guard<std::mutex> guard(queueLock);
+		return !queue.empty();
+	}
+
+	xpcc::SmartPointer
+	getPacket() const
+	{
+		std::lock_guard<std::mutex> guard(queueLock);
+		return queue.front();
+	}
+
+	void
+	dropPacket()
+	{
+		std::lock_guard<std::mutex> guard(queueLock);
+		queue.pop();
+	}
+
+private:
+	void
+	run()
+	{
+		while (isAlive)
+		{
+			std::lock_guard<std::mutex> socketGuard(socketLock);
+
+			xpcc::tipc::Header header;
+			uint32_t port;
+			while (socket.receiveHeader(port, header))
+			{
+				std::lock_guard<std::mutex> guard(queueLock);
+				queue.push(xpcc::SmartPointer(header.size));
+				socket.receivePayload(queue.back().getPointer(), header.size);
+			}
+			usleep(1000);
+		}
+	}
+
+	xpcc::tipc::ReceiverSocket socket;
+	std::atomic<bool> isAlive;
+	std::mutex socketLock;
+	mutable std::mutex queueLock;
+	std::queue<xpcc::SmartPointer> queue;
+	std::thread thread;
+};
+
+static void
+sendPackets(int socket)
+{
+	Clock::time_point next = Clock::now();
+	for (uint32_t ii = 0; ii < packets; ++ii)
+	{
+		std::this_thread::sleep_until(next);
+		next += interval;
+
+		// same layout as transmitted by xpcc::TipcConnector
+		xpcc::tipc::Header tipcHeader(sizeof(xpcc::Header) + sizeof(int64_t));
+		xpcc::Header header(xpcc::Header::Type::REQUEST, false, 1, 2, 3);
+		int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				Clock::now().time_since_epoch()).count();
+
+		uint8_t frame[sizeof(tipcHeader) + sizeof(header) + sizeof(timestamp)];
+		std::memcpy(frame, &tipcHeader, sizeof(tipcHeader));
+		std::memcpy(frame + sizeof(tipcHeader), &header, sizeof(header));
+		std::memcpy(frame + sizeof(tipcHeader) + sizeof(header), &timestamp, sizeof(timestamp));
+		if (::send(socket, frame, sizeof(frame), 0) != sizeof(frame)) {
+			XPCC_LOG_ERROR << "send() failed" << xpcc::endl;
+		}
+	}
+}
+
+static uint32_t
+latency(const xpcc::SmartPointer& packet)
+{
+	int64_t timestamp;
+	std::memcpy(&timestamp, packet.getPointer() + sizeof(xpcc::Header), sizeof(timestamp));
+	int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			Clock::now().time_since_epoch()).count();
+	return (now - timestamp) / 1000;
+}
+
+static void
+report(const char *name, std::vector<uint32_t>& latencies)
+{
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&latencies](uint32_t p) {
+		return latencies[(latencies.size() - 1) * p / 100];
+	};
+	XPCC_LOG_INFO << name << ", "
+			<< percentile(50) << ", " << percentile(90) << ", "
+			<< percentile(99) << ", " << latencies.back() << xpcc::endl;
+}
+
+int
+main()
+{
+	XPCC_LOG_INFO << "receiver, p50 [us], p90 [us], p99 [us], max [us]" << xpcc::endl;
+
+	{
+		int sockets[2];
+		socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets);
+		PollingReceiver receiver(sockets[1]);
+
+		std::vector<uint32_t> latencies;
+		std::thread sender(sendPackets, sockets[0]);
+		while (latencies.size() < packets)
+		{
+			if (receiver.hasPacket()) {
+				latencies.push_back(latency(receiver.getPacket()));
+				receiver.dropPacket();
+			}
+		}
+		sender.join();
+		close(sockets[0]);
+		report("polling", latencies);
+	}
+
+	{
+		int sockets[2];
+		socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets);
+		xpcc::tipc::Receiver receiver(ownPortId, sockets[1]);
+
+		pollfd event;
+		event.fd = receiver.getEventFileDescriptor();
+		event.events = POLLIN;
+
+		std::vector<uint32_t> latencies;
+		std::thread sender(sendPackets, sockets[0]);
+		while (latencies.size() < packets)
+		{
+			poll(&event, 1, -1);
+			while (receiver.hasPacket()) {
+				latencies.push_back(latency(receiver.getPacket()));
+				receiver.dropPacket();
+			}
+		}
+		sender.join();
+		close(sockets[0]);
+		report("event  ", latencies);
+	}
+
+	return 0;
+}
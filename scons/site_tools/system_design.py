@@ -108,7 +108,8 @@ def postman_emitter(target, source, env):
 		path = '.'
 	
 	target = [os.path.join(path, "postman.cpp"),
-			  os.path.join(path, "postman.hpp")]
+			  os.path.join(path, "postman.hpp"),
+			  os.path.join(path, "postman_report.txt")]
 	
 	return (target, source)
 
@@ -173,6 +174,7 @@ def generate(env, **kw):
 			action = SCons.Action.Action(
 				'python2 "${XPCC_SYSTEM_BUILDER}/cpp_postman.py" ' \
 					'--container "${container}" ' \
+					'--dispatch "${dispatch}" ' \
 					'--outpath ${TARGET.dir} ' \
 					'--dtdpath "${dtdPath}" ' \
 					'--namespace "${namespace}" ' \
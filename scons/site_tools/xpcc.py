@@ -165,10 +165,14 @@ def xpcc_communication_header(env, xmlfile, path='.', dtdPath=None, namespace='r
 	files += env.SystemCppCommunication(xmlfile, path=path, dtdPath=dtdPath, namespace=namespace)
 	files += env.SystemCppXpccTaskCaller(xmlfile, path=path, dtdPath=dtdPath, namespace=namespace)
 	if 'communication' in env['XPCC_CONFIG']:
+		if 'dispatch' in env['XPCC_CONFIG']['communication']:
+			dispatch = env['XPCC_CONFIG']['communication']['dispatch']
+		else: dispatch = 'switch'
 		files += env.SystemCppPostman(
 				target='postman',
 				source=xmlfile,
 				container=env['XPCC_CONFIG']['communication']['container'],
+				dispatch=dispatch,
 				path=path,
 				dtdPath=dtdPath,
 				namespace=namespace)
@@ -72,6 +72,24 @@ public:
 		///< The bus-off state is entered on TEC overflow, greater than 255
 		Off = 3,
 	};
+
+	/**
+	 * Acceptance filter for extended (29-bit) identifiers.
+	 *
+	 * A message is accepted if the bits of its identifier selected by
+	 * the mask are equal to the ones of the filter identifier.
+	 */
+	struct Filter
+	{
+		uint32_t identifier;
+		uint32_t mask;
+
+		inline bool
+		matches(uint32_t messageIdentifier) const
+		{
+			return ((messageIdentifier ^ identifier) & mask) == 0;
+		}
+	};
 #ifdef __DOXYGEN__
 public:
 	/**
@@ -122,6 +140,27 @@ public:
 
 	static BusState
 	getBusState();
+
+	/// Maximum number of acceptance filters, e.g. to size arrays.
+	static constexpr uint8_t numberOfFilters;
+
+	/// Number of acceptance filters which can be set by setFilters() now.
+	static uint8_t
+	getNumberOfFilters();
+
+	/**
+	 * Replace the acceptance filters of the controller.
+	 *
+	 * Messages matching none of the filters are dropped by the hardware.
+	 * With \p count zero all messages are received, standard and
+	 * extended, data and remote frames.
+	 *
+	 * @param	filters	Array of at most getNumberOfFilters() filters
+	 * @return	\c false if \p count is too large, the filters are not
+	 * 			changed then
+	 */
+	static bool
+	setFilters(const Filter *filters, uint8_t count);
 #endif
 };
 
@@ -7,191 +7,125 @@
  */
 // ----------------------------------------------------------------------------
 
-#include <iostream>
 #include <xpcc/debug/logger.hpp>
 
-#include <xpcc/architecture/driver.hpp>
-#include <xpcc/processing/timer.hpp>
-
 #include <xpcc/driver/can/can_lawicel_formatter.hpp>
 #include "canusb.hpp"
 
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
 #undef  XPCC_LOG_LEVEL
 #define XPCC_LOG_LEVEL xpcc::log::INFO
 
 xpcc::hosted::CanUsb::CanUsb()
-:	active(false), busState(BusState::Off)
+:	busState(BusState::Off), receiveLength(0),
+	head(0), tail(0), stopEvent(-1)
 {
 }
 
 xpcc::hosted::CanUsb::~CanUsb()
 {
-	if (this->active)
-	{
-		{
-			MutexGuard stateGuard(this->stateLock);
-			this->active = false;
-		}
-		this->thread->join();
-		delete this->thread;
-		this->thread = 0;
-	}
+	this->stopThread();
 	this->serialPort.close();
-	while (this->serialPort.isOpen())
-	{
-		//wait for port to close;
-	}
 }
 
 bool
 xpcc::hosted::CanUsb::open(std::string deviceName, unsigned int serialBaudRate, xpcc::Can::Bitrate canBitrate)
 {
-	if (this->serialPort.isOpen())
-		this->serialPort.close();
-
-	while (this->serialPort.isOpen())
-	{
-		// wait for port to close;
+	if (this->serialPort.isOpen()) {
+		this->close();
 	}
 
 	this->serialPort.setDeviceName(deviceName);
 	this->serialPort.setBaudRate(serialBaudRate);
 
-	if (this->serialPort.open())
+	if (!this->serialPort.open())
 	{
-		XPCC_LOG_DEBUG << XPCC_FILE_INFO << "SerialPort opened in canusb" << xpcc::endl;
-		XPCC_LOG_DEBUG << XPCC_FILE_INFO << "write 'C'" << xpcc::endl;
-		this->serialPort.write("C\r");
-
-		xpcc::ShortTimeout timeout;
-		timeout.restart(500);
-		while (!timeout.isExpired())
-		{
-		}
-
-		char a;
-		while( this->serialPort.read(a) );
-
-		// Set CAN bitrate
-		XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Set CAN bitrate" << xpcc::endl;
-		
-		switch (canBitrate)
-		{
-			case kBps10:
-				this->serialPort.write("S0\r");
-			break;
-			case kBps20:
-				this->serialPort.write("S1\r");
-			break;
-			case kBps50:
-				this->serialPort.write("S2\r");
-			break;
-			case kBps100:
-				this->serialPort.write("S3\r");
-			break;
-			case kBps125:
-				this->serialPort.write("S4\r");
-			break;
-			case kBps250:
-				this->serialPort.write("S5\r");
-			break;
-			case kBps500:
-				this->serialPort.write("S6\r");
-			break;
-			case MBps1:
-				this->serialPort.write("S8\r");
-			break;
-		}
-
-		
+		busState = BusState::Off;
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not open Canusb" << xpcc::endl;
+		return false;
+	}
 
-		timeout.restart(500);
-		while (!this->serialPort.read(a))
-		{
-			if (timeout.isExpired())
-			{
-				XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Timer expired" << xpcc::endl;
-				this->serialPort.close();
-				while (this->serialPort.isOpen())
-				{
-					// wait for port to close;
-				}
-				return false;
-			}
-		}
-		if (a != '\r')
-		{
-			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Wrong answer on set CAN bitrate: " << xpcc::hex << (int) a	<< xpcc::endl;
-			this->serialPort.close();
-			while (this->serialPort.isOpen())
-			{
-				// wait for port to close;
-			}
-			return false;
-		}
-		
-		// Open CAN channel
-		this->serialPort.write("O\r");
-		XPCC_LOG_DEBUG << XPCC_FILE_INFO << "written 'O'" << xpcc::endl;
-		timeout.restart(500);
-		while (!this->serialPort.read(a))
-		{
-			if (timeout.isExpired())
-			{
-				XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Timer expired" << xpcc::endl;
-				this->serialPort.close();
-				while (this->serialPort.isOpen())
-				{
-					// wait for port to close;
-				}
-				return false;
-			}
-		}
+	XPCC_LOG_DEBUG << XPCC_FILE_INFO << "SerialPort opened in canusb" << xpcc::endl;
 
-		if (a != '\r')
-		{
-			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Wrong answer on O: " << xpcc::hex << (int) a << xpcc::endl;
-			this->serialPort.close();
-			while (this->serialPort.isOpen())
-			{
-				// wait for port to close;
-			}
-			return false;
-		}
+	// Close a channel left open and discard everything received so far
+	this->serialPort.write("C\r");
+	char a;
+	while (this->readCharacter(a, 100)) {
+	}
 
-		{
-			MutexGuard stateGuard(this->stateLock);
-			this->active = true;
-		}
-		this->thread = new boost::thread(
-				boost::bind(&xpcc::hosted::CanUsb::update, this));
+	// Set CAN bitrate
+	XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Set CAN bitrate" << xpcc::endl;
 
-		busState = BusState::Connected;
-		this->tmpRead.clear();
-		return true;
+	const char *bitrate = "S4\r";
+	switch (canBitrate)
+	{
+		case kBps10:  bitrate = "S0\r"; break;
+		case kBps20:  bitrate = "S1\r"; break;
+		case kBps50:  bitrate = "S2\r"; break;
+		case kBps100: bitrate = "S3\r"; break;
+		case kBps125: bitrate = "S4\r"; break;
+		case kBps250: bitrate = "S5\r"; break;
+		case kBps500: bitrate = "S6\r"; break;
+		case MBps1:   bitrate = "S8\r"; break;
 	}
-	else
+
+	// Open CAN channel
+	if (!this->sendCommand(bitrate) || !this->sendCommand("O\r"))
 	{
-		busState = BusState::Off;
-		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not open Canusb" << xpcc::endl;
+		this->serialPort.close();
 		return false;
 	}
+
+	this->receiveLength = 0;
+	this->startThread();
+
+	busState = BusState::Connected;
+	return true;
 }
 
 void
 xpcc::hosted::CanUsb::close()
 {
 	this->serialPort.write("C\r");
+	this->stopThread();
+	this->serialPort.close();
+	busState = BusState::Off;
+}
+
+bool
+xpcc::hosted::CanUsb::sendCommand(const char *command)
+{
+	this->serialPort.write(command);
+
+	char a;
+	if (!this->readCharacter(a, 500))
 	{
-		MutexGuard stateGuard(this->stateLock);
-		this->active = false;
+		XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Timer expired" << xpcc::endl;
+		return false;
+	}
+	if (a != '\r')
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Wrong answer on " << command[0] << ": " << xpcc::hex << (int) a << xpcc::endl;
+		return false;
 	}
+	return true;
+}
 
-	this->thread->join();
-	delete this->thread;
-	this->thread = 0;
-	this->serialPort.close();
-	busState = BusState::Off;
+bool
+xpcc::hosted::CanUsb::readCharacter(char& c, int timeout)
+{
+	pollfd descriptor;
+	descriptor.fd = this->serialPort.getFileDescriptor();
+	descriptor.events = POLLIN;
+	if (poll(&descriptor, 1, timeout) <= 0) {
+		return false;
+	}
+	return this->serialPort.read(c);
 }
 
 xpcc::Can::BusState
@@ -203,57 +137,139 @@ xpcc::hosted::CanUsb::getBusState()
 bool
 xpcc::hosted::CanUsb::getMessage(can::Message& message)
 {
-	if (!this->readBuffer.empty())
-	{
-		message = this->readBuffer.front();
-		this->readBuffer.pop();
-		return true;
-	}
-	else
-	{
+	std::size_t index = this->tail.load(std::memory_order_relaxed);
+	if (index == this->head.load(std::memory_order_acquire)) {
 		return false;
 	}
+
+	message = this->queue[index & (queueSize - 1)];
+	this->tail.store(index + 1, std::memory_order_release);
+	return true;
 }
 
 bool
 xpcc::hosted::CanUsb::sendMessage(const can::Message& message)
 {
-	char str[128];
+	// the frame and its terminating '\r' are written with one call
+	char str[32];
 	xpcc::CanLawicelFormatter::convertToString(message, str);
-	XPCC_LOG_DEBUG.printf("Sending ");
-	char *p = str;
-	while (*p != '\0') {
-		XPCC_LOG_DEBUG.printf("%02x %c, ", *p, *p);
-		++p;
-	}
-	this->serialPort.write(str);
-	this->serialPort.write("\r");
+	std::size_t length = std::strlen(str);
+	str[length++] = '\r';
+
+	this->serialPort.writeBytes(reinterpret_cast<uint8_t *>(str), length);
 	return true;
 }
 
+// ----------------------------------------------------------------------------
+void
+xpcc::hosted::CanUsb::startThread()
+{
+	this->stopEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	// The start of the thread has to be placed _after_ the initialization of the event
+	this->thread.reset(new boost::thread(boost::bind(&CanUsb::run, this)));
+}
+
+void
+xpcc::hosted::CanUsb::stopThread()
+{
+	if (!this->thread) {
+		return;
+	}
+
+	uint64_t value = 1;
+	if (write(this->stopEvent, &value, sizeof(value)) != sizeof(value)) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not stop the receiver thread." << xpcc::endl;
+	}
+	this->thread->join();
+	this->thread.reset();
+
+	::close(this->stopEvent);
+	this->stopEvent = -1;
+}
+
 void
-xpcc::hosted::CanUsb::update()
+xpcc::hosted::CanUsb::run()
 {
-	while (1)
+	pollfd descriptors[2];
+	descriptors[0].fd = this->stopEvent;
+	descriptors[0].events = POLLIN;
+	descriptors[1].fd = this->serialPort.getFileDescriptor();
+	descriptors[1].events = POLLIN;
+
+	bool queueFull = false;
+	while (true)
 	{
-		char a;
-		if (this->serialPort.read(a))
+		// Sleep until data arrives. While the queue is full the port is
+		// not watched, instead check again for free space after 1ms.
+		int result = poll(descriptors, queueFull ? 1 : 2, queueFull ? 1 : -1);
+		if (result < 0)
 		{
-			XPCC_LOG_DEBUG.printf("Received %02x\n", a);
-			if (a == 'T' || a == 't' || a == 'r' || a == 'R')
-			{
-				this->tmpRead.clear();
+			if (errno == EINTR) {
+				continue;
 			}
-			this->tmpRead += a;
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "poll() failed. errno=" << errno << xpcc::endl;
+			break;
+		}
 
-			can::Message message;
-			if (xpcc::CanLawicelFormatter::convertToCanMessage(
-					this->tmpRead.c_str(), message))
-			{
-				this->readBuffer.push(message);
-			}
+		if (descriptors[0].revents != 0) {
+			break;
 		}
-		if (!this->active)
+
+		queueFull = (this->getFreeSlots() * minimumFrameLength <= this->receiveLength);
+		if (!queueFull && descriptors[1].revents != 0 && !this->receive())
+		{
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Adapter disconnected" << xpcc::endl;
+			busState = BusState::Off;
 			break;
+		}
 	}
 }
+
+bool
+xpcc::hosted::CanUsb::receive()
+{
+	// The frames in the buffer never exceed the free slots
+	std::size_t length = sizeof(this->receiveBuffer) - this->receiveLength;
+	const std::size_t limit = this->getFreeSlots() * minimumFrameLength;
+	if (length > limit - this->receiveLength) {
+		length = limit - this->receiveLength;
+	}
+
+	ssize_t result = ::read(this->serialPort.getFileDescriptor(),
+			this->receiveBuffer + this->receiveLength, length);
+	if (result <= 0) {
+		return (result < 0 && (errno == EAGAIN || errno == EINTR));
+	}
+	this->receiveLength += result;
+
+	std::size_t processed = xpcc::CanLawicelFormatter::convertBuffer(
+			this->receiveBuffer, this->receiveLength,
+			[this](const can::Message& message) { this->push(message); });
+
+	if (processed == 0 && this->receiveLength == sizeof(this->receiveBuffer)) {
+		// no frame terminator at all, discard the garbage
+		processed = this->receiveLength;
+	}
+
+	// keep the beginning of an incomplete frame for the next chunk
+	this->receiveLength -= processed;
+	std::memmove(this->receiveBuffer, this->receiveBuffer + processed, this->receiveLength);
+	return true;
+}
+
+std::size_t
+xpcc::hosted::CanUsb::getFreeSlots() const
+{
+	return queueSize - (this->head.load(std::memory_order_relaxed) -
+			this->tail.load(std::memory_order_acquire));
+}
+
+void
+xpcc::hosted::CanUsb::push(const can::Message& message)
+{
+	// there is always space, see receive()
+	std::size_t index = this->head.load(std::memory_order_relaxed);
+	this->queue[index & (queueSize - 1)] = message;
+	this->head.store(index + 1, std::memory_order_release);
+}
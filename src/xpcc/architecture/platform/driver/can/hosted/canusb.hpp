@@ -10,14 +10,14 @@
 #ifndef XPCC_HOSTED_CAN_USB_HPP
 #define XPCC_HOSTED_CAN_USB_HPP
 
-#include <queue>
+#include <atomic>
 #include <string>
 
 // FIXME: remove this dependency!
 #include "../../uart/hosted/serial_interface.hpp"
 #include <xpcc/architecture/interface/can.hpp>
-#include <boost/thread/mutex.hpp>
 #include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
 
 namespace xpcc
 {
@@ -28,6 +28,13 @@ namespace hosted
 /**
  * Driver for a CAN232 or CANUSB adapter
  *
+ * A separate thread sleeps in poll() until the adapter sends data and
+ * then reads everything available at once. All complete frames of the
+ * chunk are converted and handed over through a lock-free queue, so
+ * neither the thread nor the user ever wait for each other. While the
+ * queue is full the thread reads no further data, it is buffered by the
+ * operating system instead.
+ *
  * @see		http://www.canusb.com/
  * @see		http://www.can232.com/
  * @ingroup	hosted
@@ -48,7 +55,8 @@ public:
 	inline bool
 	isMessageAvailable()
 	{
-		return (!this->readBuffer.empty());
+		return (this->tail.load(std::memory_order_relaxed) !=
+				this->head.load(std::memory_order_acquire));
 	}
 
 	bool
@@ -79,26 +87,63 @@ public:
 	}
 
 private:
-	// updated by boost thread
+	static constexpr std::size_t queueSize = 1024;
+	static_assert((queueSize & (queueSize - 1)) == 0,
+			"queueSize must be a power of two!");
+
+	/// Length of a frame without identifier and data ("t0000\r")
+	static constexpr std::size_t minimumFrameLength = 6;
+
+	/// Send a command and wait for the '\r' of the adapter
+	bool
+	sendCommand(const char *command);
+
+	/// Wait at most `timeout` milliseconds for a character
+	bool
+	readCharacter(char& c, int timeout);
+
 	void
-	update();
+	startThread();
 
-private:
-	typedef boost::mutex				Mutex;
-	typedef boost::mutex::scoped_lock	MutexGuard;
+	void
+	stopThread();
 
-	Mutex stateLock;
-	Mutex readBufferLock;
-	bool active;
+	// executed by the receiver thread
+	void
+	run();
 
-	BusState busState;
+	/**
+	 * Read and convert the available data, at most as many characters
+	 * as needed to fill the queue.
+	 *
+	 * \return	\c false on errors
+	 */
+	bool
+	receive();
+
+	/// Number of messages which can be added to the queue
+	std::size_t
+	getFreeSlots() const;
+
+	void
+	push(const can::Message& message);
+
+private:
+	std::atomic<BusState> busState;
 
 	xpcc::hosted::SerialInterface serialPort;
 
-	std::string tmpRead;
-	std::queue<can::Message> readBuffer;
+	// only used by the receiver thread
+	char receiveBuffer[4096];
+	std::size_t receiveLength;
+
+	/// Lock-free ring between the receiver thread and the user
+	can::Message queue[queueSize];
+	std::atomic<std::size_t> head;	///< written by the receiver thread
+	std::atomic<std::size_t> tail;	///< written by the user
 
-	boost::thread* thread;
+	int stopEvent;		///< wakes the receiver thread for termination
+	boost::scoped_ptr<boost::thread> thread;
 };
 
 }	// namespace hosted
@@ -0,0 +1,336 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "socketcan.hpp"
+
+#include <linux/can/raw.h>
+#include <linux/can/error.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::WARNING
+
+// ----------------------------------------------------------------------------
+xpcc::hosted::SocketCan::SocketCan() :
+	socketDescriptor(-1), busState(BusState::Off),
+	receiveErrorCounter(0), transmitErrorCounter(0),
+	receiveCount(0), receiveIndex(0), timestamp(), hardwareTimestamp(false),
+	statistics()
+{
+}
+
+xpcc::hosted::SocketCan::~SocketCan()
+{
+	this->close();
+}
+
+bool
+xpcc::hosted::SocketCan::open(const std::string& interface, bool loopback)
+{
+	this->close();
+
+	int fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+	if (fd < 0) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not create CAN socket" << xpcc::endl;
+		return false;
+	}
+
+	ifreq request;
+	std::memset(&request, 0, sizeof(request));
+	std::strncpy(request.ifr_name, interface.c_str(), IFNAMSIZ - 1);
+
+	sockaddr_can address;
+	std::memset(&address, 0, sizeof(address));
+	address.can_family = AF_CAN;
+	if (ioctl(fd, SIOCGIFINDEX, &request) < 0 ||
+		(address.can_ifindex = request.ifr_ifindex,
+			bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0))
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not open " << interface.c_str() << xpcc::endl;
+		::close(fd);
+		return false;
+	}
+
+	int enable = 1;
+	if (loopback) {
+		setsockopt(fd, SOL_CAN_RAW, CAN_RAW_RECV_OWN_MSGS, &enable, sizeof(enable));
+	}
+
+	can_err_mask_t errors = CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_RESTARTED;
+	setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errors, sizeof(errors));
+
+	// Hardware timestamps if the controller supports them, kernel
+	// timestamps otherwise
+	int timestamping = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+			SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+	if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &timestamping, sizeof(timestamping)) < 0) {
+		setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable));
+	}
+	setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+
+	this->socketDescriptor = fd;
+	this->busState = BusState::Connected;
+	this->receiveCount = 0;
+	this->receiveIndex = 0;
+	return true;
+}
+
+void
+xpcc::hosted::SocketCan::close()
+{
+	if (this->socketDescriptor >= 0) {
+		::close(this->socketDescriptor);
+		this->socketDescriptor = -1;
+	}
+	this->busState = BusState::Off;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SocketCan::receive()
+{
+	mmsghdr messages[batchSize];
+	iovec vectors[batchSize];
+	for (std::size_t i = 0; i < batchSize; ++i)
+	{
+		vectors[i].iov_base = &this->frames[i];
+		vectors[i].iov_len = sizeof(can_frame);
+
+		msghdr& header = messages[i].msg_hdr;
+		std::memset(&header, 0, sizeof(header));
+		header.msg_iov = &vectors[i];
+		header.msg_iovlen = 1;
+		header.msg_control = this->control[i];
+		header.msg_controllen = sizeof(this->control[i]);
+	}
+
+	this->receiveIndex = 0;
+	this->receiveCount = 0;
+
+	int count = recvmmsg(this->socketDescriptor, messages, batchSize, MSG_DONTWAIT, nullptr);
+	this->statistics.receiveCalls++;
+	if (count <= 0)
+	{
+		if (count < 0 && errno != EAGAIN && errno != EINTR) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "recvmmsg() failed. errno=" << errno << xpcc::endl;
+		}
+		return false;
+	}
+
+	// CAN FD frames are skipped, the remaining ones are moved together
+	for (int i = 0; i < count; ++i)
+	{
+		if (messages[i].msg_len != sizeof(can_frame)) {
+			continue;
+		}
+		if (this->receiveCount != std::size_t(i)) {
+			this->frames[this->receiveCount] = this->frames[i];
+		}
+		this->readControlMessages(messages[i].msg_hdr, this->receiveCount);
+		this->receiveCount++;
+	}
+	return (this->receiveCount > 0);
+}
+
+void
+xpcc::hosted::SocketCan::readControlMessages(const msghdr& header, std::size_t index)
+{
+	this->timestamps[index] = timespec();
+	this->hardwareTimestamps[index] = false;
+
+	for (cmsghdr *message = CMSG_FIRSTHDR(&header); message != nullptr;
+			message = CMSG_NXTHDR(const_cast<msghdr *>(&header), message))
+	{
+		if (message->cmsg_level != SOL_SOCKET) {
+			continue;
+		}
+
+		if (message->cmsg_type == SO_TIMESTAMPING)
+		{
+			// software, deprecated and raw hardware timestamp
+			timespec time[3];
+			std::memcpy(time, CMSG_DATA(message), sizeof(time));
+			if (time[2].tv_sec != 0 || time[2].tv_nsec != 0) {
+				this->timestamps[index] = time[2];
+				this->hardwareTimestamps[index] = true;
+			}
+			else {
+				this->timestamps[index] = time[0];
+			}
+		}
+		else if (message->cmsg_type == SO_TIMESTAMPNS) {
+			std::memcpy(&this->timestamps[index], CMSG_DATA(message), sizeof(timespec));
+		}
+		else if (message->cmsg_type == SO_RXQ_OVFL) {
+			// total number of messages dropped by the socket
+			std::memcpy(&this->statistics.droppedMessages, CMSG_DATA(message), sizeof(uint32_t));
+		}
+	}
+}
+
+void
+xpcc::hosted::SocketCan::handleErrorFrame(const can_frame& frame)
+{
+	this->statistics.errorFrames++;
+
+	if (frame.can_id & CAN_ERR_BUSOFF) {
+		this->busState = BusState::Off;
+	}
+	else if (frame.can_id & CAN_ERR_RESTARTED) {
+		this->busState = BusState::Connected;
+	}
+	else if (frame.can_id & CAN_ERR_CRTL)
+	{
+		const uint8_t status = frame.data[1];
+		if (status & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) {
+			this->busState = BusState::ErrorPassive;
+		}
+		else if (status & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING)) {
+			this->busState = BusState::ErrorWarning;
+		}
+#ifdef CAN_ERR_CRTL_ACTIVE
+		else if (status & CAN_ERR_CRTL_ACTIVE) {
+			this->busState = BusState::Connected;
+		}
+#endif
+	}
+
+#ifdef CAN_ERR_CNT
+	if (frame.can_id & CAN_ERR_CNT) {
+		this->transmitErrorCounter = frame.data[6];
+		this->receiveErrorCounter = frame.data[7];
+	}
+#endif
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SocketCan::isMessageAvailable()
+{
+	if (this->socketDescriptor < 0) {
+		return false;
+	}
+
+	while (true)
+	{
+		while (this->receiveIndex < this->receiveCount)
+		{
+			const can_frame& frame = this->frames[this->receiveIndex];
+			if (!(frame.can_id & CAN_ERR_FLAG)) {
+				return true;
+			}
+			this->handleErrorFrame(frame);
+			this->receiveIndex++;
+		}
+
+		if (!this->receive()) {
+			return false;
+		}
+	}
+}
+
+bool
+xpcc::hosted::SocketCan::getMessage(can::Message& message)
+{
+	if (!this->isMessageAvailable()) {
+		return false;
+	}
+
+	const can_frame& frame = this->frames[this->receiveIndex];
+	message.flags.extended = (frame.can_id & CAN_EFF_FLAG);
+	message.flags.rtr = (frame.can_id & CAN_RTR_FLAG);
+	message.identifier = frame.can_id & (message.flags.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+	message.length = (frame.can_dlc > 8) ? 8 : frame.can_dlc;
+	std::memcpy(message.data, frame.data, 8);
+
+	this->timestamp = this->timestamps[this->receiveIndex];
+	this->hardwareTimestamp = this->hardwareTimestamps[this->receiveIndex];
+
+	this->receiveIndex++;
+	this->statistics.receivedMessages++;
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SocketCan::isReadyToSend()
+{
+	pollfd descriptor;
+	descriptor.fd = this->socketDescriptor;
+	descriptor.events = POLLOUT;
+	return (this->socketDescriptor >= 0 && poll(&descriptor, 1, 0) > 0 &&
+			(descriptor.revents & POLLOUT));
+}
+
+bool
+xpcc::hosted::SocketCan::sendMessage(const can::Message& message)
+{
+	can_frame frame;
+	std::memset(&frame, 0, sizeof(frame));
+	if (message.flags.extended) {
+		frame.can_id = (message.identifier & CAN_EFF_MASK) | CAN_EFF_FLAG;
+	}
+	else {
+		frame.can_id = message.identifier & CAN_SFF_MASK;
+	}
+	if (message.flags.rtr) {
+		frame.can_id |= CAN_RTR_FLAG;
+	}
+	frame.can_dlc = (message.length > 8) ? 8 : message.length;
+	if (!message.flags.rtr) {
+		std::memcpy(frame.data, message.data, frame.can_dlc);
+	}
+
+	// the socket is non-blocking, a full transmit queue fails with ENOBUFS
+	return (write(this->socketDescriptor, &frame, sizeof(frame)) == sizeof(frame));
+}
+
+xpcc::Can::BusState
+xpcc::hosted::SocketCan::getBusState()
+{
+	return this->busState;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::hosted::SocketCan::setFilters(const Filter *filters, uint8_t count)
+{
+	can_filter kernelFilters[numberOfFilters];
+	if (count > numberOfFilters) {
+		return false;
+	}
+
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		// only extended frames, data and remote frames
+		kernelFilters[i].can_id = (filters[i].identifier & CAN_EFF_MASK) | CAN_EFF_FLAG;
+		kernelFilters[i].can_mask = (filters[i].mask & CAN_EFF_MASK) | CAN_EFF_FLAG;
+	}
+
+	if (count == 0)
+	{
+		kernelFilters[0].can_id = 0;
+		kernelFilters[0].can_mask = 0;
+		count = 1;
+	}
+
+	if (setsockopt(this->socketDescriptor, SOL_CAN_RAW, CAN_RAW_FILTER,
+			kernelFilters, count * sizeof(can_filter)) < 0) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not set the CAN filters" << xpcc::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,212 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_HOSTED_SOCKETCAN_HPP
+#define XPCC_HOSTED_SOCKETCAN_HPP
+
+#include <string>
+
+#include <sys/socket.h>
+#include <linux/can.h>
+
+#include <xpcc/architecture/interface/can.hpp>
+
+namespace xpcc
+{
+
+namespace hosted
+{
+
+/**
+ * Driver for the CAN interfaces of the Linux kernel (SocketCAN)
+ *
+ * The bitrate is configured outside of the application, e.g.
+ * `ip link set can0 up type can bitrate 1000000`. For tests the virtual
+ * interface works the same:
+ * @code
+ * modprobe vcan
+ * ip link add dev vcan0 type vcan
+ * ip link set up vcan0
+ * @endcode
+ *
+ * Received messages are read in batches of up to `batchSize` messages
+ * with a single recvmmsg() call, so a fully loaded bus requires only a
+ * few system calls. Every message carries the time it was received,
+ * taken by the CAN controller if it supports hardware timestamps and
+ * by the kernel otherwise (see getTimestamp()).
+ *
+ * The acceptance filters are executed in the kernel, messages not
+ * matching any of them are never copied to the application. They are
+ * set with setFilters(), usually by xpcc::CanConnector::setFilters().
+ *
+ * Error frames of the controller are evaluated for getBusState() and
+ * the error counters and not returned as messages.
+ *
+ * @ingroup	hosted
+ */
+class SocketCan : public ::xpcc::Can
+{
+public:
+	/// Maximum number of messages received with one system call
+	static constexpr std::size_t batchSize = 32;
+
+	/// The kernel has no fixed limit, one filter costs a comparison per frame
+	static constexpr uint8_t numberOfFilters = 32;
+
+	static inline uint8_t
+	getNumberOfFilters()
+	{
+		return numberOfFilters;
+	}
+
+	SocketCan();
+
+	~SocketCan();
+
+	/**
+	 * Open a CAN interface, e.g. "can0" or "vcan0".
+	 *
+	 * @param	loopback	also receive the messages sent by this socket
+	 */
+	bool
+	open(const std::string& interface, bool loopback = false);
+
+	void
+	close();
+
+	inline bool
+	isOpen() const
+	{
+		return (this->socketDescriptor >= 0);
+	}
+
+	/// Descriptor to wait for messages with poll()
+	inline int
+	getFileDescriptor() const
+	{
+		return this->socketDescriptor;
+	}
+
+	/// Check for a message, reads the next batch from the kernel if necessary
+	bool
+	isMessageAvailable();
+
+	bool
+	getMessage(can::Message& message);
+
+	/**
+	 * Receive time of the message returned by the last call of
+	 * getMessage().
+	 *
+	 * Hardware timestamps use the clock of the controller, kernel
+	 * timestamps CLOCK_REALTIME.
+	 */
+	inline const timespec&
+	getTimestamp() const
+	{
+		return this->timestamp;
+	}
+
+	/// Check if the timestamp of the last message was taken by the controller
+	inline bool
+	isHardwareTimestamp() const
+	{
+		return this->hardwareTimestamp;
+	}
+
+	/// Check if the transmit queue of the socket has space
+	bool
+	isReadyToSend();
+
+	/// @return `false` if the transmit queue is full
+	bool
+	sendMessage(const can::Message& message);
+
+	BusState
+	getBusState();
+
+	/// Receive Error Counter of the last error frame
+	inline uint8_t
+	getReceiveErrorCounter() const
+	{
+		return this->receiveErrorCounter;
+	}
+
+	/// Transmit Error Counter of the last error frame
+	inline uint8_t
+	getTransmitErrorCounter() const
+	{
+		return this->transmitErrorCounter;
+	}
+
+	/**
+	 * Replace the acceptance filters in the kernel.
+	 *
+	 * Only extended messages matching a filter are received. With
+	 * \p count zero all messages are received.
+	 *
+	 * \return	\c false if \p count is larger than numberOfFilters
+	 */
+	bool
+	setFilters(const Filter *filters, uint8_t count);
+
+	struct Statistics
+	{
+		uint32_t receivedMessages;
+		uint32_t receiveCalls;		///< number of recvmmsg() calls
+		uint32_t droppedMessages;	///< dropped by the kernel because the socket buffer was full
+		uint32_t errorFrames;
+	};
+
+	inline const Statistics&
+	getStatistics() const
+	{
+		return this->statistics;
+	}
+
+private:
+	SocketCan(const SocketCan&) = delete;
+
+	SocketCan&
+	operator = (const SocketCan&) = delete;
+
+	/// Read the next batch, \return \c false if no message was available
+	bool
+	receive();
+
+	void
+	handleErrorFrame(const can_frame& frame);
+
+	/// Read the timestamp and drop counter of a received message
+	void
+	readControlMessages(const msghdr& header, std::size_t index);
+
+	int socketDescriptor;
+	BusState busState;
+	uint8_t receiveErrorCounter;
+	uint8_t transmitErrorCounter;
+
+	// receive buffers, filled by recvmmsg()
+	can_frame frames[batchSize];
+	timespec timestamps[batchSize];
+	bool hardwareTimestamps[batchSize];
+	alignas(cmsghdr) uint8_t control[batchSize][CMSG_SPACE(3 * sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t))];
+	std::size_t receiveCount;
+	std::size_t receiveIndex;
+
+	timespec timestamp;
+	bool hardwareTimestamp;
+
+	Statistics statistics;
+};
+
+}	// namespace hosted
+
+}	// namespace xpcc
+
+#endif // XPCC_HOSTED_SOCKETCAN_HPP
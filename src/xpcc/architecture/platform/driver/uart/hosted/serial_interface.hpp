@@ -151,6 +151,9 @@ namespace xpcc
 
 			/**
 			 * Write length bytes to device.
+			 *
+			 * Written with as few system calls as possible, waits while
+			 * the output buffer of the port is full.
 			 */
 			void
 			writeBytes(const uint8_t* data, std::size_t length);
@@ -164,6 +167,13 @@ namespace xpcc
 			virtual void
 			flush();
 
+			/// Descriptor of the port to wait for data with poll()
+			inline int
+			getFileDescriptor() const
+			{
+				return this->fileDescriptor;
+			}
+
 			/**
 			 * Output information about device to the Logger (Level:DEBUG).
 			 */
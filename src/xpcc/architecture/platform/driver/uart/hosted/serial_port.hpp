@@ -33,6 +33,7 @@
 
 #include <string>
 #include <queue>
+#include <utility>	// std::exchange, not included by boost/asio with C++20
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
@@ -13,11 +13,13 @@
 #include <ios>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 #include <fcntl.h>		// file control
 #include <sys/ioctl.h>	// I/O control routines
 #include <termios.h>	// POSIX terminal control
 #include <unistd.h>
+#include <poll.h>
 #include <sys/socket.h>
 
 #include <errno.h>
@@ -284,18 +286,36 @@ xpcc::hosted::SerialInterface::write(char c)
 void
 xpcc::hosted::SerialInterface::write(const char* str)
 {
-	char c;
-	while ((c = *str++)) {
-		this->write(c);
-	}
+	this->writeBytes(reinterpret_cast<const uint8_t*>(str), std::strlen(str));
 }
 
 // ----------------------------------------------------------------------------
 void
 xpcc::hosted::SerialInterface::writeBytes(const uint8_t* data, std::size_t length)
 {
-	for (std::size_t i = 0; i < length; ++i) {
-		this->write(static_cast<char>(*data++));
+	while (length > 0)
+	{
+		ssize_t result = ::write(this->fileDescriptor, data, length);
+		if (result < 0)
+		{
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN)
+			{
+				// the port is non-blocking, wait until there is space again
+				pollfd descriptor;
+				descriptor.fd = this->fileDescriptor;
+				descriptor.events = POLLOUT;
+				if (poll(&descriptor, 1, 100) > 0) {
+					continue;
+				}
+			}
+			this->dumpErrorMessage();
+			return;
+		}
+		data += result;
+		length -= result;
 	}
 }
 
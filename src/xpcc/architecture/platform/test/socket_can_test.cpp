@@ -0,0 +1,207 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "socket_can_test.hpp"
+
+#include <xpcc/architecture/utils.hpp>
+
+#ifdef XPCC__OS_LINUX
+
+#include <net/if.h>
+#include <poll.h>
+
+#include "../driver/can/socketcan/socketcan.hpp"
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::WARNING
+
+namespace
+{
+	const char *interface = "vcan0";
+
+	bool
+	isInterfaceAvailable()
+	{
+		static bool warned = false;
+		if (if_nametoindex(interface) != 0) {
+			return true;
+		}
+		if (!warned) {
+			XPCC_LOG_WARNING << "SocketCanTest: " << interface
+					<< " not available, tests skipped" << xpcc::endl;
+			warned = true;
+		}
+		return false;
+	}
+
+	/// Wait up to 100ms for the next message
+	bool
+	receive(xpcc::hosted::SocketCan& can, xpcc::can::Message& message)
+	{
+		if (can.getMessage(message)) {
+			return true;
+		}
+		pollfd descriptor;
+		descriptor.fd = can.getFileDescriptor();
+		descriptor.events = POLLIN;
+		poll(&descriptor, 1, 100);
+		return can.getMessage(message);
+	}
+
+	void
+	send(xpcc::hosted::SocketCan& can, uint32_t identifier, bool extended)
+	{
+		xpcc::can::Message message(identifier, 2);
+		message.flags.extended = extended;
+		message.data[0] = identifier;
+		message.data[1] = identifier >> 8;
+		can.sendMessage(message);
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+SocketCanTest::testSendReceive()
+{
+	if (!isInterfaceAvailable()) {
+		return;
+	}
+
+	xpcc::hosted::SocketCan transmitter;
+	xpcc::hosted::SocketCan receiver;
+	TEST_ASSERT_TRUE(transmitter.open(interface));
+	TEST_ASSERT_TRUE(receiver.open(interface));
+
+	xpcc::can::Message message(0x12345678, 8);
+	for (uint8_t i = 0; i < 8; ++i) {
+		message.data[i] = 0x10 + i;
+	}
+	TEST_ASSERT_TRUE(transmitter.isReadyToSend());
+	TEST_ASSERT_TRUE(transmitter.sendMessage(message));
+
+	xpcc::can::Message standard(0x123, 0);
+	standard.flags.extended = false;
+	standard.flags.rtr = true;
+	TEST_ASSERT_TRUE(transmitter.sendMessage(standard));
+
+	xpcc::can::Message received;
+	TEST_ASSERT_TRUE(receive(receiver, received));
+	TEST_ASSERT_EQUALS(received.identifier, 0x12345678U);
+	TEST_ASSERT_TRUE(received.flags.extended);
+	TEST_ASSERT_FALSE(received.flags.rtr);
+	TEST_ASSERT_EQUALS(received.length, 8);
+	TEST_ASSERT_EQUALS_ARRAY(received.data, message.data, 8);
+
+	TEST_ASSERT_TRUE(receive(receiver, received));
+	TEST_ASSERT_EQUALS(received.identifier, 0x123U);
+	TEST_ASSERT_FALSE(received.flags.extended);
+	TEST_ASSERT_TRUE(received.flags.rtr);
+	TEST_ASSERT_EQUALS(received.length, 0);
+
+	TEST_ASSERT_FALSE(receiver.getMessage(received));
+
+	// without loopback the own messages are not received
+	TEST_ASSERT_FALSE(transmitter.getMessage(received));
+}
+
+void
+SocketCanTest::testBatching()
+{
+	if (!isInterfaceAvailable()) {
+		return;
+	}
+
+	xpcc::hosted::SocketCan transmitter;
+	xpcc::hosted::SocketCan receiver;
+	TEST_ASSERT_TRUE(transmitter.open(interface));
+	TEST_ASSERT_TRUE(receiver.open(interface));
+
+	const uint32_t count = 3 * xpcc::hosted::SocketCan::batchSize + 5;
+	for (uint32_t i = 0; i < count; ++i) {
+		send(transmitter, i, true);
+	}
+
+	uint32_t received = 0;
+	xpcc::can::Message message;
+	while (receive(receiver, message))
+	{
+		TEST_ASSERT_EQUALS(message.identifier, received);
+		received++;
+	}
+	TEST_ASSERT_EQUALS(received, count);
+
+	// four batches if all frames arrived before the first call, some
+	// more if the receiver was faster, but far less than one per frame
+	const xpcc::hosted::SocketCan::Statistics& statistics = receiver.getStatistics();
+	TEST_ASSERT_EQUALS(statistics.receivedMessages, count);
+	TEST_ASSERT_TRUE(statistics.receiveCalls < count / 4);
+	TEST_ASSERT_EQUALS(statistics.droppedMessages, 0U);
+}
+
+void
+SocketCanTest::testFilters()
+{
+	if (!isInterfaceAvailable()) {
+		return;
+	}
+
+	xpcc::hosted::SocketCan transmitter;
+	xpcc::hosted::SocketCan receiver;
+	TEST_ASSERT_TRUE(transmitter.open(interface));
+	TEST_ASSERT_TRUE(receiver.open(interface));
+
+	const xpcc::Can::Filter filters[2] = {
+		{ 0x00100, 0x1fffff00 },
+		{ 0x12345, 0x1fffffff },
+	};
+	receiver.setFilters(filters, 2);
+
+	send(transmitter, 0x00142, true);
+	send(transmitter, 0x00242, true);
+	send(transmitter, 0x12345, true);
+	send(transmitter, 0x00100, false);
+
+	xpcc::can::Message message;
+	TEST_ASSERT_TRUE(receive(receiver, message));
+	TEST_ASSERT_EQUALS(message.identifier, 0x00142U);
+	TEST_ASSERT_TRUE(receive(receiver, message));
+	TEST_ASSERT_EQUALS(message.identifier, 0x12345U);
+	TEST_ASSERT_FALSE(receive(receiver, message));
+
+	// no filters, everything is received
+	receiver.setFilters(0, 0);
+
+	send(transmitter, 0x00242, true);
+	send(transmitter, 0x00100, false);
+
+	TEST_ASSERT_TRUE(receive(receiver, message));
+	TEST_ASSERT_EQUALS(message.identifier, 0x00242U);
+	TEST_ASSERT_TRUE(receive(receiver, message));
+	TEST_ASSERT_EQUALS(message.identifier, 0x00100U);
+	TEST_ASSERT_FALSE(message.flags.extended);
+}
+
+#else
+
+void
+SocketCanTest::testSendReceive()
+{
+}
+
+void
+SocketCanTest::testBatching()
+{
+}
+
+void
+SocketCanTest::testFilters()
+{
+}
+
+#endif
@@ -0,0 +1,37 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef SOCKET_CAN_TEST_HPP
+#define SOCKET_CAN_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+/**
+ * Needs the virtual CAN interface `vcan0`, the tests are skipped
+ * with a warning without it:
+ * @code
+ * modprobe vcan
+ * ip link add dev vcan0 type vcan
+ * ip link set up vcan0
+ * @endcode
+ */
+class SocketCanTest : public unittest::TestSuite
+{
+public:
+	void
+	testSendReceive();
+
+	/// Many queued frames are fetched with few recvmmsg() calls
+	void
+	testBatching();
+
+	void
+	testFilters();
+};
+
+#endif	// SOCKET_CAN_TEST_HPP
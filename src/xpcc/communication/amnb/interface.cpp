@@ -0,0 +1,61 @@
+// coding: utf-8
+// ----------------------------------------------------------------------------
+/* Copyright (c) 2009, Roboterclub Aachen e.V.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Roboterclub Aachen e.V. nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ROBOTERCLUB AACHEN E.V. ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ROBOTERCLUB AACHEN E.V. BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// ----------------------------------------------------------------------------
+
+#ifdef __AVR__
+#	include <util/crc16.h>
+#endif
+#include <xpcc/math/utils/crc.hpp>
+
+#include "interface.hpp"
+
+uint_fast16_t xpcc::amnb::Clock::time = 0;
+
+uint8_t
+xpcc::amnb::crcUpdate(uint8_t crc, uint8_t data)
+{
+#ifdef __AVR__
+	return _crc_ibutton_update(crc, data);
+#else
+	return xpcc::crc::Crc8Dallas::update(crc, data);
+#endif
+}
+
+uint8_t
+xpcc::amnb::crcUpdate(uint8_t crc, const uint8_t *data, std::size_t length)
+{
+#ifdef __AVR__
+	for (std::size_t i = 0; i < length; ++i) {
+		crc = _crc_ibutton_update(crc, data[i]);
+	}
+	return crc;
+#else
+	return xpcc::crc::Crc8Dallas::update(crc, data, length);
+#endif
+}
@@ -58,7 +58,8 @@ namespace xpcc
 		class Clock
 		{
 		public:
-			static Timestamp
+			template< typename TimestampType = Timestamp >
+			static TimestampType
 			now();
 			
 			/// \brief	Set the current time
@@ -83,6 +84,14 @@ namespace xpcc
 		uint8_t
 		crcUpdate(uint8_t crc, uint8_t data);
 		
+		/**
+		 * \internal
+		 * \brief	Add a block of data to the checksum
+		 * \ingroup	amnb
+		 */
+		uint8_t
+		crcUpdate(uint8_t crc, const uint8_t *data, std::size_t length);
+		
 		/**
 		 * \brief	AMNB interface
 		 * 
@@ -202,6 +211,13 @@ namespace xpcc
 			 * \brief	Update internal status
 			 * 
 			 * Has to be called periodically. Decodes received messages.
+			 * 
+			 * The received bytes are fetched from the device in blocks
+			 * with `Device::read(uint8_t *, std::size_t)`. Messages are
+			 * handed to the device four bytes at a time, the next bytes
+			 * follow after the echo from the bus matched. On a collision
+			 * the rest of the message is removed with
+			 * `Device::discardTransmitBuffer()`.
 			 */
 			static void
 			update();
@@ -223,7 +239,7 @@ namespace xpcc
 			};
 			
 			static uint8_t rx_buffer[maxPayloadLength + 3];
-			static uint8_t tx_buffer[maxPayloadLength + 4];
+			static uint8_t tx_buffer[maxPayloadLength + 5];
 			static uint8_t crc;
 			static uint8_t position;
 			static uint8_t length;
@@ -236,7 +252,7 @@ namespace xpcc
 			static bool hasMessageToSend;
 			static bool messageSent;
 			static bool transmitting;
-			static xpcc::Timeout<xpcc::amnb::Clock> rescheduleTimer;
+			static xpcc::GenericTimeout<xpcc::amnb::Clock, xpcc::Timestamp> rescheduleTimer;
 			static uint8_t rescheduleTimeout;
 			
 			static State state;
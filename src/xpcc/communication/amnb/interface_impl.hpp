@@ -32,11 +32,12 @@
 #	error	"Don't include this file directly, use 'interface.hpp' instead!"
 #endif
 
-#include <xpcc/architecture/driver/atomic/lock.hpp>
+#include <cstring>
 
-uint_fast16_t xpcc::amnb::Clock::time = 0;
+#include <xpcc/architecture/driver/atomic/lock.hpp>
 
-xpcc::Timestamp
+template< typename TimestampType >
+TimestampType
 xpcc::amnb::Clock::now()
 {
 	uint_fast16_t tempTime;
@@ -45,32 +46,7 @@ xpcc::amnb::Clock::now()
 		tempTime = time;
 	}
 	
-	return Timestamp(tempTime);
-}
-
-// ----------------------------------------------------------------------------
-#ifdef __AVR__
-#	include <util/crc16.h>
-#endif
-
-uint8_t
-xpcc::amnb::crcUpdate(uint8_t crc, uint8_t data)
-{
-#ifdef __AVR__
-	return _crc_ibutton_update(crc, data);
-#else
-	crc = crc ^ data;
-	for (uint_fast8_t i = 0; i < 8; ++i)
-	{
-		if (crc & 0x01) {
-			crc = (crc >> 1) ^ 0x8C;
-		}
-		else {
-			crc >>= 1;
-		}
-	}
-	return crc;
-#endif
+	return TimestampType(tempTime);
 }
 
 // ----------------------------------------------------------------------------
@@ -81,7 +57,7 @@ template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT>
 uint8_t xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::rx_buffer[maxPayloadLength + 3];
 
 template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT> 
-uint8_t xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::tx_buffer[maxPayloadLength + 4];
+uint8_t xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::tx_buffer[maxPayloadLength + 5];
 
 template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT>
 uint8_t xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::crc;
@@ -111,7 +87,7 @@ template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT>
 xpcc::ShortTimeout xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::resetTimer;
 
 template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT>
-xpcc::Timeout<xpcc::amnb::Clock> xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::rescheduleTimer;
+xpcc::GenericTimeout<xpcc::amnb::Clock, xpcc::Timestamp> xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::rescheduleTimer;
 
 template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT>
 uint8_t xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::rescheduleTimeout;
@@ -144,20 +120,37 @@ template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT>
 bool
 xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::writeMessage()
 {
-	uint8_t check;
+	uint8_t check[4];
 	transmitting = true;
 	Device::resetErrorFlags();
 	
-	for (uint_fast8_t i=0; i < lengthOfTransmitMessage; ++i) {
-		Device::write(tx_buffer[i]);
+	uint_fast8_t sent = 0;
+	uint_fast8_t received = 0;
+	uint16_t count = 0;
+	while (received < lengthOfTransmitMessage)
+	{
+		// hand over the next few bytes only after the previous ones came
+		// back from the bus, so a collision stops the transmission early
+		if (sent == received)
+		{
+			std::size_t size = lengthOfTransmitMessage - sent;
+			if (size > sizeof(check)) {
+				size = sizeof(check);
+			}
+			sent += Device::write(tx_buffer + sent, size);
+		}
 		
-		// try and read the transmitted byte back but do not wait infinity
-		uint16_t count(0);
-		while (!Device::read(check) && (++count <= 1000)) ;
+		// try and read the transmitted bytes back but do not wait infinity
+		std::size_t size = Device::read(check, sent - received);
+		if (size > 0) {
+			count = 0;
+		}
 		
 		// if the read timed out or framing error occurred or content mismatch
-		if ((count > 1000) || Device::readErrorFlags() || (check != tx_buffer[i])) {
+		if ((++count > 1000) || Device::readErrorFlags() ||
+				(std::memcmp(check, tx_buffer + received, size) != 0)) {
 			// stop transmitting, signal the collision
+			Device::discardTransmitBuffer();
 			transmitting = false;
 			rescheduleTransmit = true;
 			Device::resetErrorFlags();
@@ -168,6 +161,7 @@ xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::writeMessage()
 #endif
 			return false;
 		}
+		received += size;
 	}
 	
 #if AMNB_TIMING_DEBUG
@@ -189,9 +183,11 @@ xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::sendMessage(uint8_t address,
 	 // dont overwrite the buffer when transmitting
 	if (transmitting) return false;
 	
+	// would be discarded by the receiver anyway
+	if (payloadLength > maxPayloadLength) return false;
+	
 	hasMessageToSend = false;
 	messageSent = false;
-	uint8_t crc;
 
 #if AMNB_TIMING_DEBUG
 	latency = xpcc::Clock::now();
@@ -202,20 +198,12 @@ xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::sendMessage(uint8_t address,
 	tx_buffer[2] = address | flags;
 	tx_buffer[3] = command;
 	
-	crc = crcUpdate(crcInitialValue, payloadLength);
-	crc = crcUpdate(crc, address | flags);
-	crc = crcUpdate(crc, command);
-	
-	const uint8_t *ptr = static_cast<const uint8_t *>(payload);
-	uint_fast8_t i=0;
-	for (; i < payloadLength; ++i)
-	{
-		crc = crcUpdate(crc, *ptr);
-		tx_buffer[i+4] = *ptr;
-		ptr++;
+	if (payloadLength > 0) {
+		std::memcpy(tx_buffer + 4, payload, payloadLength);
 	}
 	
-	tx_buffer[i+4] = crc;
+	tx_buffer[payloadLength + 4] =
+			crcUpdate(crcInitialValue, tx_buffer + 1, payloadLength + 3);
 	
 	lengthOfTransmitMessage = payloadLength + 5;
 	hasMessageToSend = true;
@@ -341,8 +329,9 @@ template <typename Device, uint8_t PROBABILITY, uint8_t TIMEOUT>
 void
 xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::update()
 {
-	uint8_t byte;
-	while (Device::read(byte))
+	uint8_t chunk[16];
+	std::size_t count;
+	while ((count = Device::read(chunk, sizeof(chunk))) > 0)
 	{
 		if (Device::readErrorFlags())
 		{
@@ -363,38 +352,64 @@ xpcc::amnb::Interface<Device,PROBABILITY,TIMEOUT>::update()
 			return;
 		}
 		
-		switch (state)
+		const uint8_t *ptr = chunk;
+		const uint8_t *end = chunk + count;
+		while (ptr < end)
 		{
-			case SYNC:
-				if (byte == syncByte) state = LENGTH;
-				break;
-			
-			case LENGTH:
-				if (byte > maxPayloadLength) {
-					state = SYNC;
+			switch (state)
+			{
+				case SYNC:
+				{
+					const void *sync = std::memchr(ptr, syncByte, end - ptr);
+					if (sync == 0) {
+						ptr = end;
+					}
+					else {
+						ptr = static_cast<const uint8_t *>(sync) + 1;
+						state = LENGTH;
+					}
+					break;
 				}
-				else {
-					length = byte + 3;		// +3 for header, command and crc byte
-					position = 0;
-					crc = crcUpdate(crcInitialValue, byte);
-					state = DATA;
+				
+				case LENGTH:
+				{
+					uint8_t byte = *ptr++;
+					if (byte > maxPayloadLength) {
+						state = SYNC;
+					}
+					else {
+						length = byte + 3;		// +3 for header, command and crc byte
+						position = 0;
+						crc = crcUpdate(crcInitialValue, byte);
+						state = DATA;
+					}
+					break;
 				}
-				break;
-			
-			case DATA:
-				rx_buffer[position++] = byte;
-				crc = crcUpdate(crc, byte);
 				
-				if (position >= length)
+				case DATA:
 				{
-					if (crc == 0) lengthOfReceivedMessage = length;
-					state = SYNC;
+					// take as much of the frame as is available
+					uint8_t size = length - position;
+					if (size > end - ptr) {
+						size = end - ptr;
+					}
+					std::memcpy(rx_buffer + position, ptr, size);
+					crc = crcUpdate(crc, ptr, size);
+					
+					ptr += size;
+					position += size;
+					if (position >= length)
+					{
+						if (crc == 0) lengthOfReceivedMessage = length;
+						state = SYNC;
+					}
+					break;
 				}
-				break;
-			
-			default:
-				state = SYNC;
-				break;
+				
+				default:
+					state = SYNC;
+					break;
+			}
 		}
 		
 		resetTimer.restart(resetTimeout);
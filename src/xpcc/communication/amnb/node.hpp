@@ -199,6 +199,14 @@ namespace xpcc
 			Callback function;			//!< Method callActionback
 		};
 		
+		/// \internal	Key of an action, its command
+		inline uint16_t
+		getKey(xpcc::accessor::Flash<Action> list, uint8_t index);
+		
+		/// \internal	Key of a listener, its address and command
+		inline uint16_t
+		getKey(xpcc::accessor::Flash<Listener> list, uint8_t index);
+		
 		/**
 		 * \brief	AMNB Node
 		 * 
@@ -207,8 +215,8 @@ namespace xpcc
 		 * 
 		 * FLASH_STORAGE(xpcc::amnb::Action actionList[]) =
 		 * {
-		 *     AMNB__ACTION(0x57, object, Object::method1,  0),
 		 *     AMNB__ACTION(0x03, object, Object::method2,  2),
+		 *     AMNB__ACTION(0x57, object, Object::method1,  0),
 		 * };
 		 * // optional
 		 * FLASH_STORAGE(xpcc::amnb::Listener listenList[]) =
@@ -241,6 +249,12 @@ namespace xpcc
 		 * }
 		 * \endcode
 		 * 
+		 * If the actions are sorted by command and the listeners by address
+		 * and command (without duplicates), the node looks them up by binary
+		 * search, otherwise the lists are scanned linearly. The order is
+		 * checked once on construction. Nodes with many actions should keep
+		 * them sorted to answer requests in time.
+		 * 
 		 * A complete example is available in the \c example/amnb folder.
 		 * 
 		 * \author	Fabian Greif, Niklas Hauser
@@ -391,12 +405,30 @@ namespace xpcc
 			bool
 			checkErrorHandlers(uint8_t address, uint8_t command, Flags type, uint8_t errorCode);
 			
+			/// Check that the keys of a list are strictly ascending
+			template <typename T>
+			static bool
+			isSorted(xpcc::accessor::Flash<T> list, uint8_t count);
+			
+			/**
+			 * \brief	Find the entry for a key
+			 * 
+			 * Only the keys are read from flash while searching.
+			 * 
+			 * \return	Index of the entry or -1 if there is none
+			 */
+			template <typename T>
+			static int16_t
+			find(xpcc::accessor::Flash<T> list, uint8_t count, bool sorted, uint16_t key);
+			
 			
 			uint8_t ownAddress;
 			xpcc::accessor::Flash<Action> actionList;
 			uint8_t actionCount;
+			bool actionsSorted;
 			xpcc::accessor::Flash<Listener> listenList;
 			uint8_t listenCount;
+			bool listenersSorted;
 			xpcc::accessor::Flash<ErrorHandler> errorHandlerList;
 			uint8_t errorHandlerCount;
 			
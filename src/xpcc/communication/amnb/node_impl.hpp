@@ -93,6 +93,21 @@ xpcc::amnb::ErrorHandler::call(Flags type, const uint8_t errorCode)
 	(object->*function)(type, errorCode);
 }
 
+// ----------------------------------------------------------------------------
+inline uint16_t
+xpcc::amnb::getKey(xpcc::accessor::Flash<Action> list, uint8_t index)
+{
+	return *xpcc::accessor::asFlash(&list.getPointer()[index].command);
+}
+
+inline uint16_t
+xpcc::amnb::getKey(xpcc::accessor::Flash<Listener> list, uint8_t index)
+{
+	const Listener *listener = &list.getPointer()[index];
+	return (static_cast<uint16_t>(*xpcc::accessor::asFlash(&listener->address)) << 8) |
+			*xpcc::accessor::asFlash(&listener->command);
+}
+
 // Disable warnings for Visual Studio about using 'this' in a base member
 // initializer list.
 // In this case though it is totally safe so it is ok to disable this warning.
@@ -111,7 +126,9 @@ xpcc::amnb::Node<Interface>::Node(uint8_t address,
 								  uint8_t errorHandlerCount) :
 ownAddress(address),
 actionList(actionList), actionCount(actionCount),
+actionsSorted(isSorted(actionList, actionCount)),
 listenList(listenList), listenCount(listenCount),
+listenersSorted(isSorted(listenList, listenCount)),
 errorHandlerList(errorHandlerList), errorHandlerCount(errorHandlerCount),
 response(this)
 {
@@ -127,7 +144,9 @@ xpcc::amnb::Node<Interface>::Node(uint8_t address,
 								  uint8_t listenCount) :
 ownAddress(address),
 actionList(actionList), actionCount(actionCount),
+actionsSorted(isSorted(actionList, actionCount)),
 listenList(listenList), listenCount(listenCount),
+listenersSorted(isSorted(listenList, listenCount)),
 errorHandlerCount(0),
 response(this)
 {
@@ -141,7 +160,8 @@ xpcc::amnb::Node<Interface>::Node(uint8_t address,
 								  uint8_t actionCount) :
 ownAddress(address),
 actionList(actionList), actionCount(actionCount),
-listenCount(0),
+actionsSorted(isSorted(actionList, actionCount)),
+listenCount(0), listenersSorted(false),
 errorHandlerCount(0),
 response(this)
 {
@@ -397,27 +417,23 @@ xpcc::amnb::Node<Interface>::update()
 					this->response.triggered = false;
 					this->currentCommand = messageCommand;
 					
-					xpcc::accessor::Flash<Action> list = actionList;
-					for (uint8_t i = 0; i < actionCount; ++i, ++list)
+					int16_t index = find(actionList, actionCount, actionsSorted, messageCommand);
+					if (index >= 0)
 					{
-						Action action(*list);
-						if (this->currentCommand == action.command)
+						Action action(actionList[index]);
+						if (Interface::getPayloadLength() == action.payloadLength)
 						{
-							if (Interface::getPayloadLength() == action.payloadLength)
-							{
-								// execute callback function
-								action.call(this->response, Interface::getPayload());
-								
-								if (!this->response.triggered) {
-									this->response.error(ERROR__ACTION_NO_RESPONSE);
-									checkErrorHandlers(messageAddress, messageCommand, NACK, ERROR__ACTION_NO_RESPONSE);
-								}
-							}
-							else {
-								this->response.error(ERROR__ACTION_WRONG_PAYLOAD_LENGTH);
-								checkErrorHandlers(messageAddress, messageCommand, NACK, ERROR__ACTION_WRONG_PAYLOAD_LENGTH);
+							// execute callback function
+							action.call(this->response, Interface::getPayload());
+							
+							if (!this->response.triggered) {
+								this->response.error(ERROR__ACTION_NO_RESPONSE);
+								checkErrorHandlers(messageAddress, messageCommand, NACK, ERROR__ACTION_NO_RESPONSE);
 							}
-							break;
+						}
+						else {
+							this->response.error(ERROR__ACTION_WRONG_PAYLOAD_LENGTH);
+							checkErrorHandlers(messageAddress, messageCommand, NACK, ERROR__ACTION_WRONG_PAYLOAD_LENGTH);
 						}
 					}
 				}
@@ -436,16 +452,14 @@ xpcc::amnb::Node<Interface>::update()
 		
 		if (checkListeners && (listenCount > 0))
 		{	// check if we want to listen to it
-			xpcc::accessor::Flash<Listener> list = listenList;
-			for (uint8_t i = 0; i < listenCount; ++i, ++list)
+			int16_t index = find(listenList, listenCount, listenersSorted,
+					(static_cast<uint16_t>(messageAddress) << 8) | messageCommand);
+			if (index >= 0)
 			{
-				Listener listen(*list);
-				if ((messageAddress == listen.address) && (messageCommand == listen.command))
-				{
-					// execute callback function
-					listen.call(Interface::getPayload(), Interface::getPayloadLength(), messageAddress);
-					break;
-				}
+				Listener listen(listenList[index]);
+				
+				// execute callback function
+				listen.call(Interface::getPayload(), Interface::getPayloadLength(), messageAddress);
 			}
 		}
 		// finished with the message, drop it.
@@ -480,6 +494,56 @@ xpcc::amnb::Node<Interface>::checkErrorHandlers(uint8_t address, uint8_t command
 	return false;
 }
 
+// ----------------------------------------------------------------------------
+template <typename Interface> template <typename T>
+bool
+xpcc::amnb::Node<Interface>::isSorted(xpcc::accessor::Flash<T> list, uint8_t count)
+{
+	for (uint8_t i = 1; i < count; ++i)
+	{
+		if (getKey(list, i - 1) >= getKey(list, i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename Interface> template <typename T>
+int16_t
+xpcc::amnb::Node<Interface>::find(xpcc::accessor::Flash<T> list, uint8_t count,
+								  bool sorted, uint16_t key)
+{
+	if (sorted)
+	{
+		uint8_t lower = 0;
+		uint8_t upper = count;
+		while (lower < upper)
+		{
+			uint8_t middle = lower + (upper - lower) / 2;
+			uint16_t current = getKey(list, middle);
+			if (current == key) {
+				return middle;
+			}
+			else if (current < key) {
+				lower = middle + 1;
+			}
+			else {
+				upper = middle;
+			}
+		}
+	}
+	else
+	{
+		for (uint8_t i = 0; i < count; ++i)
+		{
+			if (getKey(list, i) == key) {
+				return i;
+			}
+		}
+	}
+	return -1;
+}
+
 // ----------------------------------------------------------------------------
 template <typename Interface>
 void
@@ -0,0 +1,137 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <cstring>
+
+#include "../interface.hpp"
+
+#include "fake_bus_device.hpp"
+#include "amnb_interface_test.hpp"
+
+// send with a probability close to one
+typedef xpcc::amnb::Interface<FakeBusDevice, 99> TestingInterface;
+
+static const uint8_t frame[9] = {
+	0x54, 4, 0x12, 0x34, 0xef, 0xbe, 0xad, 0xde, 238
+};
+
+/// Call update() until the interface tried to send the message once
+static void
+updateUntilTransmitted()
+{
+	const uint8_t bytesOnBus = FakeBusDevice::bytesOnBus;
+	for (uint_fast8_t i = 0; i < 100 && FakeBusDevice::bytesOnBus == bytesOnBus; ++i)
+	{
+		xpcc::amnb::Clock::increment(10);
+		TestingInterface::update();
+	}
+}
+
+void
+AmnbInterfaceTest::setUp()
+{
+	FakeBusDevice::reset();
+	TestingInterface::initialize(0);
+}
+
+// ----------------------------------------------------------------------------
+void
+AmnbInterfaceTest::testSend()
+{
+	uint32_t data = 0xdeadbeef;
+	TEST_ASSERT_TRUE(TestingInterface::sendMessage(0x12, xpcc::amnb::BROADCAST, 0x34, data));
+	
+	updateUntilTransmitted();
+	
+	TEST_ASSERT_TRUE(TestingInterface::messageTransmitted());
+	TEST_ASSERT_EQUALS(FakeBusDevice::bytesOnBus, 9);
+	TEST_ASSERT_EQUALS_ARRAY(FakeBusDevice::busBuffer, frame, 9);
+	
+	// the echo is not received as message
+	TestingInterface::update();
+	TEST_ASSERT_FALSE(TestingInterface::isMessageAvailable());
+}
+
+void
+AmnbInterfaceTest::testCollision()
+{
+	FakeBusDevice::collisionPosition = 2;
+	
+	uint32_t data = 0xdeadbeef;
+	TEST_ASSERT_TRUE(TestingInterface::sendMessage(0x12, xpcc::amnb::BROADCAST, 0x34, data));
+	
+	updateUntilTransmitted();
+	
+	// transmission stops directly after the wrong byte
+	TEST_ASSERT_FALSE(TestingInterface::messageTransmitted());
+	TEST_ASSERT_EQUALS(FakeBusDevice::bytesOnBus, 3);
+	TEST_ASSERT_EQUALS(FakeBusDevice::getTransmitBufferSize(), 0U);
+	
+	// and is repeated later
+	updateUntilTransmitted();
+	
+	TEST_ASSERT_TRUE(TestingInterface::messageTransmitted());
+	TEST_ASSERT_EQUALS(FakeBusDevice::bytesOnBus, 3 + 9);
+	TEST_ASSERT_EQUALS_ARRAY(FakeBusDevice::busBuffer + 3, frame, 9);
+}
+
+void
+AmnbInterfaceTest::testEchoTimeout()
+{
+	FakeBusDevice::connected = false;
+	
+	uint32_t data = 0xdeadbeef;
+	TEST_ASSERT_TRUE(TestingInterface::sendMessage(0x12, xpcc::amnb::BROADCAST, 0x34, data));
+	
+	updateUntilTransmitted();
+	
+	TEST_ASSERT_FALSE(TestingInterface::messageTransmitted());
+	TEST_ASSERT_EQUALS(FakeBusDevice::bytesOnBus, 4);
+	TEST_ASSERT_EQUALS(FakeBusDevice::getTransmitBufferSize(), 0U);
+	
+	FakeBusDevice::connected = true;
+	updateUntilTransmitted();
+	
+	TEST_ASSERT_TRUE(TestingInterface::messageTransmitted());
+	TEST_ASSERT_EQUALS_ARRAY(FakeBusDevice::busBuffer + 4, frame, 9);
+}
+
+// ----------------------------------------------------------------------------
+void
+AmnbInterfaceTest::testReceiveFragmented()
+{
+	uint32_t data = 0xdeadbeef;
+	
+	for (uint8_t readSize = 1; readSize <= 16; ++readSize)
+	{
+		FakeBusDevice::reset();
+		FakeBusDevice::readSize = readSize;
+		
+		// garbage, a sync byte with an invalid length, a frame with
+		// a CRC error and a valid frame
+		const uint8_t garbage[5] = { 0x00, 0x12, 0xff, 0x54, 0xff };
+		std::memcpy(FakeBusDevice::receiveBuffer, garbage, 5);
+		std::memcpy(FakeBusDevice::receiveBuffer + 5, frame, 9);
+		FakeBusDevice::receiveBuffer[5 + 5] ^= 0x01;
+		std::memcpy(FakeBusDevice::receiveBuffer + 14, frame, 9);
+		FakeBusDevice::bytesReceived = 23;
+		
+		TestingInterface::update();
+		
+		TEST_ASSERT_TRUE(TestingInterface::isMessageAvailable());
+		TEST_ASSERT_EQUALS(TestingInterface::getAddress(), 0x12);
+		TEST_ASSERT_EQUALS(TestingInterface::getCommand(), 0x34);
+		TEST_ASSERT_EQUALS(TestingInterface::getPayloadLength(), 4);
+		TEST_ASSERT_EQUALS_ARRAY(
+				TestingInterface::getPayload(),
+				reinterpret_cast<uint8_t *>(&data),
+				4);
+		
+		TestingInterface::dropMessage();
+	}
+}
@@ -0,0 +1,31 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class AmnbInterfaceTest : public unittest::TestSuite
+{
+public:
+	virtual void
+	setUp();
+	
+	void
+	testSend();
+	
+	/// Echo differs from the transmitted byte, the rest of the frame is discarded
+	void
+	testCollision();
+	
+	/// No echo at all
+	void
+	testEchoTimeout();
+	
+	/// Frames split across several block reads, garbage and CRC errors
+	void
+	testReceiveFragmented();
+};
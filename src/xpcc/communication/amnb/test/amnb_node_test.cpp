@@ -0,0 +1,324 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <cstring>
+
+#include "../node.hpp"
+
+#include "fake_bus_device.hpp"
+#include "amnb_node_test.hpp"
+
+typedef xpcc::amnb::Interface<FakeBusDevice, 99> TestingInterface;
+
+/// Makes the lookup functions accessible
+class TestingNode : public xpcc::amnb::Node<TestingInterface>
+{
+public:
+	TestingNode(uint8_t address,
+			xpcc::accessor::Flash<xpcc::amnb::Action> actionList, uint8_t actionCount,
+			xpcc::accessor::Flash<xpcc::amnb::Listener> listenList, uint8_t listenCount) :
+		xpcc::amnb::Node<TestingInterface>(address,
+				actionList, actionCount, listenList, listenCount)
+	{
+	}
+	
+	using xpcc::amnb::Node<TestingInterface>::isSorted;
+	using xpcc::amnb::Node<TestingInterface>::find;
+	
+	bool
+	areActionsSorted() const
+	{
+		return actionsSorted;
+	}
+	
+	bool
+	areListenersSorted() const
+	{
+		return listenersSorted;
+	}
+};
+
+class TestingObject : public xpcc::amnb::Callable
+{
+public:
+	void
+	actionA(xpcc::amnb::Response& response, const void *)
+	{
+		lastCall = 'a';
+		response.send();
+	}
+	
+	void
+	actionB(xpcc::amnb::Response& response, const void *)
+	{
+		lastCall = 'b';
+		response.send();
+	}
+	
+	void
+	actionC(xpcc::amnb::Response& response, const void *)
+	{
+		lastCall = 'c';
+		response.send();
+	}
+	
+	void
+	listenA(const void *, const uint8_t, const uint8_t sender)
+	{
+		lastCall = 'A';
+		lastSender = sender;
+	}
+	
+	void
+	listenB(const void *, const uint8_t, const uint8_t sender)
+	{
+		lastCall = 'B';
+		lastSender = sender;
+	}
+	
+	char lastCall;
+	uint8_t lastSender;
+};
+
+static TestingObject object;
+
+static xpcc::amnb::Action sortedActions[] =
+{
+	AMNB__ACTION(0x01, object, TestingObject::actionA, 0),
+	AMNB__ACTION(0x05, object, TestingObject::actionB, 0),
+	AMNB__ACTION(0x10, object, TestingObject::actionA, 0),
+	AMNB__ACTION(0x11, object, TestingObject::actionB, 0),
+	AMNB__ACTION(0x20, object, TestingObject::actionA, 0),
+	AMNB__ACTION(0x7f, object, TestingObject::actionB, 0),
+	AMNB__ACTION(0xfe, object, TestingObject::actionC, 0),
+};
+
+static xpcc::amnb::Action unsortedActions[] =
+{
+	AMNB__ACTION(0x20, object, TestingObject::actionA, 0),
+	AMNB__ACTION(0x05, object, TestingObject::actionB, 0),
+	AMNB__ACTION(0xfe, object, TestingObject::actionA, 0),
+	AMNB__ACTION(0x01, object, TestingObject::actionB, 0),
+	AMNB__ACTION(0x11, object, TestingObject::actionC, 0),
+};
+
+static xpcc::amnb::Action duplicateActions[] =
+{
+	AMNB__ACTION(0x01, object, TestingObject::actionA, 0),
+	AMNB__ACTION(0x05, object, TestingObject::actionB, 0),
+	AMNB__ACTION(0x05, object, TestingObject::actionC, 0),
+};
+
+// sorted by address first, the command of the second entry is smaller
+static xpcc::amnb::Listener sortedListeners[] =
+{
+	AMNB__LISTEN(0x10, 0x05, object, TestingObject::listenA),
+	AMNB__LISTEN(0x11, 0x01, object, TestingObject::listenB),
+	AMNB__LISTEN(0x11, 0x05, object, TestingObject::listenA),
+	AMNB__LISTEN(0x3f, 0xff, object, TestingObject::listenB),
+};
+
+static xpcc::amnb::Listener unsortedListeners[] =
+{
+	AMNB__LISTEN(0x11, 0x01, object, TestingObject::listenB),
+	AMNB__LISTEN(0x10, 0x05, object, TestingObject::listenA),
+};
+
+#define ACTIONS(list)	xpcc::accessor::asFlash(list), sizeof(list) / sizeof(xpcc::amnb::Action)
+#define LISTENERS(list)	xpcc::accessor::asFlash(list), sizeof(list) / sizeof(xpcc::amnb::Listener)
+
+/// Put a complete frame into the receive buffer of the device
+static void
+receiveFrame(uint8_t address, xpcc::amnb::Flags flags, uint8_t command)
+{
+	uint8_t *frame = FakeBusDevice::receiveBuffer + FakeBusDevice::bytesReceived;
+	frame[0] = xpcc::amnb::syncByte;
+	frame[1] = 0;
+	frame[2] = address | flags;
+	frame[3] = command;
+	frame[4] = xpcc::amnb::crcUpdate(xpcc::amnb::crcInitialValue, frame + 1, 3);
+	FakeBusDevice::bytesReceived += 5;
+}
+
+/// Call update() until the node sent its response
+static void
+updateUntilTransmitted(TestingNode& node)
+{
+	for (uint_fast8_t i = 0; i < 100 && FakeBusDevice::bytesOnBus == 0; ++i)
+	{
+		xpcc::amnb::Clock::increment(10);
+		node.update();
+	}
+}
+
+void
+AmnbNodeTest::setUp()
+{
+	FakeBusDevice::reset();
+	object.lastCall = 0;
+	object.lastSender = 0;
+}
+
+// ----------------------------------------------------------------------------
+void
+AmnbNodeTest::testIsSorted()
+{
+	TEST_ASSERT_TRUE(TestingNode::isSorted(xpcc::accessor::asFlash(sortedActions), 0));
+	TEST_ASSERT_TRUE(TestingNode::isSorted(xpcc::accessor::asFlash(unsortedActions), 1));
+	
+	TEST_ASSERT_TRUE(TestingNode::isSorted(ACTIONS(sortedActions)));
+	TEST_ASSERT_FALSE(TestingNode::isSorted(ACTIONS(unsortedActions)));
+	TEST_ASSERT_FALSE(TestingNode::isSorted(ACTIONS(duplicateActions)));
+	
+	TEST_ASSERT_TRUE(TestingNode::isSorted(LISTENERS(sortedListeners)));
+	TEST_ASSERT_FALSE(TestingNode::isSorted(LISTENERS(unsortedListeners)));
+	
+	TestingNode sorted(0x02, ACTIONS(sortedActions), LISTENERS(sortedListeners));
+	TEST_ASSERT_TRUE(sorted.areActionsSorted());
+	TEST_ASSERT_TRUE(sorted.areListenersSorted());
+	
+	TestingNode unsorted(0x02, ACTIONS(unsortedActions), LISTENERS(unsortedListeners));
+	TEST_ASSERT_FALSE(unsorted.areActionsSorted());
+	TEST_ASSERT_FALSE(unsorted.areListenersSorted());
+}
+
+void
+AmnbNodeTest::testFindSorted()
+{
+	xpcc::accessor::Flash<xpcc::amnb::Action> list = xpcc::accessor::asFlash(sortedActions);
+	const uint8_t count = sizeof(sortedActions) / sizeof(xpcc::amnb::Action);
+	
+	for (uint8_t i = 0; i < count; ++i) {
+		TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, sortedActions[i].command), i);
+	}
+	
+	// before the first, between two and after the last entry
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x00), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x06), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x80), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0xff), -1);
+	
+	TEST_ASSERT_EQUALS(TestingNode::find(list, 0, true, 0x01), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, 1, true, 0x01), 0);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, 1, true, 0x05), -1);
+}
+
+void
+AmnbNodeTest::testFindUnsorted()
+{
+	xpcc::accessor::Flash<xpcc::amnb::Action> list = xpcc::accessor::asFlash(unsortedActions);
+	const uint8_t count = sizeof(unsortedActions) / sizeof(xpcc::amnb::Action);
+	
+	for (uint8_t i = 0; i < count; ++i) {
+		TEST_ASSERT_EQUALS(TestingNode::find(list, count, false, unsortedActions[i].command), i);
+	}
+	
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, false, 0x00), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, false, 0x10), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, false, 0xff), -1);
+}
+
+void
+AmnbNodeTest::testFindListener()
+{
+	xpcc::accessor::Flash<xpcc::amnb::Listener> list = xpcc::accessor::asFlash(sortedListeners);
+	const uint8_t count = sizeof(sortedListeners) / sizeof(xpcc::amnb::Listener);
+	
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x1005), 0);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x1101), 1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x1105), 2);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x3fff), 3);
+	
+	// same command but from another node
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x1001), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x1205), -1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, count, true, 0x0005), -1);
+	
+	list = xpcc::accessor::asFlash(unsortedListeners);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, 2, false, 0x1101), 0);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, 2, false, 0x1005), 1);
+	TEST_ASSERT_EQUALS(TestingNode::find(list, 2, false, 0x1105), -1);
+}
+
+// ----------------------------------------------------------------------------
+void
+AmnbNodeTest::testAction()
+{
+	TestingNode sorted(0x02, ACTIONS(sortedActions), LISTENERS(sortedListeners));
+	
+	// last entry of the list
+	receiveFrame(0x02, xpcc::amnb::REQUEST, 0xfe);
+	updateUntilTransmitted(sorted);
+	
+	TEST_ASSERT_EQUALS(object.lastCall, 'c');
+	TEST_ASSERT_EQUALS(FakeBusDevice::bytesOnBus, 5);
+	TEST_ASSERT_EQUALS(FakeBusDevice::busBuffer[2], 0x02 | xpcc::amnb::ACK);
+	TEST_ASSERT_EQUALS(FakeBusDevice::busBuffer[3], 0xfe);
+	
+	// requests for other nodes are ignored
+	FakeBusDevice::reset();
+	object.lastCall = 0;
+	receiveFrame(0x03, xpcc::amnb::REQUEST, 0x01);
+	sorted.update();
+	TEST_ASSERT_EQUALS(object.lastCall, 0);
+	
+	FakeBusDevice::reset();
+	TestingNode unsorted(0x02, ACTIONS(unsortedActions), LISTENERS(unsortedListeners));
+	
+	receiveFrame(0x02, xpcc::amnb::REQUEST, 0x11);
+	updateUntilTransmitted(unsorted);
+	
+	TEST_ASSERT_EQUALS(object.lastCall, 'c');
+	TEST_ASSERT_EQUALS(FakeBusDevice::busBuffer[2], 0x02 | xpcc::amnb::ACK);
+	TEST_ASSERT_EQUALS(FakeBusDevice::busBuffer[3], 0x11);
+}
+
+void
+AmnbNodeTest::testActionMissing()
+{
+	TestingNode sorted(0x02, ACTIONS(sortedActions), LISTENERS(sortedListeners));
+	
+	receiveFrame(0x02, xpcc::amnb::REQUEST, 0x06);
+	updateUntilTransmitted(sorted);
+	
+	TEST_ASSERT_EQUALS(object.lastCall, 0);
+	TEST_ASSERT_EQUALS(FakeBusDevice::bytesOnBus, 6);
+	TEST_ASSERT_EQUALS(FakeBusDevice::busBuffer[2], 0x02 | xpcc::amnb::NACK);
+	TEST_ASSERT_EQUALS(FakeBusDevice::busBuffer[3], 0x06);
+	TEST_ASSERT_EQUALS(FakeBusDevice::busBuffer[4], xpcc::amnb::ERROR__ACTION_NO_ACTION);
+}
+
+void
+AmnbNodeTest::testListener()
+{
+	TestingNode sorted(0x02, ACTIONS(sortedActions), LISTENERS(sortedListeners));
+	
+	receiveFrame(0x11, xpcc::amnb::BROADCAST, 0x01);
+	sorted.update();
+	TEST_ASSERT_EQUALS(object.lastCall, 'B');
+	TEST_ASSERT_EQUALS(object.lastSender, 0x11);
+	
+	object.lastCall = 0;
+	receiveFrame(0x3f, xpcc::amnb::BROADCAST, 0xff);
+	sorted.update();
+	TEST_ASSERT_EQUALS(object.lastCall, 'B');
+	TEST_ASSERT_EQUALS(object.lastSender, 0x3f);
+	
+	// known command from an unknown sender
+	object.lastCall = 0;
+	receiveFrame(0x12, xpcc::amnb::BROADCAST, 0x01);
+	sorted.update();
+	TEST_ASSERT_EQUALS(object.lastCall, 0);
+	
+	TestingNode unsorted(0x02, ACTIONS(unsortedActions), LISTENERS(unsortedListeners));
+	
+	receiveFrame(0x10, xpcc::amnb::BROADCAST, 0x05);
+	unsorted.update();
+	TEST_ASSERT_EQUALS(object.lastCall, 'A');
+	TEST_ASSERT_EQUALS(object.lastSender, 0x10);
+}
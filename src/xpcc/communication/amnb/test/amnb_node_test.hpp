@@ -0,0 +1,42 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class AmnbNodeTest : public unittest::TestSuite
+{
+public:
+	virtual void
+	setUp();
+	
+	void
+	testIsSorted();
+	
+	/// Binary search for the first, last and missing entries
+	void
+	testFindSorted();
+	
+	/// Linear fallback for unsorted lists
+	void
+	testFindUnsorted();
+	
+	/// Listener keys are made of address and command
+	void
+	testFindListener();
+	
+	/// Requests are dispatched to the matching action
+	void
+	testAction();
+	
+	void
+	testActionMissing();
+	
+	/// Broadcasts are dispatched to the matching listener
+	void
+	testListener();
+};
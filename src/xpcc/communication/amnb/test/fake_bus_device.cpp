@@ -0,0 +1,122 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <cstring>
+#include "fake_bus_device.hpp"
+
+uint8_t FakeBusDevice::transmitBuffer[128];
+uint8_t FakeBusDevice::transmitPosition = 0;
+uint8_t FakeBusDevice::bytesToTransmit = 0;
+
+uint8_t FakeBusDevice::busBuffer[128];
+uint8_t FakeBusDevice::bytesOnBus = 0;
+
+uint8_t FakeBusDevice::receiveBuffer[128];
+uint8_t FakeBusDevice::receivePosition = 0;
+uint8_t FakeBusDevice::bytesReceived = 0;
+
+uint8_t FakeBusDevice::readSize = 128;
+int16_t FakeBusDevice::collisionPosition = -1;
+bool FakeBusDevice::connected = true;
+
+std::size_t
+FakeBusDevice::write(const uint8_t *data, std::size_t length)
+{
+	if (length > sizeof(transmitBuffer) - bytesToTransmit) {
+		length = sizeof(transmitBuffer) - bytesToTransmit;
+	}
+	std::memcpy(transmitBuffer + bytesToTransmit, data, length);
+	bytesToTransmit += length;
+	return length;
+}
+
+std::size_t
+FakeBusDevice::read(uint8_t *data, std::size_t length)
+{
+	if (receivePosition >= bytesReceived) {
+		receivePosition = 0;
+		bytesReceived = 0;
+	}
+	
+	// shift out the next byte and receive it again
+	if (transmitPosition < bytesToTransmit)
+	{
+		uint8_t byte = transmitBuffer[transmitPosition++];
+		if (bytesOnBus == collisionPosition) {
+			byte ^= 0xff;
+		}
+		busBuffer[bytesOnBus++] = byte;
+		if (connected) {
+			receiveBuffer[bytesReceived++] = byte;
+		}
+		
+		if (transmitPosition == bytesToTransmit) {
+			transmitPosition = 0;
+			bytesToTransmit = 0;
+		}
+	}
+	
+	std::size_t available = bytesReceived - receivePosition;
+	if (length > available) {
+		length = available;
+	}
+	if (length > readSize) {
+		length = readSize;
+	}
+	std::memcpy(data, receiveBuffer + receivePosition, length);
+	receivePosition += length;
+	return length;
+}
+
+uint8_t
+FakeBusDevice::readErrorFlags()
+{
+	return 0;
+}
+
+void
+FakeBusDevice::resetErrorFlags()
+{
+}
+
+std::size_t
+FakeBusDevice::flushReceiveBuffer()
+{
+	std::size_t size = bytesReceived - receivePosition;
+	receivePosition = 0;
+	bytesReceived = 0;
+	return size;
+}
+
+std::size_t
+FakeBusDevice::discardTransmitBuffer()
+{
+	std::size_t size = getTransmitBufferSize();
+	transmitPosition = 0;
+	bytesToTransmit = 0;
+	return size;
+}
+
+std::size_t
+FakeBusDevice::getTransmitBufferSize()
+{
+	return bytesToTransmit - transmitPosition;
+}
+
+void
+FakeBusDevice::reset()
+{
+	transmitPosition = 0;
+	bytesToTransmit = 0;
+	bytesOnBus = 0;
+	receivePosition = 0;
+	bytesReceived = 0;
+	readSize = 128;
+	collisionPosition = -1;
+	connected = true;
+}
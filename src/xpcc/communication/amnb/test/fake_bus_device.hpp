@@ -0,0 +1,72 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef FAKE_BUS_DEVICE_HPP
+#define FAKE_BUS_DEVICE_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * UART connected to a shared bus, every transmitted byte is received
+ * again.
+ * 
+ * The transmit buffer is shifted out one byte per call of read(), like
+ * a real UART which is polled faster than its baudrate.
+ */
+class FakeBusDevice
+{
+public:
+	static std::size_t
+	write(const uint8_t *data, std::size_t length);
+	
+	static std::size_t
+	read(uint8_t *data, std::size_t length);
+	
+	static uint8_t
+	readErrorFlags();
+	
+	static void
+	resetErrorFlags();
+	
+	static std::size_t
+	flushReceiveBuffer();
+	
+	static std::size_t
+	discardTransmitBuffer();
+	
+	static void
+	reset();
+	
+	/// Bytes handed over by write() but not yet on the bus
+	static std::size_t
+	getTransmitBufferSize();
+	
+	static uint8_t transmitBuffer[128];
+	static uint8_t transmitPosition;
+	static uint8_t bytesToTransmit;
+	
+	/// Everything which was actually driven onto the bus
+	static uint8_t busBuffer[128];
+	static uint8_t bytesOnBus;
+	
+	static uint8_t receiveBuffer[128];
+	static uint8_t receivePosition;
+	static uint8_t bytesReceived;
+	
+	/// Maximum number of bytes returned by a single block read
+	static uint8_t readSize;
+	
+	/// Another node overwrites the byte with this index on the bus
+	static int16_t collisionPosition;
+	
+	/// Without a bus transmitted bytes are not received again
+	static bool connected;
+};
+
+#endif	// FAKE_BUS_DEVICE_HPP
@@ -53,6 +53,14 @@ namespace xpcc
 		uint16_t
 		crcUpdate(uint16_t crc, uint8_t data);
 		
+		/**
+		 * \internal
+		 * \brief	Add a block of data to the checksum
+		 * \ingroup	token
+		 */
+		uint16_t
+		crcUpdate(uint16_t crc, const uint8_t *data, std::size_t length);
+		
 		/**
 		 * \brief	Token Ring interface
 		 *
@@ -110,6 +118,11 @@ namespace xpcc
 			 * \brief	Update internal status
 			 * 
 			 * Has to be called periodically. Encodes received messages.
+			 * 
+			 * The received bytes are fetched from the device in blocks
+			 * with `Device::read(uint8_t *, std::size_t)`. Forwarded and
+			 * transmitted bytes are collected and handed to the device
+			 * with `Device::write(const uint8_t *, std::size_t)`.
 			 */
 			static void
 			update();
@@ -117,9 +130,20 @@ namespace xpcc
 		private:
 			typedef xpcc::BoundedQueue< Message, 10 > Queue;
 			
+			static void
+			receiveByte(uint8_t data);
+			
+			/// Append a byte to the transmit buffer
+			static void
+			writeByte(uint8_t data);
+			
 			static void
 			writeByteEscaped(uint8_t data);
 			
+			/// Hand the transmit buffer to the device
+			static void
+			flush();
+			
 			static void
 			writeMessage(Message *message);
 			
@@ -154,6 +178,9 @@ namespace xpcc
 			
 			static uint8_t addressBuffer;
 			
+			static uint8_t output[32];
+			static uint8_t outputLength;
+			
 			enum Status
 			{
 				STATUS_START_DELIMITER_RECEIVED = 0x80,
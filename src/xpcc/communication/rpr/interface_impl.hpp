@@ -89,6 +89,15 @@ uint8_t xpcc::rpr::Interface<Device, N>::addressBuffer = 0;
 template <typename Device, std::size_t N>
 uint8_t xpcc::rpr::Interface<Device, N>::status = 0;
 
+template <typename Device, std::size_t N>
+xpcc::allocator::Dynamic<uint8_t> xpcc::rpr::Interface<Device, N>::bufferAllocator;
+
+template <typename Device, std::size_t N>
+uint8_t xpcc::rpr::Interface<Device, N>::output[32];
+
+template <typename Device, std::size_t N>
+uint8_t xpcc::rpr::Interface<Device, N>::outputLength = 0;
+
 // ----------------------------------------------------------------------------
 template <typename Device, std::size_t N>
 void
@@ -164,215 +173,228 @@ template <typename Device, std::size_t N>
 void
 xpcc::rpr::Interface<Device, N>::update()
 {
-	uint8_t data;
-	
 	if (status & STATUS_END_DELIMITER_RECEIVED && !messagesToSend.isEmpty())
 	{
 		writeMessage(getMessage(messagesToSend));
 		popMessage(messagesToSend);
 	}
 	
-	while (Device::read(data))
+	uint8_t chunk[16];
+	std::size_t count;
+	while ((count = Device::read(chunk, sizeof(chunk))) > 0)
+	{
+		for (std::size_t i = 0; i < count; ++i) {
+			receiveByte(chunk[i]);
+		}
+		// forward everything of this block at once
+		flush();
+	}
+}
+
+template <typename Device, std::size_t N>
+void
+xpcc::rpr::Interface<Device, N>::receiveByte(uint8_t data)
+{
+	XPCC_RPR_LOG("receiving raw " << xpcc::hex << data << xpcc::ascii);
+	
+	if (data == startDelimiterByte)
 	{
-		XPCC_RPR_LOG("receiving raw " << xpcc::hex << data << xpcc::ascii);
+		status &= ~STATUS_END_DELIMITER_RECEIVED;
+		status |= STATUS_START_DELIMITER_RECEIVED;
+
+		XPCC_RPR_LOG("start delimiter");
+		
+		crc = crcInitialValue;
+		length = 0;
+		nextEscaped = false;
 		
-		if (data == startDelimiterByte)
+		// we do not send the frame boundaries here, but wait for the AC.
+	}
+	else if (data == endDelimiterByte)
+	{
+		if (length >= 6 && (status & STATUS_START_DELIMITER_RECEIVED))
 		{
-			status &= ~STATUS_END_DELIMITER_RECEIVED;
-			status |= STATUS_START_DELIMITER_RECEIVED;
-
-			XPCC_RPR_LOG("start delimiter");
+			status &= ~STATUS_START_DELIMITER_RECEIVED;
+			status |= STATUS_END_DELIMITER_RECEIVED;
 			
-			crc = crcInitialValue;
-			length = 0;
-			nextEscaped = false;
+			if (!(status & STATUS_SOURCE_RECOGNISED) && (receiveBuffer.type != MESSAGE_TYPE_UNICAST))
+			{
+				XPCC_RPR_LOG("tx: forwarding endDelimiterByte");
+				writeByte(endDelimiterByte);
+			}
+			XPCC_RPR_LOG("end delimiter with length=" << length);
 			
-			// we do not send the frame boundaries here, but wait for the AC.
-		}
-		else if (data == endDelimiterByte)
-		{
-			if (length >= 6 && (status & STATUS_START_DELIMITER_RECEIVED))
+			if (status & STATUS_DESTINATION_RECOGNISED)
 			{
-				status &= ~STATUS_START_DELIMITER_RECEIVED;
-				status |= STATUS_END_DELIMITER_RECEIVED;
-				
-				if (!(status & STATUS_SOURCE_RECOGNISED) && (receiveBuffer.type != MESSAGE_TYPE_UNICAST))
-				{
-					XPCC_RPR_LOG("tx: forwarding endDelimiterByte");
-					Device::write(endDelimiterByte);
-				}
-				XPCC_RPR_LOG("end delimiter with length=" << length);
-				
-				if (status & STATUS_DESTINATION_RECOGNISED)
+				if (crc == 0)
 				{
-					if (crc == 0)
+					XPCC_RPR_LOG("crc check success");
+					// the checksum was buffered as well
+					receiveBuffer.length -= 2;
+					if (receiveBuffer.length >= 1)
 					{
-						XPCC_RPR_LOG("crc check success");
-						if (receiveBuffer.length > 1)
-						{
-							receiveBuffer.command = receiveBuffer.payload[0];
-							receiveBuffer.payload += 1;
-							receiveBuffer.length -= 1;
-						}
-						pushMessage(receivedMessages, &receiveBuffer);
-						receiveBuffer.payload = rx_buffer;
-					}
-					else {
-						XPCC_RPR_LOG("crc check failure");
+						receiveBuffer.command = receiveBuffer.payload[0];
+						receiveBuffer.payload += 1;
+						receiveBuffer.length -= 1;
 					}
+					pushMessage(receivedMessages, &receiveBuffer);
+					receiveBuffer.payload = rx_buffer;
+				}
+				else {
+					XPCC_RPR_LOG("crc check failure");
 				}
 			}
-			crc = crcInitialValue;
-			length = 0;
-			nextEscaped = false;
 		}
-		else if (data == controlEscapeByte)
+		crc = crcInitialValue;
+		length = 0;
+		nextEscaped = false;
+	}
+	else if (data == controlEscapeByte)
+	{
+		// the next byte is escaped
+		nextEscaped = true;
+		XPCC_RPR_LOG("escape sequence");
+		return;
+	}
+	else
+	{
+		if (nextEscaped)
 		{
-			// the next byte is escaped
-			nextEscaped = true;
-			XPCC_RPR_LOG("escape sequence");
-			continue;
+			nextEscaped = false;
+			// toggle bit 5
+			data = data ^ 0x20;
+			XPCC_RPR_LOG("data escaped");
 		}
-		else
+		// all data is now escaped
+		
+		// make sure we actually received a start delimiter before the payload
+		if (!(status & STATUS_START_DELIMITER_RECEIVED))
+			return;
+		
+		switch (length++)
 		{
-			if (nextEscaped)
-			{
-				nextEscaped = false;
-				// toggle bit 5
-				data = data ^ 0x20;
-				XPCC_RPR_LOG("data escaped");
-			}
-			// all data is now escaped
-			
-			// make sure we actually received a start delimiter before the payload
-			if (!(status & STATUS_START_DELIMITER_RECEIVED))
-				return;
-			
-			switch (length++)
+			// LSB of destination address
+			case 0:
+				XPCC_RPR_LOG("rx: LSB dest");
+				addressBuffer = data;
+				break;
+				
+				// MSB of destination address
+			case 1:
 			{
-				// LSB of destination address
-				case 0:
-					XPCC_RPR_LOG("rx: LSB dest");
-					addressBuffer = data;
-					break;
-					
-					// MSB of destination address
-				case 1:
+				XPCC_RPR_LOG("rx: MSB dest");
+				// check the destination address against our own
+				uint16_t dest = (data << 8) | addressBuffer;
+				status &= ~(STATUS_DESTINATION_RECOGNISED | STATUS_RX_BUFFER_OVERFLOW | STATUS_SOURCE_RECOGNISED);
+				receiveBuffer.type = MESSAGE_TYPE_ANY;
+				receiveBuffer.destination = dest;
+				receiveBuffer.length = 0;
+				
+				// it is a broadcast, we need to listen
+				if (receiveBuffer.destination == ADDRESS_BROADCAST)
 				{
-					XPCC_RPR_LOG("rx: MSB dest");
-					// check the destination address against our own
-					uint16_t dest = (data << 8) | addressBuffer;
-					status &= ~(STATUS_DESTINATION_RECOGNISED | STATUS_RX_BUFFER_OVERFLOW | STATUS_SOURCE_RECOGNISED);
-					receiveBuffer.type = MESSAGE_TYPE_ANY;
-					receiveBuffer.destination = dest;
-					receiveBuffer.length = 0;
-					
-					// it is a broadcast, we need to listen
-					if (receiveBuffer.destination == ADDRESS_BROADCAST)
-					{
-						XPCC_RPR_LOG("rx: broadcast");
-						receiveBuffer.type = MESSAGE_TYPE_BROADCAST;
-						status |= STATUS_DESTINATION_RECOGNISED;
-					}
-					else
+					XPCC_RPR_LOG("rx: broadcast");
+					receiveBuffer.type = MESSAGE_TYPE_BROADCAST;
+					status |= STATUS_DESTINATION_RECOGNISED;
+				}
+				else
+				{
+					if (receiveBuffer.destination & ADDRESS_INDIVIDUAL_GROUP)
 					{
-						if (receiveBuffer.destination & ADDRESS_INDIVIDUAL_GROUP)
+						// group address
+						if (_groupAddress == (receiveBuffer.destination & ADDRESS_VALUE))
 						{
-							// group address
-							if (_groupAddress == (receiveBuffer.destination & ADDRESS_VALUE))
-							{
-								XPCC_RPR_LOG("rx: my group");
-								receiveBuffer.type = MESSAGE_TYPE_MULTICAST;
-								status |= STATUS_DESTINATION_RECOGNISED;
-							}
-						}
-						else {
-							// individual address
-							if (_address == (receiveBuffer.destination & ADDRESS_VALUE))
-							{
-								XPCC_RPR_LOG("rx: my address");
-								receiveBuffer.type = MESSAGE_TYPE_UNICAST;
-								status |= STATUS_DESTINATION_RECOGNISED;
-							}
+							XPCC_RPR_LOG("rx: my group");
+							receiveBuffer.type = MESSAGE_TYPE_MULTICAST;
+							status |= STATUS_DESTINATION_RECOGNISED;
 						}
 					}
-					
-					if (status & STATUS_DESTINATION_RECOGNISED)
-					{
-						crc = crcUpdate(crc, addressBuffer);
-						crc = crcUpdate(crc, data);
+					else {
+						// individual address
+						if (_address == (receiveBuffer.destination & ADDRESS_VALUE))
+						{
+							XPCC_RPR_LOG("rx: my address");
+							receiveBuffer.type = MESSAGE_TYPE_UNICAST;
+							status |= STATUS_DESTINATION_RECOGNISED;
+						}
 					}
 				}
-					break;
-					
-					// LSB of source address
-				case 2:
-					XPCC_RPR_LOG("rx: LSB source");
-					addressBuffer = data;
-					break;
-					
-					// MSB of Source Address
-				case 3:
+				
+				if (status & STATUS_DESTINATION_RECOGNISED)
 				{
-					XPCC_RPR_LOG("rx: MSB source");
-					// check the source address against our own
-					uint16_t source = (data << 8) | addressBuffer;
-					receiveBuffer.source = (source & ADDRESS_VALUE);
-					
-					if (_address == receiveBuffer.source)
-					{
-						status |= STATUS_SOURCE_RECOGNISED;
-					}
+					crc = crcUpdate(crc, addressBuffer);
+					crc = crcUpdate(crc, data);
+				}
+			}
+				break;
+				
+				// LSB of source address
+			case 2:
+				XPCC_RPR_LOG("rx: LSB source");
+				addressBuffer = data;
+				break;
+				
+				// MSB of Source Address
+			case 3:
+			{
+				XPCC_RPR_LOG("rx: MSB source");
+				// check the source address against our own
+				uint16_t source = (data << 8) | addressBuffer;
+				receiveBuffer.source = (source & ADDRESS_VALUE);
+				
+				if (_address == receiveBuffer.source)
+				{
+					status |= STATUS_SOURCE_RECOGNISED;
+				}
+				
+				if (status & STATUS_DESTINATION_RECOGNISED)
+				{
+					crc = crcUpdate(crc, addressBuffer);
+					crc = crcUpdate(crc, data);
+				}
+				
+				if (!(status & STATUS_SOURCE_RECOGNISED) && (receiveBuffer.type != MESSAGE_TYPE_UNICAST))
+				{
+					XPCC_RPR_LOG("tx: forwarding destination");
+					writeByte(startDelimiterByte);
+					writeByteEscaped(receiveBuffer.destination);
+					writeByteEscaped(receiveBuffer.destination >> 8);
 					
-					if (status & STATUS_DESTINATION_RECOGNISED)
+					XPCC_RPR_LOG("tx: forwarding source");
+					writeByteEscaped(addressBuffer);
+					writeByteEscaped(data);
+				}
+				else {
+					XPCC_RPR_LOG("rx: no forwarding");
+				}
+
+			}
+				break;
+				
+			default:
+				if (status & STATUS_DESTINATION_RECOGNISED)
+				{
+					if (length <= N+8)
 					{
-						crc = crcUpdate(crc, addressBuffer);
+						XPCC_RPR_LOG("rx: buffering payload");
+						receiveBuffer.payload[length-5] = data;
+						receiveBuffer.length++;
 						crc = crcUpdate(crc, data);
 					}
-					
-					if (!(status & STATUS_SOURCE_RECOGNISED) && (receiveBuffer.type != MESSAGE_TYPE_UNICAST))
-					{
-						XPCC_RPR_LOG("tx: forwarding destination");
-						Device::write(startDelimiterByte);
-						writeByteEscaped(receiveBuffer.destination);
-						writeByteEscaped(receiveBuffer.destination >> 8);
-						
-						XPCC_RPR_LOG("tx: forwarding source");
-						writeByteEscaped(addressBuffer);
-						writeByteEscaped(data);
-					}
 					else {
-						XPCC_RPR_LOG("rx: no forwarding");
+						// really, really bad programmer !
+						// now go sit in the corner and increase dat payload buffer
+						status |= STATUS_RX_BUFFER_OVERFLOW;
+						XPCC_RPR_LOG("rx: buffer overflow!!!");
 					}
-
 				}
-					break;
-					
-				default:
-					if (status & STATUS_DESTINATION_RECOGNISED)
-					{
-						if (length <= N+8)
-						{
-							XPCC_RPR_LOG("rx: buffering payload");
-							receiveBuffer.payload[length-5] = data;
-							receiveBuffer.length++;
-							crc = crcUpdate(crc, data);
-						}
-						else {
-							// really, really bad programmer !
-							// now go sit in the corner and increase dat payload buffer
-							status |= STATUS_RX_BUFFER_OVERFLOW;
-							XPCC_RPR_LOG("rx: buffer overflow!!!");
-						}
-					}
-					
-					if (!(status & STATUS_SOURCE_RECOGNISED) && (receiveBuffer.type != MESSAGE_TYPE_UNICAST))
-					{
-						XPCC_RPR_LOG("forwarding payload");
-						writeByteEscaped(data);
-					}
-					break;
-			}
+				
+				if (!(status & STATUS_SOURCE_RECOGNISED) && (receiveBuffer.type != MESSAGE_TYPE_UNICAST))
+				{
+					XPCC_RPR_LOG("forwarding payload");
+					writeByteEscaped(data);
+				}
+				break;
 		}
 	}
 }
@@ -386,13 +408,13 @@ xpcc::rpr::Interface<Device, N>::writeByteEscaped(uint8_t data)
 	{
 		XPCC_RPR_LOG("tx: " << xpcc::hex << controlEscapeByte << xpcc::ascii);
 		XPCC_RPR_LOG("tx: " << xpcc::hex << (data ^ 0x20) << xpcc::ascii);
-		Device::write(controlEscapeByte);
-		Device::write(data ^ 0x20);		// toggle bit 5
+		writeByte(controlEscapeByte);
+		writeByte(data ^ 0x20);		// toggle bit 5
 	}
 	else
 	{
 		XPCC_RPR_LOG("tx: " << xpcc::hex << data << xpcc::ascii);
-		Device::write(data);
+		writeByte(data);
 	}
 }
 
@@ -403,7 +425,7 @@ xpcc::rpr::Interface<Device, N>::writeMessage(Message *message)
 	uint16_t crc = crcInitialValue;
 	
 	// Start Delimiter
-	Device::write(startDelimiterByte);
+	writeByte(startDelimiterByte);
 	
 	// HEADER
 	uint16_t destination = message->destination;
@@ -449,11 +471,32 @@ xpcc::rpr::Interface<Device, N>::writeMessage(Message *message)
 	writeByteEscaped(crc >> 8);
 	
 	// End Delimiter
-	Device::write(endDelimiterByte);
+	writeByte(endDelimiterByte);
+	flush();
 	
 	popMessage(messagesToSend);
 }
 
+template <typename Device, std::size_t N>
+void
+xpcc::rpr::Interface<Device, N>::writeByte(uint8_t data)
+{
+	if (outputLength >= sizeof(output)) {
+		flush();
+	}
+	output[outputLength++] = data;
+}
+
+template <typename Device, std::size_t N>
+void
+xpcc::rpr::Interface<Device, N>::flush()
+{
+	if (outputLength > 0) {
+		Device::write(output, outputLength);
+		outputLength = 0;
+	}
+}
+
 // ----------------------------------------------------------------------------
 template <typename Device, std::size_t N>
 bool
@@ -0,0 +1,182 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <cstring>
+
+#include "../interface.hpp"
+
+#include "../../sab/test/fake_io_device.hpp"
+#include "rpr_interface_test.hpp"
+
+typedef xpcc::rpr::Interface<FakeIODevice> TestingInterface;
+
+static const uint16_t ownAddress = 0x10;
+
+// contains all three control bytes
+static uint8_t payload[4] = { 0x7e, 0x7c, 0x7d, 0x01 };
+
+/// Create a frame sent by another node, \return its length
+static uint8_t
+createFrame(uint8_t *frame, uint16_t source, uint16_t destination,
+		xpcc::rpr::MessageType type, uint8_t command = 0x34)
+{
+	FakeIODevice::reset();
+	TestingInterface::initialize(source);
+	TestingInterface::sendMessage(destination, type, command, payload, 4);
+	TestingInterface::initialize(ownAddress);
+	
+	std::memcpy(frame, FakeIODevice::sendBuffer, FakeIODevice::bytesSend);
+	uint8_t length = FakeIODevice::bytesSend;
+	FakeIODevice::reset();
+	return length;
+}
+
+static void
+receive(const uint8_t *frame, uint8_t length)
+{
+	std::memcpy(FakeIODevice::receiveBuffer + FakeIODevice::bytesReceived, frame, length);
+	FakeIODevice::bytesReceived += length;
+}
+
+static void
+checkMessage(xpcc::rpr::MessageType type, uint16_t source)
+{
+	xpcc::rpr::Message *message = TestingInterface::getReceivedMessage();
+	TEST_ASSERT_TRUE(message != 0);
+	if (message == 0) {
+		return;
+	}
+	TEST_ASSERT_EQUALS(message->type, type);
+	TEST_ASSERT_EQUALS(message->source, source);
+	TEST_ASSERT_EQUALS(message->command, 0x34);
+	TEST_ASSERT_EQUALS(message->length, 4U);
+	TEST_ASSERT_EQUALS_ARRAY(message->payload, payload, 4);
+	TestingInterface::dropReceivedMessage();
+}
+
+void
+RprInterfaceTest::setUp()
+{
+	FakeIODevice::reset();
+	TestingInterface::initialize(ownAddress);
+	while (TestingInterface::getReceivedMessage() != 0) {
+		TestingInterface::dropReceivedMessage();
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+RprInterfaceTest::testReceiveFragmented()
+{
+	uint8_t frame[40];
+	uint8_t length = createFrame(frame, 0x20, ownAddress, xpcc::rpr::MESSAGE_TYPE_UNICAST);
+	
+	// the last payload byte is not escaped
+	TEST_ASSERT_EQUALS(frame[12], 0x01);
+	
+	for (uint8_t readSize = 1; readSize <= 16; ++readSize)
+	{
+		FakeIODevice::reset();
+		FakeIODevice::readSize = readSize;
+		
+		// garbage, a frame with a CRC error and a valid frame
+		const uint8_t garbage[3] = { 0x01, 0x7d, 0x7c };
+		receive(garbage, 3);
+		receive(frame, length);
+		FakeIODevice::receiveBuffer[3 + 12] ^= 0x01;
+		receive(frame, length);
+		
+		TestingInterface::update();
+		
+		checkMessage(xpcc::rpr::MESSAGE_TYPE_UNICAST, 0x20);
+		TEST_ASSERT_TRUE(TestingInterface::getReceivedMessage() == 0);
+		
+		// unicasts to this node end here
+		TEST_ASSERT_EQUALS(FakeIODevice::bytesSend, 0);
+	}
+}
+
+void
+RprInterfaceTest::testForwardFragmented()
+{
+	uint8_t frame[40];
+	uint8_t length = createFrame(frame, 0x20, 0, xpcc::rpr::MESSAGE_TYPE_BROADCAST);
+	
+	for (uint8_t readSize = 1; readSize <= 16; ++readSize)
+	{
+		FakeIODevice::reset();
+		FakeIODevice::readSize = readSize;
+		receive(frame, length);
+		
+		TestingInterface::update();
+		
+		checkMessage(xpcc::rpr::MESSAGE_TYPE_BROADCAST, 0x20);
+		TEST_ASSERT_EQUALS(FakeIODevice::bytesSend, length);
+		TEST_ASSERT_EQUALS_ARRAY(FakeIODevice::sendBuffer, frame, length);
+	}
+}
+
+void
+RprInterfaceTest::testForwardUnicast()
+{
+	uint8_t frame[40];
+	uint8_t length = createFrame(frame, 0x20, 0x30, xpcc::rpr::MESSAGE_TYPE_UNICAST);
+	
+	FakeIODevice::readSize = 3;
+	receive(frame, length);
+	
+	TestingInterface::update();
+	
+	TEST_ASSERT_TRUE(TestingInterface::getReceivedMessage() == 0);
+	TEST_ASSERT_EQUALS(FakeIODevice::bytesSend, length);
+	TEST_ASSERT_EQUALS_ARRAY(FakeIODevice::sendBuffer, frame, length);
+}
+
+void
+RprInterfaceTest::testRemoveOwnMessage()
+{
+	uint8_t frame[40];
+	uint8_t length = createFrame(frame, ownAddress, 0, xpcc::rpr::MESSAGE_TYPE_BROADCAST);
+	
+	receive(frame, length);
+	TestingInterface::update();
+	
+	checkMessage(xpcc::rpr::MESSAGE_TYPE_BROADCAST, ownAddress);
+	TEST_ASSERT_EQUALS(FakeIODevice::bytesSend, 0);
+}
+
+void
+RprInterfaceTest::testSendWhileForwarding()
+{
+	uint8_t frame[40];
+	uint8_t length = createFrame(frame, 0x20, 0, xpcc::rpr::MESSAGE_TYPE_BROADCAST);
+	uint8_t own[40];
+	uint8_t ownLength = createFrame(own, ownAddress, 0x30, xpcc::rpr::MESSAGE_TYPE_UNICAST);
+	
+	// first half of the frame
+	receive(frame, length);
+	FakeIODevice::bytesReceived = length / 2;
+	TestingInterface::update();
+	const uint8_t forwarded = FakeIODevice::bytesSend;
+	
+	TEST_ASSERT_TRUE(TestingInterface::sendMessage(0x30,
+			xpcc::rpr::MESSAGE_TYPE_UNICAST, 0x34, payload, 4));
+	TEST_ASSERT_EQUALS(FakeIODevice::bytesSend, forwarded);
+	
+	// rest of the frame, the own message follows with the next update
+	FakeIODevice::bytesReceived = length;
+	TestingInterface::update();
+	TEST_ASSERT_EQUALS(FakeIODevice::bytesSend, length);
+	
+	TestingInterface::update();
+	TEST_ASSERT_EQUALS(FakeIODevice::bytesSend, length + ownLength);
+	TEST_ASSERT_EQUALS_ARRAY(FakeIODevice::sendBuffer, frame, length);
+	TEST_ASSERT_EQUALS_ARRAY(FakeIODevice::sendBuffer + length, own, ownLength);
+	
+	checkMessage(xpcc::rpr::MESSAGE_TYPE_BROADCAST, 0x20);
+}
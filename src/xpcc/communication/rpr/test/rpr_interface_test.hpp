@@ -0,0 +1,36 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class RprInterfaceTest : public unittest::TestSuite
+{
+public:
+	virtual void
+	setUp();
+	
+	/// Frames split across several block reads, garbage and CRC errors
+	void
+	testReceiveFragmented();
+	
+	/// Broadcasts are received and forwarded unchanged
+	void
+	testForwardFragmented();
+	
+	/// Unicasts to other nodes are only forwarded
+	void
+	testForwardUnicast();
+	
+	/// Own messages are taken from the ring
+	void
+	testRemoveOwnMessage();
+	
+	/// Messages sent while a frame passes are delayed until its end
+	void
+	testSendWhileForwarding();
+};
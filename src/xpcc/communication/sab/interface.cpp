@@ -28,6 +28,8 @@
  */
 // ----------------------------------------------------------------------------
 
+#include <xpcc/math/utils/crc.hpp>
+
 #include "interface.hpp"
 
 uint8_t
@@ -36,17 +38,19 @@ xpcc::sab::crcUpdate(uint8_t crc, uint8_t data)
 #ifdef __AVR__
 	return _crc_ibutton_update(crc, data);
 #else
-	crc = crc ^ data;
-	for (uint_fast8_t i = 0; i < 8; ++i)
-	{
-		if (crc & 0x01) {
-			crc = (crc >> 1) ^ 0x8C;
-		}
-		else {
-			crc >>= 1;
-		}
+	return xpcc::crc::Crc8Dallas::update(crc, data);
+#endif
+}
+
+uint8_t
+xpcc::sab::crcUpdate(uint8_t crc, const uint8_t *data, std::size_t length)
+{
+#ifdef __AVR__
+	for (std::size_t i = 0; i < length; ++i) {
+		crc = _crc_ibutton_update(crc, data[i]);
 	}
 	return crc;
+#else
+	return xpcc::crc::Crc8Dallas::update(crc, data, length);
 #endif
 }
-
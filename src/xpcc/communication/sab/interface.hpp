@@ -52,6 +52,14 @@ namespace xpcc
 		uint8_t
 		crcUpdate(uint8_t crc, uint8_t data);
 		
+		/**
+		 * \internal
+		 * \brief	Add a block of data to the checksum
+		 * \ingroup	sab
+		 */
+		uint8_t
+		crcUpdate(uint8_t crc, const uint8_t *data, std::size_t length);
+		
 		/**
 		 * \brief	SAB interface
 		 * 
@@ -150,6 +158,11 @@ namespace xpcc
 			 * \brief	Update internal status
 			 * 
 			 * Has to be called periodically. Encodes received messages.
+			 * 
+			 * The received bytes are fetched from the device in blocks
+			 * with `Device::read(uint8_t *, std::size_t)` and the frames
+			 * are decoded in place, messages are transmitted with a single
+			 * `Device::write(const uint8_t *, std::size_t)`.
 			 */
 			static void
 			update();
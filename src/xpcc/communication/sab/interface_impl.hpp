@@ -32,6 +32,8 @@
 	#error	"Don't include this file directly, use 'interface.hpp' instead!"
 #endif
 
+#include <cstring>
+
 #ifdef __AVR__
 	#include <util/crc16.h>
 #endif
@@ -69,25 +71,25 @@ xpcc::sab::Interface<Device>::sendMessage(uint8_t address, Flags flags,
 		uint8_t command,
 		const void *payload, uint8_t payloadLength)
 {
-	uint8_t crcSend;
-	
-	Device::write(syncByte);
-	Device::write(payloadLength);
-	crcSend = crcUpdate(crcInitialValue, payloadLength);
-	Device::write(address | flags);
-	crcSend = crcUpdate(crcSend, address | flags);
-	Device::write(command);
-	crcSend = crcUpdate(crcSend, command);
+	if (payloadLength > maxPayloadLength) {
+		// would be discarded by the receiver anyway
+		return;
+	}
 	
-	const uint8_t *ptr = static_cast<const uint8_t *>(payload);
-	for (uint_fast8_t i = 0; i < payloadLength; ++i)
-	{
-		crcSend = crcUpdate(crcSend, *ptr);
-		Device::write(*ptr);
-		ptr++;
+	// assemble the complete frame to hand it to the device at once
+	uint8_t frame[maxPayloadLength + 5];
+	frame[0] = syncByte;
+	frame[1] = payloadLength;
+	frame[2] = address | flags;
+	frame[3] = command;
+	if (payloadLength > 0) {
+		std::memcpy(frame + 4, payload, payloadLength);
 	}
 	
-	Device::write(crcSend);
+	uint8_t crcSend = crcUpdate(crcInitialValue, frame + 1, payloadLength + 3);
+	frame[payloadLength + 4] = crcSend;
+	
+	Device::write(frame, payloadLength + 5);
 }
 
 template <typename Device> template <typename T>
@@ -174,50 +176,73 @@ template <typename Device>
 void
 xpcc::sab::Interface<Device>::update()
 {
-	uint8_t byte;
-	while (Device::read(byte))
+	uint8_t chunk[16];
+	std::size_t count;
+	while ((count = Device::read(chunk, sizeof(chunk))) > 0)
 	{
-		//XPCC_LOG_DEBUG.printf("%02x ", byte);
-		switch (state)
+		const uint8_t *ptr = chunk;
+		const uint8_t *end = chunk + count;
+		while (ptr < end)
 		{
-			case SYNC:
-				if (byte == syncByte) {
-					state = LENGTH;
-				}
-				break;
-			
-			case LENGTH:
-				if (byte > maxPayloadLength) {
-					state = SYNC;
-				}
-				else {
-					length = byte + 3;		// +3 for header, command and crc byte
-					position = 0;
-					crc = crcUpdate(crcInitialValue, byte);
-					state = DATA;
+			switch (state)
+			{
+				case SYNC:
+				{
+					const void *sync = std::memchr(ptr, syncByte, end - ptr);
+					if (sync == 0) {
+						ptr = end;
+					}
+					else {
+						ptr = static_cast<const uint8_t *>(sync) + 1;
+						state = LENGTH;
+					}
+					break;
 				}
-				break;
-			
-			case DATA:
-				buffer[position] = byte;
-				crc = crcUpdate(crc, byte);
 				
-				position += 1;
-				if (position >= length) {
-					if (crc == 0) {
-						lengthOfReceivedMessage = length;
-						//XPCC_LOG_DEBUG << "SAB received" << xpcc::endl;
+				case LENGTH:
+				{
+					uint8_t byte = *ptr++;
+					if (byte > maxPayloadLength) {
+						state = SYNC;
 					}
 					else {
-						//XPCC_LOG_ERROR << "CRC error" << xpcc::endl;
+						length = byte + 3;		// +3 for header, command and crc byte
+						position = 0;
+						crc = crcUpdate(crcInitialValue, byte);
+						state = DATA;
 					}
-					state = SYNC;
+					break;
 				}
-				break;
-			
-			default:
-				state = SYNC;
-				break;
+				
+				case DATA:
+				{
+					// take as much of the frame as is available
+					uint8_t size = length - position;
+					if (size > end - ptr) {
+						size = end - ptr;
+					}
+					std::memcpy(buffer + position, ptr, size);
+					crc = crcUpdate(crc, ptr, size);
+					
+					ptr += size;
+					position += size;
+					if (position >= length) {
+						if (crc == 0) {
+							lengthOfReceivedMessage = length;
+							//XPCC_LOG_DEBUG << "SAB received" << xpcc::endl;
+						}
+						else {
+							//XPCC_LOG_ERROR << "CRC error" << xpcc::endl;
+						}
+						state = SYNC;
+					}
+					break;
+				}
+				
+				default:
+					state = SYNC;
+					break;
+			}
 		}
 	}
 }
@@ -31,12 +31,13 @@
 #include <cstring>
 #include "fake_io_device.hpp"
 
-uint8_t FakeIODevice::sendBuffer[40];
+uint8_t FakeIODevice::sendBuffer[128];
 uint8_t FakeIODevice::bytesSend = 0;
 
-uint8_t FakeIODevice::receiveBuffer[40];
+uint8_t FakeIODevice::receiveBuffer[128];
 uint8_t FakeIODevice::receivePosition = 0;
 uint8_t FakeIODevice::bytesReceived = 0;
+uint8_t FakeIODevice::readSize = 128;
 
 void
 FakeIODevice::setBaudrate(uint32_t)
@@ -49,6 +50,14 @@ FakeIODevice::write(uint8_t data)
 	sendBuffer[bytesSend++] = data;
 }
 
+std::size_t
+FakeIODevice::write(const uint8_t *data, std::size_t length)
+{
+	std::memcpy(sendBuffer + bytesSend, data, length);
+	bytesSend += length;
+	return length;
+}
+
 bool
 FakeIODevice::read(uint8_t& byte)
 {
@@ -61,10 +70,25 @@ FakeIODevice::read(uint8_t& byte)
 	}
 }
 
+std::size_t
+FakeIODevice::read(uint8_t *data, std::size_t length)
+{
+	std::size_t available = bytesReceived - receivePosition;
+	if (length > available) {
+		length = available;
+	}
+	if (length > readSize) {
+		length = readSize;
+	}
+	std::memcpy(data, receiveBuffer + receivePosition, length);
+	receivePosition += length;
+	return length;
+}
 
 void
 FakeIODevice::reset()
 {
+	readSize = 128;
 	bytesReceived = 0;
 	receivePosition = 0;
 	bytesSend = 0;
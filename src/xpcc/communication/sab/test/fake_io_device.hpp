@@ -31,6 +31,7 @@
 #ifndef FAKE_IO_DEVICE_HPP
 #define FAKE_IO_DEVICE_HPP 
 
+#include <cstddef>
 #include <stdint.h>
 
 class FakeIODevice
@@ -42,9 +43,15 @@ public:
 	static void
 	write(uint8_t data);
 	
+	static std::size_t
+	write(const uint8_t *data, std::size_t length);
+	
 	static bool
 	read(uint8_t& byte);
 	
+	static std::size_t
+	read(uint8_t *data, std::size_t length);
+	
 	static void
 	reset();
 	
@@ -52,12 +59,15 @@ public:
 	static void
 	moveSendToReceiveBuffer();
 	
-	static uint8_t sendBuffer[40];
+	static uint8_t sendBuffer[128];
 	static uint8_t bytesSend;
 	
-	static uint8_t receiveBuffer[40];
+	static uint8_t receiveBuffer[128];
 	static uint8_t receivePosition;
 	static uint8_t bytesReceived;
+	
+	/// Maximum number of bytes returned by a single block read
+	static uint8_t readSize;
 };
 
 #endif	// FAKE_IO_DEVICE_HPP
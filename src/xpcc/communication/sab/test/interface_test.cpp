@@ -28,6 +28,8 @@
  */
 // ----------------------------------------------------------------------------
 
+#include <cstring>
+
 #include "../interface.hpp"
 
 #include "fake_io_device.hpp"
@@ -199,3 +201,43 @@ InterfaceTest::testReceiveNack()
 			reinterpret_cast<uint8_t *>(&data),
 			4);
 }
+
+// ----------------------------------------------------------------------------
+void
+InterfaceTest::testReceiveFragmented()
+{
+	TestingInterface interface;
+	
+	uint32_t data = 0xdeadbeef;
+	uint8_t message[9];
+	interface.sendMessage(0x12, xpcc::sab::REQUEST, 0x34, data);
+	std::memcpy(message, FakeIODevice::sendBuffer, 9);
+	
+	for (uint8_t readSize = 1; readSize <= 16; ++readSize)
+	{
+		FakeIODevice::reset();
+		FakeIODevice::readSize = readSize;
+		
+		// garbage, a frame with a CRC error and a valid frame
+		const uint8_t garbage[3] = { 0x00, 0x12, 0xff };
+		std::memcpy(FakeIODevice::receiveBuffer, garbage, 3);
+		std::memcpy(FakeIODevice::receiveBuffer + 3, message, 9);
+		FakeIODevice::receiveBuffer[3 + 5] ^= 0x01;
+		std::memcpy(FakeIODevice::receiveBuffer + 12, message, 9);
+		FakeIODevice::bytesReceived = 21;
+		
+		interface.update();
+		
+		TEST_ASSERT_TRUE(interface.isMessageAvailable());
+		TEST_ASSERT_EQUALS(interface.getAddress(), 0x12);
+		TEST_ASSERT_EQUALS(interface.getCommand(), 0x34);
+		TEST_ASSERT_EQUALS(interface.getPayloadLength(), 4);
+		TEST_ASSERT_EQUALS_ARRAY(
+				interface.getPayload(),
+				reinterpret_cast<uint8_t *>(&data),
+				4);
+		
+		interface.dropMessage();
+	}
+}
+
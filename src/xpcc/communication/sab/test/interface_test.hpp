@@ -53,4 +53,8 @@ public:
 	
 	void
 	testReceiveNack();
+	
+	/// Frames split across several block reads, garbage and CRC errors
+	void
+	testReceiveFragmented();
 };
@@ -32,6 +32,8 @@
 #	include <util/crc16.h>
 #endif
 
+#include <xpcc/math/utils/crc.hpp>
+
 #include "interface.hpp"
 
 uint16_t
@@ -40,18 +42,19 @@ xpcc::sab2::crcUpdate(uint16_t crc, uint8_t data)
 #ifdef __AVR__
 	return _crc16_update(crc, data);
 #else
-	crc ^= data;
-	for (uint_fast8_t i = 0; i < 8; ++i)
-	{
-		if (crc & 1) {
-			crc = (crc >> 1) ^ 0xA001;
-		}
-		else {
-			crc = (crc >> 1);
-		}
-	}
+	return xpcc::crc::Crc16Ibm::update(crc, data);
+#endif
+}
 
+uint16_t
+xpcc::sab2::crcUpdate(uint16_t crc, const uint8_t *data, std::size_t length)
+{
+#ifdef __AVR__
+	for (std::size_t i = 0; i < length; ++i) {
+		crc = _crc16_update(crc, data[i]);
+	}
 	return crc;
+#else
+	return xpcc::crc::Crc16Ibm::update(crc, data, length);
 #endif
 }
-
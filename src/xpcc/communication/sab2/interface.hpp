@@ -50,6 +50,14 @@ namespace xpcc
 		uint16_t
 		crcUpdate(uint16_t crc, uint8_t data);
 		
+		/**
+		 * \internal
+		 * \brief	Add a block of data to the checksum
+		 * \ingroup	sab2
+		 */
+		uint16_t
+		crcUpdate(uint16_t crc, const uint8_t *data, std::size_t length);
+		
 		/**
 		 * \brief	SAB2 interface
 		 * 
@@ -155,20 +163,36 @@ namespace xpcc
 			/**
 			 * \brief	Update internal status
 			 * 
-			 * Has to be called periodically. Encodes received messages.
+			 * Has to be called periodically. Decodes received messages.
+			 * 
+			 * The received bytes are fetched from the device in blocks
+			 * with `Device::read(uint8_t *, std::size_t)`. The data between
+			 * two control characters is copied and checked at once, bytes
+			 * following a complete message are kept until the message is
+			 * dropped. Messages are transmitted with a single
+			 * `Device::write(const uint8_t *, std::size_t)`.
 			 */
 			static void
 			update();
 			
 		private:
+			/// Escape a byte into the transmit frame
+			static uint8_t *
+			appendEscaped(uint8_t *frame, uint8_t data);
+			
+			/// Add unescaped data to the current message
 			static void
-			writeByteEscaped(uint8_t data);
+			appendReceived(const uint8_t *data, Size size);
 			
 			static uint8_t buffer[N + 4];
 			static uint16_t crc;
 			static Size length;
 			static Size lengthOfReceivedMessage;
 			static bool nextEscaped;
+			
+			static uint8_t input[16];		///< last block read from the device
+			static uint8_t inputPosition;
+			static uint8_t inputLength;
 		};
 	}
 }
@@ -32,6 +32,8 @@
 	#error	"Don't include this file directly, use 'interface.hpp' instead!"
 #endif
 
+#include <cstring>
+
 #include "constants.hpp"
 
 //#include <xpcc/debug/logger.hpp>
@@ -49,6 +51,10 @@ template <typename Device, std::size_t N> typename xpcc::sab2::Interface<Device,
 
 template <typename Device, std::size_t N> bool xpcc::sab2::Interface<Device, N>::nextEscaped = false;
 
+template <typename Device, std::size_t N> uint8_t xpcc::sab2::Interface<Device, N>::input[16];
+template <typename Device, std::size_t N> uint8_t xpcc::sab2::Interface<Device, N>::inputPosition = 0;
+template <typename Device, std::size_t N> uint8_t xpcc::sab2::Interface<Device, N>::inputLength = 0;
+
 // ----------------------------------------------------------------------------
 
 template <typename Device, std::size_t N>
@@ -65,27 +71,36 @@ xpcc::sab2::Interface<Device, N>::sendMessage(uint8_t address, Flags flags,
 		uint8_t command,
 		const void *payload, Size payloadLength)
 {
-	uint16_t crcSend = crcInitialValue;
+	if (payloadLength > N) {
+		// would be discarded by the receiver anyway
+		return;
+	}
+	
+	// assemble the complete frame to hand it to the device at once,
+	// every byte except the frame boundaries might need to be escaped
+	uint8_t frame[2 * (N + 4) + 2];
+	uint8_t *ptr = frame;
 	
-	Device::write(frameBounderyByte);
+	uint16_t crcSend = crcInitialValue;
+	*ptr++ = frameBounderyByte;
 	
-	writeByteEscaped(address | flags);
+	ptr = appendEscaped(ptr, address | flags);
 	crcSend = crcUpdate(crcSend, address | flags);
-	writeByteEscaped(command);
+	ptr = appendEscaped(ptr, command);
 	crcSend = crcUpdate(crcSend, command);
 	
-	const uint8_t *ptr = static_cast<const uint8_t *>(payload);
-	for (uint_fast8_t i = 0; i < payloadLength; ++i)
-	{
-		crcSend = crcUpdate(crcSend, *ptr);
-		writeByteEscaped(*ptr);
-		ptr++;
+	const uint8_t *data = static_cast<const uint8_t *>(payload);
+	crcSend = crcUpdate(crcSend, data, payloadLength);
+	for (Size i = 0; i < payloadLength; ++i) {
+		ptr = appendEscaped(ptr, data[i]);
 	}
 	
-	writeByteEscaped(crcSend & 0xff);
-	writeByteEscaped(crcSend >> 8);
+	ptr = appendEscaped(ptr, crcSend & 0xff);
+	ptr = appendEscaped(ptr, crcSend >> 8);
+	
+	*ptr++ = frameBounderyByte;
 	
-	Device::write(frameBounderyByte);
+	Device::write(frame, ptr - frame);
 }
 
 template <typename Device, std::size_t N> template <typename T>
@@ -171,66 +186,106 @@ template <typename Device, std::size_t N>
 void
 xpcc::sab2::Interface<Device, N>::update()
 {
-	uint8_t data;
-	while ((lengthOfReceivedMessage == 0) && Device::read(data))
+	while (lengthOfReceivedMessage == 0)
 	{
-		//XPCC_LOG_DEBUG.printf("%02x ", data);
-		
-		if (data == frameBounderyByte) {
-			if (nextEscaped) {
-				//XPCC_LOG_ERROR << "framing error" << xpcc::endl;
-			}
-			else {
-				if (length >= 4) {
-					if (crc == 0) {
-						lengthOfReceivedMessage = length;
-					}
-					else {
-						//XPCC_LOG_ERROR.printf("crc=%04x\n", crc);
-					}
-				}
+		if (inputPosition >= inputLength)
+		{
+			inputLength = Device::read(input, sizeof(input));
+			inputPosition = 0;
+			if (inputLength == 0) {
+				return;
 			}
-			
-			crc = crcInitialValue;
-			length = 0;
-			nextEscaped = false;
 		}
-		else if (data == controlEscapeByte) {
-			nextEscaped = true;
-			continue;
+		
+		const uint8_t *ptr = input + inputPosition;
+		const uint8_t *end = input + inputLength;
+		
+		// everything up to the next control character is plain data
+		const uint8_t *control = ptr;
+		while ((control < end) &&
+				(*control != frameBounderyByte) && (*control != controlEscapeByte)) {
+			++control;
 		}
-		else
+		
+		if (nextEscaped && (ptr < control))
 		{
-			if (nextEscaped) {
-				nextEscaped = false;
-				data = data ^ 0x20;	// toggle bit 5
-			}
-			
-			if (length >= (N+4)) {
-				// Error message to long
+			nextEscaped = false;
+			uint8_t data = *ptr++ ^ 0x20;	// toggle bit 5
+			appendReceived(&data, 1);
+		}
+		appendReceived(ptr, control - ptr);
+		ptr = control;
+		
+		if (ptr < end)
+		{
+			if (*ptr == frameBounderyByte) {
+				if (nextEscaped) {
+					//XPCC_LOG_ERROR << "framing error" << xpcc::endl;
+				}
+				else {
+					if (length >= 4) {
+						if (crc == 0) {
+							lengthOfReceivedMessage = length;
+						}
+						else {
+							//XPCC_LOG_ERROR.printf("crc=%04x\n", crc);
+						}
+					}
+				}
+				
+				crc = crcInitialValue;
 				length = 0;
-				//XPCC_LOG_ERROR << "message to long" << xpcc::endl;
+				nextEscaped = false;
 			}
 			else {
-				buffer[length] = data;
-				length += 1;
-				
-				crc = crcUpdate(crc, data);
+				nextEscaped = true;
 			}
+			ptr++;
 		}
+		inputPosition = ptr - input;
 	}
 }
 
 // ----------------------------------------------------------------------------
 template <typename Device, std::size_t N>
 void
-xpcc::sab2::Interface<Device, N>::writeByteEscaped(uint8_t data)
+xpcc::sab2::Interface<Device, N>::appendReceived(const uint8_t *data, Size size)
+{
+	while (size > 0)
+	{
+		if (length >= (N+4)) {
+			// Error message to long
+			length = 0;
+			data++;
+			size--;
+			//XPCC_LOG_ERROR << "message to long" << xpcc::endl;
+			continue;
+		}
+		
+		Size count = (N+4) - length;
+		if (count > size) {
+			count = size;
+		}
+		std::memcpy(buffer + length, data, count);
+		crc = crcUpdate(crc, data, count);
+		
+		length += count;
+		data += count;
+		size -= count;
+	}
+}
+
+// ----------------------------------------------------------------------------
+template <typename Device, std::size_t N>
+uint8_t *
+xpcc::sab2::Interface<Device, N>::appendEscaped(uint8_t *frame, uint8_t data)
 {
 	if (data == frameBounderyByte || data == controlEscapeByte) {
-		Device::write(controlEscapeByte);
-		Device::write(data ^ 0x20);		// toggle bit 5
+		*frame++ = controlEscapeByte;
+		*frame++ = data ^ 0x20;		// toggle bit 5
 	}
 	else {
-		Device::write(data);
+		*frame++ = data;
 	}
+	return frame;
 }
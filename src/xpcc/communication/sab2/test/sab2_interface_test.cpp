@@ -0,0 +1,130 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <cstring>
+
+#include "../interface.hpp"
+
+#include "../../sab/test/fake_io_device.hpp"
+#include "sab2_interface_test.hpp"
+
+typedef xpcc::sab2::Interface<FakeIODevice> TestingInterface;
+
+static const uint8_t payload[4] = { 0x7e, 0x11, 0x7d, 0x22 };
+
+/// Create a frame with the interface, \return its length
+static uint8_t
+createFrame(uint8_t *frame, uint8_t command)
+{
+	FakeIODevice::reset();
+	TestingInterface::sendMessage(0x12, xpcc::sab::ACK, command, payload);
+	std::memcpy(frame, FakeIODevice::sendBuffer, FakeIODevice::bytesSend);
+	return FakeIODevice::bytesSend;
+}
+
+static void
+checkMessage(uint8_t command)
+{
+	TEST_ASSERT_TRUE(TestingInterface::isMessageAvailable());
+	TEST_ASSERT_TRUE(TestingInterface::isResponse());
+	TEST_ASSERT_TRUE(TestingInterface::isAcknowledge());
+	TEST_ASSERT_EQUALS(TestingInterface::getAddress(), 0x12);
+	TEST_ASSERT_EQUALS(TestingInterface::getCommand(), command);
+	TEST_ASSERT_EQUALS(TestingInterface::getPayloadLength(), 4);
+	TEST_ASSERT_EQUALS_ARRAY(TestingInterface::getPayload(), payload, 4);
+}
+
+void
+Sab2InterfaceTest::setUp()
+{
+	TestingInterface::initialize();
+	FakeIODevice::reset();
+	
+	// remove anything left over by the previous test
+	TestingInterface::update();
+	TestingInterface::dropMessage();
+}
+
+// ----------------------------------------------------------------------------
+void
+Sab2InterfaceTest::testSendEscaped()
+{
+	uint8_t frame[32];
+	uint8_t length = createFrame(frame, 0x34);
+	
+	const uint8_t start[9] = {
+		0x7e, 0x12 | 0xc0, 0x34, 0x7d, 0x5e, 0x11, 0x7d, 0x5d, 0x22
+	};
+	TEST_ASSERT_EQUALS_ARRAY(frame, start, 9);
+	TEST_ASSERT_EQUALS(frame[length - 1], 0x7e);
+	
+	// the checksum bytes are escaped as well
+	for (uint8_t i = 1; i < length - 1; ++i) {
+		TEST_ASSERT_TRUE(frame[i] != 0x7e);
+	}
+}
+
+void
+Sab2InterfaceTest::testReceiveFragmented()
+{
+	uint8_t frame[32];
+	uint8_t length = createFrame(frame, 0x34);
+	
+	for (uint8_t readSize = 1; readSize <= 16; ++readSize)
+	{
+		FakeIODevice::reset();
+		FakeIODevice::readSize = readSize;
+		
+		// garbage ending with an escape byte, a frame with a CRC error
+		// and a valid frame
+		uint8_t *buffer = FakeIODevice::receiveBuffer;
+		const uint8_t garbage[3] = { 0x01, 0x02, 0x7d };
+		std::memcpy(buffer, garbage, 3);
+		std::memcpy(buffer + 3, frame, length);
+		buffer[3 + 5] ^= 0x01;
+		std::memcpy(buffer + 3 + length, frame, length);
+		FakeIODevice::bytesReceived = 3 + 2 * length;
+		
+		// the interface fetches 16 bytes at most with a single call
+		for (uint8_t i = 0; i < FakeIODevice::bytesReceived && !TestingInterface::isMessageAvailable(); ++i) {
+			TestingInterface::update();
+		}
+		
+		checkMessage(0x34);
+		TestingInterface::dropMessage();
+		
+		TestingInterface::update();
+		TEST_ASSERT_FALSE(TestingInterface::isMessageAvailable());
+	}
+}
+
+void
+Sab2InterfaceTest::testReceiveConsecutive()
+{
+	uint8_t first[32];
+	uint8_t firstLength = createFrame(first, 0x34);
+	uint8_t second[32];
+	uint8_t secondLength = createFrame(second, 0x56);
+	
+	FakeIODevice::reset();
+	std::memcpy(FakeIODevice::receiveBuffer, first, firstLength);
+	std::memcpy(FakeIODevice::receiveBuffer + firstLength, second, secondLength);
+	FakeIODevice::bytesReceived = firstLength + secondLength;
+	
+	TestingInterface::update();
+	checkMessage(0x34);
+	
+	// kept until dropped
+	TestingInterface::update();
+	checkMessage(0x34);
+	TestingInterface::dropMessage();
+	
+	TestingInterface::update();
+	checkMessage(0x56);
+	TestingInterface::dropMessage();
+}
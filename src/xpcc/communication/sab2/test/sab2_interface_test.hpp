@@ -0,0 +1,28 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class Sab2InterfaceTest : public unittest::TestSuite
+{
+public:
+	virtual void
+	setUp();
+	
+	/// Frame boundary and escape bytes inside the payload
+	void
+	testSendEscaped();
+	
+	/// Frames split across several block reads, garbage and CRC errors
+	void
+	testReceiveFragmented();
+	
+	/// Two frames in one block are returned one after the other
+	void
+	testReceiveConsecutive();
+};
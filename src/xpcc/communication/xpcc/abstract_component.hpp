@@ -114,6 +114,16 @@ namespace xpcc
 		callAction(uint8_t receiver, uint8_t actionIdentifier, const T& data,
 				ResponseCallback& responseCallback);
 
+		/// Call an action with a payload constructed in place, see Communicator::emplaceAction()
+		template<typename T, typename... Args>
+		inline bool
+		emplaceAction(uint8_t receiver, uint8_t actionIdentifier, const Args&... args);
+
+		template<typename T, typename... Args>
+		inline bool
+		emplaceAction(uint8_t receiver, uint8_t actionIdentifier,
+				ResponseCallback& responseCallback, const Args&... args);
+
 
 		inline void
 		publishEvent(uint8_t eventIdentifier);
@@ -122,6 +132,11 @@ namespace xpcc
 		inline void
 		publishEvent(uint8_t eventIdentifier, const T& data);
 
+		/// Publish an event with a payload constructed in place, see Communicator::emplaceEvent()
+		template<typename T, typename... Args>
+		inline bool
+		emplaceEvent(uint8_t eventIdentifier, const Args&... args);
+
 
 		inline void
 		sendResponse(const ResponseHandle& handle);
@@ -76,6 +76,23 @@ xpcc::AbstractComponent::callAction(uint8_t receiver, uint8_t actionIdentifier,
 	this->communicator.callAction(receiver, actionIdentifier, data, responseCallback);
 }
 
+template<typename T, typename... Args>
+bool
+xpcc::AbstractComponent::emplaceAction(uint8_t receiver, uint8_t actionIdentifier,
+		const Args&... args)
+{
+	return this->communicator.emplaceAction<T>(receiver, actionIdentifier, args...);
+}
+
+template<typename T, typename... Args>
+bool
+xpcc::AbstractComponent::emplaceAction(uint8_t receiver, uint8_t actionIdentifier,
+		ResponseCallback& responseCallback, const Args&... args)
+{
+	return this->communicator.emplaceAction<T>(receiver, actionIdentifier,
+			responseCallback, args...);
+}
+
 // ----------------------------------------------------------------------------
 template<typename T>
 void
@@ -84,6 +101,13 @@ xpcc::AbstractComponent::publishEvent(uint8_t eventIdentifier, const T& data)
 	communicator.publishEvent(eventIdentifier, data);
 }
 
+template<typename T, typename... Args>
+bool
+xpcc::AbstractComponent::emplaceEvent(uint8_t eventIdentifier, const Args&... args)
+{
+	return this->communicator.emplaceEvent<T>(eventIdentifier, args...);
+}
+
 // ----------------------------------------------------------------------------
 void
 xpcc::AbstractComponent::sendResponse(const ResponseHandle& handle)
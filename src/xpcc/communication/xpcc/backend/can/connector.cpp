@@ -29,12 +29,10 @@
 // ----------------------------------------------------------------------------
 
 #include <stdlib.h>
+#include <xpcc/math/utils/bit_operation.hpp>
 
 #include "connector.hpp"
 
-// ----------------------------------------------------------------------------
-uint8_t xpcc::CanConnectorBase::messageCounter = 0;
-
 // ----------------------------------------------------------------------------
 uint32_t
 xpcc::CanConnectorBase::convertToIdentifier(const Header & header,
@@ -124,3 +122,356 @@ xpcc::CanConnectorBase::getNumberOfFragments(uint8_t messageSize)
 	div_t n = div(messageSize, 6);
 	return (n.rem > 0) ? n.quot + 1 : n.quot;
 }
+
+// ----------------------------------------------------------------------------
+// Number of identifiers a filter accepts, the CAN identifier has 29 bits
+static inline uint32_t
+getAcceptedIdentifiers(const xpcc::Can::Filter& filter)
+{
+	return 1UL << (29 - xpcc::bitCount(static_cast<uint32_t>(filter.mask & 0x1fffffff)));
+}
+
+// Smallest filter accepting everything both filters accept
+static inline xpcc::Can::Filter
+mergeFilters(const xpcc::Can::Filter& a, const xpcc::Can::Filter& b)
+{
+	xpcc::Can::Filter filter;
+	filter.mask = a.mask & b.mask & ~(a.identifier ^ b.identifier);
+	filter.identifier = a.identifier & filter.mask;
+	return filter;
+}
+
+// Number of identifiers accepted additionally by the merged filter, may be
+// negative if the filters overlap
+static inline int32_t
+getMergeCost(const xpcc::Can::Filter& a, const xpcc::Can::Filter& b)
+{
+	return int32_t(getAcceptedIdentifiers(mergeFilters(a, b))) -
+			int32_t(getAcceptedIdentifiers(a)) -
+			int32_t(getAcceptedIdentifiers(b));
+}
+
+static inline bool
+isCoveredBy(const xpcc::Can::Filter& filter, const xpcc::Can::Filter& by)
+{
+	return ((filter.mask & by.mask) == by.mask) &&
+			by.matches(filter.identifier);
+}
+
+uint8_t
+xpcc::CanConnectorBase::insertFilter(Can::Filter filter,
+		Can::Filter *filters, uint8_t count, uint8_t maxFilters)
+{
+	while (true)
+	{
+		bool merged = false;
+		for (uint8_t i = 0; i < count; ++i)
+		{
+			if (isCoveredBy(filter, filters[i])) {
+				return count;
+			}
+			if (isCoveredBy(filters[i], filter) ||
+				(filter.mask == filters[i].mask && getMergeCost(filter, filters[i]) == 0))
+			{
+				// covers the other filter or differs in a single bit of
+				// the identifier: combine without accepting additional
+				// identifiers, the result might be combinable again
+				filter = mergeFilters(filter, filters[i]);
+				filters[i] = filters[--count];
+				merged = true;
+				break;
+			}
+		}
+		if (merged) {
+			continue;
+		}
+
+		if (count < maxFilters)
+		{
+			filters[count] = filter;
+			return count + 1;
+		}
+
+		// all filters in use, merge the cheapest pair out of the existing
+		// filters and the new one, which is stored at index count
+		uint8_t first = 0;
+		uint8_t second = count;
+		int32_t minimalCost = INT32_MAX;
+		for (uint8_t i = 0; i <= count; ++i)
+		{
+			const Can::Filter& a = (i < count) ? filters[i] : filter;
+			for (uint8_t k = i + 1; k <= count; ++k)
+			{
+				const Can::Filter& b = (k < count) ? filters[k] : filter;
+				int32_t cost = getMergeCost(a, b);
+				if (cost < minimalCost)
+				{
+					minimalCost = cost;
+					first = i;
+					second = k;
+				}
+			}
+		}
+
+		if (second == count)
+		{
+			filter = mergeFilters(filters[first], filter);
+			filters[first] = filters[--count];
+		}
+		else
+		{
+			Can::Filter combined = mergeFilters(filters[first], filters[second]);
+			// remove the higher index first, the other one might be moved otherwise
+			filters[second] = filters[--count];
+			filters[first] = filters[--count];
+			filters[count++] = filter;
+			filter = combined;
+		}
+	}
+}
+
+uint8_t
+xpcc::CanConnectorBase::calculateFilters(
+		const uint8_t *components, uint8_t numberOfComponents,
+		const uint8_t *events, uint8_t numberOfEvents,
+		Can::Filter *filters, uint8_t maxFilters)
+{
+	if (maxFilters == 0) {
+		return 0;
+	}
+
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < numberOfComponents; ++i)
+	{
+		Can::Filter filter;
+		filter.identifier = XPCC_CAN_PACKET_DESTINATION(components[i]);
+		filter.mask = XPCC_CAN_PACKET_DESTINATION_MASK;
+		count = insertFilter(filter, filters, count, maxFilters);
+	}
+	for (uint8_t i = 0; i < numberOfEvents; ++i)
+	{
+		Can::Filter filter;
+		filter.identifier = XPCC_CAN_PACKET_EVENT | XPCC_CAN_PACKET_ID(events[i]);
+		filter.mask = XPCC_CAN_PACKET_EVENT_MASK | XPCC_CAN_PACKET_ID_MASK;
+		count = insertFilter(filter, filters, count, maxFilters);
+	}
+	return count;
+}
+
+// ----------------------------------------------------------------------------
+xpcc::CanConnectorBase::CanConnectorBase() :
+	messageCounter(0), acknowledgeCoalescing(false), acknowledgeSlot(),
+	coalescingPeers(), freeSendItems(0), statistics(),
+	actionPriority(nullptr), eventPriority(nullptr)
+{
+	for (uint8_t i = 0; i < sendQueueSize; ++i) {
+		this->sendItems[i].next = (i + 1U < sendQueueSize) ? (i + 1) : invalidIndex;
+	}
+	for (uint8_t i = 0; i < numberOfPriorities; ++i) {
+		this->sendQueues[i].head = invalidIndex;
+		this->sendQueues[i].tail = invalidIndex;
+	}
+}
+
+void
+xpcc::CanConnectorBase::setPriorityFunctions(ActionPriorityFunction action,
+		EventPriorityFunction event)
+{
+	this->actionPriority = action;
+	this->eventPriority = event;
+}
+
+uint8_t
+xpcc::CanConnectorBase::getPriority(const Header& header) const
+{
+	uint8_t priority = 1;
+	if (header.isAcknowledge) {
+		// Acknowledges are short, delaying them only causes retransmissions
+		return 0;
+	}
+	else if (header.type != Header::Type::REQUEST) {
+		// responses are sent by the component executing the action
+		if (this->actionPriority != nullptr) {
+			priority = this->actionPriority(header.source, header.packetIdentifier);
+		}
+	}
+	else if (header.destination == 0) {
+		if (this->eventPriority != nullptr) {
+			priority = this->eventPriority(header.packetIdentifier);
+		}
+	}
+	else if (this->actionPriority != nullptr) {
+		priority = this->actionPriority(header.destination, header.packetIdentifier);
+	}
+
+	return (priority < numberOfPriorities) ? priority : (numberOfPriorities - 1);
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::CanConnectorBase::appendSendItem(uint8_t priority, uint32_t identifier,
+		const SmartPointer& payload, uint8_t counter)
+{
+	PriorityStatistics& stat = this->statistics[priority];
+
+	uint8_t index = this->freeSendItems;
+	if (index == invalidIndex) {
+		stat.droppedPackets++;
+		return false;
+	}
+
+	SendListItem& item = this->sendItems[index];
+	this->freeSendItems = item.next;
+
+	item.identifier = identifier;
+	item.payload = payload;
+	item.time = Clock::nowShort();
+	item.fragmentIndex = 0;
+	item.counter = counter;
+	item.next = invalidIndex;
+
+	SendQueue& queue = this->sendQueues[priority];
+	if (queue.tail == invalidIndex) {
+		queue.head = index;
+	}
+	else {
+		this->sendItems[queue.tail].next = index;
+	}
+	queue.tail = index;
+
+	stat.queueDepth++;
+	if (stat.queueDepth > stat.maxQueueDepth) {
+		stat.maxQueueDepth = stat.queueDepth;
+	}
+	return true;
+}
+
+bool
+xpcc::CanConnectorBase::isSendItemWaiting(uint8_t priority) const
+{
+	for (uint8_t i = 0; i <= priority; ++i)
+	{
+		if (this->sendQueues[i].head != invalidIndex) {
+			return true;
+		}
+	}
+	return false;
+}
+
+xpcc::CanConnectorBase::SendListItem*
+xpcc::CanConnectorBase::getSendItem(uint8_t& priority)
+{
+	for (priority = 0; priority < numberOfPriorities; ++priority)
+	{
+		uint8_t index = this->sendQueues[priority].head;
+		if (index != invalidIndex) {
+			return &this->sendItems[index];
+		}
+	}
+	return nullptr;
+}
+
+void
+xpcc::CanConnectorBase::removeSendItem(uint8_t priority)
+{
+	SendQueue& queue = this->sendQueues[priority];
+	uint8_t index = queue.head;
+	SendListItem& item = this->sendItems[index];
+
+	queue.head = item.next;
+	if (queue.head == invalidIndex) {
+		queue.tail = invalidIndex;
+	}
+
+	PriorityStatistics& stat = this->statistics[priority];
+	stat.queueDepth--;
+	stat.transmittedPackets++;
+
+	uint16_t latency = (Clock::nowShort() - item.time).getTime();
+	stat.totalLatency += latency;
+	if (latency > stat.maxLatency) {
+		stat.maxLatency = latency;
+	}
+
+	// release the payload, otherwise it is kept until the item is reused
+	item.payload = SmartPointer();
+	item.next = this->freeSendItems;
+	this->freeSendItems = index;
+}
+
+void
+xpcc::CanConnectorBase::clearSendItems()
+{
+	for (uint8_t priority = 0; priority < numberOfPriorities; ++priority)
+	{
+		SendQueue& queue = this->sendQueues[priority];
+		while (queue.head != invalidIndex)
+		{
+			uint8_t index = queue.head;
+			SendListItem& item = this->sendItems[index];
+			queue.head = item.next;
+
+			item.payload = SmartPointer();
+			item.next = this->freeSendItems;
+			this->freeSendItems = index;
+		}
+		queue.tail = invalidIndex;
+
+		this->statistics[priority].droppedPackets += this->statistics[priority].queueDepth;
+		this->statistics[priority].queueDepth = 0;
+	}
+}
+
+void
+xpcc::CanConnectorBase::countTransmittedPacket(uint8_t priority)
+{
+	this->statistics[priority].transmittedPackets++;
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::CanConnectorBase::setAcknowledgeCoalescing(bool enable)
+{
+	this->acknowledgeCoalescing = enable;
+}
+
+bool
+xpcc::CanConnectorBase::isCoalescingPeer(uint8_t component) const
+{
+	return this->coalescingPeers[component / 8] & (1 << (component % 8));
+}
+
+void
+xpcc::CanConnectorBase::setCoalescingPeer(uint8_t component)
+{
+	this->coalescingPeers[component / 8] |= (1 << (component % 8));
+}
+
+bool
+xpcc::CanConnectorBase::collectAcknowledge(uint32_t identifier)
+{
+	AcknowledgeSlot *freeSlot = nullptr;
+	for (AcknowledgeSlot& slot : this->acknowledgeSlot)
+	{
+		if (slot.count == 0)
+		{
+			if (freeSlot == nullptr) {
+				freeSlot = &slot;
+			}
+		}
+		else if (((slot.identifier ^ identifier) & ~XPCC_CAN_PACKET_ID_MASK) == 0 &&
+				slot.count < maxCoalescedAcknowledges)
+		{
+			slot.packetIdentifiers[slot.count - 1] = identifier & XPCC_CAN_PACKET_ID_MASK;
+			slot.count++;
+			return true;
+		}
+	}
+
+	if (freeSlot == nullptr) {
+		return false;
+	}
+	freeSlot->identifier = identifier;
+	freeSlot->count = 1;
+	return true;
+}
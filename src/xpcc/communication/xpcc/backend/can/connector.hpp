@@ -31,7 +31,11 @@
 #ifndef	XPCC__CAN_CONNECTOR_HPP
 #define	XPCC__CAN_CONNECTOR_HPP
 
-#include <xpcc/container/linked_list.hpp>
+#include <xpcc/architecture/interface/can.hpp>
+#include <xpcc/container/deque.hpp>
+#include <xpcc/processing/timer.hpp>
+#include <xpcc_config.hpp>
+
 #include "../backend_interface.hpp"
 
 // Filter
@@ -41,6 +45,7 @@
 
 #define XPCC_CAN_PACKET_TYPE_REQUEST		(0x00UL << 24)
 #define XPCC_CAN_PACKET_ACKNOWLEDGE			(0x04UL << 24)
+#define XPCC_CAN_PACKET_COALESCED			(0x02UL << 24)
 
 #define	XPCC_CAN_PACKET_EVENT				(XPCC_CAN_PACKET_TYPE_REQUEST | XPCC_CAN_PACKET_DESTINATION(0))
 
@@ -59,6 +64,57 @@ namespace xpcc
 	class CanConnectorBase
 	{
 	public:
+		/// Number of priority classes, 0 is the highest priority
+		static constexpr uint8_t numberOfPriorities = 3;
+
+		/// Priority class of an action, also used for its responses
+		typedef uint8_t (*ActionPriorityFunction)(uint8_t component, uint8_t action);
+
+		/// Priority class of an event
+		typedef uint8_t (*EventPriorityFunction)(uint8_t event);
+
+		/// Counters of a priority class
+		struct PriorityStatistics
+		{
+			uint16_t queueDepth;			///< currently waiting packets
+			uint16_t maxQueueDepth;
+			uint32_t transmittedPackets;
+			uint32_t droppedPackets;		///< send queue full or bus not connected
+			uint32_t totalLatency;			///< sum of the latencies in ms
+			uint16_t maxLatency;			///< in ms
+		};
+
+	public:
+		CanConnectorBase();
+
+		/**
+		 * \brief	Set the functions returning the priority class of a packet
+		 *
+		 * The functions are generated from the system design XML file as
+		 * `robot::priority::action` and `robot::priority::event`.
+		 * Acknowledges are always sent with the highest priority, without
+		 * functions all other packets get priority class 1.
+		 */
+		void
+		setPriorityFunctions(ActionPriorityFunction action,
+				EventPriorityFunction event);
+
+		/// Priority class used for a packet
+		uint8_t
+		getPriority(const Header& header) const;
+
+		/**
+		 * \brief	Counters of a priority class
+		 *
+		 * The latency is the time from sendPacket() until the last
+		 * CAN message of the packet was handed to the driver.
+		 */
+		inline const PriorityStatistics&
+		getStatistics(uint8_t priority) const
+		{
+			return this->statistics[priority];
+		}
+
 		/// Convert a packet header to a can identifier
 		static uint32_t
 		convertToIdentifier(const Header & header, bool fragmentated);
@@ -89,8 +145,143 @@ namespace xpcc
 		static uint8_t
 		getNumberOfFragments(uint8_t messageSize);
 
+		/**
+		 * \brief	Calculate the acceptance filters for a board
+		 *
+		 * A board has to receive all packets addressed to one of its
+		 * components (requests, responses and acknowledges) and the
+		 * events its components subscribed to. Every component and event
+		 * results in one filter, filters which can be combined without
+		 * accepting additional identifiers are merged.
+		 *
+		 * If more than \p maxFilters filters remain, the pair of filters
+		 * whose combination accepts the fewest additional identifiers is
+		 * merged until the filters fit. Then some unneeded packets pass
+		 * the hardware and are dropped by the postman as before.
+		 *
+		 * \param[out]	filters	Array of \p maxFilters elements
+		 * \return	Number of filters written to \p filters
+		 */
+		static uint8_t
+		calculateFilters(const uint8_t *components, uint8_t numberOfComponents,
+				const uint8_t *events, uint8_t numberOfEvents,
+				Can::Filter *filters, uint8_t maxFilters);
+
+		/**
+		 * \brief	Merge the ACKs to the same component
+		 *
+		 * If enabled, all messages are sent with the coalescing flag set
+		 * and ACKs to components which sent messages with the flag are
+		 * collected until the next update(). ACKs with the same type,
+		 * destination and source are then sent in one CAN message, see
+		 * \ref can_coalescing. Disabled by default.
+		 */
+		void
+		setAcknowledgeCoalescing(bool enable);
+
+		/// Check if the component sent messages with the coalescing flag
+		bool
+		isCoalescingPeer(uint8_t component) const;
+
+	protected:
+		struct SendListItem
+		{
+			uint32_t identifier;
+			SmartPointer payload;
+			ShortTimestamp time;
+
+			uint8_t fragmentIndex;
+			uint8_t counter;
+			uint8_t next;
+		};
+
+		static constexpr std::size_t sendQueueSize = XPCC__CAN_SEND_QUEUE_SIZE;
+		static_assert(sendQueueSize < 255, "XPCC__CAN_SEND_QUEUE_SIZE must be smaller than 255!");
+
+		/// Append a packet to the queue of its priority class
+		bool
+		appendSendItem(uint8_t priority, uint32_t identifier,
+				const SmartPointer& payload, uint8_t counter);
+
+		/// Check if packets of the given or a higher priority are waiting
+		bool
+		isSendItemWaiting(uint8_t priority) const;
+
+		/// First packet of the highest priority class, \c nullptr if none
+		SendListItem*
+		getSendItem(uint8_t& priority);
+
+		/// Remove the first packet of a priority class after transmission
+		void
+		removeSendItem(uint8_t priority);
+
+		/// Drop all waiting packets
+		void
+		clearSendItems();
+
+		/// Count a packet which was transmitted without waiting
+		void
+		countTransmittedPacket(uint8_t priority);
+
+		/// Add a filter to a set of filters, merging it if necessary
+		static uint8_t
+		insertFilter(Can::Filter filter, Can::Filter *filters, uint8_t count,
+				uint8_t maxFilters);
+
+		/// Remember that the component understands coalesced ACKs
+		void
+		setCoalescingPeer(uint8_t component);
+
+		/**
+		 * \brief	Collect an ACK for transmission in the next update()
+		 *
+		 * \return	\c false if no slot is free, the ACK has to be sent
+		 * 			on its own then
+		 */
+		bool
+		collectAcknowledge(uint32_t identifier);
+
+		/// ACKs with the same identifier except the packet identifier
+		struct AcknowledgeSlot
+		{
+			uint32_t identifier;		///< with the first packet identifier
+			uint8_t count;				///< zero if the slot is free
+			uint8_t packetIdentifiers[8];
+		};
+
+		/// One CAN message carries up to nine ACKs
+		static constexpr uint8_t maxCoalescedAcknowledges = 9;
+
+		static constexpr std::size_t acknowledgeSlots = XPCC__CAN_ACKNOWLEDGE_SLOTS;
+		static_assert(acknowledgeSlots > 0, "XPCC__CAN_ACKNOWLEDGE_SLOTS must be at least 1!");
+
 	protected:
-		static uint8_t messageCounter;
+		/// Counter of the fragmented packets, stored in the upper four bits
+		uint8_t messageCounter;
+
+		bool acknowledgeCoalescing;
+		AcknowledgeSlot acknowledgeSlot[acknowledgeSlots];
+
+		/// Bitmask of the components which sent the coalescing flag
+		uint8_t coalescingPeers[256 / 8];
+
+	private:
+		static constexpr uint8_t invalidIndex = 0xff;
+
+		SendListItem sendItems[sendQueueSize];
+		uint8_t freeSendItems;
+
+		struct SendQueue
+		{
+			uint8_t head;
+			uint8_t tail;
+		};
+		SendQueue sendQueues[numberOfPriorities];
+
+		PriorityStatistics statistics[numberOfPriorities];
+
+		ActionPriorityFunction actionPriority;
+		EventPriorityFunction eventPriority;
 	};
 
 	/**
@@ -123,13 +314,74 @@ namespace xpcc
 	 *
 	 * \image html xpcc_can_identifier.png
 	 *
-	 * Changes in the highest 4 bits:
+	 * Changes in the highest 5 bits:
 	 * - 2 bit: Action [0], Response [1], Neg. Response [2], not used [3]
 	 * - 1 bit: Request [0], Acknowledge [1] (NACK implicit in the payload)
-	 * - 1 bit: Message Counter active [1] / not active [1]
+	 * - 1 bit: Coalescing flag, see \ref can_coalescing
+	 * - 1 bit: Fragmented [1] / not fragmented [0]
 	 *
 	 * Every event is send with the destination identifier \c 0x00.
 	 *
+	 * \section can_priorities Priorities
+	 *
+	 * Every packet is assigned to one of three priority classes, see
+	 * setPriorityFunctions(). One CAN message is sent per update(), always
+	 * from the oldest packet of the highest priority class waiting. A
+	 * fragmented packet of a lower priority class is interrupted as soon
+	 * as a packet with a higher priority is waiting and continued
+	 * afterwards, so the fragments of packets of different classes are
+	 * interleaved on the bus. Within a class the packets are sent in
+	 * order.
+	 *
+	 * \section can_coalescing Coalesced Acknowledges
+	 *
+	 * Every request and response is acknowledged with an empty CAN
+	 * message. To save bus time, ACKs to the same component can be merged
+	 * with setAcknowledgeCoalescing(). The ACKs handed to sendPacket()
+	 * between two calls of update() are collected and sent in one CAN
+	 * message with the coalescing flag set. The identifier carries the
+	 * first packet identifier, the data bytes up to eight further ones.
+	 * The receiver hands them to the dispatcher as separate ACKs.
+	 *
+	 * Older nodes ignore the flag and would only see the first ACK.
+	 * Therefore a node with coalescing enabled sets the flag on all of
+	 * its messages and ACKs are only merged for components which have
+	 * sent a message with the flag before. All other components get one
+	 * CAN message per ACK as before.
+	 *
+	 * At most `XPCC__CAN_ACKNOWLEDGE_SLOTS` different combinations of
+	 * type, destination and source are collected at the same time.
+	 *
+	 * \section can_filters Acceptance Filters
+	 *
+	 * Without filters every message on the bus is read from the driver,
+	 * reassembled and handed to the postman, which drops all packets not
+	 * addressed to one of its components. If the driver supports the
+	 * optional filter functions of xpcc::Can, setFilters() programs the
+	 * CAN controller to accept only the messages the board needs:
+	 *
+	 * \code
+	 * connector.setFilters(
+	 *         Postman::componentIdentifiers, Postman::numberOfComponents,
+	 *         Postman::eventIdentifiers, Postman::numberOfEvents);
+	 * \endcode
+	 *
+	 * \section can_buffers Buffers
+	 *
+	 * All buffers are allocated statically, their size is set in the
+	 * project configuration:
+	 *
+	 * - `XPCC__CAN_SEND_QUEUE_SIZE` packets are queued for transmission,
+	 *   further packets are dropped. The queue is shared by all priority
+	 *   classes.
+	 * - `XPCC__CAN_RECEIVE_QUEUE_SIZE` received packets are kept until
+	 *   they are fetched. While the queue is full no further messages are
+	 *   read from the driver.
+	 * - `XPCC__CAN_REASSEMBLY_SLOTS` fragmented packets are reassembled
+	 *   at the same time, if all slots are in use the oldest incomplete
+	 *   packet is discarded. The fragments are written directly into the
+	 *   payload of the resulting packet.
+	 *
 	 * \todo timeout
 	 *
 	 * \ingroup	backend
@@ -137,6 +389,16 @@ namespace xpcc
 	template <typename Driver>
 	class CanConnector : protected CanConnectorBase, public BackendInterface
 	{
+	public:
+		using CanConnectorBase::numberOfPriorities;
+		using CanConnectorBase::PriorityStatistics;
+		using CanConnectorBase::setPriorityFunctions;
+		using CanConnectorBase::getPriority;
+		using CanConnectorBase::getStatistics;
+		using CanConnectorBase::calculateFilters;
+		using CanConnectorBase::setAcknowledgeCoalescing;
+		using CanConnectorBase::isCoalescingPeer;
+
 	public:
 		CanConnector(Driver *driver);
 
@@ -163,6 +425,23 @@ namespace xpcc
 		virtual void
 		update();
 
+		/**
+		 * \brief	Program the acceptance filters of the driver
+		 *
+		 * Requires the optional `numberOfFilters`, `getNumberOfFilters()`
+		 * and `setFilters()` of the xpcc::Can interface. The filters are calculated by
+		 * calculateFilters() from the identifiers of the components of
+		 * this board and the events they subscribed to, e.g.
+		 * `Postman::componentIdentifiers` and `Postman::eventIdentifiers`
+		 * generated from the system design.
+		 *
+		 * \return	Number of hardware filters used, zero if the driver
+		 * 			rejected them
+		 */
+		uint8_t
+		setFilters(const uint8_t *components, uint8_t numberOfComponents,
+				const uint8_t *events, uint8_t numberOfEvents);
+
 	protected:
 		CanConnector(const CanConnector&);
 
@@ -178,9 +457,22 @@ namespace xpcc
 		sendMessage(const uint32_t & identifier,
 				const uint8_t *data, uint8_t size);
 
+		/**
+		 * \brief	Try to send the next fragment of a fragmented packet
+		 *
+		 * \return	\b true if the fragment could be send, \b false otherwise
+		 */
+		bool
+		sendFragment(const uint32_t & identifier, const SmartPointer& payload,
+				uint8_t fragmentIndex, uint8_t counter);
+
 		void
 		sendWaitingMessages();
 
+		/// Send the ACKs collected since the last update()
+		void
+		sendCollectedAcknowledges();
+
 		bool
 		retrieveMessage();
 
@@ -188,71 +480,44 @@ namespace xpcc
 		checkAndReceiveMessages();
 
 	protected:
-		class SendListItem
+		struct ReceiveListItem
 		{
-		public:
-			SendListItem(const uint32_t & inIdentifier,
-					const SmartPointer& inPayload) :
-				identifier(inIdentifier),
-				payload(inPayload),
-				fragmentIndex(0)
-			{
-			}
-
-			SendListItem(const SendListItem& other) :
-				identifier(other.identifier),
-				payload(other.payload),
-				fragmentIndex(other.fragmentIndex)
-			{
-			}
-
-			uint32_t identifier;
+			Header header;
 			SmartPointer payload;
 
-			uint8_t fragmentIndex;
-
-		private:
-			SendListItem&
-			operator = (const SendListItem& other);
+			/// Remaining ACKs of a coalesced ACK, zero for other packets.
+			/// The payload holds their packet identifiers.
+			uint8_t acknowledges;
 		};
 
-		class ReceiveListItem
+		/// Fragmented packet during reassembly
+		struct ReassemblySlot
 		{
-		public:
-			ReceiveListItem(uint8_t size, const Header& inHeader,
-					uint8_t messageCounter = 0) :
-				header(inHeader), payload(size),
-				receivedFragments(0),
-				counter(messageCounter)
-			{
-			}
-
-			ReceiveListItem(const ReceiveListItem& other) :
-				header(other.header), payload(other.payload),
-				receivedFragments(other.receivedFragments),
-				counter(other.counter)
-			{
-			}
-
 			Header header;
 			SmartPointer payload;
 
-			uint8_t receivedFragments;
-			const uint8_t counter;
-
-		private:
-			ReceiveListItem&
-			operator = (const ReceiveListItem& other);
+			uint8_t counter;
+			uint8_t receivedFragments;	///< bitmask, zero if the slot is free
+			uint8_t sequence;			///< to find the oldest slot
 		};
 
-		typedef xpcc::LinkedList< SendListItem > SendList;
-		typedef xpcc::LinkedList< ReceiveListItem > ReceiveList;
+		static constexpr std::size_t reassemblySlots = XPCC__CAN_REASSEMBLY_SLOTS;
+		static_assert((reassemblySlots & (reassemblySlots - 1)) == 0 && reassemblySlots > 0,
+				"XPCC__CAN_REASSEMBLY_SLOTS must be a power of two!");
+
+		/// Find the slot of a fragmented packet or allocate a new one
+		ReassemblySlot&
+		getReassemblySlot(const Header& header, uint8_t counter,
+				uint8_t messageSize);
+
+		typedef xpcc::BoundedDeque< ReceiveListItem, XPCC__CAN_RECEIVE_QUEUE_SIZE > ReceiveList;
 
 	protected:
-		SendList sendList;
-		ReceiveList pendingMessages;
 		ReceiveList receivedMessages;
 
+		ReassemblySlot reassembly[reassemblySlots];
+		uint8_t reassemblySequence;
+
 		Driver *canDriver;
 	};
 }
@@ -38,7 +38,7 @@
 // ----------------------------------------------------------------------------
 template<typename Driver>
 xpcc::CanConnector<Driver>::CanConnector(Driver *driver) :
-	canDriver(driver)
+	reassembly(), reassemblySequence(0), canDriver(driver)
 {
 }
 
@@ -66,7 +66,12 @@ template<typename Driver>
 const xpcc::SmartPointer
 xpcc::CanConnector<Driver>::getPacketPayload() const
 {
-	return this->receivedMessages.getFront().payload;
+	const ReceiveListItem& item = this->receivedMessages.getFront();
+	if (item.acknowledges > 0) {
+		// the payload of a coalesced ACK is not part of the packets
+		return SmartPointer();
+	}
+	return item.payload;
 }
 
 // ----------------------------------------------------------------------------
@@ -76,19 +81,41 @@ xpcc::CanConnector<Driver>::sendPacket(const Header &header, SmartPointer payloa
 {
 	bool successful = false;
 	bool fragmented = (payload.getSize() > 8);
+	uint8_t priority = this->getPriority(header);
 
 	uint32_t identifier = convertToIdentifier(header, fragmented);
-	if (!fragmented && this->canDriver->isReadyToSend())
+	if (this->acknowledgeCoalescing)
+	{
+		identifier |= XPCC_CAN_PACKET_COALESCED;
+		if (header.isAcknowledge && payload.getSize() == 0 &&
+				this->isCoalescingPeer(header.destination) &&
+				this->collectAcknowledge(identifier)) {
+			// sent with the next update()
+			return;
+		}
+	}
+
+	if (!fragmented && !this->isSendItemWaiting(priority) &&
+			this->canDriver->isReadyToSend())
 	{
-		// try to send the message directly
+		// try to send the message directly, nothing with the same or a
+		// higher priority is waiting
 		successful = this->sendMessage(identifier,
 				payload.getPointer(), payload.getSize());
+		if (successful) {
+			this->countTransmittedPacket(priority);
+		}
 	}
 
 	if (!successful)
 	{
-		// append the message to the list of waiting messages
-		this->sendList.append(SendListItem(identifier, payload));
+		// append the message to the list of waiting messages, the
+		// message counter is assigned now so that it stays the same
+		// for all fragments
+		if (this->appendSendItem(priority, identifier, payload,
+				this->messageCounter) && fragmented) {
+			this->messageCounter += 0x10;
+		}
 	}
 }
 
@@ -97,6 +124,18 @@ template<typename Driver>
 void
 xpcc::CanConnector<Driver>::dropPacket()
 {
+	ReceiveListItem& item = this->receivedMessages.getFront();
+	if (item.acknowledges > 1)
+	{
+		// continue with the next ACK of a coalesced ACK
+		item.acknowledges--;
+		item.header.packetIdentifier =
+				item.payload.getPointer()[item.payload.getSize() - item.acknowledges];
+		return;
+	}
+
+	// release the payload, the deque does not destroy removed items
+	item.payload = SmartPointer();
 	this->receivedMessages.removeFront();
 }
 
@@ -106,9 +145,33 @@ void
 xpcc::CanConnector<Driver>::update()
 {
 	this->checkAndReceiveMessages();
+	this->sendCollectedAcknowledges();
 	this->sendWaitingMessages();
 }
 
+// ----------------------------------------------------------------------------
+template<typename Driver>
+uint8_t
+xpcc::CanConnector<Driver>::setFilters(
+		const uint8_t *components, uint8_t numberOfComponents,
+		const uint8_t *events, uint8_t numberOfEvents)
+{
+	static_assert(Driver::numberOfFilters > 0, "The driver has no acceptance filters!");
+
+	Can::Filter filters[Driver::numberOfFilters];
+	uint8_t available = this->canDriver->getNumberOfFilters();
+	if (available > Driver::numberOfFilters) {
+		available = Driver::numberOfFilters;
+	}
+	uint8_t count = calculateFilters(components, numberOfComponents,
+			events, numberOfEvents, filters, available);
+
+	if (!this->canDriver->setFilters(filters, count)) {
+		return 0;
+	}
+	return count;
+}
+
 // ----------------------------------------------------------------------------
 // protected
 // ----------------------------------------------------------------------------
@@ -126,65 +189,99 @@ xpcc::CanConnector<Driver>::sendMessage(const uint32_t & identifier,
 	return this->canDriver->sendMessage(message);
 }
 
+template<typename Driver>
+bool
+xpcc::CanConnector<Driver>::sendFragment(const uint32_t & identifier,
+		const SmartPointer& payload, uint8_t fragmentIndex, uint8_t counter)
+{
+	uint8_t offset = fragmentIndex * 6;
+	uint8_t fragmentSize = payload.getSize() - offset;
+	if (fragmentSize > 6) {
+		fragmentSize = 6;
+	}
+
+	// the fragment is assembled directly in the message handed to the
+	// driver
+	xpcc::can::Message message(identifier, fragmentSize + 2);
+	message.data[0] = fragmentIndex | counter;
+	message.data[1] = payload.getSize(); 	// size of the complete message
+	std::memcpy(message.data + 2, payload.getPointer() + offset, fragmentSize);
+
+	return this->canDriver->sendMessage(message);
+}
+
 template<typename Driver>
 void
 xpcc::CanConnector<Driver>::sendWaitingMessages()
 {
-	if (this->sendList.isEmpty()) {
+	uint8_t priority;
+	SendListItem *message = this->getSendItem(priority);
+	if (message == nullptr) {
 		// no message in the queue
 		return;
 	}
 	else if (canDriver->getBusState() != Driver::BusState::Connected) {
 		// No connection to the CAN bus, drop all messages which should be send
-		while (!sendList.isEmpty()) {
-			sendList.removeFront();
-		}
+		this->clearSendItems();
+		return;
+	}
+	else if (!this->canDriver->isReadyToSend()) {
 		return;
 	}
 
-	SendListItem& message = this->sendList.getFront();
-
-	uint8_t messageSize = message.payload.getSize();
+	bool sendFinished;
+	uint8_t messageSize = message->payload.getSize();
 	if (messageSize > 8)
 	{
 		// fragmented message
-		uint8_t data[8];
-
-		data[0] = message.fragmentIndex | (this->messageCounter & 0xf0);
-		data[1] = messageSize; 	// size of the complete message
-
-		bool sendFinished = true;
-		uint8_t offset = message.fragmentIndex * 6;
-		uint8_t fragmentSize = messageSize - offset;
-		if (fragmentSize > 6)
+		sendFinished = false;
+		if (this->sendFragment(message->identifier, message->payload,
+				message->fragmentIndex, message->counter))
 		{
-			fragmentSize = 6;
-			sendFinished = false;
+			message->fragmentIndex++;
+			// the last fragment was sent
+			sendFinished = (message->fragmentIndex * 6 >= messageSize);
 		}
-		// otherwise fragmentSize is smaller or equal to six, so the last
-		// fragment is about to be sent.
+	}
+	else
+	{
+		sendFinished = this->sendMessage(message->identifier,
+				message->payload.getPointer(), messageSize);
+	}
 
-		memcpy(data + 2, message.payload.getPointer() + offset, fragmentSize);
+	if (sendFinished) {
+		this->removeSendItem(priority);
+	}
+}
+
+template<typename Driver>
+void
+xpcc::CanConnector<Driver>::sendCollectedAcknowledges()
+{
+	for (AcknowledgeSlot& slot : this->acknowledgeSlot)
+	{
+		if (slot.count == 0) {
+			continue;
+		}
 
-		if (sendMessage(message.identifier, data, fragmentSize + 2))
+		// ACKs have the highest priority, waiting ones are sent first
+		bool successful = false;
+		if (!this->isSendItemWaiting(0) && this->canDriver->isReadyToSend())
 		{
-			message.fragmentIndex++;
-			if (sendFinished)
-			{
-				// message was the last fragment
-				// => remove it from the list
-				this->sendList.removeFront();
-				this->messageCounter += 0x10;
+			successful = this->sendMessage(slot.identifier,
+					slot.packetIdentifiers, slot.count - 1);
+			if (successful) {
+				this->countTransmittedPacket(0);
 			}
 		}
-	}
-	else
-	{
-		if (this->sendMessage(message.identifier, message.payload.getPointer(),
-				messageSize))
+
+		if (!successful)
 		{
-			this->sendList.removeFront();
+			SmartPointer payload(slot.count - 1);
+			std::memcpy(payload.getPointer(), slot.packetIdentifiers, slot.count - 1);
+			this->appendSendItem(0, slot.identifier, payload, 0);
 		}
+		slot.count = 0;
 	}
 }
 
@@ -198,12 +295,20 @@ xpcc::CanConnector<Driver>::retrieveMessage()
 		xpcc::Header header;
 		bool isFragment = convertToHeader(message.identifier, header);
 
+		const bool coalesced = (message.identifier & XPCC_CAN_PACKET_COALESCED);
+		if (coalesced) {
+			this->setCoalescingPeer(header.source);
+		}
+
 		if (!isFragment)
 		{
-			this->receivedMessages.append(ReceiveListItem(message.length, header));
-			std::memcpy(this->receivedMessages.getBack().payload.getPointer(),
-					message.data,
-					message.length);
+			ReceiveListItem item = { header, SmartPointer(message.length), 0 };
+			std::memcpy(item.payload.getPointer(), message.data, message.length);
+			if (coalesced && header.isAcknowledge && message.length > 0) {
+				// the data bytes are the packet identifiers of further ACKs
+				item.acknowledges = message.length + 1;
+			}
+			this->receivedMessages.append(item);
 		}
 		else
 		{
@@ -244,46 +349,32 @@ xpcc::CanConnector<Driver>::retrieveMessage()
 				return false;
 			}
 
-			// Check if other parts of this message are already in the
-			// list of receiving messages.
-			typename ReceiveList::iterator packet = this->pendingMessages.begin();
-			for ( ; packet != this->pendingMessages.end(); ++packet)
-			{
-				if (packet->header == header &&
-					packet->counter == counter)
-				{
-					break;
-				}
-			}
-
-			if (packet == this->pendingMessages.end()) {
-				// message not found => first part of this message,
-				// prepend it to the list
-				this->pendingMessages.prepend(ReceiveListItem(messageSize, header, counter));
-				packet = this->pendingMessages.begin();
-			}
+			ReassemblySlot& slot = this->getReassemblySlot(header, counter, messageSize);
 
 			// create a marker for the currently received fragment and
 			// test if the fragment was already received
 			const uint8_t currentFragment = (1 << fragmentIndex);
-			if (currentFragment & packet->receivedFragments)
+			if (currentFragment & slot.receivedFragments)
 			{
 				// error: received fragment twice -> most likely a new message -> delete the old one
 				//XPCC_LOG_WARNING << "lost fragment" << xpcc::flush;
-				packet->receivedFragments = 0;
+				slot.receivedFragments = 0;
 			}
-			packet->receivedFragments |= currentFragment;
+			slot.receivedFragments |= currentFragment;
 
-			std::memcpy(packet->payload.getPointer() + offset,
+			std::memcpy(slot.payload.getPointer() + offset,
 					message.data + 2,
 					message.length - 2);
 
 			// test if this was the last segment, otherwise we have to wait
 			// for more messages
-			if (xpcc::bitCount(packet->receivedFragments) == numberOfFragments)
+			if (xpcc::bitCount(slot.receivedFragments) == numberOfFragments)
 			{
-				this->receivedMessages.append(*packet);
-				this->pendingMessages.remove(packet);
+				ReceiveListItem item = { slot.header, slot.payload, 0 };
+				this->receivedMessages.append(item);
+
+				slot.payload = SmartPointer();
+				slot.receivedFragments = 0;
 			}
 		}
 
@@ -294,11 +385,64 @@ xpcc::CanConnector<Driver>::retrieveMessage()
 	}
 }
 
+template<typename Driver>
+typename xpcc::CanConnector<Driver>::ReassemblySlot&
+xpcc::CanConnector<Driver>::getReassemblySlot(const Header& header,
+		uint8_t counter, uint8_t messageSize)
+{
+	// Fragments of one packet always start searching at the same slot.
+	// Usually only one packet per source is reassembled at a time, so
+	// the first slot is already the right one.
+	const std::size_t start = (header.source ^ header.packetIdentifier ^
+			(counter >> 4)) & (reassemblySlots - 1);
+
+	ReassemblySlot *freeSlot = nullptr;
+	ReassemblySlot *oldestSlot = nullptr;
+	for (std::size_t ii = 0; ii < reassemblySlots; ++ii)
+	{
+		ReassemblySlot& slot = this->reassembly[(start + ii) & (reassemblySlots - 1)];
+		if (slot.receivedFragments == 0)
+		{
+			if (freeSlot == nullptr) {
+				freeSlot = &slot;
+			}
+		}
+		else if (slot.counter == counter && slot.header == header)
+		{
+			if (slot.payload.getSize() == messageSize) {
+				return slot;
+			}
+			// same packet with a different size, start again
+			freeSlot = &slot;
+			break;
+		}
+		else if (oldestSlot == nullptr ||
+				uint8_t(this->reassemblySequence - slot.sequence) >
+				uint8_t(this->reassemblySequence - oldestSlot->sequence))
+		{
+			oldestSlot = &slot;
+		}
+	}
+
+	// if all slots are in use the oldest packet is discarded
+	ReassemblySlot& slot = (freeSlot != nullptr) ? *freeSlot : *oldestSlot;
+	slot.header = header;
+	slot.counter = counter;
+	slot.receivedFragments = 0;
+	slot.sequence = this->reassemblySequence++;
+	if (slot.payload.getSize() != messageSize) {
+		slot.payload = SmartPointer(messageSize);
+	}
+	return slot;
+}
+
 template<typename Driver>
 void
 xpcc::CanConnector<Driver>::checkAndReceiveMessages()
 {
-	while (this->canDriver->isMessageAvailable()) {
+	// messages are left in the driver until there is space to store them
+	while (!this->receivedMessages.isFull() &&
+			this->canDriver->isMessageAvailable()) {
 		this->retrieveMessage();
 	}
 }
@@ -131,3 +131,136 @@ CanConnectorBaseTest::testConversionToHeader()
 	TEST_ASSERT_FALSE(connector.convertToHeader(identifier, header));
 	TEST_ASSERT_EQUALS(header, xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 0, 0x0a));
 }
+
+// ----------------------------------------------------------------------------
+namespace
+{
+	uint8_t
+	actionPriority(uint8_t component, uint8_t action)
+	{
+		return (component == 0x12 && action == 0x01) ? 0 : 2;
+	}
+
+	uint8_t
+	eventPriority(uint8_t event)
+	{
+		return (event == 0x05) ? 0 : 7;
+	}
+}
+
+void
+CanConnectorBaseTest::testPriority()
+{
+	xpcc::CanConnectorBase connector;
+
+	// without priority functions all packets have the normal priority
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x01);
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 1);
+
+	connector.setPriorityFunctions(actionPriority, eventPriority);
+
+	// action call
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 0);
+	header.packetIdentifier = 0x02;
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 2);
+
+	// acknowledges always have the highest priority
+	header.isAcknowledge = true;
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 0);
+
+	// responses use the priority of the action of the source
+	header = xpcc::Header(xpcc::Header::Type::RESPONSE, false, 0x34, 0x12, 0x01);
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 0);
+	header.type = xpcc::Header::Type::NEGATIVE_RESPONSE;
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 0);
+
+	// events, invalid classes are mapped to the lowest priority
+	header = xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x34, 0x05);
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 0);
+	header.packetIdentifier = 0x06;
+	TEST_ASSERT_EQUALS(connector.getPriority(header), 2);
+}
+
+// ----------------------------------------------------------------------------
+static bool
+isAccepted(const xpcc::Can::Filter *filters, uint8_t count, const xpcc::Header& header)
+{
+	uint32_t identifier = xpcc::CanConnectorBase::convertToIdentifier(header, false);
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		if (filters[i].matches(identifier)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+CanConnectorBaseTest::testFilters()
+{
+	const uint8_t components[] = { 0x10, 0x11, 0x20 };
+	const uint8_t events[] = { 0x80, 0x81 };
+	xpcc::Can::Filter filters[4];
+
+	uint8_t count = xpcc::CanConnectorBase::calculateFilters(
+			components, 3, events, 2, filters, 4);
+
+	// neighbouring identifiers share a filter
+	TEST_ASSERT_EQUALS(count, 3);
+	TEST_ASSERT_EQUALS(filters[0].identifier, 0x00100000U);
+	TEST_ASSERT_EQUALS(filters[0].mask, 0x00fe0000U);
+	TEST_ASSERT_EQUALS(filters[1].identifier, 0x00200000U);
+	TEST_ASSERT_EQUALS(filters[1].mask, 0x00ff0000U);
+	TEST_ASSERT_EQUALS(filters[2].identifier, 0x00000080U);
+	TEST_ASSERT_EQUALS(filters[2].mask, 0x18ff00feU);
+
+	// requests, responses and acknowledges for the components
+	TEST_ASSERT_TRUE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x11, 0x30, 0x05)));
+	TEST_ASSERT_TRUE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::NEGATIVE_RESPONSE, false, 0x20, 0x30, 0x05)));
+	TEST_ASSERT_TRUE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::RESPONSE, true, 0x10, 0x30, 0x05)));
+	TEST_ASSERT_FALSE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x10, 0x05)));
+
+	// subscribed events only
+	TEST_ASSERT_TRUE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x30, 0x81)));
+	TEST_ASSERT_FALSE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x30, 0x82)));
+
+	// without hardware filters everything has to be received
+	TEST_ASSERT_EQUALS(xpcc::CanConnectorBase::calculateFilters(
+			components, 3, events, 2, filters, 0), 0);
+}
+
+void
+CanConnectorBaseTest::testFiltersMerged()
+{
+	const uint8_t components[] = { 0x10, 0x11, 0x20 };
+	const uint8_t events[] = { 0x80, 0x81, 0x84, 0x90 };
+	xpcc::Can::Filter filters[2];
+
+	uint8_t count = xpcc::CanConnectorBase::calculateFilters(
+			components, 3, events, 4, filters, 2);
+
+	TEST_ASSERT_EQUALS(count, 2);
+
+	for (uint8_t component : components)
+	{
+		TEST_ASSERT_TRUE(isAccepted(filters, count,
+				xpcc::Header(xpcc::Header::Type::REQUEST, false, component, 0x30, 0x05)));
+	}
+	for (uint8_t event : events)
+	{
+		TEST_ASSERT_TRUE(isAccepted(filters, count,
+				xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x30, event)));
+	}
+
+	// the filters still reject most of the traffic
+	TEST_ASSERT_FALSE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x30, 0x10, 0x05)));
+	TEST_ASSERT_FALSE(isAccepted(filters, count,
+			xpcc::Header(xpcc::Header::Type::RESPONSE, false, 0x42, 0x10, 0x05)));
+}
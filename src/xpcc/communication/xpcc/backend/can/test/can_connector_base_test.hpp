@@ -41,6 +41,15 @@ public:
 	
 	void
 	testConversionToHeader();
+	
+	void
+	testPriority();
+
+	void
+	testFilters();
+
+	void
+	testFiltersMerged();
 };
 
 #endif // CAN_CONNECTOR_BASE_TEST_HPP
@@ -176,6 +176,96 @@ CanConnectorTest::testSendFragmentedMessage()
 	TEST_ASSERT_EQUALS(connector->messageCounter, 0x40);
 }
 
+namespace
+{
+	uint8_t
+	actionPriority(uint8_t /* component */, uint8_t /* action */)
+	{
+		return 2;
+	}
+
+	uint8_t
+	eventPriority(uint8_t /* event */)
+	{
+		return 0;
+	}
+}
+
+void
+CanConnectorTest::testSendPriority()
+{
+	connector->setPriorityFunctions(actionPriority, eventPriority);
+	this->messageCounter = connector->messageCounter = 0x30;
+
+	// action call with low priority
+	xpcc::SmartPointer payload(&fragmentedPayload);
+	connector->sendPacket(xpccHeader, payload);
+
+	driver->sendSlots = 1;
+	connector->update();
+	checkFragmentedMessage(driver->sendList.getFront(), 0);
+	driver->sendList.removeFront();
+
+	// an event is sent between the fragments
+	xpcc::Header event(xpcc::Header::Type::REQUEST, false, 0x00, 0x34, 0x56);
+	connector->sendPacket(event, xpcc::SmartPointer(&shortPayload));
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 0U);
+	TEST_ASSERT_EQUALS(connector->getStatistics(0).queueDepth, 1U);
+	TEST_ASSERT_EQUALS(connector->getStatistics(2).queueDepth, 1U);
+
+	driver->sendSlots = 1;
+	connector->update();
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().identifier, 0x00003456U);
+	driver->sendList.removeFront();
+
+	// the remaining fragments follow
+	driver->sendSlots = 2;
+	connector->update();
+	connector->update();
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 2U);
+	checkFragmentedMessage(driver->sendList.getFront(), 1);
+	driver->sendList.removeFront();
+	checkFragmentedMessage(driver->sendList.getFront(), 2);
+	driver->sendList.removeFront();
+
+	TEST_ASSERT_EQUALS(connector->getStatistics(0).transmittedPackets, 1U);
+	TEST_ASSERT_EQUALS(connector->getStatistics(0).queueDepth, 0U);
+	TEST_ASSERT_EQUALS(connector->getStatistics(2).transmittedPackets, 1U);
+	TEST_ASSERT_EQUALS(connector->getStatistics(2).queueDepth, 0U);
+	TEST_ASSERT_EQUALS(connector->getStatistics(2).maxQueueDepth, 1U);
+
+	// a short packet is sent directly if nothing with a higher or the
+	// same priority is waiting
+	connector->sendPacket(xpccHeader, payload);
+	driver->sendSlots = 1;
+	connector->sendPacket(event, xpcc::SmartPointer(&shortPayload));
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 1U);
+	TEST_ASSERT_EQUALS(connector->getStatistics(0).transmittedPackets, 2U);
+}
+
+void
+CanConnectorTest::testSendQueueFull()
+{
+	xpcc::SmartPointer payload(&shortPayload);
+	const uint16_t size = XPCC__CAN_SEND_QUEUE_SIZE;
+	for (uint8_t i = 0; i < size + 1; ++i) {
+		connector->sendPacket(xpccHeader, payload);
+	}
+	TEST_ASSERT_EQUALS(connector->getStatistics(1).queueDepth, size);
+	TEST_ASSERT_EQUALS(connector->getStatistics(1).droppedPackets, 1U);
+
+	driver->sendSlots = 255;
+	for (uint8_t i = 0; i < size + 1; ++i) {
+		connector->update();
+	}
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), size);
+	TEST_ASSERT_EQUALS(connector->getStatistics(1).transmittedPackets, size);
+
+	// the queue can be used again
+	connector->sendPacket(xpccHeader, payload);
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), size + 1U);
+}
+
 void
 CanConnectorTest::testReceiveShortMessage()
 {
@@ -274,3 +364,300 @@ CanConnectorTest::testReceiveFragmentedMessage()
 	
 	TEST_ASSERT_FALSE(connector->isPacketAvailable());
 }
+
+void
+CanConnectorTest::testReceiveInterleavedFragmentedMessages()
+{
+	// fragments of the same packet from two different sources
+	this->messageCounter = 0x20;
+	xpcc::can::Message first[3];
+	xpcc::can::Message second[3];
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		createMessage(first[i], i);
+		createMessage(second[i], i);
+		second[i].identifier = fragmentedIdentifier + 0x100;	// source 0x35
+	}
+
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		driver->receiveList.append(first[i]);
+		driver->receiveList.append(second[i]);
+	}
+	connector->update();
+
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getPacketHeader(), xpccHeader);
+	TEST_ASSERT_EQUALS_ARRAY(
+			connector->getPacketPayload().getPointer(),
+			fragmentedPayload,
+			sizeof(fragmentedPayload));
+	connector->dropPacket();
+
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getPacketHeader().source, 0x35);
+	TEST_ASSERT_EQUALS_ARRAY(
+			connector->getPacketPayload().getPointer(),
+			fragmentedPayload,
+			sizeof(fragmentedPayload));
+	connector->dropPacket();
+
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+}
+
+void
+CanConnectorTest::testReceiveEvictsOldestFragmentedMessage()
+{
+	xpcc::can::Message message;
+
+	// start more fragmented packets than can be reassembled at once
+	for (uint8_t i = 0; i <= XPCC__CAN_REASSEMBLY_SLOTS; ++i)
+	{
+		this->messageCounter = i << 4;
+		createMessage(message, 0);
+		driver->receiveList.append(message);
+		createMessage(message, 1);
+		driver->receiveList.append(message);
+	}
+	connector->update();
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+
+	// the others are still complete
+	for (uint8_t i = 1; i <= XPCC__CAN_REASSEMBLY_SLOTS; ++i)
+	{
+		this->messageCounter = i << 4;
+		createMessage(message, 2);
+		driver->receiveList.append(message);
+		connector->update();
+
+		TEST_ASSERT_TRUE(connector->isPacketAvailable());
+		TEST_ASSERT_EQUALS_ARRAY(
+				connector->getPacketPayload().getPointer(),
+				fragmentedPayload,
+				sizeof(fragmentedPayload));
+		connector->dropPacket();
+	}
+
+	// the first packet was discarded
+	this->messageCounter = 0x00;
+	createMessage(message, 2);
+	driver->receiveList.append(message);
+	connector->update();
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+}
+
+void
+CanConnectorTest::testReceiveQueueFull()
+{
+	xpcc::can::Message message(normalIdentifier, 8);
+	memcpy(&message.data, shortPayload, 8);
+
+	for (uint8_t i = 0; i < XPCC__CAN_RECEIVE_QUEUE_SIZE + 2; ++i) {
+		driver->receiveList.append(message);
+	}
+
+	// messages which don't fit into the queue are left in the driver
+	connector->update();
+	TEST_ASSERT_EQUALS(driver->receiveList.getSize(), 2U);
+
+	for (uint8_t i = 0; i < XPCC__CAN_RECEIVE_QUEUE_SIZE; ++i)
+	{
+		TEST_ASSERT_TRUE(connector->isPacketAvailable());
+		connector->dropPacket();
+	}
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+
+	connector->update();
+	TEST_ASSERT_EQUALS(driver->receiveList.getSize(), 0U);
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+}
+
+void
+CanConnectorTest::testReceiveFiltered()
+{
+	const uint8_t components[] = { 0x10, 0x11 };
+	const uint8_t events[] = { 0x80 };
+
+	TEST_ASSERT_EQUALS(connector->setFilters(components, 2, events, 1), 2);
+	TEST_ASSERT_EQUALS(driver->filterCount, 2);
+
+	const xpcc::Header headers[] = {
+		xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x11, 0x20, 0x01),	// accepted
+		xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x20, 0x01),
+		xpcc::Header(xpcc::Header::Type::RESPONSE, false, 0x20, 0x10, 0x01),
+		xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x20, 0x81),
+		xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x20, 0x80),	// accepted
+	};
+	for (const xpcc::Header& header : headers)
+	{
+		xpcc::can::Message message(
+				xpcc::CanConnectorBase::convertToIdentifier(header, false), 1);
+		driver->receiveList.append(message);
+	}
+
+	connector->update();
+
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getPacketHeader(), headers[0]);
+	connector->dropPacket();
+
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getPacketHeader(), headers[4]);
+	connector->dropPacket();
+
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(driver->filteredMessages, 3);
+}
+
+void
+CanConnectorTest::testReceiveFilteredSharedBanks()
+{
+	const uint8_t components[] = { 0x10, 0x11 };
+	const uint8_t events[] = { 0x80 };
+
+	// the filters are merged instead of dropped
+	driver->availableFilters = 1;
+	TEST_ASSERT_EQUALS(connector->setFilters(components, 2, events, 1), 1);
+	TEST_ASSERT_EQUALS(driver->filterCount, 1);
+
+	const xpcc::Header headers[] = {
+		xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x11, 0x20, 0x01),
+		xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x00, 0x20, 0x80),
+	};
+	for (const xpcc::Header& header : headers)
+	{
+		xpcc::can::Message message(
+				xpcc::CanConnectorBase::convertToIdentifier(header, false), 1);
+		driver->receiveList.append(message);
+	}
+
+	connector->update();
+
+	for (const xpcc::Header& header : headers)
+	{
+		TEST_ASSERT_TRUE(connector->isPacketAvailable());
+		TEST_ASSERT_EQUALS(connector->getPacketHeader(), header);
+		connector->dropPacket();
+	}
+
+	// too many filters are rejected by the driver
+	const xpcc::Can::Filter filters[2] = { { 0, 0 }, { 0, 0 } };
+	TEST_ASSERT_FALSE(driver->setFilters(filters, 2));
+	TEST_ASSERT_EQUALS(driver->filterCount, 1);
+}
+
+// ----------------------------------------------------------------------------
+void
+CanConnectorTest::testSendCoalescedAcknowledges()
+{
+	connector->setAcknowledgeCoalescing(true);
+	driver->sendSlots = 20;
+	
+	// the peer has not announced coalescing yet, one message per ACK
+	for (uint8_t i = 0; i < 3; ++i) {
+		connector->sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, true,
+				0x34, 0x12, 0x40 + i), xpcc::SmartPointer());
+	}
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 3U);
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().getIdentifier(),
+			0x04341240 | XPCC_CAN_PACKET_COALESCED);
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().getLength(), 0);
+	driver->sendList.removeAll();
+	
+	// any message with the flag announces the peer
+	xpcc::can::Message message(0x00123440 | XPCC_CAN_PACKET_COALESCED, 0);
+	driver->receiveList.append(message);
+	TEST_ASSERT_FALSE(connector->isCoalescingPeer(0x34));
+	connector->update();
+	TEST_ASSERT_TRUE(connector->isCoalescingPeer(0x34));
+	TEST_ASSERT_FALSE(connector->isCoalescingPeer(0x12));
+	connector->dropPacket();
+	
+	// ten ACKs to the peer from two components, one to another component
+	for (uint8_t i = 0; i < 9; ++i) {
+		connector->sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, true,
+				0x34, 0x12, 0x40 + i), xpcc::SmartPointer());
+	}
+	connector->sendPacket(xpcc::Header(xpcc::Header::Type::RESPONSE, true,
+			0x34, 0x13, 0x50), xpcc::SmartPointer());
+	connector->sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, true,
+			0x35, 0x12, 0x60), xpcc::SmartPointer());
+	
+	// all slots are in use, sent on its own
+	connector->sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, true,
+			0x34, 0x14, 0x70), xpcc::SmartPointer());
+	
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 2U);
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().getIdentifier(),
+			0x04351260 | XPCC_CAN_PACKET_COALESCED);
+	TEST_ASSERT_EQUALS(driver->sendList.getBack().getIdentifier(),
+			0x04341470 | XPCC_CAN_PACKET_COALESCED);
+	driver->sendList.removeAll();
+	
+	connector->update();
+	
+	// 10 ACKs in 2 messages
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 2U);
+	const uint8_t packetIdentifiers[] = { 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48 };
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().getIdentifier(),
+			0x04341240 | XPCC_CAN_PACKET_COALESCED);
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().getLength(), 8);
+	TEST_ASSERT_EQUALS_ARRAY(driver->sendList.getFront().data, packetIdentifiers, 8);
+	TEST_ASSERT_EQUALS(driver->sendList.getBack().getIdentifier(),
+			0x0c341350 | XPCC_CAN_PACKET_COALESCED);
+	TEST_ASSERT_EQUALS(driver->sendList.getBack().getLength(), 0);
+	driver->sendList.removeAll();
+	
+	// without a free driver slot the ACKs are queued
+	driver->sendSlots = 0;
+	connector->sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, true,
+			0x34, 0x12, 0x40), xpcc::SmartPointer());
+	connector->sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, true,
+			0x34, 0x12, 0x41), xpcc::SmartPointer());
+	connector->update();
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 0U);
+	
+	driver->sendSlots = 1;
+	connector->update();
+	TEST_ASSERT_EQUALS(driver->sendList.getSize(), 1U);
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().getLength(), 1);
+	TEST_ASSERT_EQUALS(driver->sendList.getFront().data[0], 0x41);
+}
+
+void
+CanConnectorTest::testReceiveCoalescedAcknowledges()
+{
+	const xpcc::Header header(xpcc::Header::Type::REQUEST, true, 0x12, 0x34, 0x40);
+	xpcc::can::Message message(
+			xpcc::CanConnectorBase::convertToIdentifier(header, false) |
+			XPCC_CAN_PACKET_COALESCED, 3);
+	message.data[0] = 0x41;
+	message.data[1] = 0x42;
+	message.data[2] = 0x45;
+	driver->receiveList.append(message);
+	
+	// a normal message afterwards
+	message = xpcc::can::Message(normalIdentifier, 8);
+	memcpy(&message.data, shortPayload, 8);
+	driver->receiveList.append(message);
+	
+	connector->update();
+	
+	const uint8_t packetIdentifiers[] = { 0x40, 0x41, 0x42, 0x45 };
+	for (uint8_t packetIdentifier : packetIdentifiers)
+	{
+		TEST_ASSERT_TRUE(connector->isPacketAvailable());
+		TEST_ASSERT_EQUALS(connector->getPacketHeader(),
+				xpcc::Header(xpcc::Header::Type::REQUEST, true, 0x12, 0x34, packetIdentifier));
+		TEST_ASSERT_EQUALS(connector->getPacketPayload().getSize(), 0U);
+		connector->dropPacket();
+	}
+	
+	TEST_ASSERT_TRUE(connector->isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector->getPacketHeader(), xpccHeader);
+	TEST_ASSERT_EQUALS(connector->getPacketPayload().getSize(), 8U);
+	connector->dropPacket();
+	
+	TEST_ASSERT_FALSE(connector->isPacketAvailable());
+	TEST_ASSERT_TRUE(connector->isCoalescingPeer(0x34));
+}
@@ -69,12 +69,40 @@ public:
     void
     testSendFragmentedMessage();
     
+    void
+    testSendPriority();
+    
+    void
+    testSendQueueFull();
+    
     void
     testReceiveShortMessage();
     
     void
     testReceiveFragmentedMessage();
     
+    void
+    testReceiveInterleavedFragmentedMessages();
+    
+    void
+    testReceiveEvictsOldestFragmentedMessage();
+    
+    void
+    testReceiveQueueFull();
+
+    void
+    testReceiveFiltered();
+    
+    /// Fewer filter banks available than the driver supports at most
+    void
+    testReceiveFilteredSharedBanks();
+    
+    void
+    testSendCoalescedAcknowledges();
+    
+    void
+    testReceiveCoalescedAcknowledges();
+    
 private:
 	TestingCanConnector *connector;
 	FakeCanDriver *driver;
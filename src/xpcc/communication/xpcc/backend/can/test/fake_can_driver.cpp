@@ -31,14 +31,29 @@
 #include "fake_can_driver.hpp"
 
 FakeCanDriver::FakeCanDriver() :
-	sendSlots(0)
+	sendSlots(0), filterCount(0), availableFilters(numberOfFilters),
+	filteredMessages(0)
 {
 }
 
 bool
 FakeCanDriver::isMessageAvailable()
 {
-	return (not receiveList.isEmpty());
+	// drop the messages the hardware filters would not accept
+	while (not receiveList.isEmpty())
+	{
+		const uint32_t identifier = receiveList.getFront().getIdentifier();
+		bool accepted = (filterCount == 0);
+		for (uint8_t i = 0; i < filterCount; ++i) {
+			accepted = accepted or filters[i].matches(identifier);
+		}
+		if (accepted) {
+			return true;
+		}
+		receiveList.removeFront();
+		filteredMessages++;
+	}
+	return false;
 }
 
 bool
@@ -93,3 +108,22 @@ FakeCanDriver::getBusState()
 {
 	return xpcc::Can::BusState::Connected;
 }
+
+uint8_t
+FakeCanDriver::getNumberOfFilters()
+{
+	return this->availableFilters;
+}
+
+bool
+FakeCanDriver::setFilters(const Filter *filters, uint8_t count)
+{
+	if (count > this->availableFilters) {
+		return false;
+	}
+	for (uint8_t i = 0; i < count; ++i) {
+		this->filters[i] = filters[i];
+	}
+	this->filterCount = count;
+	return true;
+}
@@ -59,6 +59,14 @@ public:
 
 	static BusState
 	getBusState();
+
+	static constexpr uint8_t numberOfFilters = 4;
+
+	uint8_t
+	getNumberOfFilters();
+
+	bool
+	setFilters(const Filter *filters, uint8_t count);
 	
 public:
 	/// Messages which should be received
@@ -69,6 +77,16 @@ public:
 	
 	/// number of messages which could be send
 	uint8_t sendSlots;
+
+	/// Acceptance filters, messages not matching are dropped
+	Filter filters[numberOfFilters];
+	uint8_t filterCount;
+
+	/// filter banks not used by another controller
+	uint8_t availableFilters;
+
+	/// number of messages dropped by the filters
+	uint16_t filteredMessages;
 };
 
 #endif	// FAKE_CAN_DRIVER_HPP
@@ -0,0 +1,23 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+/**
+ * \ingroup		backend
+ * \defgroup 	datagram	Datagram Sockets (UDP and Unix Domain Sockets)
+ * \brief 		Backends for hosted targets based on datagram sockets.
+ *
+ * Unlike TIPC no kernel module or configuration is required.
+ * xpcc::UdpConnector uses UDP multicast and works across machines,
+ * xpcc::UnixConnector uses local sockets in a shared directory.
+ *
+ * Several packets are transmitted and received with a single system
+ * call (sendmmsg() and recvmmsg()), which allows simulating a large
+ * number of components on one machine.
+ */
+
+#include "datagram/udp_connector.hpp"
+#include "datagram/unix_connector.hpp"
@@ -0,0 +1,310 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "connector.hpp"
+
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::WARNING
+
+// ----------------------------------------------------------------------------
+xpcc::DatagramConnector::DatagramConnector() :
+	transmitSocket(-1), receiveSocket(-1),
+	receiveCount(0), receiveIndex(0),
+	statistics()
+{
+	this->transmitQueue.reserve(batchSize);
+	this->deferredMessages.reserve(maxDeferredMessages);
+}
+
+xpcc::DatagramConnector::~DatagramConnector()
+{
+	if (this->transmitSocket >= 0) {
+		close(this->transmitSocket);
+	}
+	if (this->receiveSocket >= 0 && this->receiveSocket != this->transmitSocket) {
+		close(this->receiveSocket);
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::DatagramConnector::setSockets(int transmitSocket, int receiveSocket)
+{
+	this->transmitSocket = transmitSocket;
+	this->receiveSocket = receiveSocket;
+}
+
+void
+xpcc::DatagramConnector::destinationFailed(const Address& /* destination */, int error)
+{
+	XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not transmit packet. errno=" << error << xpcc::endl;
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::DatagramConnector::update()
+{
+	if (!this->isOpen()) {
+		return;
+	}
+
+	this->transmit();
+
+	if (this->receiveIndex >= this->receiveCount) {
+		this->receive();
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::DatagramConnector::sendPacket(const Header &header, SmartPointer payload)
+{
+	if (!this->isOpen()) {
+		this->statistics.droppedPackets++;
+		return;
+	}
+
+	if (this->transmitQueue.size() >= batchSize) {
+		this->transmit();
+	}
+
+	Packet packet = { header, payload };
+	this->transmitQueue.push_back(packet);
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::DatagramConnector::isPacketAvailable() const
+{
+	return (this->receiveIndex < this->receiveCount);
+}
+
+const xpcc::Header&
+xpcc::DatagramConnector::getPacketHeader() const
+{
+	return this->receiveHeader[this->receiveOrder[this->receiveIndex]];
+}
+
+const xpcc::SmartPointer
+xpcc::DatagramConnector::getPacketPayload() const
+{
+	uint16_t index = this->receiveOrder[this->receiveIndex];
+
+	SmartPointer payload(this->receivePayloadSize[index]);
+	if (payload.getSize() > 0) {
+		std::memcpy(payload.getPointer(), this->receivePayload[index], payload.getSize());
+	}
+	return payload;
+}
+
+void
+xpcc::DatagramConnector::dropPacket()
+{
+	this->receiveIndex++;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::DatagramConnector::isSameAddress(const Address& a, const Address& b)
+{
+	return (a.length == b.length && std::memcmp(&a.address, &b.address, a.length) == 0);
+}
+
+void
+xpcc::DatagramConnector::transmit()
+{
+	if (this->transmitQueue.empty() && this->deferredMessages.empty()) {
+		return;
+	}
+
+	// Deferred messages go first to keep the order for every destination
+	this->outgoingMessages.clear();
+	this->outgoingMessages.swap(this->deferredMessages);
+	if (!this->transmitQueue.empty())
+	{
+		const std::vector<Address>& destinations = this->getDestinations();
+		for (const Packet& packet : this->transmitQueue)
+		{
+			for (const Address& destination : destinations) {
+				Message message = { packet.header, packet.payload, destination };
+				this->outgoingMessages.push_back(message);
+			}
+		}
+		this->transmitQueue.clear();
+	}
+
+	// Destinations for which sending failed. Following messages to these
+	// destinations are not tried again within this call, as they would
+	// fail for the same reason with one system call each.
+	std::vector< std::pair<Address, int> > blocked;
+
+	mmsghdr messages[batchSize];
+	iovec vectors[batchSize][2];
+	std::size_t index[batchSize];
+
+	std::size_t next = 0;
+	while (next < this->outgoingMessages.size())
+	{
+		std::size_t count = 0;
+		for (; count < batchSize && next < this->outgoingMessages.size(); ++next)
+		{
+			Message& m = this->outgoingMessages[next];
+
+			bool isBlocked = false;
+			for (const auto& entry : blocked)
+			{
+				if (isSameAddress(entry.first, m.destination)) {
+					this->skipMessage(m, entry.second);
+					isBlocked = true;
+					break;
+				}
+			}
+			if (isBlocked) {
+				continue;
+			}
+
+			vectors[count][0].iov_base = &m.header;
+			vectors[count][0].iov_len = sizeof(Header);
+			vectors[count][1].iov_base = m.payload.getPointer();
+			vectors[count][1].iov_len = m.payload.getSize();
+
+			std::memset(&messages[count], 0, sizeof(mmsghdr));
+			messages[count].msg_hdr.msg_name = &m.destination.address;
+			messages[count].msg_hdr.msg_namelen = m.destination.length;
+			messages[count].msg_hdr.msg_iov = vectors[count];
+			messages[count].msg_hdr.msg_iovlen = 2;
+			index[count] = next;
+			count++;
+		}
+
+		std::size_t sent = 0;
+		while (sent < count)
+		{
+			int result = sendmmsg(this->transmitSocket, messages + sent, count - sent, MSG_DONTWAIT);
+			this->statistics.transmitCalls++;
+			if (result >= 0) {
+				this->statistics.transmittedPackets += result;
+				sent += result;
+				continue;
+			}
+			if (errno == EINTR) {
+				continue;
+			}
+
+			// The first remaining message failed. It and the remaining
+			// messages of this batch to the same destination are skipped,
+			// the others are moved up and sent with the next call.
+			const int error = errno;
+			Message& m = this->outgoingMessages[index[sent]];
+			blocked.push_back(std::make_pair(m.destination, error));
+			this->skipMessage(m, error);
+
+			std::size_t kept = sent;
+			for (std::size_t ii = sent + 1; ii < count; ++ii)
+			{
+				Message& other = this->outgoingMessages[index[ii]];
+				if (isSameAddress(other.destination, m.destination)) {
+					this->skipMessage(other, error);
+					continue;
+				}
+				if (kept != ii)
+				{
+					messages[kept] = messages[ii];
+					vectors[kept][0] = vectors[ii][0];
+					vectors[kept][1] = vectors[ii][1];
+					messages[kept].msg_hdr.msg_iov = vectors[kept];
+					index[kept] = index[ii];
+				}
+				kept++;
+			}
+			count = kept;
+		}
+	}
+	this->outgoingMessages.clear();
+
+	for (const auto& entry : blocked)
+	{
+		if (entry.second != EAGAIN && entry.second != EWOULDBLOCK) {
+			this->destinationFailed(entry.first, entry.second);
+		}
+	}
+}
+
+void
+xpcc::DatagramConnector::skipMessage(Message& message, int error)
+{
+	if ((error == EAGAIN || error == EWOULDBLOCK) &&
+		this->deferredMessages.size() < maxDeferredMessages)
+	{
+		// receive buffer of the destination is full, try again later
+		this->deferredMessages.push_back(message);
+		this->statistics.deferredPackets++;
+	}
+	else {
+		this->statistics.droppedPackets++;
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::DatagramConnector::receive()
+{
+	this->receiveCount = 0;
+	this->receiveIndex = 0;
+
+	mmsghdr messages[batchSize];
+	iovec vectors[batchSize][2];
+
+	for (std::size_t ii = 0; ii < batchSize; ++ii)
+	{
+		vectors[ii][0].iov_base = &this->receiveHeader[ii];
+		vectors[ii][0].iov_len = sizeof(Header);
+		vectors[ii][1].iov_base = this->receivePayload[ii];
+		vectors[ii][1].iov_len = maxPayloadSize;
+
+		std::memset(&messages[ii], 0, sizeof(mmsghdr));
+		messages[ii].msg_hdr.msg_name = &this->receiveSource[ii].address;
+		messages[ii].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+		messages[ii].msg_hdr.msg_iov = vectors[ii];
+		messages[ii].msg_hdr.msg_iovlen = 2;
+	}
+
+	int result = recvmmsg(this->receiveSocket, messages, batchSize, MSG_DONTWAIT, nullptr);
+	this->statistics.receiveCalls++;
+	if (result < 0)
+	{
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not receive packets. errno=" << errno << xpcc::endl;
+		}
+		return;
+	}
+
+	for (int ii = 0; ii < result; ++ii)
+	{
+		const msghdr& message = messages[ii].msg_hdr;
+		if (messages[ii].msg_len < sizeof(Header) || (message.msg_flags & MSG_TRUNC)) {
+			this->statistics.droppedPackets++;
+			continue;
+		}
+
+		this->receiveSource[ii].length = message.msg_namelen;
+		if (this->isOwnPacket(this->receiveSource[ii])) {
+			continue;
+		}
+
+		this->receivePayloadSize[ii] = messages[ii].msg_len - sizeof(Header);
+		this->receiveOrder[this->receiveCount++] = ii;
+		this->statistics.receivedPackets++;
+	}
+}
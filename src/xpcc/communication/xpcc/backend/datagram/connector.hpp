@@ -0,0 +1,194 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__DATAGRAM_CONNECTOR_HPP
+#define XPCC__DATAGRAM_CONNECTOR_HPP
+
+#include <vector>
+#include <sys/socket.h>
+
+#include <xpcc/container/smart_pointer.hpp>
+#include <xpcc_config.hpp>
+
+#include "../backend_interface.hpp"
+
+namespace xpcc
+{
+	/**
+	 * \brief	Base class for backends based on datagram sockets
+	 *
+	 * Every packet is transmitted as one datagram containing the
+	 * xpcc::Header followed by the payload. Header and payload are
+	 * gathered respectively scattered directly from and into their
+	 * buffers.
+	 *
+	 * Packets passed to sendPacket() are collected and transmitted with
+	 * a single sendmmsg() call during the next update(), or as soon as
+	 * `XPCC__DATAGRAM_BATCH_SIZE` packets are waiting. Received packets
+	 * are read with recvmmsg() in batches of up to the same size.
+	 *
+	 * If the receive buffer of a destination is full the message to it
+	 * and all following ones are kept and transmitted first during the
+	 * next update(). At most `4 * XPCC__DATAGRAM_BATCH_SIZE` messages are
+	 * kept, further ones are dropped.
+	 *
+	 * Subclasses open the socket and provide the destinations of the
+	 * packets. If the sockets could not be opened isOpen() returns
+	 * `false`, packets passed to sendPacket() are dropped and update()
+	 * does nothing.
+	 *
+	 * \see		UdpConnector
+	 * \see		UnixConnector
+	 *
+	 * \ingroup	datagram
+	 */
+	class DatagramConnector : public BackendInterface
+	{
+	public:
+		virtual
+		~DatagramConnector();
+
+		/// Transmit the collected packets and receive new ones
+		virtual void
+		update();
+
+		/// Check if the sockets could be opened
+		inline bool
+		isOpen() const
+		{
+			return (this->transmitSocket >= 0 && this->receiveSocket >= 0);
+		}
+
+		virtual void
+		sendPacket(const Header &header,
+				SmartPointer payload = SmartPointer());
+
+		virtual bool
+		isPacketAvailable() const;
+
+		virtual const Header&
+		getPacketHeader() const;
+
+		virtual const SmartPointer
+		getPacketPayload() const;
+
+		virtual void
+		dropPacket();
+
+		/// Descriptor of the receiving socket to wait for packets with poll()
+		inline int
+		getFileDescriptor() const
+		{
+			return this->receiveSocket;
+		}
+
+		struct Statistics
+		{
+			uint32_t transmittedPackets;
+			uint32_t transmitCalls;		///< number of sendmmsg() calls
+			uint32_t receivedPackets;
+			uint32_t receiveCalls;		///< number of recvmmsg() calls
+			uint32_t droppedPackets;	///< malformed, too large or not deliverable
+			uint32_t deferredPackets;	///< postponed because the receiver was busy
+		};
+
+		inline const Statistics&
+		getStatistics() const
+		{
+			return this->statistics;
+		}
+
+	protected:
+		static constexpr std::size_t batchSize = XPCC__DATAGRAM_BATCH_SIZE;
+		static constexpr std::size_t maxPayloadSize = XPCC__DATAGRAM_MAX_PAYLOAD_SIZE;
+
+		struct Address
+		{
+			sockaddr_storage address;
+			socklen_t length;
+		};
+
+		static bool
+		isSameAddress(const Address& a, const Address& b);
+
+		DatagramConnector();
+
+		/**
+		 * \brief	Set the sockets used for transmission and reception
+		 *
+		 * Both may be the same socket. The connector takes ownership and
+		 * closes them on destruction. Not called if opening failed, the
+		 * connector stays closed.
+		 */
+		void
+		setSockets(int transmitSocket, int receiveSocket);
+
+		/// Addresses every packet is sent to
+		virtual const std::vector<Address>&
+		getDestinations() = 0;
+
+		/// Check if a received packet was transmitted by this connector
+		virtual bool
+		isOwnPacket(const Address& source) const = 0;
+
+		/**
+		 * \brief	Called when transmitting to a destination failed
+		 *
+		 * Not called for full receive buffers (`EAGAIN`), these messages
+		 * are deferred.
+		 */
+		virtual void
+		destinationFailed(const Address& destination, int error);
+
+	private:
+		void
+		transmit();
+
+		void
+		receive();
+
+		struct Packet
+		{
+			Header header;
+			SmartPointer payload;
+		};
+
+		/// Packet for one destination
+		struct Message
+		{
+			Header header;
+			SmartPointer payload;
+			Address destination;
+		};
+
+		static constexpr std::size_t maxDeferredMessages = 4 * batchSize;
+
+		void
+		skipMessage(Message& message, int error);
+
+		int transmitSocket;
+		int receiveSocket;
+
+		std::vector<Packet> transmitQueue;
+		std::vector<Message> outgoingMessages;
+		std::vector<Message> deferredMessages;
+
+		// receive buffers, filled by recvmmsg()
+		Header receiveHeader[batchSize];
+		uint8_t receivePayload[batchSize][maxPayloadSize];
+		uint16_t receivePayloadSize[batchSize];
+		Address receiveSource[batchSize];
+		uint16_t receiveOrder[batchSize];	///< indices of the valid packets
+		std::size_t receiveCount;
+		std::size_t receiveIndex;
+
+		Statistics statistics;
+	};
+}
+
+#endif	// XPCC__DATAGRAM_CONNECTOR_HPP
@@ -0,0 +1,299 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstring>
+
+#include <xpcc/communication/xpcc/backend/datagram.hpp>
+
+#include "datagram_connector_test.hpp"
+
+namespace
+{
+	const uint8_t payload[] = { 0x12, 0x34, 0x56, 0x78, 0x9a };
+
+	/// Update both connectors until a packet has arrived at the receiver
+	bool
+	waitForPacket(xpcc::DatagramConnector& transmitter,
+			xpcc::DatagramConnector& receiver)
+	{
+		for (int i = 0; i < 100; ++i)
+		{
+			transmitter.update();
+			receiver.update();
+			if (receiver.isPacketAvailable()) {
+				return true;
+			}
+			usleep(1000);
+		}
+		return false;
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+DatagramConnectorTest::setUp()
+{
+	char name[] = "/tmp/xpcc_datagram_XXXXXX";
+	this->directory = mkdtemp(name);
+}
+
+void
+DatagramConnectorTest::tearDown()
+{
+	rmdir(this->directory.c_str());
+}
+
+// ----------------------------------------------------------------------------
+void
+DatagramConnectorTest::testUnixExchange()
+{
+	xpcc::UnixConnector first(this->directory.c_str(), "first");
+	xpcc::UnixConnector second(this->directory.c_str(), "second");
+	TEST_ASSERT_TRUE(first.isOpen());
+	TEST_ASSERT_TRUE(second.isOpen());
+	first.updatePeers();
+
+	xpcc::Header header(xpcc::Header::Type::RESPONSE, false, 0x12, 0x34, 0x56);
+	first.sendPacket(header, xpcc::SmartPointer(&payload));
+
+	TEST_ASSERT_TRUE(waitForPacket(first, second));
+	TEST_ASSERT_TRUE(second.getPacketHeader() == header);
+	TEST_ASSERT_EQUALS(second.getPacketPayload().getSize(), sizeof(payload));
+	TEST_ASSERT_EQUALS_ARRAY(second.getPacketPayload().getPointer(), payload, sizeof(payload));
+
+	second.dropPacket();
+	TEST_ASSERT_FALSE(second.isPacketAvailable());
+
+	// the transmitter does not receive its own packet
+	first.update();
+	TEST_ASSERT_FALSE(first.isPacketAvailable());
+
+	// packets without payload
+	xpcc::Header ack(xpcc::Header::Type::REQUEST, true, 0x34, 0x12, 0x56);
+	second.sendPacket(ack);
+
+	TEST_ASSERT_TRUE(waitForPacket(second, first));
+	TEST_ASSERT_TRUE(first.getPacketHeader() == ack);
+	TEST_ASSERT_EQUALS(first.getPacketPayload().getSize(), 0U);
+	first.dropPacket();
+}
+
+void
+DatagramConnectorTest::testUnixBatching()
+{
+	xpcc::UnixConnector first(this->directory.c_str(), "first");
+	xpcc::UnixConnector second(this->directory.c_str(), "second");
+	first.updatePeers();
+
+	// stays below the default queue length of the socket
+	for (uint8_t i = 0; i < 8; ++i) {
+		first.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, i),
+				xpcc::SmartPointer(&i));
+	}
+	TEST_ASSERT_EQUALS(first.getStatistics().transmitCalls, 0U);
+
+	// all packets are transmitted with a single system call
+	first.update();
+	TEST_ASSERT_EQUALS(first.getStatistics().transmitCalls, 1U);
+	TEST_ASSERT_EQUALS(first.getStatistics().transmittedPackets, 8U);
+
+	// ... and received in order with a single system call
+	second.update();
+	TEST_ASSERT_EQUALS(second.getStatistics().receiveCalls, 1U);
+	TEST_ASSERT_EQUALS(second.getStatistics().receivedPackets, 8U);
+	for (uint8_t i = 0; i < 8; ++i)
+	{
+		TEST_ASSERT_TRUE(second.isPacketAvailable());
+		TEST_ASSERT_EQUALS(second.getPacketHeader().packetIdentifier, i);
+		TEST_ASSERT_EQUALS(second.getPacketPayload().get<uint8_t>(), i);
+		second.dropPacket();
+	}
+	second.update();
+	TEST_ASSERT_FALSE(second.isPacketAvailable());
+}
+
+void
+DatagramConnectorTest::testUnixDeferred()
+{
+	xpcc::UnixConnector first(this->directory.c_str(), "first");
+	xpcc::UnixConnector second(this->directory.c_str(), "second");
+	first.updatePeers();
+
+	// more packets than the receiving socket is able to queue
+	for (uint8_t i = 0; i < 40; ++i) {
+		first.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, i));
+	}
+
+	uint8_t expected = 0;
+	for (int i = 0; i < 100 && expected < 40; ++i)
+	{
+		first.update();
+		second.update();
+		while (second.isPacketAvailable())
+		{
+			TEST_ASSERT_EQUALS(second.getPacketHeader().packetIdentifier, expected);
+			expected++;
+			second.dropPacket();
+		}
+	}
+	TEST_ASSERT_EQUALS(expected, 40);
+	TEST_ASSERT_EQUALS(first.getStatistics().transmittedPackets, 40U);
+	TEST_ASSERT_EQUALS(first.getStatistics().droppedPackets, 0U);
+}
+
+void
+DatagramConnectorTest::testUnixPeerGone()
+{
+	xpcc::UnixConnector first(this->directory.c_str(), "first");
+	{
+		xpcc::UnixConnector second(this->directory.c_str(), "second");
+		first.updatePeers();
+	}
+
+	// the socket of the peer was removed, the packet is dropped
+	first.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56));
+	first.update();
+	TEST_ASSERT_EQUALS(first.getStatistics().transmittedPackets, 0U);
+	TEST_ASSERT_EQUALS(first.getStatistics().droppedPackets, 1U);
+
+	// a new peer is found again
+	xpcc::UnixConnector third(this->directory.c_str(), "third");
+	first.updatePeers();
+	first.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x57));
+	TEST_ASSERT_TRUE(waitForPacket(first, third));
+	TEST_ASSERT_EQUALS(third.getPacketHeader().packetIdentifier, 0x57);
+}
+
+void
+DatagramConnectorTest::testUnixOnePeerFull()
+{
+	xpcc::UnixConnector first(this->directory.c_str(), "first");
+	xpcc::UnixConnector full(this->directory.c_str(), "full");
+	xpcc::UnixConnector free(this->directory.c_str(), "free");
+	first.updatePeers();
+
+	// fill the receive queue of one peer from an unnamed socket
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	std::string path = this->directory + "/full";
+	std::strcpy(address.sun_path, path.c_str());
+
+	int filler = socket(AF_UNIX, SOCK_DGRAM, 0);
+	xpcc::Header fill(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0xff);
+	uint16_t filled = 0;
+	while (sendto(filler, &fill, sizeof(fill), MSG_DONTWAIT,
+			(sockaddr *) &address, sizeof(address)) >= 0) {
+		filled++;
+	}
+	close(filler);
+	TEST_ASSERT_TRUE(filled > 0);
+
+	for (uint8_t i = 0; i < 20; ++i) {
+		first.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, i));
+	}
+	first.update();
+
+	// All messages to the full peer are deferred. The queue of the free
+	// peer fills up as well, every message is still handled only once.
+	const xpcc::DatagramConnector::Statistics& statistics = first.getStatistics();
+	TEST_ASSERT_TRUE(statistics.transmittedPackets > 0);
+	TEST_ASSERT_TRUE(statistics.deferredPackets >= 20);
+	TEST_ASSERT_EQUALS(statistics.transmittedPackets + statistics.deferredPackets, 40U);
+	TEST_ASSERT_EQUALS(statistics.droppedPackets, 0U);
+
+	uint8_t expectedFree = 0;
+	uint8_t expectedFull = 0;
+	for (int i = 0; i < 100 && (expectedFree < 20 || expectedFull < 20); ++i)
+	{
+		first.update();
+		free.update();
+		while (free.isPacketAvailable())
+		{
+			TEST_ASSERT_EQUALS(free.getPacketHeader().packetIdentifier, expectedFree);
+			expectedFree++;
+			free.dropPacket();
+		}
+		full.update();
+		while (full.isPacketAvailable())
+		{
+			if (full.getPacketHeader().packetIdentifier != 0xff)
+			{
+				TEST_ASSERT_EQUALS(full.getPacketHeader().packetIdentifier, expectedFull);
+				expectedFull++;
+			}
+			full.dropPacket();
+		}
+	}
+	TEST_ASSERT_EQUALS(expectedFree, 20);
+	TEST_ASSERT_EQUALS(expectedFull, 20);
+
+	// no duplicates were transmitted
+	TEST_ASSERT_EQUALS(statistics.transmittedPackets, 40U);
+	TEST_ASSERT_EQUALS(statistics.droppedPackets, 0U);
+}
+
+void
+DatagramConnectorTest::testUdpLoopback()
+{
+	xpcc::UdpConnector first("239.255.0.1", 24321);
+	xpcc::UdpConnector second("239.255.0.1", 24321);
+	TEST_ASSERT_TRUE(first.isOpen());
+	TEST_ASSERT_TRUE(second.isOpen());
+
+	xpcc::Header header(xpcc::Header::Type::NEGATIVE_RESPONSE, false, 0x01, 0x02, 0x03);
+	first.sendPacket(header, xpcc::SmartPointer(&payload));
+
+	TEST_ASSERT_TRUE(waitForPacket(first, second));
+	TEST_ASSERT_TRUE(second.getPacketHeader() == header);
+	TEST_ASSERT_EQUALS_ARRAY(second.getPacketPayload().getPointer(), payload, sizeof(payload));
+	second.dropPacket();
+
+	// multicast loopback is enabled, but the own packets are filtered
+	first.update();
+	TEST_ASSERT_FALSE(first.isPacketAvailable());
+}
+
+void
+DatagramConnectorTest::testUnixClosed()
+{
+	// the directory does not exist, the socket can not be created
+	std::string missing = this->directory + "/missing";
+	xpcc::UnixConnector connector(missing.c_str(), "first");
+	TEST_ASSERT_FALSE(connector.isOpen());
+
+	// packets are dropped without any system call
+	connector.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56));
+	connector.update();
+	TEST_ASSERT_FALSE(connector.isPacketAvailable());
+	TEST_ASSERT_EQUALS(connector.getStatistics().transmitCalls, 0U);
+	TEST_ASSERT_EQUALS(connector.getStatistics().receiveCalls, 0U);
+	TEST_ASSERT_EQUALS(connector.getStatistics().droppedPackets, 1U);
+}
+
+void
+DatagramConnectorTest::testUdpClosed()
+{
+	xpcc::UdpConnector invalidGroup("239.255.0.256", 24321);
+	TEST_ASSERT_FALSE(invalidGroup.isOpen());
+
+	// not the address of a local interface
+	xpcc::UdpConnector invalidInterface("239.255.0.1", 24321, "192.0.2.1");
+	TEST_ASSERT_FALSE(invalidInterface.isOpen());
+
+	invalidInterface.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56));
+	invalidInterface.update();
+	TEST_ASSERT_FALSE(invalidInterface.isPacketAvailable());
+	TEST_ASSERT_EQUALS(invalidInterface.getStatistics().transmitCalls, 0U);
+	TEST_ASSERT_EQUALS(invalidInterface.getStatistics().receiveCalls, 0U);
+	TEST_ASSERT_EQUALS(invalidInterface.getStatistics().droppedPackets, 1U);
+}
@@ -0,0 +1,53 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef DATAGRAM_CONNECTOR_TEST_HPP
+#define DATAGRAM_CONNECTOR_TEST_HPP
+
+#include <string>
+#include <unittest/testsuite.hpp>
+
+class DatagramConnectorTest : public unittest::TestSuite
+{
+public:
+	virtual void
+	setUp();
+
+	virtual void
+	tearDown();
+
+public:
+	void
+	testUnixExchange();
+
+	void
+	testUnixBatching();
+
+	void
+	testUnixDeferred();
+
+	void
+	testUnixPeerGone();
+
+	void
+	testUnixOnePeerFull();
+
+	void
+	testUdpLoopback();
+
+	void
+	testUnixClosed();
+
+	void
+	testUdpClosed();
+
+private:
+	std::string directory;
+};
+
+#endif	// DATAGRAM_CONNECTOR_TEST_HPP
@@ -0,0 +1,123 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "udp_connector.hpp"
+
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::WARNING
+
+// ----------------------------------------------------------------------------
+static void
+closeSockets(int first, int second)
+{
+	if (first >= 0) {
+		close(first);
+	}
+	if (second >= 0) {
+		close(second);
+	}
+}
+
+// ----------------------------------------------------------------------------
+xpcc::UdpConnector::UdpConnector(const char *group, uint16_t port,
+		const char *interface) :
+	destinations(1)
+{
+	in_addr groupAddress;
+	in_addr interfaceAddress;
+	if (inet_pton(AF_INET, group, &groupAddress) != 1 ||
+		inet_pton(AF_INET, interface, &interfaceAddress) != 1)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Invalid address." << xpcc::endl;
+		this->destinations.clear();
+		return;
+	}
+
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr = groupAddress;
+
+	std::memcpy(&this->destinations[0].address, &address, sizeof(address));
+	this->destinations[0].length = sizeof(address);
+
+	// Receive: bound to the group address, so only packets of this group
+	// are received. Several connectors on one machine share the port.
+	int receiveSocket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	int enable = 1;
+	if (receiveSocket < 0 ||
+		setsockopt(receiveSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) != 0 ||
+		bind(receiveSocket, (sockaddr *) &address, sizeof(address)) != 0)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not bind to port " << port << xpcc::endl;
+		closeSockets(receiveSocket, -1);
+		return;
+	}
+
+	ip_mreq membership;
+	membership.imr_multiaddr = groupAddress;
+	membership.imr_interface = interfaceAddress;
+	if (setsockopt(receiveSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not join the multicast group." << xpcc::endl;
+		closeSockets(receiveSocket, -1);
+		return;
+	}
+
+	// Transmit: bound to the interface, the address is used to recognize
+	// the own packets looped back by the kernel.
+	int transmitSocket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	std::memset(&this->ownAddress, 0, sizeof(this->ownAddress));
+	this->ownAddress.sin_family = AF_INET;
+	this->ownAddress.sin_addr = interfaceAddress;
+	socklen_t length = sizeof(this->ownAddress);
+	if (transmitSocket < 0 ||
+		bind(transmitSocket, (sockaddr *) &this->ownAddress, sizeof(this->ownAddress)) != 0 ||
+		getsockname(transmitSocket, (sockaddr *) &this->ownAddress, &length) != 0)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not bind the transmit socket." << xpcc::endl;
+		closeSockets(receiveSocket, transmitSocket);
+		return;
+	}
+
+	uint8_t loop = 1;
+	uint8_t ttl = 1;
+	if (setsockopt(transmitSocket, IPPROTO_IP, IP_MULTICAST_IF, &interfaceAddress, sizeof(interfaceAddress)) != 0 ||
+		setsockopt(transmitSocket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0 ||
+		setsockopt(transmitSocket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not configure multicast transmission." << xpcc::endl;
+		closeSockets(receiveSocket, transmitSocket);
+		return;
+	}
+
+	this->setSockets(transmitSocket, receiveSocket);
+}
+
+// ----------------------------------------------------------------------------
+const std::vector<xpcc::DatagramConnector::Address>&
+xpcc::UdpConnector::getDestinations()
+{
+	return this->destinations;
+}
+
+bool
+xpcc::UdpConnector::isOwnPacket(const Address& source) const
+{
+	const sockaddr_in *address = (const sockaddr_in *) &source.address;
+	return (source.length >= sizeof(sockaddr_in) &&
+			address->sin_family == AF_INET &&
+			address->sin_port == this->ownAddress.sin_port &&
+			address->sin_addr.s_addr == this->ownAddress.sin_addr.s_addr);
+}
@@ -0,0 +1,56 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__UDP_CONNECTOR_HPP
+#define XPCC__UDP_CONNECTOR_HPP
+
+#include <netinet/in.h>
+
+#include "connector.hpp"
+
+namespace xpcc
+{
+	/**
+	 * \brief	Backend using UDP multicast
+	 *
+	 * All connectors using the same multicast group and port receive
+	 * the packets of each other, packets transmitted by the connector
+	 * itself are ignored. With the default interface address the packets
+	 * never leave the local machine.
+	 *
+	 * \ingroup	datagram
+	 */
+	class UdpConnector : public DatagramConnector
+	{
+	public:
+		/**
+		 * \param	group		IPv4 multicast group
+		 * \param	port		UDP port
+		 * \param	interface	address of the local network interface
+		 * 						used to send and receive the packets
+		 *
+		 * Check isOpen() to see if the sockets could be set up.
+		 */
+		UdpConnector(const char *group = "239.255.0.1",
+				uint16_t port = 4321,
+				const char *interface = "127.0.0.1");
+
+	protected:
+		virtual const std::vector<Address>&
+		getDestinations();
+
+		virtual bool
+		isOwnPacket(const Address& source) const;
+
+	private:
+		std::vector<Address> destinations;
+		sockaddr_in ownAddress;
+	};
+}
+
+#endif	// XPCC__UDP_CONNECTOR_HPP
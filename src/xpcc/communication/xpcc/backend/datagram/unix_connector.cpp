@@ -0,0 +1,127 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "unix_connector.hpp"
+
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::WARNING
+
+// ----------------------------------------------------------------------------
+xpcc::UnixConnector::UnixConnector(const char *directory, const char *name) :
+	directory(directory), path(std::string(directory) + "/" + name),
+	peerTimer(1000)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (this->path.size() >= sizeof(address.sun_path)) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Socket path too long." << xpcc::endl;
+		return;
+	}
+	std::strcpy(address.sun_path, this->path.c_str());
+
+	// remove the socket of a previous run
+	unlink(this->path.c_str());
+
+	int socketDescriptor = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (socketDescriptor < 0 ||
+		bind(socketDescriptor, (sockaddr *) &address, sizeof(address)) != 0)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not create socket " << this->path.c_str() << xpcc::endl;
+		if (socketDescriptor >= 0) {
+			close(socketDescriptor);
+		}
+		return;
+	}
+	this->setSockets(socketDescriptor, socketDescriptor);
+
+	this->updatePeers();
+}
+
+xpcc::UnixConnector::~UnixConnector()
+{
+	unlink(this->path.c_str());
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::UnixConnector::updatePeers()
+{
+	DIR *dir = opendir(this->directory.c_str());
+	if (dir == nullptr) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not open " << this->directory.c_str() << xpcc::endl;
+		return;
+	}
+
+	this->peers.clear();
+	while (dirent *entry = readdir(dir))
+	{
+		std::string peer = this->directory + "/" + entry->d_name;
+
+		struct stat status;
+		if (peer == this->path || stat(peer.c_str(), &status) != 0 ||
+			!S_ISSOCK(status.st_mode) || peer.size() >= sizeof(sockaddr_un::sun_path)) {
+			continue;
+		}
+
+		Address address;
+		sockaddr_un *unixAddress = (sockaddr_un *) &address.address;
+		std::memset(unixAddress, 0, sizeof(sockaddr_un));
+		unixAddress->sun_family = AF_UNIX;
+		std::strcpy(unixAddress->sun_path, peer.c_str());
+		address.length = sizeof(sockaddr_un);
+
+		this->peers.push_back(address);
+	}
+	closedir(dir);
+}
+
+// ----------------------------------------------------------------------------
+const std::vector<xpcc::DatagramConnector::Address>&
+xpcc::UnixConnector::getDestinations()
+{
+	if (this->peerTimer.execute()) {
+		this->updatePeers();
+	}
+	return this->peers;
+}
+
+bool
+xpcc::UnixConnector::isOwnPacket(const Address& /* source */) const
+{
+	// packets are never sent to the own socket
+	return false;
+}
+
+void
+xpcc::UnixConnector::destinationFailed(const Address& destination, int error)
+{
+	const sockaddr_un *address = (const sockaddr_un *) &destination.address;
+	if (error != ECONNREFUSED && error != ENOENT) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not transmit to " << address->sun_path
+				<< ", errno=" << error << xpcc::endl;
+	}
+
+	// the peer is gone or not reachable
+	for (auto it = this->peers.begin(); it != this->peers.end(); ++it)
+	{
+		if (isSameAddress(*it, destination)) {
+			this->peers.erase(it);
+			break;
+		}
+	}
+}
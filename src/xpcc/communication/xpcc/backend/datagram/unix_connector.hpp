@@ -0,0 +1,71 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__UNIX_CONNECTOR_HPP
+#define XPCC__UNIX_CONNECTOR_HPP
+
+#include <string>
+
+#include <xpcc/processing/timer.hpp>
+
+#include "connector.hpp"
+
+namespace xpcc
+{
+	/**
+	 * \brief	Backend using local (AF_UNIX) datagram sockets
+	 *
+	 * Every connector creates a socket inside a common directory and
+	 * transmits its packets to all other sockets found in this directory.
+	 * The directory is searched for new connectors once per second,
+	 * connectors which have disappeared are removed as soon as a packet
+	 * can not be delivered to them.
+	 *
+	 * The kernel queues only a few datagrams for every socket (see
+	 * `net.unix.max_dgram_qlen`, default 10). Further packets are
+	 * deferred until the receiver has read its queue.
+	 *
+	 * \ingroup	datagram
+	 */
+	class UnixConnector : public DatagramConnector
+	{
+	public:
+		/**
+		 * \param	directory	Existing directory shared by all connectors
+		 * 						which should communicate with each other
+		 * \param	name		Unique name of the socket of this connector
+		 *
+		 * Check isOpen() to see if the socket could be created.
+		 */
+		UnixConnector(const char *directory, const char *name);
+
+		~UnixConnector();
+
+		/// Search the directory for other connectors
+		void
+		updatePeers();
+
+	protected:
+		virtual const std::vector<Address>&
+		getDestinations();
+
+		virtual bool
+		isOwnPacket(const Address& source) const;
+
+		virtual void
+		destinationFailed(const Address& destination, int error);
+
+	private:
+		std::string directory;
+		std::string path;
+		std::vector<Address> peers;
+		xpcc::PeriodicTimer peerTimer;
+	};
+}
+
+#endif	// XPCC__UNIX_CONNECTOR_HPP
@@ -0,0 +1,37 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+/**
+ * \ingroup		backend
+ * \defgroup 	recorder	Traffic Recorder and Replay
+ * \brief 		Record the traffic of a backend and play it back later.
+ *
+ * xpcc::TrafficRecorder is put between a xpcc::Dispatcher and its backend
+ * and writes every transmitted and received packet with a timestamp of
+ * xpcc::Clock into a log file. xpcc::TrafficReplay is a backend which
+ * delivers the received packets of such a log again, either with the
+ * recorded timing, scaled by a speed factor, or as fast as possible.
+ *
+ * @code
+ * // on the robot
+ * xpcc::CanConnector< Can1 > connector(&can1);
+ * xpcc::TrafficRecorder recorder(&connector, "session.xpcclog");
+ * xpcc::Dispatcher dispatcher(&recorder, &postman);
+ *
+ * // offline, a hundred times faster
+ * xpcc::TrafficReplay replay("session.xpcclog", 100);
+ * xpcc::Dispatcher dispatcher(&replay, &postman);
+ * @endcode
+ *
+ * The log is a sequence of records appended to a small file header, see
+ * xpcc::TrafficLog. It can be read with xpcc::TrafficLogReader, which maps
+ * the file into memory.
+ */
+
+#include "recorder/traffic_log.hpp"
+#include "recorder/traffic_recorder.hpp"
+#include "recorder/traffic_replay.hpp"
@@ -0,0 +1,309 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <deque>
+
+#include <xpcc/architecture/driver/test/testing_clock.hpp>
+#include <xpcc/communication/xpcc/backend/recorder.hpp>
+
+#include "traffic_recorder_test.hpp"
+
+namespace
+{
+	const uint8_t payload[] = { 0x12, 0x34, 0x56, 0x78, 0x9a };
+
+	/// Delivers a list of packets and counts the transmitted ones
+	class QueueBackend : public xpcc::BackendInterface
+	{
+	public:
+		QueueBackend() :
+			transmittedPackets(0)
+		{
+		}
+
+		virtual void
+		update()
+		{
+		}
+
+		virtual void
+		sendPacket(const xpcc::Header& /* header */, xpcc::SmartPointer /* payload */)
+		{
+			transmittedPackets++;
+		}
+
+		virtual bool
+		isPacketAvailable() const
+		{
+			return !packets.empty();
+		}
+
+		virtual const xpcc::Header&
+		getPacketHeader() const
+		{
+			return packets.front().first;
+		}
+
+		virtual const xpcc::SmartPointer
+		getPacketPayload() const
+		{
+			return packets.front().second;
+		}
+
+		virtual void
+		dropPacket()
+		{
+			packets.pop_front();
+		}
+
+		std::deque< std::pair<xpcc::Header, xpcc::SmartPointer> > packets;
+		uint32_t transmittedPackets;
+	};
+
+	const xpcc::Header request(xpcc::Header::Type::REQUEST, false, 0x12, 0x34, 0x56);
+	const xpcc::Header response(xpcc::Header::Type::RESPONSE, false, 0x34, 0x12, 0x56);
+	const xpcc::Header acknowledge(xpcc::Header::Type::RESPONSE, true, 0x12, 0x34, 0x56);
+	const xpcc::Header event(xpcc::Header::Type::REQUEST, false, 0x00, 0x20, 0x80);
+}
+
+// ----------------------------------------------------------------------------
+void
+TrafficRecorderTest::setUp()
+{
+	char name[] = "/tmp/xpcc_traffic_XXXXXX";
+	int fd = mkstemp(name);
+	close(fd);
+	this->filename = name;
+}
+
+void
+TrafficRecorderTest::tearDown()
+{
+	unlink(this->filename.c_str());
+}
+
+// ----------------------------------------------------------------------------
+void
+TrafficRecorderTest::testRecord()
+{
+	QueueBackend backend;
+	backend.packets.push_back(std::make_pair(response, xpcc::SmartPointer(&payload)));
+	backend.packets.push_back(std::make_pair(acknowledge, xpcc::SmartPointer()));
+	{
+		TestingClock::time = 20000;
+		xpcc::TrafficRecorder recorder(&backend, this->filename.c_str());
+		TEST_ASSERT_TRUE(recorder.isRecording());
+
+		TestingClock::time += 10;
+		recorder.sendPacket(request, xpcc::SmartPointer(&payload));
+		TEST_ASSERT_EQUALS(backend.transmittedPackets, 1U);
+
+		TestingClock::time += 15;
+		recorder.update();
+		TEST_ASSERT_TRUE(recorder.isPacketAvailable());
+		// asking again must not create a second record
+		TEST_ASSERT_TRUE(recorder.isPacketAvailable());
+		TEST_ASSERT_TRUE(recorder.getPacketHeader() == response);
+		recorder.dropPacket();
+
+		// dropped without asking first
+		TestingClock::time += 5;
+		recorder.dropPacket();
+		TEST_ASSERT_FALSE(recorder.isPacketAvailable());
+
+		recorder.sendPacket(event);
+	}
+
+	xpcc::TrafficLogReader reader(this->filename.c_str());
+	TEST_ASSERT_TRUE(reader.isOpen());
+
+	xpcc::TrafficLog::Entry entry;
+	TEST_ASSERT_TRUE(reader.next(entry));
+	TEST_ASSERT_EQUALS(entry.direction, xpcc::TrafficLog::TRANSMITTED);
+	TEST_ASSERT_TRUE(entry.header == request);
+	TEST_ASSERT_EQUALS(entry.payloadSize, sizeof(payload));
+	TEST_ASSERT_EQUALS_ARRAY(entry.payload, payload, sizeof(payload));
+	TEST_ASSERT_EQUALS(entry.time, 10U);
+
+	TEST_ASSERT_TRUE(reader.next(entry));
+	TEST_ASSERT_EQUALS(entry.direction, xpcc::TrafficLog::RECEIVED);
+	TEST_ASSERT_TRUE(entry.header == response);
+	TEST_ASSERT_EQUALS(entry.getPayload().getSize(), sizeof(payload));
+	TEST_ASSERT_EQUALS_ARRAY(entry.getPayload().getPointer(), payload, sizeof(payload));
+	TEST_ASSERT_EQUALS(entry.time, 25U);
+
+	TEST_ASSERT_TRUE(reader.next(entry));
+	TEST_ASSERT_EQUALS(entry.direction, xpcc::TrafficLog::RECEIVED);
+	TEST_ASSERT_TRUE(entry.header == acknowledge);
+	TEST_ASSERT_EQUALS(entry.payloadSize, 0);
+	TEST_ASSERT_EQUALS(entry.time, 30U);
+
+	TEST_ASSERT_TRUE(reader.next(entry));
+	TEST_ASSERT_EQUALS(entry.direction, xpcc::TrafficLog::TRANSMITTED);
+	TEST_ASSERT_TRUE(entry.header == event);
+
+	TEST_ASSERT_FALSE(reader.next(entry));
+
+	reader.rewind();
+	TEST_ASSERT_TRUE(reader.next(entry));
+	TEST_ASSERT_TRUE(entry.header == request);
+}
+
+void
+TrafficRecorderTest::testTruncatedLog()
+{
+	{
+		xpcc::TrafficLogWriter writer(this->filename.c_str());
+		writer.write(0, xpcc::TrafficLog::RECEIVED, request, xpcc::SmartPointer(&payload));
+		writer.write(1, xpcc::TrafficLog::RECEIVED, response, xpcc::SmartPointer(&payload));
+	}
+
+	// cut off the payload of the second record
+	TEST_ASSERT_EQUALS(truncate(this->filename.c_str(),
+			sizeof(xpcc::TrafficLog::FileHeader) +
+			xpcc::TrafficLog::getRecordSize(sizeof(payload)) +
+			sizeof(xpcc::TrafficLog::Record) + 2), 0);
+
+	xpcc::TrafficLogReader reader(this->filename.c_str());
+	xpcc::TrafficLog::Entry entry;
+	TEST_ASSERT_TRUE(reader.next(entry));
+	TEST_ASSERT_TRUE(entry.header == request);
+	TEST_ASSERT_FALSE(reader.next(entry));
+
+	// not a traffic log at all
+	TEST_ASSERT_EQUALS(truncate(this->filename.c_str(), 4), 0);
+	TEST_ASSERT_FALSE(reader.open(this->filename.c_str()));
+}
+
+void
+TrafficRecorderTest::testReplayAsFastAsPossible()
+{
+	{
+		xpcc::TrafficLogWriter writer(this->filename.c_str());
+		writer.write(0, xpcc::TrafficLog::RECEIVED, request, xpcc::SmartPointer(&payload));
+		writer.write(50000, xpcc::TrafficLog::RECEIVED, response, xpcc::SmartPointer());
+		writer.write(100000, xpcc::TrafficLog::RECEIVED, event, xpcc::SmartPointer());
+	}
+
+	xpcc::TrafficReplay replay(this->filename.c_str(), 0);
+	TEST_ASSERT_FALSE(replay.isPacketAvailable());
+
+	replay.update();
+	TEST_ASSERT_TRUE(replay.isPacketAvailable());
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == request);
+	TEST_ASSERT_EQUALS(replay.getPacketPayload().getSize(), sizeof(payload));
+	TEST_ASSERT_EQUALS_ARRAY(replay.getPacketPayload().getPointer(), payload, sizeof(payload));
+	replay.dropPacket();
+
+	// one packet per update()
+	TEST_ASSERT_FALSE(replay.isPacketAvailable());
+	replay.update();
+	TEST_ASSERT_TRUE(replay.isPacketAvailable());
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == response);
+	TEST_ASSERT_EQUALS(replay.getPacketPayload().getSize(), 0);
+	replay.dropPacket();
+
+	replay.update();
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == event);
+	replay.dropPacket();
+
+	replay.update();
+	TEST_ASSERT_FALSE(replay.isPacketAvailable());
+	TEST_ASSERT_TRUE(replay.isFinished());
+	TEST_ASSERT_EQUALS(replay.getNumberOfReplayedPackets(), 3U);
+
+	replay.restart();
+	TEST_ASSERT_FALSE(replay.isFinished());
+	replay.update();
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == request);
+}
+
+void
+TrafficRecorderTest::testReplayTiming()
+{
+	{
+		xpcc::TrafficLogWriter writer(this->filename.c_str());
+		writer.write(1000, xpcc::TrafficLog::RECEIVED, request, xpcc::SmartPointer());
+		writer.write(1000, xpcc::TrafficLog::RECEIVED, response, xpcc::SmartPointer());
+		writer.write(6000, xpcc::TrafficLog::RECEIVED, event, xpcc::SmartPointer());
+	}
+
+	TestingClock::time = 0;
+	xpcc::TrafficReplay replay(this->filename.c_str(), 1);
+
+	// the first packet starts the replay, packets with the same time
+	// are delivered together
+	TestingClock::time = 300;
+	replay.update();
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == request);
+	replay.dropPacket();
+	TEST_ASSERT_TRUE(replay.isPacketAvailable());
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == response);
+	replay.dropPacket();
+	TEST_ASSERT_FALSE(replay.isPacketAvailable());
+
+	TestingClock::time += 4999;
+	replay.update();
+	TEST_ASSERT_FALSE(replay.isPacketAvailable());
+
+	TestingClock::time += 1;
+	replay.update();
+	TEST_ASSERT_TRUE(replay.isPacketAvailable());
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == event);
+	replay.dropPacket();
+
+	// a hundred times faster, the replayed time is kept
+	replay.restart();
+	TestingClock::time = 0;
+	replay.update();
+	replay.dropPacket();
+	replay.dropPacket();
+
+	TestingClock::time = 1000;
+	replay.setSpeed(100);
+	TestingClock::time += 39;
+	replay.update();
+	TEST_ASSERT_FALSE(replay.isPacketAvailable());
+
+	TestingClock::time += 1;
+	replay.update();
+	TEST_ASSERT_TRUE(replay.getPacketHeader() == event);
+}
+
+void
+TrafficRecorderTest::testReplayDirections()
+{
+	{
+		xpcc::TrafficLogWriter writer(this->filename.c_str());
+		writer.write(0, xpcc::TrafficLog::TRANSMITTED, request, xpcc::SmartPointer());
+		writer.write(0, xpcc::TrafficLog::RECEIVED, response, xpcc::SmartPointer());
+		writer.write(0, xpcc::TrafficLog::TRANSMITTED, event, xpcc::SmartPointer());
+	}
+
+	xpcc::TrafficReplay received(this->filename.c_str(), 0);
+	received.update();
+	TEST_ASSERT_TRUE(received.getPacketHeader() == response);
+	received.dropPacket();
+	received.update();
+	TEST_ASSERT_TRUE(received.isFinished());
+
+	xpcc::TrafficReplay all(this->filename.c_str(), 0,
+			xpcc::TrafficLog::RECEIVED | xpcc::TrafficLog::TRANSMITTED);
+	uint32_t count = 0;
+	while (!all.isFinished())
+	{
+		all.update();
+		if (all.isPacketAvailable()) {
+			all.dropPacket();
+			count++;
+		}
+	}
+	TEST_ASSERT_EQUALS(count, 3U);
+}
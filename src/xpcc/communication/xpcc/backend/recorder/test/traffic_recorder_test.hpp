@@ -0,0 +1,44 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef TRAFFIC_RECORDER_TEST_HPP
+#define TRAFFIC_RECORDER_TEST_HPP
+
+#include <string>
+#include <unittest/testsuite.hpp>
+
+class TrafficRecorderTest : public unittest::TestSuite
+{
+public:
+	virtual void
+	setUp();
+
+	virtual void
+	tearDown();
+
+public:
+	void
+	testRecord();
+
+	void
+	testTruncatedLog();
+
+	void
+	testReplayAsFastAsPossible();
+
+	void
+	testReplayTiming();
+
+	void
+	testReplayDirections();
+
+private:
+	std::string filename;
+};
+
+#endif	// TRAFFIC_RECORDER_TEST_HPP
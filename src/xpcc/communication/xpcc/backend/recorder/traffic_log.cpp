@@ -0,0 +1,226 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "traffic_log.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::WARNING
+
+const char xpcc::TrafficLog::magic[8] = "xpcclog";
+
+constexpr uint16_t xpcc::TrafficLog::version;
+constexpr uint16_t xpcc::TrafficLog::byteOrderMark;
+constexpr uint8_t xpcc::TrafficLog::FLAG_ACKNOWLEDGE;
+
+// ----------------------------------------------------------------------------
+xpcc::SmartPointer
+xpcc::TrafficLog::Entry::getPayload() const
+{
+	if (this->payloadSize == 0) {
+		return SmartPointer();
+	}
+
+	SmartPointer copy(this->payloadSize);
+	std::memcpy(copy.getPointer(), this->payload, this->payloadSize);
+	return copy;
+}
+
+// ----------------------------------------------------------------------------
+xpcc::TrafficLogWriter::TrafficLogWriter() :
+	file(nullptr), dirty(false)
+{
+}
+
+xpcc::TrafficLogWriter::TrafficLogWriter(const char *filename) :
+	file(nullptr), dirty(false)
+{
+	this->open(filename);
+}
+
+xpcc::TrafficLogWriter::~TrafficLogWriter()
+{
+	this->close();
+}
+
+bool
+xpcc::TrafficLogWriter::open(const char *filename)
+{
+	this->close();
+
+	this->file = std::fopen(filename, "wb");
+	if (this->file == nullptr) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not create " << filename << xpcc::endl;
+		return false;
+	}
+
+	TrafficLog::FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, TrafficLog::magic, sizeof(header.magic));
+	header.version = TrafficLog::version;
+	header.byteOrder = TrafficLog::byteOrderMark;
+
+	std::fwrite(&header, sizeof(header), 1, this->file);
+	this->dirty = true;
+	return true;
+}
+
+void
+xpcc::TrafficLogWriter::close()
+{
+	if (this->file != nullptr) {
+		std::fclose(this->file);
+		this->file = nullptr;
+	}
+	this->dirty = false;
+}
+
+void
+xpcc::TrafficLogWriter::write(uint32_t time, TrafficLog::Direction direction,
+		const Header& header, const SmartPointer& payload)
+{
+	if (this->file == nullptr) {
+		return;
+	}
+
+	TrafficLog::Record record;
+	record.time = time;
+	record.payloadSize = payload.getSize();
+	record.direction = direction;
+	record.type = static_cast<uint8_t>(header.type);
+	record.destination = header.destination;
+	record.source = header.source;
+	record.packetIdentifier = header.packetIdentifier;
+	record.flags = header.isAcknowledge ? TrafficLog::FLAG_ACKNOWLEDGE : 0;
+
+	static const uint8_t padding[3] = { 0, 0, 0 };
+	std::size_t paddingSize = TrafficLog::getRecordSize(record.payloadSize) -
+			sizeof(record) - record.payloadSize;
+
+	std::fwrite(&record, sizeof(record), 1, this->file);
+	if (record.payloadSize > 0) {
+		std::fwrite(payload.getPointer(), record.payloadSize, 1, this->file);
+	}
+	if (paddingSize > 0) {
+		std::fwrite(padding, paddingSize, 1, this->file);
+	}
+	this->dirty = true;
+}
+
+void
+xpcc::TrafficLogWriter::flush()
+{
+	if (this->dirty) {
+		std::fflush(this->file);
+		this->dirty = false;
+	}
+}
+
+// ----------------------------------------------------------------------------
+xpcc::TrafficLogReader::TrafficLogReader() :
+	data(nullptr), size(0), offset(0)
+{
+}
+
+xpcc::TrafficLogReader::TrafficLogReader(const char *filename) :
+	data(nullptr), size(0), offset(0)
+{
+	this->open(filename);
+}
+
+xpcc::TrafficLogReader::~TrafficLogReader()
+{
+	this->close();
+}
+
+bool
+xpcc::TrafficLogReader::open(const char *filename)
+{
+	this->close();
+
+	int fd = ::open(filename, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not open " << filename << xpcc::endl;
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(fd, &status) != 0 ||
+		std::size_t(status.st_size) < sizeof(TrafficLog::FileHeader)) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << filename << " is no traffic log" << xpcc::endl;
+		::close(fd);
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not map " << filename << xpcc::endl;
+		return false;
+	}
+
+	const TrafficLog::FileHeader *header =
+			static_cast<const TrafficLog::FileHeader *>(mapping);
+	if (std::memcmp(header->magic, TrafficLog::magic, sizeof(header->magic)) != 0 ||
+		header->version != TrafficLog::version ||
+		header->byteOrder != TrafficLog::byteOrderMark) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << filename << " is no traffic log of this version or byte order" << xpcc::endl;
+		munmap(mapping, status.st_size);
+		return false;
+	}
+
+	this->data = static_cast<const uint8_t *>(mapping);
+	this->size = status.st_size;
+	this->rewind();
+	return true;
+}
+
+void
+xpcc::TrafficLogReader::close()
+{
+	if (this->data != nullptr) {
+		munmap(const_cast<uint8_t *>(this->data), this->size);
+		this->data = nullptr;
+	}
+	this->size = 0;
+	this->offset = 0;
+}
+
+bool
+xpcc::TrafficLogReader::next(TrafficLog::Entry& entry)
+{
+	if (this->data == nullptr ||
+		this->offset + sizeof(TrafficLog::Record) > this->size) {
+		return false;
+	}
+
+	const TrafficLog::Record *record =
+			reinterpret_cast<const TrafficLog::Record *>(this->data + this->offset);
+	if (this->offset + sizeof(TrafficLog::Record) + record->payloadSize > this->size) {
+		// incomplete record at the end of the file
+		return false;
+	}
+
+	entry.time = record->time;
+	entry.direction = static_cast<TrafficLog::Direction>(record->direction);
+	entry.header = Header(static_cast<Header::Type>(record->type),
+			record->flags & TrafficLog::FLAG_ACKNOWLEDGE,
+			record->destination, record->source, record->packetIdentifier);
+	entry.payload = reinterpret_cast<const uint8_t *>(record + 1);
+	entry.payloadSize = record->payloadSize;
+
+	this->offset += TrafficLog::getRecordSize(record->payloadSize);
+	return true;
+}
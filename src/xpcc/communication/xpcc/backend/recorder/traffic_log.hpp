@@ -0,0 +1,196 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__TRAFFIC_LOG_HPP
+#define XPCC__TRAFFIC_LOG_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <stdint.h>
+
+#include <xpcc/container/smart_pointer.hpp>
+
+#include "../header.hpp"
+
+namespace xpcc
+{
+	/**
+	 * \brief	File format of the traffic log
+	 *
+	 * The file starts with a FileHeader followed by one Record per packet.
+	 * Every record is followed by its payload and padded to a multiple of
+	 * four bytes, so all records are aligned when the file is mapped into
+	 * memory. Records are only ever appended, a record cut off at the end
+	 * of the file (e.g. because the program crashed) is ignored.
+	 *
+	 * All values are stored in the byte order of the recording machine,
+	 * the reader only accepts files with its own byte order.
+	 *
+	 * \ingroup	recorder
+	 */
+	struct TrafficLog
+	{
+		enum Direction : uint8_t
+		{
+			TRANSMITTED = 0x01,		///< passed to sendPacket()
+			RECEIVED = 0x02,		///< delivered by the backend
+		};
+
+		struct FileHeader
+		{
+			char magic[8];			///< "xpcclog" with terminating zero
+			uint16_t version;
+			uint16_t byteOrder;		///< `byteOrderMark` in the byte order of the file
+			uint32_t reserved;
+		};
+
+		struct Record
+		{
+			uint32_t time;			///< milliseconds since the start of the recording
+			uint16_t payloadSize;
+			uint8_t direction;
+			uint8_t type;			///< xpcc::Header::Type
+			uint8_t destination;
+			uint8_t source;
+			uint8_t packetIdentifier;
+			uint8_t flags;			///< FLAG_ACKNOWLEDGE
+		};
+
+		/// A record together with its payload
+		struct Entry
+		{
+			uint32_t time;
+			Direction direction;
+			Header header;
+			const uint8_t *payload;
+			uint16_t payloadSize;
+
+			/// Copy of the payload for xpcc::BackendInterface::getPacketPayload()
+			SmartPointer
+			getPayload() const;
+		};
+
+		static const char magic[8];
+		static constexpr uint16_t version = 1;
+		static constexpr uint16_t byteOrderMark = 0x0102;
+		static constexpr uint8_t FLAG_ACKNOWLEDGE = 0x01;
+
+		/// Size of a record including payload and padding
+		static inline std::size_t
+		getRecordSize(uint16_t payloadSize)
+		{
+			return (sizeof(Record) + payloadSize + 3) & ~std::size_t(3);
+		}
+	};
+
+	/**
+	 * \brief	Append records to a traffic log
+	 *
+	 * The records are buffered and written to the file by flush() or when
+	 * the buffer of the C library is full.
+	 *
+	 * \ingroup	recorder
+	 */
+	class TrafficLogWriter
+	{
+	public:
+		TrafficLogWriter();
+
+		/// Create the file, an existing file is overwritten
+		explicit
+		TrafficLogWriter(const char *filename);
+
+		~TrafficLogWriter();
+
+		bool
+		open(const char *filename);
+
+		void
+		close();
+
+		inline bool
+		isOpen() const
+		{
+			return (this->file != nullptr);
+		}
+
+		void
+		write(uint32_t time, TrafficLog::Direction direction,
+				const Header& header, const SmartPointer& payload);
+
+		/// Hand the buffered records to the operating system
+		void
+		flush();
+
+	private:
+		// disable copy constructor
+		TrafficLogWriter(const TrafficLogWriter&);
+
+		TrafficLogWriter&
+		operator = (const TrafficLogWriter&);
+
+		std::FILE *file;
+		bool dirty;
+	};
+
+	/**
+	 * \brief	Read the records of a traffic log
+	 *
+	 * The file is mapped into memory, the payload of an entry points
+	 * directly into the mapping and is valid until the reader is closed.
+	 *
+	 * \ingroup	recorder
+	 */
+	class TrafficLogReader
+	{
+	public:
+		TrafficLogReader();
+
+		explicit
+		TrafficLogReader(const char *filename);
+
+		~TrafficLogReader();
+
+		/// \return	`false` if the file could not be mapped or is no traffic log
+		bool
+		open(const char *filename);
+
+		void
+		close();
+
+		inline bool
+		isOpen() const
+		{
+			return (this->data != nullptr);
+		}
+
+		/// Read the next record, `false` at the end of the log
+		bool
+		next(TrafficLog::Entry& entry);
+
+		/// Continue with the first record
+		inline void
+		rewind()
+		{
+			this->offset = sizeof(TrafficLog::FileHeader);
+		}
+
+	private:
+		// disable copy constructor
+		TrafficLogReader(const TrafficLogReader&);
+
+		TrafficLogReader&
+		operator = (const TrafficLogReader&);
+
+		const uint8_t *data;
+		std::size_t size;
+		std::size_t offset;
+	};
+}
+
+#endif	// XPCC__TRAFFIC_LOG_HPP
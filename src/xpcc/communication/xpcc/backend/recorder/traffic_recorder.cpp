@@ -0,0 +1,85 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "traffic_recorder.hpp"
+
+// ----------------------------------------------------------------------------
+xpcc::TrafficRecorder::TrafficRecorder(BackendInterface *backend,
+		const char *filename) :
+	backend(backend), log(filename), start(Clock::now()),
+	packetRecorded(false)
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::TrafficRecorder::update()
+{
+	this->backend->update();
+	this->log.flush();
+}
+
+void
+xpcc::TrafficRecorder::sendPacket(const Header &header, SmartPointer payload)
+{
+	this->log.write(this->getTime(), TrafficLog::TRANSMITTED, header, payload);
+	this->backend->sendPacket(header, payload);
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::TrafficRecorder::isPacketAvailable() const
+{
+	if (!this->backend->isPacketAvailable()) {
+		return false;
+	}
+
+	this->recordReceivedPacket();
+	return true;
+}
+
+const xpcc::Header&
+xpcc::TrafficRecorder::getPacketHeader() const
+{
+	return this->backend->getPacketHeader();
+}
+
+const xpcc::SmartPointer
+xpcc::TrafficRecorder::getPacketPayload() const
+{
+	return this->backend->getPacketPayload();
+}
+
+void
+xpcc::TrafficRecorder::dropPacket()
+{
+	if (this->backend->isPacketAvailable()) {
+		this->recordReceivedPacket();
+	}
+	this->packetRecorded = false;
+	this->backend->dropPacket();
+}
+
+// ----------------------------------------------------------------------------
+uint32_t
+xpcc::TrafficRecorder::getTime() const
+{
+	return (Clock::now() - this->start).getTime();
+}
+
+void
+xpcc::TrafficRecorder::recordReceivedPacket() const
+{
+	if (!this->packetRecorded)
+	{
+		this->log.write(this->getTime(), TrafficLog::RECEIVED,
+				this->backend->getPacketHeader(),
+				this->backend->getPacketPayload());
+		this->packetRecorded = true;
+	}
+}
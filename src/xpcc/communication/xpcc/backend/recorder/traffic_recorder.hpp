@@ -0,0 +1,83 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__TRAFFIC_RECORDER_HPP
+#define XPCC__TRAFFIC_RECORDER_HPP
+
+#include <xpcc/architecture/driver/clock.hpp>
+
+#include "../backend_interface.hpp"
+#include "traffic_log.hpp"
+
+namespace xpcc
+{
+	/**
+	 * \brief	Records the traffic of another backend
+	 *
+	 * All calls are forwarded to the wrapped backend. Packets passed to
+	 * sendPacket() are recorded before they are forwarded, received
+	 * packets when isPacketAvailable() (or dropPacket()) sees them for
+	 * the first time. The time is taken from xpcc::Clock relative to the
+	 * construction of the recorder.
+	 *
+	 * The records are written to the file at the end of every update(),
+	 * so the log is complete up to the last update() even if the program
+	 * does not terminate normally.
+	 *
+	 * \ingroup	recorder
+	 */
+	class TrafficRecorder : public BackendInterface
+	{
+	public:
+		/// \param	filename	log file, an existing file is overwritten
+		TrafficRecorder(BackendInterface *backend, const char *filename);
+
+		virtual void
+		update();
+
+		virtual void
+		sendPacket(const Header &header,
+				SmartPointer payload = SmartPointer());
+
+		virtual bool
+		isPacketAvailable() const;
+
+		virtual const Header&
+		getPacketHeader() const;
+
+		virtual const SmartPointer
+		getPacketPayload() const;
+
+		virtual void
+		dropPacket();
+
+		/// Check if the log file could be created
+		inline bool
+		isRecording() const
+		{
+			return this->log.isOpen();
+		}
+
+	private:
+		uint32_t
+		getTime() const;
+
+		void
+		recordReceivedPacket() const;
+
+		BackendInterface * const backend;
+
+		mutable TrafficLogWriter log;
+		const Timestamp start;
+
+		/// The current received packet is already in the log
+		mutable bool packetRecorded;
+	};
+}
+
+#endif	// XPCC__TRAFFIC_RECORDER_HPP
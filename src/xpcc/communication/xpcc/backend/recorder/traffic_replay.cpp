@@ -0,0 +1,147 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "traffic_replay.hpp"
+
+// ----------------------------------------------------------------------------
+xpcc::TrafficReplay::TrafficReplay(const char *filename, float speed,
+		uint8_t directions) :
+	reader(filename), speed(speed), directions(directions),
+	hasEntry(false), isDue(false),
+	started(false), firstTime(0), lastTime(0), offset(0),
+	replayedPackets(0)
+{
+	this->readEntry();
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::TrafficReplay::update()
+{
+	this->checkEntry();
+}
+
+void
+xpcc::TrafficReplay::sendPacket(const Header& /* header */,
+		SmartPointer /* payload */)
+{
+}
+
+bool
+xpcc::TrafficReplay::isPacketAvailable() const
+{
+	return this->hasEntry && this->isDue;
+}
+
+const xpcc::Header&
+xpcc::TrafficReplay::getPacketHeader() const
+{
+	return this->entry.header;
+}
+
+const xpcc::SmartPointer
+xpcc::TrafficReplay::getPacketPayload() const
+{
+	return this->payload;
+}
+
+void
+xpcc::TrafficReplay::dropPacket()
+{
+	if (!this->isPacketAvailable()) {
+		return;
+	}
+
+	this->replayedPackets++;
+	this->readEntry();
+
+	// with the recorded timing all packets which are due are delivered
+	// at once, otherwise only one packet per update()
+	if (this->speed > 0) {
+		this->checkEntry();
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::TrafficReplay::setSpeed(float speed)
+{
+	if (this->started)
+	{
+		this->offset = this->getReplayTime();
+		this->start = Clock::now();
+	}
+	this->speed = speed;
+}
+
+void
+xpcc::TrafficReplay::restart()
+{
+	this->reader.rewind();
+	this->started = false;
+	this->offset = 0;
+	this->replayedPackets = 0;
+	this->readEntry();
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::TrafficReplay::readEntry()
+{
+	this->hasEntry = false;
+	this->isDue = false;
+	this->payload = SmartPointer();
+
+	while (this->reader.next(this->entry))
+	{
+		if (this->entry.direction & this->directions)
+		{
+			this->hasEntry = true;
+			this->payload = this->entry.getPayload();
+			break;
+		}
+	}
+}
+
+void
+xpcc::TrafficReplay::checkEntry()
+{
+	if (!this->hasEntry || this->isDue) {
+		return;
+	}
+
+	if (!this->started)
+	{
+		// the replay starts with the first packet
+		this->started = true;
+		this->firstTime = this->entry.time;
+		this->start = Clock::now();
+		this->isDue = true;
+	}
+	else if (this->speed <= 0) {
+		this->isDue = true;
+	}
+	else {
+		this->isDue = (this->entry.time - this->firstTime <= this->getReplayTime());
+	}
+
+	if (this->isDue) {
+		this->lastTime = this->entry.time;
+	}
+}
+
+uint32_t
+xpcc::TrafficReplay::getReplayTime() const
+{
+	if (this->speed <= 0) {
+		return this->lastTime - this->firstTime;
+	}
+
+	uint32_t elapsed = (Clock::now() - this->start).getTime();
+	return this->offset + static_cast<uint32_t>(elapsed * this->speed);
+}
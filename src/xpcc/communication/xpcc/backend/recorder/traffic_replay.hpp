@@ -0,0 +1,123 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__TRAFFIC_REPLAY_HPP
+#define XPCC__TRAFFIC_REPLAY_HPP
+
+#include <xpcc/architecture/driver/clock.hpp>
+
+#include "../backend_interface.hpp"
+#include "traffic_log.hpp"
+
+namespace xpcc
+{
+	/**
+	 * \brief	Backend delivering the packets of a traffic log
+	 *
+	 * By default only the received packets of the log are delivered, the
+	 * transmitted ones are created again by the components under test.
+	 * Packets passed to sendPacket() are discarded.
+	 *
+	 * With a positive speed a packet becomes available once the time
+	 * since the start of the replay, multiplied by the speed, has reached
+	 * its time in the log relative to the first delivered packet. All
+	 * packets which are due are delivered in the same update() cycle.
+	 *
+	 * With a speed of zero the packets are delivered as fast as possible,
+	 * one per call of update(). The sequence of packets and calls is
+	 * then independent of the machine and its load.
+	 *
+	 * \ingroup	recorder
+	 */
+	class TrafficReplay : public BackendInterface
+	{
+	public:
+		/**
+		 * \param	filename	traffic log created by xpcc::TrafficRecorder
+		 * \param	speed		factor for the recorded timing,
+		 * 						0 for as fast as possible
+		 * \param	directions	combination of xpcc::TrafficLog::Direction
+		 * 						values to deliver
+		 */
+		TrafficReplay(const char *filename, float speed = 1.0f,
+				uint8_t directions = TrafficLog::RECEIVED);
+
+		virtual void
+		update();
+
+		/// Discards the packet
+		virtual void
+		sendPacket(const Header &header,
+				SmartPointer payload = SmartPointer());
+
+		virtual bool
+		isPacketAvailable() const;
+
+		virtual const Header&
+		getPacketHeader() const;
+
+		virtual const SmartPointer
+		getPacketPayload() const;
+
+		virtual void
+		dropPacket();
+
+		/// Change the speed, the already replayed time is kept
+		void
+		setSpeed(float speed);
+
+		/// Start again with the first packet of the log
+		void
+		restart();
+
+		/// Check if all packets of the log have been delivered
+		inline bool
+		isFinished() const
+		{
+			return !this->hasEntry;
+		}
+
+		/// Number of packets delivered so far
+		inline uint32_t
+		getNumberOfReplayedPackets() const
+		{
+			return this->replayedPackets;
+		}
+
+	private:
+		/// Read the next entry of the selected directions
+		void
+		readEntry();
+
+		/// Check if the current entry is due
+		void
+		checkEntry();
+
+		/// Milliseconds of the log which have been replayed
+		uint32_t
+		getReplayTime() const;
+
+		TrafficLogReader reader;
+		float speed;
+		const uint8_t directions;
+
+		TrafficLog::Entry entry;
+		bool hasEntry;
+		bool isDue;
+		SmartPointer payload;
+
+		bool started;
+		uint32_t firstTime;		///< log time of the first delivered entry
+		uint32_t lastTime;		///< log time of the last delivered entry
+		uint32_t offset;		///< replay time at `start`
+		Timestamp start;
+		uint32_t replayedPackets;
+	};
+}
+
+#endif	// XPCC__TRAFFIC_REPLAY_HPP
@@ -0,0 +1,19 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+/**
+ * \ingroup		backend
+ * \defgroup 	shared_memory	Shared Memory
+ * \brief 		Backend for processes on the same Linux host.
+ *
+ * All processes map the same POSIX shared memory segment. A packet is
+ * written once into a ring buffer and read directly from there by all
+ * other processes. Waiting processes are woken up with a futex, no
+ * system call is needed to transmit or receive a packet otherwise.
+ */
+
+#include "shared_memory/connector.hpp"
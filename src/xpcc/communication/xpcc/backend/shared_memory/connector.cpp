@@ -0,0 +1,389 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "connector.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <climits>
+#include <cstring>
+
+#include <xpcc/debug/logger.hpp>
+
+#undef  XPCC_LOG_LEVEL
+#define XPCC_LOG_LEVEL xpcc::log::WARNING
+
+static_assert(sizeof(xpcc::Header) <= 6, "Record layout requires a small header");
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+		"Atomics in shared memory must be lock free");
+
+namespace
+{
+	const uint32_t segmentMagic = 0x78706363;	// "xpcc"
+
+	long
+	futex(std::atomic<uint32_t> *address, int operation, uint32_t value,
+			const timespec *timeout = nullptr)
+	{
+		// not FUTEX_PRIVATE_FLAG, the futex is shared between processes
+		return syscall(SYS_futex, reinterpret_cast<uint32_t *>(address),
+				operation, value, timeout, nullptr, 0);
+	}
+
+	/// Wait until `condition()` is true, at most about one second
+	template< typename Condition >
+	bool
+	waitFor(Condition condition)
+	{
+		for (int i = 0; i < 1000; ++i)
+		{
+			if (condition()) {
+				return true;
+			}
+			usleep(1000);
+		}
+		return condition();
+	}
+}
+
+// ----------------------------------------------------------------------------
+xpcc::SharedMemoryConnector::SharedMemoryConnector(const char *name, std::size_t size) :
+	name(name), segment(nullptr), mappedSize(0), mask(0), id(0), readPosition(0),
+	packetAvailable(false), statistics()
+{
+	if (!this->open(size)) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not open shared memory " << name << xpcc::endl;
+		return;
+	}
+
+	this->id = this->segment->nextConnectorId.fetch_add(1) + 1;
+	// only packets transmitted from now on are received
+	this->readPosition = this->segment->committed.load(std::memory_order_acquire);
+}
+
+xpcc::SharedMemoryConnector::~SharedMemoryConnector()
+{
+	if (this->segment != nullptr) {
+		munmap(this->segment, this->mappedSize);
+	}
+}
+
+bool
+xpcc::SharedMemoryConnector::remove(const char *name)
+{
+	return (shm_unlink(name) == 0);
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::SharedMemoryConnector::open(std::size_t size)
+{
+	bool created = true;
+	int fd = shm_open(this->name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+	if (fd < 0)
+	{
+		if (errno != EEXIST) {
+			return false;
+		}
+		created = false;
+		fd = shm_open(this->name.c_str(), O_RDWR | O_CLOEXEC, 0);
+		if (fd < 0) {
+			return false;
+		}
+	}
+
+	if (created)
+	{
+		std::size_t bufferSize = 1024;
+		while (bufferSize < size) {
+			bufferSize <<= 1;
+		}
+		this->mappedSize = dataOffset + bufferSize;
+		if (ftruncate(fd, this->mappedSize) != 0) {
+			close(fd);
+			shm_unlink(this->name.c_str());
+			return false;
+		}
+	}
+	else
+	{
+		// the creator might not have set the size yet
+		struct stat status;
+		waitFor([&]() {
+			return (fstat(fd, &status) == 0 && status.st_size > 0);
+		});
+		this->mappedSize = status.st_size;
+		if (this->mappedSize <= dataOffset) {
+			close(fd);
+			return false;
+		}
+	}
+
+	void *memory = mmap(nullptr, this->mappedSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED, fd, 0);
+	close(fd);
+	if (memory == MAP_FAILED) {
+		return false;
+	}
+	this->segment = static_cast<Segment *>(memory);
+
+	if (created)
+	{
+		// the new segment is filled with zeros
+		this->segment->size = this->mappedSize - dataOffset;
+
+		pthread_mutexattr_t attributes;
+		pthread_mutexattr_init(&attributes);
+		pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+		pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+		pthread_mutex_init(&this->segment->transmitMutex, &attributes);
+		pthread_mutexattr_destroy(&attributes);
+
+		this->segment->magic.store(segmentMagic, std::memory_order_release);
+	}
+	else if (!waitFor([this]() {
+			return this->segment->magic.load(std::memory_order_acquire) == segmentMagic; }) ||
+			this->segment->size + dataOffset != this->mappedSize)
+	{
+		munmap(this->segment, this->mappedSize);
+		this->segment = nullptr;
+		return false;
+	}
+
+	this->mask = this->segment->size - 1;
+	return true;
+}
+
+uint8_t *
+xpcc::SharedMemoryConnector::getData(uint64_t position) const
+{
+	return reinterpret_cast<uint8_t *>(this->segment) + dataOffset + (position & this->mask);
+}
+
+std::size_t
+xpcc::SharedMemoryConnector::getMaxPayloadSize() const
+{
+	if (this->segment == nullptr) {
+		return 0;
+	}
+	std::size_t size = this->segment->size / 4 - sizeof(Record);
+	return (size < paddingRecord) ? size : (paddingRecord - 1);
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::SharedMemoryConnector::lockTransmitter()
+{
+	int result = pthread_mutex_lock(&this->segment->transmitMutex);
+	if (result == EOWNERDEAD)
+	{
+		// The previous transmitter died while writing, its record was
+		// never committed and is discarded.
+		this->segment->reserved.store(
+				this->segment->committed.load(std::memory_order_relaxed),
+				std::memory_order_relaxed);
+		pthread_mutex_consistent(&this->segment->transmitMutex);
+		result = 0;
+	}
+	return (result == 0);
+}
+
+void
+xpcc::SharedMemoryConnector::sendPacket(const Header &header, SmartPointer payload)
+{
+	if (this->segment == nullptr) {
+		return;
+	}
+
+	const std::size_t payloadSize = payload.getSize();
+	if (payloadSize > this->getMaxPayloadSize()) {
+		this->statistics.droppedPackets++;
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Payload too large, packet dropped" << xpcc::endl;
+		return;
+	}
+	const uint32_t length = (sizeof(Record) + payloadSize + alignment - 1) & ~(alignment - 1);
+
+	if (!this->lockTransmitter()) {
+		return;
+	}
+
+	// Records are never split, the rest of the buffer is skipped with a
+	// padding record if necessary. All lengths are multiples of the
+	// record size, so there is always space for it.
+	const uint64_t start = this->segment->committed.load(std::memory_order_relaxed);
+	const uint32_t remaining = this->segment->size - (start & this->mask);
+	const uint32_t padding = (length > remaining) ? remaining : 0;
+	const uint64_t end = start + padding + length;
+
+	// announce the overwritten area before writing, see fetch()
+	this->segment->reserved.store(end, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (padding > 0)
+	{
+		Record *record = reinterpret_cast<Record *>(this->getData(start));
+		record->length = padding;
+		record->connector = this->id;
+		record->payloadSize = paddingRecord;
+	}
+
+	Record *record = reinterpret_cast<Record *>(this->getData(start + padding));
+	record->length = length;
+	record->connector = this->id;
+	record->header = header;
+	record->payloadSize = payloadSize;
+	if (payloadSize > 0) {
+		std::memcpy(record + 1, payload.getPointer(), payloadSize);
+	}
+
+	this->segment->committed.store(end, std::memory_order_release);
+	pthread_mutex_unlock(&this->segment->transmitMutex);
+
+	// sequentially consistent together with waitForPacket(), otherwise
+	// a receiver might go to sleep right after this packet was added
+	this->segment->sequence.fetch_add(1, std::memory_order_seq_cst);
+	if (this->segment->waiters.load(std::memory_order_seq_cst) > 0) {
+		futex(&this->segment->sequence, FUTEX_WAKE, INT_MAX);
+		this->statistics.wakeups++;
+	}
+	this->statistics.transmittedPackets++;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::SharedMemoryConnector::fetch()
+{
+	const uint64_t size = this->segment->size;
+	while (true)
+	{
+		const uint64_t committed = this->segment->committed.load(std::memory_order_acquire);
+		if (this->readPosition == committed) {
+			return false;
+		}
+		if (committed - this->readPosition > size) {
+			this->statistics.overruns++;
+			this->readPosition = committed;
+			return false;
+		}
+
+		const uint8_t *data = this->getData(this->readPosition);
+		Record record;
+		std::memcpy(&record, data, sizeof(Record));
+
+		const bool isPadding = (record.payloadSize == paddingRecord);
+		bool valid = (record.length >= sizeof(Record) &&
+				(record.length % alignment) == 0 &&
+				(this->readPosition & this->mask) + record.length <= size &&
+				this->readPosition + record.length <= committed &&
+				(isPadding || sizeof(Record) + record.payloadSize <= record.length));
+
+		const bool isOwn = (record.connector == this->id);
+		SmartPointer payload;
+		if (valid && !isPadding && !isOwn && record.payloadSize > 0)
+		{
+			payload = SmartPointer(record.payloadSize);
+			std::memcpy(payload.getPointer(), data + sizeof(Record), record.payloadSize);
+		}
+
+		// The transmitters might have overwritten the record while it was
+		// copied, in this case it is discarded.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (!valid || this->segment->reserved.load(std::memory_order_relaxed) -
+				this->readPosition > size)
+		{
+			this->statistics.overruns++;
+			this->readPosition = this->segment->committed.load(std::memory_order_acquire);
+			return false;
+		}
+		this->readPosition += record.length;
+
+		if (!isPadding && !isOwn)
+		{
+			this->receivedHeader = record.header;
+			this->receivedPayload = payload;
+			this->packetAvailable = true;
+			this->statistics.receivedPackets++;
+			return true;
+		}
+	}
+}
+
+void
+xpcc::SharedMemoryConnector::update()
+{
+	if (!this->packetAvailable && this->segment != nullptr) {
+		this->fetch();
+	}
+}
+
+bool
+xpcc::SharedMemoryConnector::isPacketAvailable() const
+{
+	return this->packetAvailable;
+}
+
+const xpcc::Header&
+xpcc::SharedMemoryConnector::getPacketHeader() const
+{
+	return this->receivedHeader;
+}
+
+const xpcc::SmartPointer
+xpcc::SharedMemoryConnector::getPacketPayload() const
+{
+	return this->receivedPayload;
+}
+
+void
+xpcc::SharedMemoryConnector::dropPacket()
+{
+	this->packetAvailable = false;
+	this->receivedPayload = SmartPointer();
+	if (this->segment != nullptr) {
+		this->fetch();
+	}
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::SharedMemoryConnector::waitForPacket(std::chrono::microseconds timeout)
+{
+	if (this->packetAvailable || this->segment == nullptr) {
+		return this->packetAvailable;
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	this->segment->waiters.fetch_add(1, std::memory_order_seq_cst);
+	while (true)
+	{
+		const uint32_t sequence = this->segment->sequence.load(std::memory_order_seq_cst);
+		if (this->fetch()) {
+			break;
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now >= deadline) {
+			break;
+		}
+		const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+		timespec time;
+		time.tv_sec = remaining.count() / 1000000000;
+		time.tv_nsec = remaining.count() % 1000000000;
+
+		// returns at once if a packet was transmitted after loading `sequence`
+		futex(&this->segment->sequence, FUTEX_WAIT, sequence, &time);
+	}
+	this->segment->waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+	return this->packetAvailable;
+}
@@ -0,0 +1,214 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC__SHARED_MEMORY_CONNECTOR_HPP
+#define XPCC__SHARED_MEMORY_CONNECTOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <pthread.h>
+
+#include <xpcc/container/smart_pointer.hpp>
+
+#include "../backend_interface.hpp"
+
+namespace xpcc
+{
+	/**
+	 * \brief	Backend exchanging packets through POSIX shared memory
+	 *
+	 * All connectors opened with the same name share one segment (see
+	 * `shm_open()`), which is created by the first one. It contains a
+	 * ring buffer every connector appends its packets to. The header
+	 * and the payload of a packet are written once and read by all
+	 * other connectors, which keep their own read position. The own
+	 * packets are skipped.
+	 *
+	 * Like on a bus the transmitters never wait for the receivers. A
+	 * receiver which falls behind by more than the size of the ring
+	 * buffer loses the overwritten packets and continues with the next
+	 * one written (see Statistics::overruns). The xpcc::Dispatcher
+	 * retransmits lost action calls and responses a few times until
+	 * they are acknowledged. Events and ACKs are never acknowledged or
+	 * retransmitted, when overwritten they are lost without further
+	 * notice. The ring buffer has to be large enough for all packets
+	 * transmitted while the slowest receiver does not call update().
+	 *
+	 * Transmitters are serialised by a robust process shared mutex, so
+	 * a process killed while transmitting does not block the others.
+	 * Receivers do not lock anything. A record is copied out of the
+	 * ring buffer and afterwards checked to be still valid, the same as
+	 * with a seqlock.
+	 *
+	 * waitForPacket() sleeps on a futex in the segment which is woken
+	 * up by the transmitters, no polling is required:
+	 * @code
+	 * xpcc::SharedMemoryConnector connector("/robot");
+	 * xpcc::Dispatcher dispatcher(&connector, &postman);
+	 *
+	 * while (true)
+	 * {
+	 *     connector.waitForPacket(std::chrono::milliseconds(1));
+	 *     dispatcher.update();
+	 * }
+	 * @endcode
+	 *
+	 * The segment is kept after all connectors are closed, it has to be
+	 * deleted with remove() if needed.
+	 *
+	 * \ingroup	shared_memory
+	 */
+	class SharedMemoryConnector : public BackendInterface
+	{
+	public:
+		/**
+		 * \param	name	name of the segment, has to start with a slash
+		 * \param	size	size of the ring buffer in bytes, rounded up
+		 * 					to a power of two, only used if the segment is
+		 * 					created
+		 */
+		SharedMemoryConnector(const char *name, std::size_t size = 64 * 1024);
+
+		virtual
+		~SharedMemoryConnector();
+
+		/// Check if the segment could be opened
+		inline bool
+		isConnected() const
+		{
+			return (this->segment != nullptr);
+		}
+
+		/// Delete the segment, connectors having it open may still use it
+		static bool
+		remove(const char *name);
+
+		/// Fetch the next packet if none is available
+		virtual void
+		update();
+
+		/// Append the packet to the ring buffer, visible to the others at once
+		virtual void
+		sendPacket(const Header &header,
+				SmartPointer payload = SmartPointer());
+
+		virtual bool
+		isPacketAvailable() const;
+
+		virtual const Header&
+		getPacketHeader() const;
+
+		virtual const SmartPointer
+		getPacketPayload() const;
+
+		/// Drop the current packet and fetch the next one
+		virtual void
+		dropPacket();
+
+		/**
+		 * \brief	Wait until a packet of another connector is available
+		 *
+		 * \return	`true` if a packet is available, `false` after the
+		 * 			timeout
+		 */
+		bool
+		waitForPacket(std::chrono::microseconds timeout);
+
+		/// Largest payload which can be transmitted, a quarter of the buffer
+		std::size_t
+		getMaxPayloadSize() const;
+
+		struct Statistics
+		{
+			uint32_t transmittedPackets;
+			uint32_t receivedPackets;
+			uint32_t droppedPackets;	///< payload too large
+			uint32_t overruns;			///< packets overwritten before they were read
+			uint32_t wakeups;			///< futex wake up system calls
+		};
+
+		inline const Statistics&
+		getStatistics() const
+		{
+			return this->statistics;
+		}
+
+	private:
+		SharedMemoryConnector(const SharedMemoryConnector&) = delete;
+
+		SharedMemoryConnector&
+		operator = (const SharedMemoryConnector&) = delete;
+
+		/// Beginning of the shared memory segment
+		struct Segment
+		{
+			std::atomic<uint32_t> magic;	///< set when initialized
+			uint32_t size;					///< size of the ring buffer
+			std::atomic<uint32_t> nextConnectorId;
+
+			/// futex, incremented for every transmitted packet
+			std::atomic<uint32_t> sequence;
+			/// number of connectors waiting on `sequence`
+			std::atomic<uint32_t> waiters;
+
+			pthread_mutex_t transmitMutex;
+
+			/// end of the records being written, ahead of `committed`
+			std::atomic<uint64_t> reserved;
+			/// end of the completely written records
+			std::atomic<uint64_t> committed;
+
+			// the ring buffer follows at `dataOffset`
+		};
+
+		/// Record in the ring buffer, the payload follows directly
+		struct Record
+		{
+			uint32_t length;		///< including this header and padding
+			uint32_t connector;		///< id of the transmitting connector
+			Header header;
+			uint16_t payloadSize;	///< `paddingRecord` for a wrap around
+		};
+
+		static constexpr uint16_t paddingRecord = 0xffff;
+		static constexpr std::size_t alignment = sizeof(Record);
+		static constexpr std::size_t dataOffset = 128;
+		static_assert(sizeof(Segment) <= dataOffset,
+				"The segment header overlaps the ring buffer!");
+
+		bool
+		open(std::size_t size);
+
+		bool
+		lockTransmitter();
+
+		uint8_t *
+		getData(uint64_t position) const;
+
+		/// Copy the next record of another connector out of the ring buffer
+		bool
+		fetch();
+
+		std::string name;
+		Segment *segment;
+		std::size_t mappedSize;
+		uint64_t mask;
+
+		uint32_t id;
+		uint64_t readPosition;
+
+		bool packetAvailable;
+		Header receivedHeader;
+		SmartPointer receivedPayload;
+
+		Statistics statistics;
+	};
+}
+
+#endif	// XPCC__SHARED_MEMORY_CONNECTOR_HPP
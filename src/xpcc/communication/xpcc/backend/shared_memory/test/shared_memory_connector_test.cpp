@@ -0,0 +1,172 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unistd.h>
+#include <algorithm>
+#include <thread>
+
+#include <xpcc/communication/xpcc/backend/shared_memory.hpp>
+
+#include "shared_memory_connector_test.hpp"
+
+namespace
+{
+	const uint8_t payload[] = { 0x12, 0x34, 0x56, 0x78, 0x9a };
+}
+
+// ----------------------------------------------------------------------------
+void
+SharedMemoryConnectorTest::setUp()
+{
+	this->name = "/xpcc_test_" + std::to_string(getpid());
+	xpcc::SharedMemoryConnector::remove(this->name.c_str());
+}
+
+void
+SharedMemoryConnectorTest::tearDown()
+{
+	xpcc::SharedMemoryConnector::remove(this->name.c_str());
+}
+
+// ----------------------------------------------------------------------------
+void
+SharedMemoryConnectorTest::testExchange()
+{
+	xpcc::SharedMemoryConnector first(this->name.c_str());
+	xpcc::SharedMemoryConnector second(this->name.c_str());
+	xpcc::SharedMemoryConnector third(this->name.c_str());
+	TEST_ASSERT_TRUE(first.isConnected());
+	TEST_ASSERT_TRUE(second.isConnected());
+
+	xpcc::Header header(xpcc::Header::Type::RESPONSE, false, 0x12, 0x34, 0x56);
+	first.sendPacket(header, xpcc::SmartPointer(&payload));
+
+	// every other connector receives the packet
+	second.update();
+	TEST_ASSERT_TRUE(second.isPacketAvailable());
+	TEST_ASSERT_TRUE(second.getPacketHeader() == header);
+	TEST_ASSERT_EQUALS(second.getPacketPayload().getSize(), sizeof(payload));
+	TEST_ASSERT_EQUALS_ARRAY(second.getPacketPayload().getPointer(), payload, sizeof(payload));
+	second.dropPacket();
+	TEST_ASSERT_FALSE(second.isPacketAvailable());
+
+	third.update();
+	TEST_ASSERT_TRUE(third.isPacketAvailable());
+	TEST_ASSERT_TRUE(third.getPacketHeader() == header);
+	third.dropPacket();
+
+	// but not the transmitter itself
+	first.update();
+	TEST_ASSERT_FALSE(first.isPacketAvailable());
+
+	// packets without payload, dropPacket() fetches the next one
+	xpcc::Header ack(xpcc::Header::Type::REQUEST, true, 0x34, 0x12, 0x56);
+	second.sendPacket(ack);
+	third.sendPacket(header, xpcc::SmartPointer(&payload));
+
+	first.update();
+	TEST_ASSERT_TRUE(first.getPacketHeader() == ack);
+	TEST_ASSERT_EQUALS(first.getPacketPayload().getSize(), 0);
+	first.dropPacket();
+	TEST_ASSERT_TRUE(first.isPacketAvailable());
+	TEST_ASSERT_TRUE(first.getPacketHeader() == header);
+	first.dropPacket();
+	TEST_ASSERT_FALSE(first.isPacketAvailable());
+
+	TEST_ASSERT_EQUALS(first.getStatistics().transmittedPackets, 1U);
+	TEST_ASSERT_EQUALS(first.getStatistics().receivedPackets, 2U);
+	TEST_ASSERT_EQUALS(first.getStatistics().overruns, 0U);
+
+	// a connector opened later only receives new packets
+	xpcc::SharedMemoryConnector fourth(this->name.c_str());
+	fourth.update();
+	TEST_ASSERT_FALSE(fourth.isPacketAvailable());
+}
+
+void
+SharedMemoryConnectorTest::testWrapAround()
+{
+	xpcc::SharedMemoryConnector transmitter(this->name.c_str(), 1024);
+	xpcc::SharedMemoryConnector receiver(this->name.c_str());
+	TEST_ASSERT_EQUALS(transmitter.getMaxPayloadSize(), 256U - 16U);
+
+	// payloads of different sizes, so that records end everywhere in
+	// the buffer
+	uint8_t data[200];
+	for (uint16_t i = 0; i < 100; ++i)
+	{
+		const uint16_t size = (i * 7) % sizeof(data);
+		for (uint16_t k = 0; k < size; ++k) {
+			data[k] = i + k;
+		}
+		xpcc::SmartPointer message(size);
+		std::copy(data, data + size, message.getPointer());
+		transmitter.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x10, 0x20, i), message);
+
+		receiver.update();
+		TEST_ASSERT_TRUE(receiver.isPacketAvailable());
+		TEST_ASSERT_EQUALS(receiver.getPacketHeader().packetIdentifier, i % 256);
+		TEST_ASSERT_EQUALS(receiver.getPacketPayload().getSize(), size);
+		TEST_ASSERT_EQUALS_ARRAY(receiver.getPacketPayload().getPointer(), data, size);
+		receiver.dropPacket();
+	}
+	TEST_ASSERT_EQUALS(receiver.getStatistics().overruns, 0U);
+
+	// too large for the buffer
+	transmitter.sendPacket(xpcc::Header(), xpcc::SmartPointer(uint16_t(241)));
+	TEST_ASSERT_EQUALS(transmitter.getStatistics().droppedPackets, 1U);
+	receiver.update();
+	TEST_ASSERT_FALSE(receiver.isPacketAvailable());
+}
+
+void
+SharedMemoryConnectorTest::testOverrun()
+{
+	xpcc::SharedMemoryConnector transmitter(this->name.c_str(), 1024);
+	xpcc::SharedMemoryConnector receiver(this->name.c_str());
+
+	// 32 bytes per record, 40 records do not fit
+	for (uint8_t i = 0; i < 40; ++i) {
+		transmitter.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x10, 0x20, i),
+				xpcc::SmartPointer(&payload));
+	}
+
+	// the overwritten packets are lost, the following ones are received
+	receiver.update();
+	TEST_ASSERT_FALSE(receiver.isPacketAvailable());
+	TEST_ASSERT_EQUALS(receiver.getStatistics().overruns, 1U);
+
+	transmitter.sendPacket(xpcc::Header(xpcc::Header::Type::REQUEST, false, 0x10, 0x20, 40));
+	receiver.update();
+	TEST_ASSERT_TRUE(receiver.isPacketAvailable());
+	TEST_ASSERT_EQUALS(receiver.getPacketHeader().packetIdentifier, 40);
+}
+
+void
+SharedMemoryConnectorTest::testWaitForPacket()
+{
+	xpcc::SharedMemoryConnector transmitter(this->name.c_str());
+	xpcc::SharedMemoryConnector receiver(this->name.c_str());
+
+	TEST_ASSERT_FALSE(receiver.waitForPacket(std::chrono::milliseconds(5)));
+
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0x10, 0x20, 0x30);
+	std::thread thread([&]() {
+		usleep(10000);
+		transmitter.sendPacket(header, xpcc::SmartPointer(&payload));
+	});
+
+	TEST_ASSERT_TRUE(receiver.waitForPacket(std::chrono::seconds(2)));
+	TEST_ASSERT_TRUE(receiver.getPacketHeader() == header);
+	thread.join();
+
+	TEST_ASSERT_EQUALS(transmitter.getStatistics().wakeups, 1U);
+
+	// an available packet is returned at once
+	TEST_ASSERT_TRUE(receiver.waitForPacket(std::chrono::seconds(2)));
+}
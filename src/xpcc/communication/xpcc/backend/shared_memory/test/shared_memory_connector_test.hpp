@@ -0,0 +1,41 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef SHARED_MEMORY_CONNECTOR_TEST_HPP
+#define SHARED_MEMORY_CONNECTOR_TEST_HPP
+
+#include <string>
+#include <unittest/testsuite.hpp>
+
+class SharedMemoryConnectorTest : public unittest::TestSuite
+{
+public:
+	virtual void
+	setUp();
+
+	virtual void
+	tearDown();
+
+public:
+	void
+	testExchange();
+
+	void
+	testWrapAround();
+
+	void
+	testOverrun();
+
+	void
+	testWaitForPacket();
+
+private:
+	std::string name;
+};
+
+#endif	// SHARED_MEMORY_CONNECTOR_TEST_HPP
@@ -92,6 +92,20 @@ namespace xpcc
 			this->receiver.addReceiverId(id);
 		}
 
+		/**
+		 * \brief	File descriptor which is readable while packets are available
+		 *
+		 * Allows to sleep in poll() or epoll until a packet arrives instead
+		 * of calling Dispatcher::update() periodically.
+		 *
+		 * \see	tipc::Receiver::getEventFileDescriptor()
+		 */
+		inline int
+		getEventFileDescriptor()
+		{
+			return this->receiver.getEventFileDescriptor();
+		}
+
 		/// Check if a new packet was received by the backend
 		virtual bool
 		isPacketAvailable() const;
@@ -30,6 +30,11 @@
 #include "receiver.hpp"
 #include "header.hpp"
 
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <errno.h>
+
 #include <boost/bind.hpp>
 
 #include <xpcc/debug/logger.hpp>
@@ -43,21 +48,56 @@ xpcc::tipc::Receiver::Receiver(
 	tipcReceiverSocket_(),
 	ignoreTipcPortId_(ignoreTipcPortId),
 	domainId_( tipc::Header::DOMAIN_ID_UNDEFINED ),
-	packetQueue_(),
-	receiverThread_(),
-	receiverSocketLock_(),
-	packetQueueLock_(),
-	isAlive_(true)
+	head_(0),
+	tail_(0),
+	stopEvent_(-1),
+	packetEvent_(-1),
+	packetEventSignaled_(false),
+	discardedPackets_(0),
+	receiverThread_()
 {
-	// The start of the thread has to be placed _after_ the initialization of isAlive_
-	this->receiverThread_.reset(new Thread(boost::bind(&Receiver::runReceiver, this)));
+	this->start();
+}
+
+xpcc::tipc::Receiver::Receiver(
+		uint32_t ignoreTipcPortId, int socketDescriptor) :
+	tipcReceiverSocket_(socketDescriptor),
+	ignoreTipcPortId_(ignoreTipcPortId),
+	domainId_( tipc::Header::DOMAIN_ID_UNDEFINED ),
+	head_(0),
+	tail_(0),
+	stopEvent_(-1),
+	packetEvent_(-1),
+	packetEventSignaled_(false),
+	discardedPackets_(0),
+	receiverThread_()
+{
+	this->start();
 }
 
 // ----------------------------------------------------------------------------
 xpcc::tipc::Receiver::~Receiver()
 {
-	this->isAlive_ = false;
+	uint64_t value = 1;
+	if (write(this->stopEvent_, &value, sizeof(value)) != sizeof(value)) {
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not stop the receiver thread." << xpcc::flush;
+	}
 	this->receiverThread_->join();
+
+	close(this->stopEvent_);
+	if (this->packetEvent_ >= 0) {
+		close(this->packetEvent_);
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::tipc::Receiver::start()
+{
+	this->stopEvent_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	// The start of the thread has to be placed _after_ the initialization of the event
+	this->receiverThread_.reset(new Thread(boost::bind(&Receiver::runReceiver, this)));
 }
 
 // ----------------------------------------------------------------------------
@@ -71,37 +111,116 @@ xpcc::tipc::Receiver::setDomainId( unsigned int domainId )
 void
 xpcc::tipc::Receiver::dropPacket()
 {
-	// Set the mutex guard for the packetQueue
-	MutexGuard packetQueueGuard(this->packetQueueLock_);
+	std::size_t tail = this->tail_.load(std::memory_order_relaxed);
 
-	this->packetQueue_.pop();
+	// release the payload now, not when the slot is reused
+	this->packetQueue_[tail & (queueSize - 1)] = Payload();
+	this->tail_.store(tail + 1, std::memory_order_release);
 }
 
 // ----------------------------------------------------------------------------
 bool
 xpcc::tipc::Receiver::hasPacket() const
 {
-	// Set the mutex guard for the packetQueue
-	MutexGuard packetQueueGuard(this->packetQueueLock_);
+	if (this->tail_.load(std::memory_order_relaxed) !=
+			this->head_.load(std::memory_order_acquire)) {
+		return true;
+	}
+
+	if (this->packetEventSignaled_.load(std::memory_order_relaxed))
+	{
+		// All packets are processed => reset the event. A packet added
+		// in the meantime is either seen by the check below or signals
+		// the event again.
+		this->packetEventSignaled_.store(false, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		uint64_t value;
+		if (read(this->packetEvent_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not reset the packet event." << xpcc::flush;
+		}
+
+		return (this->tail_.load(std::memory_order_relaxed) !=
+				this->head_.load(std::memory_order_acquire));
+	}
 
-	return !this->packetQueue_.empty();
+	return false;
+}
+
+// ----------------------------------------------------------------------------
+int
+xpcc::tipc::Receiver::getEventFileDescriptor()
+{
+	if (this->packetEvent_ < 0)
+	{
+		this->packetEvent_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (this->packetEvent_ < 0) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not create the packet event." << xpcc::flush;
+		}
+		else if (this->hasPacket()) {
+			this->notify();
+		}
+	}
+	return this->packetEvent_;
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::tipc::Receiver::notify()
+{
+	int event = this->packetEvent_.load(std::memory_order_acquire);
+	if (event < 0) {
+		return;
+	}
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!this->packetEventSignaled_.exchange(true, std::memory_order_relaxed))
+	{
+		uint64_t value = 1;
+		if (write(event, &value, sizeof(value)) != sizeof(value)) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Could not signal the packet event." << xpcc::flush;
+		}
+	}
 }
 
 // ----------------------------------------------------------------------------
 bool
-xpcc::tipc::Receiver::isAlive()
+xpcc::tipc::Receiver::isQueueFull() const
 {
-	return this->isAlive_;
+	return ((this->head_.load(std::memory_order_relaxed) -
+			this->tail_.load(std::memory_order_acquire)) >= queueSize);
 }
 
 // ----------------------------------------------------------------------------
 void*
 xpcc::tipc::Receiver::runReceiver()
 {
-	while (this->isAlive())
+	pollfd descriptors[2];
+	descriptors[0].fd = this->stopEvent_;
+	descriptors[0].events = POLLIN;
+	descriptors[1].fd = this->tipcReceiverSocket_.getFileDescriptor();
+	descriptors[1].events = POLLIN;
+
+	bool queueFull = false;
+	while (true)
 	{
-		this->update();
-		usleep(1000);
+		// Sleep until a packet arrives. While the queue is full the socket
+		// is not watched, instead check again for free space after 1ms.
+		int result = poll(descriptors, queueFull ? 1 : 2, queueFull ? 1 : -1);
+		if (result < 0)
+		{
+			if (errno == EINTR) {
+				continue;
+			}
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "poll() failed. errno=" << errno << xpcc::flush;
+			break;
+		}
+
+		if (descriptors[0].revents != 0) {
+			break;
+		}
+
+		queueFull = !this->update();
 	}
 
 	XPCC_LOG_INFO << XPCC_FILE_INFO << "Thread terminates." << xpcc::flush;
@@ -109,52 +228,78 @@ xpcc::tipc::Receiver::runReceiver()
 }
 
 // ----------------------------------------------------------------------------
-// This method is private and is called from the runReceiver again and again!
-void
+// This method is private and is called from the runReceiver whenever
+// the socket is readable.
+bool
 xpcc::tipc::Receiver::update()
 {
 	xpcc::tipc::Header tipcHeader;
 	uint32_t tipcPortId;
-	// Set the mutex guard for the receiver socket
-	MutexGuard receiverSocketGuard( this->receiverSocketLock_ );
+	bool received = false;
 
-	// Get the TIPC header (typeId and instanceRange) - call by reference
-	while( this->tipcReceiverSocket_.receiveHeader( tipcPortId, tipcHeader ) )
+	while (!this->isQueueFull())
 	{
+		// Get the TIPC header (typeId and instanceRange) - call by reference
+		if (!this->tipcReceiverSocket_.receiveHeader( tipcPortId, tipcHeader ))
+		{
+			if (received) {
+				this->notify();
+			}
+			return true;
+		}
+
 		// ignore messages, that are send by the port, that shoud be ignored
+		unsigned int domainId = this->domainId_;
 		if 		(tipcPortId != this->ignoreTipcPortId_ &&
-				(this->domainId_==Header::DOMAIN_ID_UNDEFINED || this->domainId_==tipcHeader.domainId) )
+				(domainId == Header::DOMAIN_ID_UNDEFINED || domainId == tipcHeader.domainId) )
 		{
 			XPCC_LOG_DEBUG << XPCC_FILE_INFO << "Header available." << xpcc::flush;
 
-			// Try to allocate memory for the packet
-			Payload payload ( tipcHeader.size );
+			// Allocate the packet directly in the queue, it must not be
+			// referenced by this thread anymore once it is published.
+			std::size_t head = this->head_.load(std::memory_order_relaxed);
+			Payload& payload = this->packetQueue_[head & (queueSize - 1)];
+			payload = Payload( tipcHeader.size );
 
-			// Get the payload by passing a void pointer by reference and the length
-			// of the payload to be read from the socket.
-			this->tipcReceiverSocket_.receivePayload(
+			// Read the payload, this removes the packet from the socket.
+			// A size which does not fit into the payload is not read at all.
+			if (payload.getSize() == tipcHeader.size &&
+				this->tipcReceiverSocket_.receivePayload(
 					payload.getPointer(),
-					tipcHeader.size);
-
-			// Set the mutex guard for the packetQueue
-			MutexGuard packetQueueGuard( this->packetQueueLock_);
-
-			// add the packet to the queue
-			this->packetQueue_.push( payload );
+					tipcHeader.size))
+			{
+				// add the packet to the queue
+				this->head_.store(head + 1, std::memory_order_release);
+				received = true;
+			}
+			else {
+				if (payload.getSize() != tipcHeader.size) {
+					XPCC_LOG_ERROR << XPCC_FILE_INFO << "Packet of " << tipcHeader.size << " bytes discarded." << xpcc::flush;
+					this->tipcReceiverSocket_.popPayload();
+				}
+				payload = Payload();
+				this->discardedPackets_.fetch_add(1, std::memory_order_relaxed);
+			}
 		}
-		// Clean the TIPC socket! ( That means removing the current data from the queue)
-		this->tipcReceiverSocket_.popPayload();
+		else {
+			// Clean the TIPC socket! ( That means removing the current data from the queue)
+			this->tipcReceiverSocket_.popPayload();
+		}
+	}
+
+	if (received) {
+		this->notify();
 	}
+	return false;
 }
+
 // ----------------------------------------------------------------------------
 const xpcc::SmartPointer&
 xpcc::tipc::Receiver::getPacket() const
 {
-	// Set the mutex guard for the packetQueue
-	MutexGuard packetQueueGuard( this->packetQueueLock_);
-
-	if (!this->packetQueue_.empty()) {
-		return this->packetQueue_.front();
+	std::size_t tail = this->tail_.load(std::memory_order_relaxed);
+	if (tail != this->head_.load(std::memory_order_acquire)) {
+		return this->packetQueue_[tail & (queueSize - 1)];
 	}
 	else {
 		// No packet was available
@@ -167,9 +312,6 @@ xpcc::tipc::Receiver::getPacket() const
 void
 xpcc::tipc::Receiver::addEventId(uint8_t id)
 {
-	// Set the mutex guard for the receiver socket
-	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
-
 	// TODO: Logging on which packet one is registered..
 
 	// Ranges dürfen sich nicht überschneiden. Eine Range gilt fürs gesamte TIPC,
@@ -185,9 +327,6 @@ xpcc::tipc::Receiver::addEventId(uint8_t id)
 void
 xpcc::tipc::Receiver::addReceiverId(uint8_t id)
 {
-	// Set the mutex guard for the receiver socket
-	MutexGuard receiverSocketGuard(this->receiverSocketLock_);
-
 	// TODO: Logging on which packet one is registered..
 
 	// Ranges dürfen sich nicht überschneiden. Eine Range gilt fürs gesamte TIPC,
@@ -31,13 +31,13 @@
 #ifndef XPCC_TIPC__RECEIVER_HPP
 #define XPCC_TIPC__RECEIVER_HPP
 
-#include <queue>
+#include <atomic>
 
-#include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/scoped_ptr.hpp>
 
 #include <xpcc/container/smart_pointer.hpp>
+#include <xpcc_config.hpp>
 
 #include "receiver_socket.hpp"
 
@@ -49,6 +49,12 @@ namespace xpcc
 		 * \brief	Receive Packets over the TIPC and store them.
 		 *
 		 * In a separate thread the packets are taken from the TIPC and saved local.
+		 * The thread blocks in poll() on the socket until a packet arrives,
+		 * the packets are handed over through a lock-free single-producer
+		 * single-consumer ring of `XPCC__TIPC_RECEIVE_QUEUE_SIZE` entries.
+		 *
+		 * Use getEventFileDescriptor() to sleep until a packet is available
+		 * instead of polling hasPacket() periodically.
 		 *
 		 * \ingroup	tipc
 		 * \author	Carsten Schmitt
@@ -63,6 +69,15 @@ namespace xpcc
 			 */
 			Receiver(uint32_t ignoreTipcPortId);
 
+			/**
+			 * \brief	Receive from an already opened datagram socket
+			 *
+			 * The socket has to deliver the same frames as TIPC (tipc::Header
+			 * followed by the payload), e.g. one end of a local socket pair.
+			 * Used to test and benchmark without a TIPC enabled kernel.
+			 */
+			Receiver(uint32_t ignoreTipcPortId, int socketDescriptor);
+
 			~Receiver();
 
 			void
@@ -94,33 +109,65 @@ namespace xpcc
 			void
 			dropPacket();
 
+			/**
+			 * \brief	File descriptor which is readable while packets are available
+			 *
+			 * The eventfd is created on the first call, afterwards the
+			 * receiver thread signals it whenever a packet is added to
+			 * an empty queue. It is reset by hasPacket() once all packets
+			 * are processed, so wait on it with poll() or epoll and call
+			 * hasPacket() until it returns \c false.
+			 */
+			int
+			getEventFileDescriptor();
+
+			/// Number of packets discarded because they could not be received
+			inline uint32_t
+			getDiscardedPackets() const
+			{
+				return this->discardedPackets_.load(std::memory_order_relaxed);
+			}
+
 		private:
 			typedef xpcc::SmartPointer			Payload;
-			typedef boost::mutex				Mutex;
-			typedef boost::mutex::scoped_lock	MutexGuard;
 			typedef	boost::thread				Thread;
 
-			bool
-			isAlive();
+			/// Lock-free ring between the receiver thread and the user
+			static constexpr std::size_t queueSize = XPCC__TIPC_RECEIVE_QUEUE_SIZE;
+			static_assert((queueSize & (queueSize - 1)) == 0,
+					"XPCC__TIPC_RECEIVE_QUEUE_SIZE must be a power of two!");
+
+			void
+			start();
 
 			void*
 			runReceiver();
 
-			void
+			/// Read all pending packets from the socket, \return \c false if the queue is full
+			bool
 			update();
 
+			bool
+			isQueueFull() const;
+
+			void
+			notify();
+
 			ReceiverSocket tipcReceiverSocket_;
 			uint32_t ignoreTipcPortId_;	// the tipc port ID from that all messages will be ignored
-			unsigned int domainId_;
+			std::atomic<unsigned int> domainId_;
 
-			std::queue<Payload>	packetQueue_;
+			Payload packetQueue_[queueSize];
+			std::atomic<std::size_t> head_;	///< written by the receiver thread
+			std::atomic<std::size_t> tail_;	///< written by the user
 
-			boost::scoped_ptr<Thread> receiverThread_;
-			mutable Mutex receiverSocketLock_;
-			mutable Mutex packetQueueLock_;
+			int stopEvent_;		///< wakes the receiver thread for termination
+			std::atomic<int> packetEvent_;
+			mutable std::atomic<bool> packetEventSignaled_;
 
-			bool isAlive_;
+			std::atomic<uint32_t> discardedPackets_;
 
+			boost::scoped_ptr<Thread> receiverThread_;
 		};
 	}
 }
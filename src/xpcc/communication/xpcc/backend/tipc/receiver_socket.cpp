@@ -30,12 +30,12 @@
 #include "receiver_socket.hpp"
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <linux/tipc.h>
 #include <errno.h>
+#include <unistd.h>
 #include <cstring>
 
-#include <boost/scoped_array.hpp>
-
 #include <iostream>
 
 #include <xpcc/debug/logger.hpp>
@@ -48,6 +48,11 @@ xpcc::tipc::ReceiverSocket::ReceiverSocket() :
 	socketDescriptor_ ( socket (AF_TIPC, SOCK_RDM,0) ) // Create the socket
 {
 }
+
+xpcc::tipc::ReceiverSocket::ReceiverSocket(int socketDescriptor) :
+	socketDescriptor_ ( socketDescriptor )
+{
+}
 // ----------------------------------------------------------------------------
 xpcc::tipc::ReceiverSocket::~ReceiverSocket()
 {
@@ -98,6 +103,9 @@ xpcc::tipc::ReceiverSocket::receiveHeader(
 	Header localTipcHeader;
   	int result = 0;
 
+	// sockets of other families do not fill in a TIPC address
+	std::memset(&fromAddress, 0, sizeof(fromAddress));
+
 	// First receive the tipc-header
 	result = recvfrom(
 			this->socketDescriptor_,
@@ -107,7 +115,9 @@ xpcc::tipc::ReceiverSocket::receiveHeader(
 	        (sockaddr*) &fromAddress,
 	        &addressLength);
 
-	if( result > 0) {
+	// Every datagram is reported, even if it is too short for a header.
+	// Those are rejected by receivePayload() which removes them.
+	if( result >= 0) {
 		// Make a copy of the received data
 		transmitterPort = fromAddress.addr.id.ref;
 		tipcHeader = localTipcHeader;
@@ -136,33 +146,43 @@ xpcc::tipc::ReceiverSocket::receiveHeader(
 }
 // -------------------------------------------------------------------------------------------------------
 // This method gets payload form the TIPC socket form the given length
-// without deleting it. It returns true if the payload could be received
-// correctly from the TIPC socket - otherwise false.
+// and removes the packet. The header and the payload are read directly
+// into their destination with a single call. It returns true if the
+// payload could be received correctly from the TIPC socket - otherwise false.
+// The packet is removed in both cases, a malformed packet must not block
+// the following ones.
 bool
 xpcc::tipc::ReceiverSocket::receivePayload(uint8_t* payloadPointer, size_t payloadLength)
 {
 	int result = 0;
-
-	// Allocate memory for the whole packet inclusive header
-	boost::scoped_array<uint8_t> packetPointer ( new uint8_t[ sizeof(Header) + payloadLength ] );
-
-	result = recv(	this->socketDescriptor_,
-					packetPointer.get(),
-					sizeof(Header) + payloadLength,
-					MSG_PEEK | MSG_DONTWAIT);	// Do not delete data from TIPC and do not wait for data
-
-	if( result > 0 ) {
-
-		// Copy the payload-part of the packet to it's destination!
-		memcpy(payloadPointer, packetPointer.get()+sizeof(Header), payloadLength);
-
-/*		XPCC_LOG_DEBUG << __FILE__ << __FUNCTION__;
-		for(unsigned int i=0; i<payloadLength; i++) {
-			XPCC_LOG_DEBUG << " " << (int)(*(payloadPointer+i));
+	Header header;
+
+	iovec vector[2];
+	vector[0].iov_base = &header;
+	vector[0].iov_len = sizeof(Header);
+	vector[1].iov_base = payloadPointer;
+	vector[1].iov_len = payloadLength;
+
+	msghdr message;
+	std::memset(&message, 0, sizeof(message));
+	message.msg_iov = vector;
+	message.msg_iovlen = 2;
+
+	result = recvmsg(	this->socketDescriptor_,
+						&message,
+						MSG_DONTWAIT);	// Do not wait for data
+
+	if( result >= 0 ) {
+		if (static_cast<size_t>(result) == sizeof(Header) + payloadLength &&
+				(message.msg_flags & MSG_TRUNC) == 0) {
+			return true;
 		}
-		XPCC_LOG_DEBUG << xpcc::flush;
-*/
-		return true;
+		// the packet is already removed from the socket
+		xpcc::log::error
+				<< XPCC_FILE_INFO
+				<< "Malformed packet discarded: received " << result
+				<< " bytes, expected " << (sizeof(Header) + payloadLength)
+				<< xpcc::flush;
 	}
 	else if ( errno == EWOULDBLOCK ) {
 		xpcc::log::debug
@@ -180,8 +200,10 @@ xpcc::tipc::ReceiverSocket::receivePayload(uint8_t* payloadPointer, size_t paylo
 	else {
 		xpcc::log::error
 				<< XPCC_FILE_INFO
+				<< "Packet discarded. errno=" << errno
 				<< xpcc::flush;
-		// TODO: Error handling??!!
+		// The packet is still in the socket
+		this->popPayload();
 	}
 
 	return false;
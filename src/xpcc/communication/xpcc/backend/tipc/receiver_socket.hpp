@@ -47,6 +47,11 @@ namespace xpcc {
 		class ReceiverSocket {
 			public:	
 				ReceiverSocket();
+
+				/// Take ownership of an already opened datagram socket
+				explicit
+				ReceiverSocket(int socketDescriptor);
+
 				~ReceiverSocket();
 		
 				void 
@@ -63,13 +68,29 @@ namespace xpcc {
 						uint32_t & transmitterPortId,
 						tipc::Header & tipcHeader );
 				
+				/**
+				 * Read the payload of the current packet and remove the
+				 * packet from the socket.
+				 *
+				 * \return	\c false if the packet could not be read or its
+				 * 			size does not match \p payloadLength. The packet
+				 * 			is removed nevertheless.
+				 */
 				bool 
 				receivePayload(
 						uint8_t* payloadPointer,
 						size_t payloadLength);
 				
+				/// Remove the current packet without reading it
 				bool 
 				popPayload();
+
+				/// Descriptor to wait for packets with poll()
+				inline int
+				getFileDescriptor() const
+				{
+					return this->socketDescriptor_;
+				}
 		
 			private:
 				const int socketDescriptor_;
@@ -0,0 +1,106 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <cstring>
+
+#include <xpcc/communication/xpcc/backend/tipc/receiver.hpp>
+
+#include "tipc_receiver_test.hpp"
+
+namespace
+{
+	const uint8_t payload[] = { 0x12, 0x34, 0x56, 0x78, 0x9a };
+
+	// The sockets of a socket pair do not report a TIPC port id,
+	// so the receiver sees all packets from port 0.
+	const uint32_t ignoredPortId = 1;
+
+	/// Send a TIPC header followed by `length` bytes of the payload
+	bool
+	send(int socket, size_t size, std::size_t length)
+	{
+		uint8_t buffer[sizeof(xpcc::tipc::Header) + sizeof(payload)];
+		xpcc::tipc::Header header(size);
+		std::memcpy(buffer, &header, sizeof(header));
+		std::memcpy(buffer + sizeof(header), payload, length);
+
+		std::size_t total = sizeof(header) + length;
+		return (::send(socket, buffer, total, 0) == ssize_t(total));
+	}
+
+	bool
+	waitForPacket(xpcc::tipc::Receiver& receiver)
+	{
+		for (int i = 0; i < 1000; ++i)
+		{
+			if (receiver.hasPacket()) {
+				return true;
+			}
+			usleep(1000);
+		}
+		return false;
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+TipcReceiverTest::testReceive()
+{
+	int sockets[2];
+	TEST_ASSERT_EQUALS(socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets), 0);
+	{
+		// takes ownership of the first socket
+		xpcc::tipc::Receiver receiver(ignoredPortId, sockets[0]);
+
+		TEST_ASSERT_TRUE(send(sockets[1], sizeof(payload), sizeof(payload)));
+		TEST_ASSERT_TRUE(send(sockets[1], 0, 0));
+
+		TEST_ASSERT_TRUE(waitForPacket(receiver));
+		TEST_ASSERT_EQUALS(receiver.getPacket().getSize(), sizeof(payload));
+		TEST_ASSERT_EQUALS_ARRAY(receiver.getPacket().getPointer(), payload, sizeof(payload));
+		receiver.dropPacket();
+
+		TEST_ASSERT_TRUE(waitForPacket(receiver));
+		TEST_ASSERT_EQUALS(receiver.getPacket().getSize(), 0U);
+		receiver.dropPacket();
+
+		TEST_ASSERT_FALSE(receiver.hasPacket());
+		TEST_ASSERT_EQUALS(receiver.getDiscardedPackets(), 0U);
+	}
+	close(sockets[1]);
+}
+
+void
+TipcReceiverTest::testMalformedPackets()
+{
+	int sockets[2];
+	TEST_ASSERT_EQUALS(socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets), 0);
+	{
+		xpcc::tipc::Receiver receiver(ignoredPortId, sockets[0]);
+
+		// the header announces more payload than the packet contains
+		TEST_ASSERT_TRUE(send(sockets[1], sizeof(payload), 2));
+		// an empty packet without a header
+		TEST_ASSERT_EQUALS(::send(sockets[1], payload, 0, 0), 0);
+		// the announced size does not fit into a payload
+		TEST_ASSERT_TRUE(send(sockets[1], 0x10000 + sizeof(payload), sizeof(payload)));
+		// the packets above must not block the following ones
+		TEST_ASSERT_TRUE(send(sockets[1], sizeof(payload), sizeof(payload)));
+
+		TEST_ASSERT_TRUE(waitForPacket(receiver));
+		TEST_ASSERT_EQUALS(receiver.getDiscardedPackets(), 3U);
+		TEST_ASSERT_EQUALS(receiver.getPacket().getSize(), sizeof(payload));
+		TEST_ASSERT_EQUALS_ARRAY(receiver.getPacket().getPointer(), payload, sizeof(payload));
+		receiver.dropPacket();
+
+		TEST_ASSERT_FALSE(receiver.hasPacket());
+	}
+	close(sockets[1]);
+}
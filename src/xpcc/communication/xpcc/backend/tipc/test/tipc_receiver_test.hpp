@@ -0,0 +1,24 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef TIPC_RECEIVER_TEST_HPP
+#define TIPC_RECEIVER_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+class TipcReceiverTest : public unittest::TestSuite
+{
+public:
+	void
+	testReceive();
+
+	void
+	testMalformedPackets();
+};
+
+#endif	// TIPC_RECEIVER_TEST_HPP
@@ -76,6 +76,17 @@ xpcc::Communicator::publishEvent(uint8_t eventIdentifier)
 	this->dispatcher->addMessage(header, payload);
 }
 
+#if XPCC__DISPATCHER_STATISTICS
+void
+xpcc::Communicator::publishStatistics(uint8_t eventIdentifier)
+{
+	const DispatcherStatistics& statistics = this->dispatcher->getStatistics();
+	for (uint8_t i = 0; i < statistics.getNumberOfActions(); ++i) {
+		this->publishEvent(eventIdentifier, statistics.getActions()[i]);
+	}
+}
+#endif
+
 // ----------------------------------------------------------------------------
 void
 xpcc::Communicator::sendResponse(const ResponseHandle& handle)
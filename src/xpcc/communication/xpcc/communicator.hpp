@@ -93,6 +93,34 @@ namespace xpcc
 		callAction(uint8_t receiver, uint8_t actionIdentifier, const T& data, ResponseCallback& responseCallback);
 
 
+		/**
+		 * \brief	Call an action with a payload constructed in place
+		 *
+		 * The payload of type \p T is constructed from \p args directly in
+		 * its SmartPointer storage, without a temporary object and without
+		 * allocating memory on the heap. Payloads of up to eight bytes are
+		 * stored inline, larger ones in a block of the SmartPointer pools.
+		 * The message is added to the dispatcher once the payload is
+		 * constructed.
+		 *
+		 * \code
+		 * communicator->emplaceAction<robot::packet::Position>(
+		 *         robot::component::DRIVER, robot::action::SET_POSITION, x, y);
+		 * \endcode
+		 *
+		 * \return	\c false if the message was dropped because the table
+		 * 			is full or no pool block is available
+		 */
+		template<typename T, typename... Args>
+		bool
+		emplaceAction(uint8_t receiver, uint8_t actionIdentifier, const Args&... args);
+
+		template<typename T, typename... Args>
+		bool
+		emplaceAction(uint8_t receiver, uint8_t actionIdentifier,
+				ResponseCallback& responseCallback, const Args&... args);
+
+
 		void
 		publishEvent(uint8_t eventIdentifier);
 
@@ -100,6 +128,25 @@ namespace xpcc
 		void
 		publishEvent(uint8_t eventIdentifier, const T& data);
 
+		/**
+		 * \brief	Publish an event with a payload constructed in place
+		 *
+		 * See emplaceAction().
+		 */
+		template<typename T, typename... Args>
+		bool
+		emplaceEvent(uint8_t eventIdentifier, const Args&... args);
+
+#if XPCC__DISPATCHER_STATISTICS
+		/**
+		 * \brief	Publish the statistics of the dispatcher
+		 *
+		 * Publishes one event with a xpcc::DispatcherStatistics::Action as
+		 * payload for every tracked action.
+		 */
+		void
+		publishStatistics(uint8_t eventIdentifier);
+#endif
 
 		void
 		sendResponse(const ResponseHandle& handle);
@@ -31,6 +31,8 @@
 	#error	"Don't include this file directly, use 'communicator.hpp' instead"
 #endif
 
+#include <new>		// needed for placement new
+
 
 // ----------------------------------------------------------------------------
 template<typename T>
@@ -64,6 +66,49 @@ xpcc::Communicator::callAction(uint8_t receiver, uint8_t actionIdentifier,
 	this->dispatcher->addMessage(header, payload, responseCallback);
 }
 
+// ----------------------------------------------------------------------------
+template<typename T, typename... Args>
+bool
+xpcc::Communicator::emplaceAction(uint8_t receiver, uint8_t actionIdentifier,
+		const Args&... args)
+{
+	Header header(Header::Type::REQUEST, false,
+			receiver,
+			this->ownIdentifier,
+			actionIdentifier);
+
+	// the payload is constructed before the message is visible to the
+	// dispatcher, which might transmit it from another thread
+	SmartPointer payload;
+	uint8_t *storage = this->dispatcher->reservePayload(payload, sizeof(T));
+	if (storage == nullptr) {
+		return false;
+	}
+	new (storage) T(args...);
+	return this->dispatcher->addMessage(header, payload);
+}
+
+template<typename T, typename... Args>
+bool
+xpcc::Communicator::emplaceAction(uint8_t receiver, uint8_t actionIdentifier,
+		ResponseCallback& responseCallback, const Args&... args)
+{
+	Header header(Header::Type::REQUEST, false,
+			receiver,
+			this->ownIdentifier,
+			actionIdentifier);
+
+	// the payload is constructed before the message is visible to the
+	// dispatcher, which might transmit it from another thread
+	SmartPointer payload;
+	uint8_t *storage = this->dispatcher->reservePayload(payload, sizeof(T));
+	if (storage == nullptr) {
+		return false;
+	}
+	new (storage) T(args...);
+	return this->dispatcher->addMessage(header, payload, responseCallback);
+}
+
 // ----------------------------------------------------------------------------
 template<typename T>
 void
@@ -78,6 +123,26 @@ xpcc::Communicator::publishEvent(uint8_t eventIdentifier, const T& data)
 	this->dispatcher->addMessage(header, payload);
 }
 
+template<typename T, typename... Args>
+bool
+xpcc::Communicator::emplaceEvent(uint8_t eventIdentifier, const Args&... args)
+{
+	Header header(Header::Type::REQUEST, false,
+			0,
+			this->ownIdentifier,
+			eventIdentifier);
+
+	// the payload is constructed before the message is visible to the
+	// dispatcher, which might transmit it from another thread
+	SmartPointer payload;
+	uint8_t *storage = this->dispatcher->reservePayload(payload, sizeof(T));
+	if (storage == nullptr) {
+		return false;
+	}
+	new (storage) T(args...);
+	return this->dispatcher->addMessage(header, payload);
+}
+
 // ----------------------------------------------------------------------------
 template<typename T>
 void
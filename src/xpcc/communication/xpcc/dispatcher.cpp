@@ -38,12 +38,17 @@
 xpcc::Dispatcher::Dispatcher(BackendInterface *backend_, Postman* postman_) :
 	backend(backend_), postman(postman_)
 {
+	for (size_t i = 0; i < maxPendingMessages; ++i) {
+		this->append(this->freeEntries, i);
+	}
 }
 
 // ----------------------------------------------------------------------------
 void
 xpcc::Dispatcher::update()
 {
+	Lock lock(*this);
+
 	this->backend->update();
 	
 	//Check if a new packet was received by the backend
@@ -74,6 +79,32 @@ xpcc::Dispatcher::update()
 	this->handleWaitingMessages();
 }
 
+size_t
+xpcc::Dispatcher::getNumberOfPendingMessages() const
+{
+	Lock lock(*this);
+
+	size_t count = 0;
+	for (Index index = this->freeEntries.head; index != invalidIndex;
+			index = this->entries[index].next) {
+		++count;
+	}
+	return maxPendingMessages - count;
+}
+
+#if XPCC__DISPATCHER_STATISTICS
+void
+xpcc::Dispatcher::resetStatistics()
+{
+	Lock lock(*this);
+
+	for (size_t i = 0; i < maxPendingMessages; ++i) {
+		this->entries[i].action = nullptr;
+	}
+	this->statistics.reset();
+}
+#endif
+
 void
 xpcc::Dispatcher::handleActionCall(const Header& header,
 		const SmartPointer& payload)
@@ -115,74 +146,82 @@ void
 xpcc::Dispatcher::handlePacket(const Header& header,
 		const SmartPointer& payload)
 {
-	auto entry = this->entries.begin();
-	while(entry != this->entries.end())
+	Index index = this->findEntry(header);
+	if (index == invalidIndex) {
+		return;
+	}
+
+	Entry& entry = this->entries[index];
+#if XPCC__DISPATCHER_STATISTICS
+	if (entry.action != nullptr)
 	{
-		if (entry->type == Entry::Type::Default)
+		if (header.isAcknowledge) {
+			entry.action->acknowledge.add(getLatency(entry));
+		}
+		else if (header.type != Header::Type::REQUEST) {
+			entry.action->response.add(getLatency(entry));
+		}
+	}
+#endif
+	if (entry.type == Entry::Type::Default)
+	{
+		// waiting for ack, no response can be handled
+		this->removeEntry(index);
+	}
+	else if (entry.type == Entry::Type::Callback)
+	{
+		// entry actual has to be marked acknowledged if acknowleded
+		// request
+		if (header.type == Header::Type::REQUEST)
 		{
-			// waiting for ack, no response can be handled
-			if (entry->headerFits(header))
+			// Must be an acknowledge otherwise there is an error in
+			// communication, cause no requests can be handled here
+			if (header.isAcknowledge)
 			{
-				entry = this->entries.remove(entry);
-				return;
+				// make sure no requests passed here
+				entry.time.restart(responseTimeout);
+				this->changeState(index, Entry::State::WaitForResponse);
 			}
 		}
-		else if (entry->type == Entry::Type::Callback)
+		else
 		{
-			if (entry->headerFits(header))
-			{
-				// entry actual has to be marked acknowledged if acknowleded
-				// request
-				if (header.type == Header::Type::REQUEST)
-				{
-					// Must be an acknowledge otherwise there is an error in
-					// communication, cause no requests can be handled here
-					if (header.isAcknowledge)
-					{
-						// make sure no requests passed here
-						entry->state = Entry::State::WaitForResponse;
-					}
-				}
-				else
-				{
-					// response or negative response
-					if (!header.isAcknowledge) {
-						entry->callbackResponse(header, payload);
-					} else {
-						// cannot happen, since responses with callbacks are
-						// not possible
-					}
-					entry = this->entries.remove(entry);
-				}
-				return;
+			// response or negative response
+			if (!header.isAcknowledge) {
+				this->postman->deliverResponse(entry.callback, header, payload);
+			} else {
+				// cannot happen, since responses with callbacks are
+				// not possible
 			}
+			this->removeEntry(index);
 		}
-		++entry;
 	}
 }
 
-xpcc::Dispatcher::EntryIterator
-xpcc::Dispatcher::sendMessageToInnerComponent(EntryIterator entry)
+xpcc::Dispatcher::Index
+xpcc::Dispatcher::sendMessageToInnerComponent(Index index)
 {
+	Entry& entry = this->entries[index];
+
 	// to one component on board inner component
 	// send message also out, so it is possible to log
 	// communication externally
-	backend->sendPacket(entry->header, entry->payload);
+	backend->sendPacket(entry.header, entry.payload);
 	
-	if (entry->header.type == Header::Type::REQUEST)
+	if (entry.header.type == Header::Type::REQUEST)
 	{
-		postman->deliverPacket(entry->header, entry->payload);
+#if XPCC__DISPATCHER_STATISTICS
+		this->trackRequest(entry);
+#endif
+		postman->deliverPacket(entry.header, entry.payload);
 		// TODO handle postman errors?
 		
-		if (entry->type == Entry::Type::Callback)
+		if (entry.type == Entry::Type::Callback)
 		{
-			// TODO timer for RESPONSES not handeled yet
-			entry->state = Entry::State::WaitForResponse;
-			entry->time.restart(responseTimeout);
-			return entry;
+			entry.time.restart(responseTimeout);
+			return this->changeState(index, Entry::State::WaitForResponse);
 		}
 		else {
-			return this->entries.remove(entry);
+			return this->removeEntry(index);
 		}
 	}
 	else
@@ -190,130 +229,428 @@ xpcc::Dispatcher::sendMessageToInnerComponent(EntryIterator entry)
 		// packet is a (NEG)RESPONSE
 		//
 		// we need to find the coresponding REQUEST and delete it as well
-		// as the RESPONSE
-		//
-		// responses are inserted at front, requests at end,
-		// thus we only need to search after the RESPONSE
-
-		auto req = entry;
-		for (++req; req != this->entries.end(); ++req)
+		// as the RESPONSE. The REQUEST must already be transmitted, i.e.
+		// wait for the response.
+		Index request = this->findEntry(entry.header, false);
+		if (request != invalidIndex)
 		{
-			if (req->header.type == Header::Type::REQUEST and
-			    // must be State::WaitForResponse
-			    req->state != Entry::State::TransmissionPending and
-			    req->headerFits(entry->header))
+#if XPCC__DISPATCHER_STATISTICS
+			if (this->entries[request].action != nullptr) {
+				this->entries[request].action->response.add(
+						getLatency(this->entries[request]));
+			}
+#endif
+			if (this->entries[request].type == Entry::Type::Callback)
 			{
-				if (req->type == Entry::Type::Callback)
-				{
-					req->callbackResponse(entry->header, entry->payload);
-				}
-				this->entries.remove(req);
-				break;
+				this->postman->deliverResponse(this->entries[request].callback,
+						entry.header, entry.payload);
 			}
+			this->removeEntry(request);
 		}
 		
-		return this->entries.remove(entry);
+		return this->removeEntry(index);
 	}
-	
-	return entry;
 }
 
 void
 xpcc::Dispatcher::handleWaitingMessages()
 {
-	auto entry = this->entries.begin();
-	while(entry != this->entries.end())
+	// Entries added while iterating are appended (requests) and handled
+	// within this call or inserted behind the leading responses and
+	// handled in the next call, unless they follow a response which is
+	// still waiting in the queue.
+	Index index = this->pendingMessages.head;
+	while (index != invalidIndex)
 	{
-		if (entry->state == Entry::State::TransmissionPending)
+		Entry& entry = this->entries[index];
+		if (entry.header.destination == 0)
 		{
-			if (entry->header.destination == 0)
-			{
-				// event
-				postman->deliverPacket(entry->header, entry->payload);
-				backend->sendPacket(entry->header, entry->payload);
+			// event
+			postman->deliverPacket(entry.header, entry.payload);
+			backend->sendPacket(entry.header, entry.payload);
 
-				entry = this->entries.remove(entry);
-				continue;
+			index = this->removeEntry(index);
+		}
+		else
+		{
+			// action or response
+			if (postman->isComponentAvailable(entry.header.destination))
+			{
+				index = sendMessageToInnerComponent(index);
 			}
 			else
 			{
-				// action or response
-				if (postman->isComponentAvailable(entry->header.destination))
-				{
-					entry = sendMessageToInnerComponent(entry);
-					continue;
+				// destination not on board, message has to be sent
+				// out to the backend
+				backend->sendPacket(entry.header, entry.payload);
+#if XPCC__DISPATCHER_STATISTICS
+				if (entry.header.type == Header::Type::REQUEST) {
+					this->trackRequest(entry);
 				}
-				else
-				{
-					// destination not on board, message has to be sent
-					// out to the backend
-					backend->sendPacket(entry->header, entry->payload);
+#endif
 
-					entry->state = Entry::State::WaitForACK;
-					entry->time.restart(acknowledgeTimeout);
+				entry.time.restart(acknowledgeTimeout);
+				index = this->changeState(index, Entry::State::WaitForACK);
+			}
+		}
+	}
 
-					++entry;
-				}
+	// All entries use the same timeout and are appended when the timer is
+	// restarted, therefore the queue is sorted by the expiration time.
+	index = this->waitForAcknowledge.head;
+	while (index != invalidIndex)
+	{
+		Entry& entry = this->entries[index];
+		if (!entry.time.isExpired()) {
+			break;
+		}
+
+		if (entry.tries >= 2)
+		{
+			// TODO do sth to notify the user
+#if XPCC__DISPATCHER_STATISTICS
+			if (entry.action != nullptr) {
+				entry.action->acknowledgeTimeouts++;
 			}
+#endif
+			index = this->removeEntry(index);
 		}
-		else if (entry->state == Entry::State::WaitForACK)
+		else
 		{
-			if (entry->time.isExpired())
-			{
-				if (entry->tries >= 2)
-				{
-					// TODO do sth to notify the user
-					entry = this->entries.remove(entry);
-					continue;
-				}
-				else
-				{
-					backend->sendPacket(entry->header, entry->payload);
+			backend->sendPacket(entry.header, entry.payload);
+#if XPCC__DISPATCHER_STATISTICS
+			if (entry.action != nullptr) {
+				entry.action->retransmissions++;
+			}
+#endif
 
-					entry->tries++;
-					entry->time.restart(acknowledgeTimeout);
-				}
+			entry.tries++;
+			entry.time.restart(acknowledgeTimeout);
+			index = this->changeState(index, Entry::State::WaitForACK);
+		}
+	}
+
+	// WAIT_FOR_RESPONSE
+	// Responses stay in the queue until the response arrives. Only if the
+	// table is full entries with an expired response timeout are discarded
+	// (see allocateEntry()).
+#if XPCC__DISPATCHER_STATISTICS
+	this->trackResponseTimeouts();
+#endif
+}
+
+#if XPCC__DISPATCHER_STATISTICS
+void
+xpcc::Dispatcher::trackRequest(Entry& entry)
+{
+	entry.sent = Clock::nowShort();
+	entry.action = this->statistics.findAction(entry.header.destination,
+			entry.header.packetIdentifier);
+	if (entry.action != nullptr) {
+		entry.action->requests++;
+	} else {
+		this->statistics.untrackedRequests++;
+	}
+}
+
+void
+xpcc::Dispatcher::trackResponseTimeouts()
+{
+	// The expired entries stay at the front of the queue until their
+	// response arrives or they are discarded, already counted ones are
+	// skipped.
+	Index index = this->waitForResponse.head;
+	while (index != invalidIndex)
+	{
+		Entry& entry = this->entries[index];
+		if (!entry.time.isExpired()) {
+			break;
+		}
+
+		if (!entry.overdue)
+		{
+			entry.overdue = true;
+			if (entry.action != nullptr) {
+				entry.action->responseTimeouts++;
 			}
+		}
+		index = entry.next;
+	}
+}
+#endif
 
-			++entry;
+// ----------------------------------------------------------------------------
+xpcc::Dispatcher::Index
+xpcc::Dispatcher::allocateEntry(Entry::Type type, const Header& header,
+		const SmartPointer& payload, const ResponseCallback& callback)
+{
+	Index index = this->freeEntries.head;
+	if (index == invalidIndex)
+	{
+		Index oldest = this->waitForResponse.head;
+		if (oldest == invalidIndex or !this->entries[oldest].time.isExpired()) {
+			XPCC_LOG_ERROR << XPCC_FILE_INFO << "Dispatcher queue full, message dropped" << xpcc::endl;
+#if XPCC__DISPATCHER_STATISTICS
+			this->statistics.droppedMessages++;
+#endif
+			return invalidIndex;
+		}
+#if XPCC__DISPATCHER_STATISTICS
+		if (!this->entries[oldest].overdue and
+			this->entries[oldest].action != nullptr) {
+			this->entries[oldest].action->responseTimeouts++;
 		}
-		else 
+#endif
+		this->removeEntry(oldest);
+		index = this->freeEntries.head;
+	}
+	this->unlink(this->freeEntries, index);
+
+	Entry& entry = this->entries[index];
+	entry.type = type;
+	entry.header = header;
+	entry.payload = payload;
+	entry.callback = callback;
+	entry.state = Entry::State::TransmissionPending;
+	entry.tries = 0;
+#if XPCC__DISPATCHER_STATISTICS
+	entry.action = nullptr;
+	entry.overdue = false;
+	this->statistics.updateQueueDepth(++this->usedEntries);
+#endif
+
+	Queue& bucket = this->buckets[hash(header.destination, header.source,
+			header.packetIdentifier)];
+	entry.previousInBucket = bucket.tail;
+	entry.nextInBucket = invalidIndex;
+	if (bucket.tail == invalidIndex) {
+		bucket.head = index;
+	} else {
+		this->entries[bucket.tail].nextInBucket = index;
+	}
+	bucket.tail = index;
+
+	return index;
+}
+
+xpcc::Dispatcher::Index
+xpcc::Dispatcher::removeEntry(Index index)
+{
+	Entry& entry = this->entries[index];
+
+	Queue& bucket = this->buckets[hash(entry.header.destination,
+			entry.header.source, entry.header.packetIdentifier)];
+	if (entry.previousInBucket == invalidIndex) {
+		bucket.head = entry.nextInBucket;
+	} else {
+		this->entries[entry.previousInBucket].nextInBucket = entry.nextInBucket;
+	}
+	if (entry.nextInBucket == invalidIndex) {
+		bucket.tail = entry.previousInBucket;
+	} else {
+		this->entries[entry.nextInBucket].previousInBucket = entry.previousInBucket;
+	}
+
+	Index next = entry.next;
+	this->unlink(this->getQueue(entry.state), index);
+
+	// release the payload and the callback
+	entry.payload = SmartPointer();
+	entry.callback = ResponseCallback();
+	this->append(this->freeEntries, index);
+#if XPCC__DISPATCHER_STATISTICS
+	this->usedEntries--;
+#endif
+
+	return next;
+}
+
+xpcc::Dispatcher::Index
+xpcc::Dispatcher::changeState(Index index, Entry::State state)
+{
+	Entry& entry = this->entries[index];
+
+	Index next = entry.next;
+	this->unlink(this->getQueue(entry.state), index);
+	entry.state = state;
+	this->append(this->getQueue(state), index);
+
+	return next;
+}
+
+xpcc::Dispatcher::Index
+xpcc::Dispatcher::findEntry(const Header& header, bool pendingAllowed) const
+{
+	// the entry is stored under its own header, which has source and
+	// destination swapped compared to the ACK or response.
+	Index index = this->buckets[hash(header.source, header.destination,
+			header.packetIdentifier)].head;
+	while (index != invalidIndex)
+	{
+		const Entry& entry = this->entries[index];
+		if (entry.headerFits(header) and
+			(pendingAllowed or (entry.header.type == Header::Type::REQUEST and
+					entry.state != Entry::State::TransmissionPending)))
 		{
-			// WAIT_FOR_RESPONSE
-			// Responses stay in the queue for ever if no response ever
-			// comes. This may have to be changed.
-			++entry;
+			return index;
 		}
+		index = entry.nextInBucket;
 	}
+	return invalidIndex;
 }
 
 // ----------------------------------------------------------------------------
+xpcc::Dispatcher::Queue&
+xpcc::Dispatcher::getQueue(Entry::State state)
+{
+	switch (state)
+	{
+		case Entry::State::WaitForACK:
+			return this->waitForAcknowledge;
+		case Entry::State::WaitForResponse:
+			return this->waitForResponse;
+		default:
+			return this->pendingMessages;
+	}
+}
+
+void
+xpcc::Dispatcher::append(Queue& queue, Index index)
+{
+	Entry& entry = this->entries[index];
+	entry.previous = queue.tail;
+	entry.next = invalidIndex;
+	if (queue.tail == invalidIndex) {
+		queue.head = index;
+	} else {
+		this->entries[queue.tail].next = index;
+	}
+	queue.tail = index;
+}
+
 void
+xpcc::Dispatcher::prepend(Queue& queue, Index index)
+{
+	Entry& entry = this->entries[index];
+	entry.previous = invalidIndex;
+	entry.next = queue.head;
+	if (queue.head == invalidIndex) {
+		queue.tail = index;
+	} else {
+		this->entries[queue.head].previous = index;
+	}
+	queue.head = index;
+}
+
+void
+xpcc::Dispatcher::insertAfter(Queue& queue, Index previous, Index index)
+{
+	Entry& entry = this->entries[index];
+	entry.previous = previous;
+	entry.next = this->entries[previous].next;
+	if (entry.next == invalidIndex) {
+		queue.tail = index;
+	} else {
+		this->entries[entry.next].previous = index;
+	}
+	this->entries[previous].next = index;
+}
+
+void
+xpcc::Dispatcher::unlink(Queue& queue, Index index)
+{
+	Entry& entry = this->entries[index];
+	if (entry.previous == invalidIndex) {
+		queue.head = entry.next;
+	} else {
+		this->entries[entry.previous].next = entry.next;
+	}
+	if (entry.next == invalidIndex) {
+		queue.tail = entry.previous;
+	} else {
+		this->entries[entry.next].previous = entry.previous;
+	}
+	entry.previous = invalidIndex;
+	entry.next = invalidIndex;
+}
+
+// ----------------------------------------------------------------------------
+bool
 xpcc::Dispatcher::addMessage(const Header& header,
 		SmartPointer& smartPayload)
 {
-	this->entries.append(Entry(header, smartPayload));
+	Lock lock(*this);
+
+	Index index = this->allocateEntry(Entry::Type::Default, header,
+			smartPayload, ResponseCallback());
+	if (index == invalidIndex) {
+		return false;
+	}
+	this->append(this->pendingMessages, index);
+	return true;
 }
 
-void
+bool
 xpcc::Dispatcher::addMessage(const Header& header,
 		SmartPointer& smartPayload, ResponseCallback& responseCallback)
 {
-	this->entries.append(Entry(header, smartPayload, responseCallback));
+	Lock lock(*this);
+
+	Index index = this->allocateEntry(Entry::Type::Callback, header,
+			smartPayload, responseCallback);
+	if (index == invalidIndex) {
+		return false;
+	}
+	this->append(this->pendingMessages, index);
+	return true;
+}
+
+uint8_t *
+xpcc::Dispatcher::reservePayload(SmartPointer& payload, uint16_t size)
+{
+	uint8_t *storage = payload.reserve(size);
+	if (storage == nullptr)
+	{
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "No payload block available, message dropped" << xpcc::endl;
+#if XPCC__DISPATCHER_STATISTICS
+		Lock lock(*this);
+		this->statistics.droppedMessages++;
+#endif
+	}
+	return storage;
 }
 
 void
 xpcc::Dispatcher::addResponse(const Header& header,
 		SmartPointer& smartPayload)
 {
+	Lock lock(*this);
+
 	// it makes response more important, than requests
 	// it prevents intern loops. Since it is possible to give a response while 
 	// an action is handled and call an action while response is handled
 	// one component calling one action on another component on same board
 	// handling its response in the same callback-function would cause a loop
 	// if responses and actions both are appended at the tail of the list.
-	// but now responses are handled in reverse order that's not good
-	// what to do? a separator between responses and requests possible?
+	// The responses are inserted behind the responses already waiting at
+	// the front, so that they are sent in order.
+
+	Index index = this->allocateEntry(Entry::Type::Default, header,
+			smartPayload, ResponseCallback());
+	if (index == invalidIndex) {
+		return;
+	}
+
+	Index previous = invalidIndex;
+	for (Index i = this->pendingMessages.head;
+			i != invalidIndex and this->entries[i].header.type != Header::Type::REQUEST;
+			i = this->entries[i].next) {
+		previous = i;
+	}
 
-	this->entries.prepend(Entry(header, smartPayload));
+	if (previous == invalidIndex) {
+		this->prepend(this->pendingMessages, index);
+	} else {
+		this->insertAfter(this->pendingMessages, previous, index);
+	}
 }
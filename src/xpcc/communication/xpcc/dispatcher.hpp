@@ -31,19 +31,55 @@
 #ifndef	XPCC__DISPATCHER_HPP
 #define	XPCC__DISPATCHER_HPP
 
+#include <stddef.h>
+
+#include <xpcc/architecture/detect.hpp>
+
 #include <xpcc/processing/timer.hpp>
-#include <xpcc/container/linked_list.hpp>
+#include <xpcc/math/utils/bit_operation.hpp>
+#include <xpcc/utils/template_metaprogramming.hpp>
 
 #include "backend/backend_interface.hpp"
 #include "postman/postman.hpp"
 
 #include "response_callback.hpp"
 
+#include <xpcc_config.hpp>
+
+#if XPCC__DISPATCHER_STATISTICS
+#	include "dispatcher_statistics.hpp"
+#endif
+
+#if defined(XPCC__OS_HOSTED)
+#	include <mutex>
+#endif
+
 namespace xpcc
 {
 	/**
 	 * \brief
 	 *
+	 * All messages waiting for transmission, acknowledge or response are
+	 * kept in a statically allocated table with
+	 * `XPCC__DISPATCHER_PENDING_MESSAGES` entries. The entries are
+	 * additionally indexed by (destination, source, packetIdentifier) so
+	 * that matching an incoming ACK or response does not depend on the
+	 * number of outstanding messages.
+	 *
+	 * Messages waiting for an ACK or a response are kept in separate
+	 * queues ordered by their deadline, so only the expired entries at the
+	 * front of these queues have to be checked in update().
+	 *
+	 * With `XPCC__DISPATCHER_STATISTICS` set to 1 the dispatcher records
+	 * latencies and error counters for every action call, see
+	 * xpcc::DispatcherStatistics.
+	 *
+	 * If the postman executes the components in other threads (see
+	 * xpcc::ThreadedPostman and Postman::isThreaded()) all methods are
+	 * protected by a mutex, so that the components may send messages from
+	 * their threads. Otherwise, and always on embedded targets, no lock is
+	 * taken.
+	 *
 	 * \todo	Documentation
 	 *
 	 * \author	Georgi Grinshpun
@@ -55,13 +91,92 @@ namespace xpcc
 		static const uint16_t acknowledgeTimeout = 500;
 		static const uint16_t responseTimeout = 100;
 
+		/// Maximum number of messages waiting for transmission, ACK or response
+		static constexpr size_t maxPendingMessages = XPCC__DISPATCHER_PENDING_MESSAGES;
+
+		/**
+		 * \brief	Exclusive access to the dispatcher
+		 *
+		 * Held while the message table is accessed. Only locks the mutex
+		 * if the postman is threaded, does nothing on embedded targets.
+		 */
+#if defined(XPCC__OS_HOSTED)
+		class Lock
+		{
+		public:
+			explicit inline
+			Lock(const Dispatcher& dispatcher) :
+				mutex(dispatcher.postman->isThreaded() ? &dispatcher.mutex : nullptr)
+			{
+				if (mutex) {
+					mutex->lock();
+				}
+			}
+
+			inline
+			~Lock()
+			{
+				if (mutex) {
+					mutex->unlock();
+				}
+			}
+
+		private:
+			Lock(const Lock&) = delete;
+
+			Lock&
+			operator = (const Lock&) = delete;
+
+			std::recursive_mutex *mutex;
+		};
+#else
+		class Lock
+		{
+		public:
+			explicit inline
+			Lock(const Dispatcher&)
+			{
+			}
+		};
+#endif
+
 	public:
 		Dispatcher(BackendInterface *backend, Postman* postman);
 
 		void
 		update();
 
+		/// Number of messages currently waiting for transmission, ACK or response
+		size_t
+		getNumberOfPendingMessages() const;
+
+#if XPCC__DISPATCHER_STATISTICS
+		inline const DispatcherStatistics&
+		getStatistics() const
+		{
+			return this->statistics;
+		}
+
+		/// Clear all statistics, calls still pending are no longer tracked
+		void
+		resetStatistics();
+#endif
+
 	private:
+		static_assert(maxPendingMessages > 0 and maxPendingMessages < 65535,
+				"XPCC__DISPATCHER_PENDING_MESSAGES must be in the range 1..65534");
+
+		// select the type of the index variables with some template magic :-)
+		typedef xpcc::tmp::Select< (maxPendingMessages >= 255),
+								   uint16_t,
+								   uint8_t >::Result Index;
+
+		static constexpr Index invalidIndex = static_cast<Index>(-1);
+
+		/// Number of hash buckets, the next power of two of the number of entries
+		static constexpr size_t hashTableSize =
+				size_t(1) << (leftmostBit(maxPendingMessages - 1) + 1);
+
 		/// Does not handle requests which are not acknowledge.
 		void
 		handlePacket(const Header& header, const SmartPointer& payload);
@@ -72,7 +187,6 @@ namespace xpcc
 
 		/**
 		 * \brief 	This class holds information about a Message being send.
-		 * 			This is the superclass of all entries.
 		 */
 		class Entry
 		{
@@ -92,39 +206,6 @@ namespace xpcc
 			};
 
 		public:
-			/**
-			 * \brief 	Creates one Entry with given header.
-			 * 			this->next is initially set Null
-			 *
-			 * Creates one Entry with given header. this->next is initially
-			 * set Null. The const member this->typeInfo is set to typeInfo
-			 * and never else changed. this->typeInfo replaces runtime
-			 * information needed by handling of messages.
-			 */
-			Entry(Type type, const Header& inHeader, SmartPointer& inPayload) :
-				type(type),
-				header(inHeader), payload(inPayload)
-			{
-			}
-
-			Entry(const Header& inHeader, SmartPointer& inPayload) :
-				header(inHeader), payload(inPayload)
-			{
-			}
-
-			Entry(const Header& inHeader) :
-				header(inHeader)
-			{
-			}
-
-			Entry(const Header& inHeader,
-					SmartPointer& inPayload, ResponseCallback& callback_) :
-				type(Type::Callback),
-				header(inHeader), payload(inPayload),
-				callback(callback_)
-			{
-			}
-
 			/**
 			 * \brief 	Checks if a Response or Acknowledge fits to the
 			 * 			Message represented by this Entry.
@@ -132,48 +213,157 @@ namespace xpcc
 			bool
 			headerFits(const Header& header) const;
 
-			inline void
-			callbackResponse(const Header& header, const SmartPointer &payload) const
-			{
-				this->callback.call(header, payload);
-			}
-
-			const Type type = Type::Default;
-			const Header header;
-			const SmartPointer payload;
+			Type type = Type::Default;
+			Header header;
+			SmartPointer payload;
 			State state = State::TransmissionPending;
 			ShortTimeout time;
 			uint8_t tries = 0;
-		private:
 			ResponseCallback callback;
+
+#if XPCC__DISPATCHER_STATISTICS
+			/// Statistics of the called action, \c nullptr if not tracked
+			DispatcherStatistics::Action *action = nullptr;
+			/// Time of the first transmission
+			ShortTimestamp sent;
+			/// Response timeout already counted
+			bool overdue = false;
+#endif
+
+			/// Neighbours in the queue of the current state (or the free list)
+			Index previous = invalidIndex;
+			Index next = invalidIndex;
+
+			/// Neighbours in the hash bucket
+			Index previousInBucket = invalidIndex;
+			Index nextInBucket = invalidIndex;
 		};
 
-		void
+		/// Doubly linked list of entries, linked through the entries itself
+		struct Queue
+		{
+			Index head = invalidIndex;
+			Index tail = invalidIndex;
+		};
+
+		/// \return	\c false if the table is full, the message is dropped
+		bool
 		addMessage(const Header& header, SmartPointer& smartPayload);
 
-		void
+		/// \return	\c false if the table is full, the message is dropped
+		bool
 		addMessage(const Header& header, SmartPointer& smartPayload,
 				ResponseCallback& responseCallback);
 
 		void
 		addResponse(const Header& header, SmartPointer& smartPayload);
 
+		/**
+		 * \brief	Reserve storage for a payload constructed in place
+		 *
+		 * The storage is reserved inline or from a pool block, never on
+		 * the heap. The caller constructs the payload and then adds it
+		 * with addMessage(), so the dispatcher never sees an
+		 * uninitialized payload.
+		 *
+		 * \return	Pointer to \p size bytes of payload storage, \c nullptr
+		 * 			if no pool block is available
+		 */
+		uint8_t *
+		reservePayload(SmartPointer& payload, uint16_t size);
+
 		inline void
 		handleActionCall(const Header& header, const SmartPointer& payload);
 
 		void
 		sendAcknowledge(const Header& header);
 
-		using EntryList = LinkedList<Entry>;
-		using EntryIterator = EntryList::iterator;
+		/// \return next entry in the pending queue
+		Index
+		sendMessageToInnerComponent(Index index);
+
+		/**
+		 * \brief	Take an entry from the free list and initialize it
+		 *
+		 * If no entry is free, the oldest entry whose response timed out is
+		 * discarded. Returns `invalidIndex` if the table is full.
+		 */
+		Index
+		allocateEntry(Entry::Type type, const Header& header,
+				const SmartPointer& payload, const ResponseCallback& callback);
+
+		/// Release the entry, \return the next entry of its previous queue
+		Index
+		removeEntry(Index index);
+
+		/// Move the entry to the end of the queue of `state`, \return the next entry of its previous queue
+		Index
+		changeState(Index index, Entry::State state);
+
+		/// Find the oldest entry the given ACK or response belongs to
+		Index
+		findEntry(const Header& header, bool pendingAllowed = true) const;
+
+		Queue&
+		getQueue(Entry::State state);
+
+		void
+		append(Queue& queue, Index index);
+
+		void
+		prepend(Queue& queue, Index index);
 
-		EntryIterator
-		sendMessageToInnerComponent(EntryIterator entry);
+		void
+		insertAfter(Queue& queue, Index previous, Index index);
+
+		void
+		unlink(Queue& queue, Index index);
+
+#if XPCC__DISPATCHER_STATISTICS
+		/// Start tracking a request at its first transmission
+		void
+		trackRequest(Entry& entry);
+
+		/// Count the response timeouts of the expired entries
+		void
+		trackResponseTimeouts();
+
+		/// Milliseconds since the first transmission of the entry
+		static inline uint16_t
+		getLatency(const Entry& entry)
+		{
+			return (Clock::nowShort() - entry.sent).getTime();
+		}
+#endif
+
+		static inline size_t
+		hash(uint8_t destination, uint8_t source, uint8_t packetIdentifier)
+		{
+			uint16_t value = destination * 251 + source * 31 + packetIdentifier;
+			return (value ^ (value >> 7)) & (hashTableSize - 1);
+		}
 
 		BackendInterface * const backend;
 		Postman * const postman;
 
-		EntryList entries;
+		Entry entries[maxPendingMessages];
+		Queue buckets[hashTableSize];
+
+		Queue freeEntries;
+		Queue pendingMessages;
+		Queue waitForAcknowledge;
+		Queue waitForResponse;
+
+#if XPCC__DISPATCHER_STATISTICS
+		DispatcherStatistics statistics;
+		uint16_t usedEntries = 0;
+#endif
+
+#if defined(XPCC__OS_HOSTED)
+		/// Recursive, handlers called in update() may send messages. Only
+		/// used with a threaded postman, see Lock.
+		mutable std::recursive_mutex mutex;
+#endif
 
 	private:
 		friend class Communicator;
@@ -0,0 +1,144 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "dispatcher_statistics.hpp"
+
+#if XPCC__DISPATCHER_STATISTICS
+
+#include <string.h>
+
+#include <xpcc/math/utils/bit_operation.hpp>
+
+// ----------------------------------------------------------------------------
+void
+xpcc::LatencyHistogram::add(uint16_t latency)
+{
+	uint8_t bucket = 0;
+	if (latency >= 2)
+	{
+		bucket = leftmostBit(latency);
+		if (bucket >= numberOfBuckets) {
+			bucket = numberOfBuckets - 1;
+		}
+	}
+	if (this->buckets[bucket] < 0xffff) {
+		this->buckets[bucket]++;
+	}
+
+	if (latency > this->maximum) {
+		this->maximum = latency;
+	}
+}
+
+uint32_t
+xpcc::LatencyHistogram::getCount() const
+{
+	uint32_t count = 0;
+	for (uint8_t i = 0; i < numberOfBuckets; ++i) {
+		count += this->buckets[i];
+	}
+	return count;
+}
+
+// ----------------------------------------------------------------------------
+xpcc::DispatcherStatistics::DispatcherStatistics()
+{
+	this->reset();
+}
+
+void
+xpcc::DispatcherStatistics::reset()
+{
+	memset(this->actions, 0, sizeof(this->actions));
+	this->numberOfActions = 0;
+	this->maximumQueueDepth = 0;
+	this->droppedMessages = 0;
+	this->untrackedRequests = 0;
+}
+
+const xpcc::DispatcherStatistics::Action *
+xpcc::DispatcherStatistics::getAction(uint8_t component, uint8_t action) const
+{
+	for (uint8_t i = 0; i < this->numberOfActions; ++i)
+	{
+		if (this->actions[i].component == component &&
+			this->actions[i].action == action) {
+			return &this->actions[i];
+		}
+	}
+	return nullptr;
+}
+
+xpcc::DispatcherStatistics::Action *
+xpcc::DispatcherStatistics::findAction(uint8_t component, uint8_t action)
+{
+	Action *entry = const_cast<Action *>(this->getAction(component, action));
+	if (entry == nullptr)
+	{
+		if (this->numberOfActions >= maxActions) {
+			return nullptr;
+		}
+		entry = &this->actions[this->numberOfActions++];
+		entry->component = component;
+		entry->action = action;
+	}
+	return entry;
+}
+
+void
+xpcc::DispatcherStatistics::updateQueueDepth(uint16_t depth)
+{
+	if (depth > this->maximumQueueDepth) {
+		this->maximumQueueDepth = depth;
+	}
+}
+
+// ----------------------------------------------------------------------------
+namespace
+{
+	void
+	printHistogram(xpcc::IOStream& stream, const xpcc::LatencyHistogram& histogram)
+	{
+		stream << " [";
+		for (uint8_t i = 0; i < xpcc::LatencyHistogram::numberOfBuckets; ++i)
+		{
+			if (i > 0) {
+				stream << " ";
+			}
+			stream << histogram.buckets[i];
+		}
+		stream << "] max=" << histogram.maximum << "ms";
+	}
+}
+
+xpcc::IOStream&
+xpcc::operator << (xpcc::IOStream& stream, const DispatcherStatistics& statistics)
+{
+	stream << "dispatcher: max queue depth=" << statistics.maximumQueueDepth
+		   << " dropped=" << statistics.droppedMessages
+		   << " untracked=" << statistics.untrackedRequests;
+
+	for (uint8_t i = 0; i < statistics.getNumberOfActions(); ++i)
+	{
+		const DispatcherStatistics::Action& action = statistics.getActions()[i];
+		stream << xpcc::endl
+			   << "  component=" << action.component
+			   << " action=" << action.action
+			   << " requests=" << action.requests
+			   << " retransmissions=" << action.retransmissions
+			   << " ack timeouts=" << action.acknowledgeTimeouts
+			   << " response timeouts=" << action.responseTimeouts
+			   << xpcc::endl << "    ack";
+		printHistogram(stream, action.acknowledge);
+		stream << xpcc::endl << "    response";
+		printHistogram(stream, action.response);
+	}
+	return stream;
+}
+
+#endif	// XPCC__DISPATCHER_STATISTICS
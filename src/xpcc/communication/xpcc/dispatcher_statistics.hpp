@@ -0,0 +1,153 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC__DISPATCHER_STATISTICS_HPP
+#define	XPCC__DISPATCHER_STATISTICS_HPP
+
+#include <stdint.h>
+
+#include <xpcc/architecture/utils.hpp>
+#include <xpcc/io/iostream.hpp>
+
+#include <xpcc_config.hpp>
+
+namespace xpcc
+{
+	/**
+	 * \brief	Histogram of latencies in milliseconds
+	 *
+	 * Bucket 0 counts latencies below 2ms, bucket `i` latencies from
+	 * `2^i` to `2^(i+1) - 1` milliseconds and the last bucket everything
+	 * from 512ms on. The counters saturate instead of overflowing.
+	 *
+	 * \ingroup	xpcc_comm
+	 */
+	struct LatencyHistogram
+	{
+		static constexpr uint8_t numberOfBuckets = 10;
+
+		uint16_t buckets[numberOfBuckets];
+		uint16_t maximum;	///< highest latency in milliseconds
+
+		void
+		add(uint16_t latency);
+
+		/// Number of latencies in the histogram
+		uint32_t
+		getCount() const;
+
+		/// Lowest latency in milliseconds counted in the bucket
+		static inline uint16_t
+		getLowerBound(uint8_t bucket)
+		{
+			return (bucket == 0) ? 0 : (1 << bucket);
+		}
+	} xpcc_packed;
+
+	/**
+	 * \brief	Latencies and error counters of the xpcc::Dispatcher
+	 *
+	 * Only available if `XPCC__DISPATCHER_STATISTICS` is set to 1 in the
+	 * project configuration, otherwise the dispatcher does not collect any
+	 * data and has no overhead.
+	 *
+	 * Action calls are tracked per destination component and action
+	 * identifier for the first `XPCC__DISPATCHER_STATISTICS_ACTIONS`
+	 * different actions called on the board, further ones are only
+	 * counted in `untrackedRequests`:
+	 *
+	 * - the time from the first transmission to the ACK,
+	 * - the time from the first transmission to the response (only for
+	 *   calls with a response callback),
+	 * - the number of retransmissions because of a missing ACK,
+	 * - the number of calls which were never acknowledged and
+	 * - the number of calls whose response was not received within
+	 *   xpcc::Dispatcher::responseTimeout.
+	 *
+	 * Action calls to components on the same board are answered without
+	 * ACK, only their response latency is recorded.
+	 *
+	 * The data can be printed with the logger
+	 * @code
+	 * XPCC_LOG_INFO << dispatcher.getStatistics() << xpcc::endl;
+	 * @endcode
+	 * or published as xpcc events with
+	 * xpcc::Communicator::publishStatistics().
+	 *
+	 * \ingroup	xpcc_comm
+	 */
+	class DispatcherStatistics
+	{
+	public:
+		static constexpr uint8_t maxActions = XPCC__DISPATCHER_STATISTICS_ACTIONS;
+
+		/// Statistics of one action, published as payload of the statistics event
+		struct Action
+		{
+			uint8_t component;
+			uint8_t action;
+			uint16_t requests;
+			uint16_t retransmissions;
+			uint16_t acknowledgeTimeouts;
+			uint16_t responseTimeouts;
+			LatencyHistogram acknowledge;
+			LatencyHistogram response;
+		} xpcc_packed;
+
+	public:
+		DispatcherStatistics();
+
+		/// Clear all counters and histograms
+		void
+		reset();
+
+		/// Statistics of the given action, \c nullptr if it is not tracked
+		const Action *
+		getAction(uint8_t component, uint8_t action) const;
+
+		inline const Action *
+		getActions() const
+		{
+			return this->actions;
+		}
+
+		inline uint8_t
+		getNumberOfActions() const
+		{
+			return this->numberOfActions;
+		}
+
+		/// Highest number of messages waiting in the dispatcher at the same time
+		uint16_t maximumQueueDepth;
+
+		/// Messages dropped because the dispatcher was full
+		uint16_t droppedMessages;
+
+		/// Action calls not tracked because `maxActions` were reached
+		uint16_t untrackedRequests;
+
+	private:
+		friend class Dispatcher;
+
+		/// Find or create the entry of an action, \c nullptr if full
+		Action *
+		findAction(uint8_t component, uint8_t action);
+
+		void
+		updateQueueDepth(uint16_t depth);
+
+		Action actions[maxActions];
+		uint8_t numberOfActions;
+	};
+
+	/// Print one line per action and the global counters
+	xpcc::IOStream&
+	operator << (xpcc::IOStream& stream, const DispatcherStatistics& statistics);
+}
+
+#endif	// XPCC__DISPATCHER_STATISTICS_HPP
@@ -15,7 +15,8 @@
 #include "../backend/header.hpp"
 #include "../response_handle.hpp"
 
-#include <map>
+#include <array>
+#include <vector>
 #include <functional>
 
 namespace xpcc
@@ -29,6 +30,12 @@ namespace xpcc
  *
  * On hosted however, this class allows for much easier registering of callbacks.
  *
+ * Action handlers are found through a direct index table per component,
+ * event listeners are stored sorted by event identifier in one vector with
+ * the offset of every event in a separate table. Delivering a packet is
+ * therefore O(1), independent of the number of registered callbacks, and
+ * all listeners of an event are stored next to each other.
+ *
  * @ingroup	xpcc_comm
  * @author	Niklas Hauser
  */
@@ -99,17 +106,26 @@ private:
 		void operator()(const ResponseHandle& response, const SmartPointer& payload) const;
 	};
 
-	/// packetIdentifier -> callback
-	typedef std::multimap<uint8_t, EventListener> EventMap;
+	void
+	insertActionHandler(uint8_t componentId, uint8_t actionId,
+			const ActionHandler& handler);
 
-	/// packetIdentifier -> callback
-	typedef std::map<uint8_t, ActionHandler > CallbackMap;
-	///< destination -> callbackMap
-	typedef std::map<uint8_t, CallbackMap > ActionMap;
+	void
+	insertEventListener(uint8_t eventId, const EventListener& listener);
 
 private:
-	EventMap eventMap;
-	ActionMap actionMap;
+	/// action identifier -> index in actionHandlers + 1, 0 if not registered
+	typedef std::array<uint16_t, 256> ActionIndex;
+
+	/// component identifier -> index in actionIndex + 1, 0 if not registered
+	std::array<uint8_t, 256> componentIndex;
+	std::vector<ActionIndex> actionIndex;
+	std::vector<ActionHandler> actionHandlers;
+
+	/// Listeners sorted by event identifier, the listeners of event `i`
+	/// are stored at [eventOffset[i], eventOffset[i + 1]).
+	std::array<uint16_t, 257> eventOffset;
+	std::vector<EventListener> eventListeners;
 };
 
 }	// namespace xpcc
@@ -12,6 +12,8 @@
 // ----------------------------------------------------------------------------
 xpcc::DynamicPostman::DynamicPostman()
 {
+	componentIndex.fill(0);
+	eventOffset.fill(0);
 }
 
 // ----------------------------------------------------------------------------
@@ -21,37 +23,34 @@ xpcc::DynamicPostman::deliverPacket(const Header &header, const SmartPointer& pa
 	if (header.destination == 0)
 	{
 		// EVENT
-		EventMap::const_iterator lowerBound(this->eventMap.lower_bound(header.packetIdentifier));
-		EventMap::const_iterator upperBound(this->eventMap.upper_bound(header.packetIdentifier));
-		if (lowerBound != upperBound) {
-			do {
-				lowerBound->second(header, payload);
-				lowerBound++;
-			}
-			while (lowerBound != upperBound);
-			return OK;
+		uint16_t begin = this->eventOffset[header.packetIdentifier];
+		uint16_t end = this->eventOffset[header.packetIdentifier + 1];
+		if (begin == end) {
+			return NO_EVENT;
+		}
+
+		for (uint16_t ii = begin; ii < end; ++ii) {
+			this->eventListeners[ii](header, payload);
 		}
-		return NO_EVENT;
+		return OK;
 	}
 	else
 	{
 		// REQUEST
-		ActionMap::const_iterator iterDestination(this->actionMap.find(header.destination));
-		if (iterDestination != this->actionMap.end())
+		uint8_t component = this->componentIndex[header.destination];
+		if (component == 0) {
+			return NO_COMPONENT;
+		}
+
+		uint16_t handler = this->actionIndex[component - 1][header.packetIdentifier];
+		if (handler != 0)
 		{
-			CallbackMap::const_iterator iterCallback(iterDestination->second.find(header.packetIdentifier));
-			if (iterCallback != iterDestination->second.end())
-			{
-				xpcc::ResponseHandle response(header);
-				iterCallback->second(response, payload);
-				return OK;
-			}
-			else {
-				return NO_ACTION;
-			}
+			xpcc::ResponseHandle response(header);
+			this->actionHandlers[handler - 1](response, payload);
+			return OK;
 		}
 		else {
-			return NO_COMPONENT;
+			return NO_ACTION;
 		}
 	}
 }
@@ -60,7 +59,47 @@ xpcc::DynamicPostman::deliverPacket(const Header &header, const SmartPointer& pa
 bool
 xpcc::DynamicPostman::isComponentAvailable(uint8_t component) const
 {
-	return (this->actionMap.find(component) != this->actionMap.end());
+	return (this->componentIndex[component] != 0);
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::DynamicPostman::insertActionHandler(uint8_t componentId,
+		uint8_t actionId, const ActionHandler& handler)
+{
+	uint8_t& component = this->componentIndex[componentId];
+	if (component == 0)
+	{
+		ActionIndex index;
+		index.fill(0);
+		this->actionIndex.push_back(index);
+		component = this->actionIndex.size();
+	}
+
+	uint16_t& action = this->actionIndex[component - 1][actionId];
+	if (action != 0) {
+		// replace the existing handler
+		this->actionHandlers[action - 1] = handler;
+	}
+	else {
+		this->actionHandlers.push_back(handler);
+		action = this->actionHandlers.size();
+	}
+}
+
+void
+xpcc::DynamicPostman::insertEventListener(uint8_t eventId,
+		const EventListener& listener)
+{
+	// insert behind all listeners of the same event to keep the order
+	// of registration
+	this->eventListeners.insert(
+			this->eventListeners.begin() + this->eventOffset[eventId + 1],
+			listener);
+
+	for (uint16_t ii = eventId + 1; ii < this->eventOffset.size(); ++ii) {
+		this->eventOffset[ii]++;
+	}
 }
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/communication/xpcc/postman/dynamic_postman.hpp>
+
+#include "dynamic_postman_test.hpp"
+
+namespace
+{
+	class Receiver
+	{
+	public:
+		void
+		actionSimple(const xpcc::ResponseHandle&)
+		{
+			calls[callCount++] = 1;
+		}
+
+		void
+		actionValue(const xpcc::ResponseHandle&, const uint16_t& value)
+		{
+			calls[callCount++] = value;
+		}
+
+		void
+		eventSimple(const xpcc::Header&)
+		{
+			calls[callCount++] = 2;
+		}
+
+		void
+		eventValue(const xpcc::Header&, const uint16_t& value)
+		{
+			calls[callCount++] = value;
+		}
+
+		uint16_t calls[8] = {};
+		uint8_t callCount = 0;
+	};
+}
+
+void
+DynamicPostmanTest::testActionHandler()
+{
+	xpcc::DynamicPostman postman;
+	Receiver receiver;
+
+	postman.registerActionHandler(3, 0x10, &receiver, &Receiver::actionSimple);
+	postman.registerActionHandler(3, 0x11, &receiver, &Receiver::actionValue);
+	postman.registerActionHandler(1, 0x11, &receiver, &Receiver::actionSimple);
+
+	uint16_t value = 1234;
+	xpcc::SmartPointer payload(&value);
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 3, 10, 0x11);
+
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, payload), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(receiver.callCount, 1);
+	TEST_ASSERT_EQUALS(receiver.calls[0], 1234);
+
+	header.packetIdentifier = 0x10;
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, payload), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(receiver.callCount, 2);
+	TEST_ASSERT_EQUALS(receiver.calls[1], 1);
+
+	header.packetIdentifier = 0x12;
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, payload), xpcc::Postman::NO_ACTION);
+
+	header.destination = 2;
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, payload), xpcc::Postman::NO_COMPONENT);
+	TEST_ASSERT_EQUALS(receiver.callCount, 2);
+}
+
+void
+DynamicPostmanTest::testActionHandlerReplaced()
+{
+	xpcc::DynamicPostman postman;
+	Receiver receiver;
+
+	postman.registerActionHandler(3, 0x10, &receiver, &Receiver::actionValue);
+	postman.registerActionHandler(3, 0x10, &receiver, &Receiver::actionSimple);
+
+	uint16_t value = 1234;
+	xpcc::SmartPointer payload(&value);
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 3, 10, 0x10);
+
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, payload), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(receiver.callCount, 1);
+	TEST_ASSERT_EQUALS(receiver.calls[0], 1);
+}
+
+void
+DynamicPostmanTest::testEventListenerOrder()
+{
+	xpcc::DynamicPostman postman;
+	Receiver receiver;
+
+	postman.registerEventListener(0x21, &receiver, &Receiver::eventValue);
+	postman.registerEventListener(0x20, &receiver, &Receiver::eventSimple);
+	postman.registerEventListener(0x21, &receiver, &Receiver::eventSimple);
+	postman.registerEventListener(0x22, &receiver, &Receiver::eventSimple);
+
+	uint16_t value = 4321;
+	xpcc::SmartPointer payload(&value);
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0, 10, 0x21);
+
+	// listeners are called in the order of registration
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, payload), xpcc::Postman::OK);
+	TEST_ASSERT_EQUALS(receiver.callCount, 2);
+	TEST_ASSERT_EQUALS(receiver.calls[0], 4321);
+	TEST_ASSERT_EQUALS(receiver.calls[1], 2);
+
+	header.packetIdentifier = 0x23;
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, payload), xpcc::Postman::NO_EVENT);
+	TEST_ASSERT_EQUALS(receiver.callCount, 2);
+}
+
+void
+DynamicPostmanTest::testComponentAvailable()
+{
+	xpcc::DynamicPostman postman;
+	Receiver receiver;
+
+	TEST_ASSERT_FALSE(postman.isComponentAvailable(3));
+
+	postman.registerActionHandler(3, 0x10, &receiver, &Receiver::actionSimple);
+	postman.registerEventListener(0x20, &receiver, &Receiver::eventSimple);
+
+	TEST_ASSERT_TRUE(postman.isComponentAvailable(3));
+	TEST_ASSERT_FALSE(postman.isComponentAvailable(0));
+	TEST_ASSERT_FALSE(postman.isComponentAvailable(4));
+}
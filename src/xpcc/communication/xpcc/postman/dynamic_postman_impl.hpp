@@ -19,16 +19,13 @@ xpcc::DynamicPostman::registerEventListener(const uint8_t eventId,
 {
 	using namespace std::placeholders;
 
-	eventMap.insert(
-			std::pair<uint8_t, EventListener>(
-					eventId,
-					EventListener(static_cast<EventCallbackSimple>(
-							std::bind(
-									memberFunction,
-									componentObject,
-									_1)
-					))
-			)
+	insertEventListener(eventId,
+			EventListener(static_cast<EventCallbackSimple>(
+					std::bind(
+							memberFunction,
+							componentObject,
+							_1)
+			))
 	);
 
 	return true;
@@ -43,15 +40,12 @@ xpcc::DynamicPostman::registerEventListener(const uint8_t eventId,
 	using namespace std::placeholders;
 	typedef void (C::*Function)(const Header&, const uint8_t&);
 
-	eventMap.insert(
-			std::pair<uint8_t, EventListener>(
-					eventId,
-					EventListener(
-							std::bind(
-									reinterpret_cast<Function>(memberFunction),
-									componentObject,
-									_1, _2)
-					)
+	insertEventListener(eventId,
+			EventListener(
+					std::bind(
+							reinterpret_cast<Function>(memberFunction),
+							componentObject,
+							_1, _2)
 			)
 	);
 
@@ -67,12 +61,14 @@ xpcc::DynamicPostman::registerActionHandler(const uint8_t componentId,
 {
 	using namespace std::placeholders;
 
-	actionMap[componentId][actionId] = ActionHandler(static_cast<ActionCallbackSimple>(
-			std::bind(
-					memberFunction,
-					componentObject,
-					_1)
-	));
+	insertActionHandler(componentId, actionId,
+			ActionHandler(static_cast<ActionCallbackSimple>(
+					std::bind(
+							memberFunction,
+							componentObject,
+							_1)
+			))
+	);
 
 	return true;
 }
@@ -87,11 +83,13 @@ xpcc::DynamicPostman::registerActionHandler(const uint8_t componentId,
 	using namespace std::placeholders;
 	typedef void (C::*Function)(const ResponseHandle&, const uint8_t&);
 
-	actionMap[componentId][actionId] = ActionHandler(
-			std::bind(
-					reinterpret_cast<Function>(memberFunction),
-					componentObject,
-					_1, _2)
+	insertActionHandler(componentId, actionId,
+			ActionHandler(
+					std::bind(
+							reinterpret_cast<Function>(memberFunction),
+							componentObject,
+							_1, _2)
+			)
 	);
 
 	return true;
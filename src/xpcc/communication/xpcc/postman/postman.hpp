@@ -32,6 +32,7 @@
 #define	XPCC__POSTMAN_HPP
 
 #include "../backend/backend_interface.hpp"
+#include "../response_callback.hpp"
 #include "response.hpp"
 
 namespace xpcc
@@ -72,6 +73,33 @@ namespace xpcc
 		 */
 		virtual bool
 		isComponentAvailable(uint8_t component) const = 0;
+
+		/**
+		 * \brief	Call the callback of an action call with its response
+		 *
+		 * Called by the dispatcher instead of calling the callback
+		 * itself, so that a postman which executes its components in
+		 * other threads (see xpcc::ThreadedPostman) can forward the
+		 * response to the thread of the calling component.
+		 */
+		virtual void
+		deliverResponse(const ResponseCallback& callback,
+				const Header& header, const SmartPointer& payload)
+		{
+			callback.call(header, payload);
+		}
+
+		/**
+		 * \brief	Check if the components are executed in other threads
+		 *
+		 * The dispatcher only protects itself with a mutex if this
+		 * returns \c true. Must not change while the dispatcher is used.
+		 */
+		virtual bool
+		isThreaded() const
+		{
+			return false;
+		}
 	};
 }
 
@@ -0,0 +1,250 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC_THREADED_POSTMAN_HPP
+#define	XPCC_THREADED_POSTMAN_HPP
+
+#include "postman.hpp"
+#include "../response_callback.hpp"
+#include "../backend/header.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xpcc
+{
+
+/**
+ * Worker thread executing a group of components.
+ *
+ * All action handlers, event listeners and response callbacks of the
+ * components and their update() methods are called from this thread, so
+ * the components need no locking as long as they only share data with
+ * components of the same thread.
+ *
+ * Messages are handed over by the xpcc::ThreadedPostman through a
+ * lock-free single producer, single consumer mailbox. While the mailbox
+ * is empty the thread calls the update() methods every `period` and
+ * sleeps in between.
+ *
+ * @see		xpcc::ThreadedPostman
+ * @ingroup	xpcc_comm
+ */
+class ComponentThread
+{
+public:
+	/**
+	 * @param	postman		delivers the messages to the components of this
+	 * 						thread, usually a xpcc::DynamicPostman with only
+	 * 						their handlers and listeners
+	 * @param	mailboxSize	number of messages which can wait for the
+	 * 						thread, rounded up to a power of two
+	 * @param	period		interval of the update() calls while idle
+	 */
+	ComponentThread(Postman *postman, std::size_t mailboxSize = 256,
+			std::chrono::microseconds period = std::chrono::milliseconds(1));
+
+	/// Stops the thread
+	~ComponentThread();
+
+	/**
+	 * Execute a component in this thread, only before start()
+	 *
+	 * Calls `component->update()` in this thread and delivers the
+	 * responses to the actions called by the component to this thread,
+	 * also if the component has no action handlers.
+	 */
+	template< class C >
+	void
+	addComponent(C *component)
+	{
+		updates.push_back([component]() { component->update(); });
+		components.push_back(component->getCommunicator()->getIdentifier());
+	}
+
+	/// Check if the component was added with addComponent()
+	bool
+	isExecuting(uint8_t component) const;
+
+	void
+	start();
+
+	/// Stop the thread after the current message and wait for it
+	void
+	stop();
+
+	inline Postman *
+	getPostman() const
+	{
+		return postman;
+	}
+
+	/**
+	 * Queue a request or event for the components of this thread.
+	 *
+	 * Must only be called from one thread at a time, i.e. by the
+	 * dispatcher.
+	 *
+	 * @return	`false` if the mailbox is full, the message is discarded
+	 */
+	bool
+	post(const Header& header, const SmartPointer& payload);
+
+	/// Queue a response for a callback of a component of this thread
+	bool
+	post(const ResponseCallback& callback, const Header& header,
+			const SmartPointer& payload);
+
+	/// Number of messages discarded because the mailbox was full
+	inline uint32_t
+	getDiscardedMessages() const
+	{
+		return discardedMessages.load(std::memory_order_relaxed);
+	}
+
+private:
+	ComponentThread(const ComponentThread&) = delete;
+
+	ComponentThread&
+	operator = (const ComponentThread&) = delete;
+
+	struct Message
+	{
+		Header header;
+		SmartPointer payload;
+		/// callable for responses, empty for requests and events
+		ResponseCallback callback;
+	};
+
+	bool
+	push(const ResponseCallback& callback, const Header& header,
+			const SmartPointer& payload);
+
+	bool
+	pop(Message& message);
+
+	void
+	run();
+
+	/// Wait for a message, at most one period
+	void
+	wait();
+
+	Postman * const postman;
+	const std::chrono::microseconds period;
+	std::vector< std::function<void ()> > updates;
+	std::vector<uint8_t> components;
+
+	// Mailbox, a ring buffer with free running indices. `tail` is only
+	// written by the producer, `head` only by this thread.
+	std::vector<Message> mailbox;
+	const std::size_t mask;
+	std::atomic<std::size_t> head;
+	std::atomic<std::size_t> tail;
+
+	std::atomic<bool> sleeping;
+	std::mutex sleepMutex;
+	std::condition_variable wakeup;
+
+	std::atomic<bool> running;
+	std::thread thread;
+
+	std::atomic<uint32_t> discardedMessages;
+};
+
+/**
+ * Postman executing the components in several threads.
+ *
+ * By default all components are executed in `Dispatcher::update()`, so
+ * one slow handler stalls all other components. The threaded postman
+ * instead hands every message to the xpcc::ComponentThread of its
+ * destination component, which calls the handler in its own thread.
+ * Events are handed to all threads, each thread delivers them to the
+ * listeners of its own components. Response callbacks are executed in
+ * the thread of the component which called the action, so every
+ * component calling actions has to be added to its thread with
+ * ComponentThread::addComponent(). Responses for other components are
+ * discarded, they are never executed in the thread of the dispatcher.
+ *
+ * Each thread receives the messages in the order they are delivered by
+ * the dispatcher, so the order of the messages between two components
+ * is preserved.
+ *
+ * Only available on hosted targets. With a threaded postman the
+ * dispatcher is protected by a mutex, so the components may call
+ * actions, publish events and send responses from their threads.
+ *
+ * @code
+ * xpcc::DynamicPostman driverPostman;
+ * driverPostman.registerActionHandler(robot::component::DRIVER,
+ *         robot::action::SET_SPEED, &driver, &Driver::setSpeed);
+ *
+ * xpcc::ComponentThread driverThread(&driverPostman);
+ * driverThread.addComponent(&driver);
+ * // ... more threads with other components
+ *
+ * xpcc::ThreadedPostman postman;
+ * postman.addThread(&driverThread);
+ *
+ * xpcc::Dispatcher dispatcher(&backend, &postman);
+ * postman.start();
+ *
+ * while (true) {
+ *     dispatcher.update();
+ *     // ...
+ * }
+ * @endcode
+ *
+ * @ingroup	xpcc_comm
+ */
+class ThreadedPostman : public Postman
+{
+public:
+	/// Add a thread, only before start()
+	void
+	addThread(ComponentThread *thread);
+
+	/// Start all threads
+	void
+	start();
+
+	/// Stop all threads
+	void
+	stop();
+
+	DeliverInfo
+	deliverPacket(const Header &header, const SmartPointer& payload) override;
+
+	bool
+	isComponentAvailable(uint8_t component) const override;
+
+	void
+	deliverResponse(const ResponseCallback& callback,
+			const Header& header, const SmartPointer& payload) override;
+
+	/// Always `true`, the dispatcher has to lock its mutex
+	bool
+	isThreaded() const override;
+
+private:
+	/// Thread executing the component, `nullptr` if none
+	ComponentThread *
+	findThread(uint8_t component) const;
+
+	std::vector<ComponentThread *> threads;
+};
+
+}	// namespace xpcc
+
+#endif	// XPCC_THREADED_POSTMAN_HPP
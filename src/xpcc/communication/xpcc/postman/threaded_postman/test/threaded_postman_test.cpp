@@ -0,0 +1,346 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <xpcc/communication/xpcc/abstract_component.hpp>
+#include <xpcc/communication/xpcc/postman/dynamic_postman.hpp>
+#include <xpcc/communication/xpcc/postman/threaded_postman.hpp>
+
+#include "threaded_postman_test.hpp"
+
+namespace
+{
+	const uint16_t numberOfCalls = 200;
+
+	class NullBackend : public xpcc::BackendInterface
+	{
+	public:
+		virtual void
+		update()
+		{
+		}
+
+		virtual void
+		sendPacket(const xpcc::Header&, xpcc::SmartPointer)
+		{
+		}
+
+		virtual bool
+		isPacketAvailable() const
+		{
+			return false;
+		}
+
+		virtual const xpcc::Header&
+		getPacketHeader() const
+		{
+			return header;
+		}
+
+		virtual const xpcc::SmartPointer
+		getPacketPayload() const
+		{
+			return xpcc::SmartPointer();
+		}
+
+		virtual void
+		dropPacket()
+		{
+		}
+
+		xpcc::Header header;
+	};
+
+	/// Answers every call with the received value
+	class Server : public xpcc::AbstractComponent
+	{
+	public:
+		Server(xpcc::Dispatcher *dispatcher) :
+			xpcc::AbstractComponent(1, dispatcher)
+		{
+		}
+
+		void
+		update()
+		{
+		}
+
+		void
+		echo(const xpcc::ResponseHandle& handle, const uint16_t& value)
+		{
+			thread = std::this_thread::get_id();
+			values.push_back(value);
+			sendResponse(handle, value);
+		}
+
+		void
+		event(const xpcc::Header&)
+		{
+			events++;
+		}
+
+		std::vector<uint16_t> values;
+		std::thread::id thread;
+		uint32_t events = 0;
+	};
+
+	/// Calls the action of the server from its update() method
+	class Client : public xpcc::AbstractComponent
+	{
+	public:
+		Client(xpcc::Dispatcher *dispatcher) :
+			xpcc::AbstractComponent(2, dispatcher)
+		{
+		}
+
+		void
+		update()
+		{
+			updateThread = std::this_thread::get_id();
+
+			// at most a few calls in flight, the dispatcher has a fixed size
+			while (sent < numberOfCalls && sent - responses.size() < 4)
+			{
+				xpcc::ResponseCallback callback(this, &Client::response);
+				callAction(1, 0x10, sent, callback);
+				sent++;
+			}
+		}
+
+		void
+		response(const xpcc::Header&, const uint16_t *value)
+		{
+			responseThread = std::this_thread::get_id();
+			responses.push_back(*value);
+			if (responses.size() == numberOfCalls) {
+				finished = true;
+			}
+		}
+
+		void
+		ping(const xpcc::ResponseHandle&)
+		{
+		}
+
+		void
+		event(const xpcc::Header&)
+		{
+			events++;
+		}
+
+		uint16_t sent = 0;
+		std::vector<uint16_t> responses;
+		std::thread::id updateThread;
+		std::thread::id responseThread;
+		uint32_t events = 0;
+		std::atomic<bool> finished { false };
+	};
+
+	/// Calls the action of the server once, but has no handlers itself
+	class Caller : public xpcc::AbstractComponent
+	{
+	public:
+		Caller(xpcc::Dispatcher *dispatcher) :
+			xpcc::AbstractComponent(3, dispatcher)
+		{
+		}
+
+		void
+		update()
+		{
+			updateThread = std::this_thread::get_id();
+			if (!called)
+			{
+				xpcc::ResponseCallback callback(this, &Caller::response);
+				callAction(1, 0x10, uint16_t(0x1234), callback);
+				called = true;
+			}
+		}
+
+		void
+		response(const xpcc::Header&, const uint16_t *value)
+		{
+			responseThread = std::this_thread::get_id();
+			this->value = *value;
+			finished = true;
+		}
+
+		bool called = false;
+		uint16_t value = 0;
+		std::thread::id updateThread;
+		std::thread::id responseThread;
+		std::atomic<bool> finished { false };
+	};
+
+	/// Run the dispatcher until the condition is true, at most two seconds
+	template< typename Condition >
+	bool
+	runDispatcher(xpcc::Dispatcher& dispatcher, Condition condition)
+	{
+		auto end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+		while (std::chrono::steady_clock::now() < end)
+		{
+			dispatcher.update();
+			if (condition()) {
+				return true;
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		return false;
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+ThreadedPostmanTest::testActionCallsBetweenThreads()
+{
+	NullBackend backend;
+	xpcc::ThreadedPostman postman;
+	xpcc::Dispatcher dispatcher(&backend, &postman);
+
+	Server server(&dispatcher);
+	Client client(&dispatcher);
+
+	xpcc::DynamicPostman serverPostman;
+	serverPostman.registerActionHandler(1, 0x10, &server, &Server::echo);
+	xpcc::DynamicPostman clientPostman;
+	clientPostman.registerActionHandler(2, 0x10, &client, &Client::ping);
+
+	xpcc::ComponentThread serverThread(&serverPostman);
+	serverThread.addComponent(&server);
+	xpcc::ComponentThread clientThread(&clientPostman);
+	clientThread.addComponent(&client);
+
+	postman.addThread(&serverThread);
+	postman.addThread(&clientThread);
+	TEST_ASSERT_TRUE(postman.isComponentAvailable(1));
+	TEST_ASSERT_TRUE(postman.isComponentAvailable(2));
+	TEST_ASSERT_FALSE(postman.isComponentAvailable(3));
+
+	postman.start();
+	bool finished = runDispatcher(dispatcher, [&]() { return client.finished.load(); });
+	postman.stop();
+
+	TEST_ASSERT_TRUE(finished);
+	TEST_ASSERT_EQUALS(server.values.size(), numberOfCalls);
+	TEST_ASSERT_EQUALS(client.responses.size(), numberOfCalls);
+
+	// the order between two components is preserved
+	for (uint16_t i = 0; i < numberOfCalls; ++i)
+	{
+		TEST_ASSERT_EQUALS(server.values[i], i);
+		TEST_ASSERT_EQUALS(client.responses[i], i);
+	}
+
+	// handlers and callbacks are called in the thread of their component
+	TEST_ASSERT_TRUE(server.thread != std::this_thread::get_id());
+	TEST_ASSERT_TRUE(client.updateThread != std::this_thread::get_id());
+	TEST_ASSERT_TRUE(client.updateThread != server.thread);
+	TEST_ASSERT_TRUE(client.responseThread == client.updateThread);
+
+	TEST_ASSERT_EQUALS(dispatcher.getNumberOfPendingMessages(), 0U);
+}
+
+void
+ThreadedPostmanTest::testResponseToComponentWithoutHandlers()
+{
+	NullBackend backend;
+	xpcc::ThreadedPostman postman;
+	xpcc::Dispatcher dispatcher(&backend, &postman);
+
+	Server server(&dispatcher);
+	Caller caller(&dispatcher);
+
+	xpcc::DynamicPostman serverPostman;
+	serverPostman.registerActionHandler(1, 0x10, &server, &Server::echo);
+	xpcc::DynamicPostman callerPostman;
+
+	xpcc::ComponentThread serverThread(&serverPostman);
+	serverThread.addComponent(&server);
+	xpcc::ComponentThread callerThread(&callerPostman);
+	callerThread.addComponent(&caller);
+
+	postman.addThread(&serverThread);
+	postman.addThread(&callerThread);
+	TEST_ASSERT_TRUE(postman.isComponentAvailable(3));
+	TEST_ASSERT_TRUE(callerThread.isExecuting(3));
+	TEST_ASSERT_FALSE(serverThread.isExecuting(3));
+
+	postman.start();
+	bool finished = runDispatcher(dispatcher, [&]() { return caller.finished.load(); });
+	postman.stop();
+
+	TEST_ASSERT_TRUE(finished);
+	TEST_ASSERT_EQUALS(caller.value, 0x1234);
+
+	// the callback is not called by the dispatcher
+	TEST_ASSERT_TRUE(caller.responseThread != std::this_thread::get_id());
+	TEST_ASSERT_TRUE(caller.responseThread == caller.updateThread);
+}
+
+void
+ThreadedPostmanTest::testEventDeliveredOncePerThread()
+{
+	NullBackend backend;
+	xpcc::ThreadedPostman postman;
+	xpcc::Dispatcher dispatcher(&backend, &postman);
+
+	Server server(&dispatcher);
+	Client client(&dispatcher);
+
+	xpcc::DynamicPostman serverPostman;
+	serverPostman.registerActionHandler(1, 0x10, &server, &Server::echo);
+	serverPostman.registerEventListener(0x20, &server, &Server::event);
+	xpcc::DynamicPostman clientPostman;
+	clientPostman.registerActionHandler(2, 0x10, &client, &Client::ping);
+	clientPostman.registerEventListener(0x20, &client, &Client::event);
+	clientPostman.registerEventListener(0x21, &client, &Client::event);
+
+	xpcc::ComponentThread serverThread(&serverPostman);
+	xpcc::ComponentThread clientThread(&clientPostman);
+	postman.addThread(&serverThread);
+	postman.addThread(&clientThread);
+	postman.start();
+
+	// published from the main thread
+	server.getCommunicator()->publishEvent(0x20);
+	server.getCommunicator()->publishEvent(0x21);
+
+	std::atomic<uint32_t> updates(0);
+	runDispatcher(dispatcher, [&]() { return ++updates > 100; });
+	postman.stop();
+
+	TEST_ASSERT_EQUALS(server.events, 1U);
+	TEST_ASSERT_EQUALS(client.events, 2U);
+}
+
+void
+ThreadedPostmanTest::testMailboxFull()
+{
+	xpcc::DynamicPostman serverPostman;
+	xpcc::ComponentThread thread(&serverPostman, 3);
+
+	xpcc::ThreadedPostman postman;
+	postman.addThread(&thread);
+
+	// rounded up to four messages, the thread is not running
+	xpcc::Header header(xpcc::Header::Type::REQUEST, false, 0, 2, 0x20);
+	for (uint8_t i = 0; i < 4; ++i) {
+		TEST_ASSERT_TRUE(thread.post(header, xpcc::SmartPointer()));
+	}
+	TEST_ASSERT_FALSE(thread.post(header, xpcc::SmartPointer()));
+	TEST_ASSERT_EQUALS(thread.getDiscardedMessages(), 1U);
+
+	// unknown components are rejected before the mailbox
+	header.destination = 5;
+	TEST_ASSERT_EQUALS(postman.deliverPacket(header, xpcc::SmartPointer()),
+			xpcc::Postman::NO_COMPONENT);
+}
@@ -0,0 +1,30 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef THREADED_POSTMAN_TEST_HPP
+#define THREADED_POSTMAN_TEST_HPP
+
+#include <unittest/testsuite.hpp>
+
+class ThreadedPostmanTest : public unittest::TestSuite
+{
+public:
+	void
+	testActionCallsBetweenThreads();
+
+	void
+	testResponseToComponentWithoutHandlers();
+
+	void
+	testEventDeliveredOncePerThread();
+
+	void
+	testMailboxFull();
+};
+
+#endif // THREADED_POSTMAN_TEST_HPP
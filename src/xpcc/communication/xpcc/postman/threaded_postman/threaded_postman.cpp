@@ -0,0 +1,265 @@
+// coding: utf-8
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../threaded_postman.hpp"
+
+#include <xpcc/debug/logger.hpp>
+
+#undef	XPCC_LOG_LEVEL
+#define	XPCC_LOG_LEVEL xpcc::log::WARNING
+
+namespace
+{
+	std::size_t
+	roundUpToPowerOfTwo(std::size_t value)
+	{
+		std::size_t result = 1;
+		while (result < value) {
+			result <<= 1;
+		}
+		return result;
+	}
+}
+
+// ----------------------------------------------------------------------------
+xpcc::ComponentThread::ComponentThread(Postman *postman,
+		std::size_t mailboxSize, std::chrono::microseconds period) :
+	postman(postman), period(period),
+	mailbox(roundUpToPowerOfTwo(mailboxSize)), mask(mailbox.size() - 1),
+	head(0), tail(0), sleeping(false), running(false), discardedMessages(0)
+{
+}
+
+xpcc::ComponentThread::~ComponentThread()
+{
+	this->stop();
+}
+
+void
+xpcc::ComponentThread::start()
+{
+	if (this->running.exchange(true)) {
+		return;
+	}
+	this->thread = std::thread(&ComponentThread::run, this);
+}
+
+void
+xpcc::ComponentThread::stop()
+{
+	if (!this->running.exchange(false)) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex);
+		this->wakeup.notify_one();
+	}
+	this->thread.join();
+}
+
+bool
+xpcc::ComponentThread::isExecuting(uint8_t component) const
+{
+	for (uint8_t identifier : this->components)
+	{
+		if (identifier == component) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::ComponentThread::post(const Header& header, const SmartPointer& payload)
+{
+	return this->push(ResponseCallback(), header, payload);
+}
+
+bool
+xpcc::ComponentThread::post(const ResponseCallback& callback,
+		const Header& header, const SmartPointer& payload)
+{
+	return this->push(callback, header, payload);
+}
+
+bool
+xpcc::ComponentThread::push(const ResponseCallback& callback,
+		const Header& header, const SmartPointer& payload)
+{
+	const std::size_t index = this->tail.load(std::memory_order_relaxed);
+	if (index - this->head.load(std::memory_order_acquire) > this->mask)
+	{
+		this->discardedMessages.fetch_add(1, std::memory_order_relaxed);
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "Mailbox full, message dropped" << xpcc::endl;
+		return false;
+	}
+
+	Message& message = this->mailbox[index & this->mask];
+	message.header = header;
+	message.payload = payload;
+	message.callback = callback;
+
+	// sequentially consistent together with `sleeping`, otherwise the
+	// thread might go to sleep right after this message was added
+	this->tail.store(index + 1, std::memory_order_seq_cst);
+	if (this->sleeping.load(std::memory_order_seq_cst))
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex);
+		this->wakeup.notify_one();
+	}
+	return true;
+}
+
+bool
+xpcc::ComponentThread::pop(Message& message)
+{
+	const std::size_t index = this->head.load(std::memory_order_relaxed);
+	if (index == this->tail.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	Message& slot = this->mailbox[index & this->mask];
+	message.header = slot.header;
+	message.payload = slot.payload;
+	message.callback = slot.callback;
+
+	// release the payload before the slot is handed back to the producer
+	slot.payload = SmartPointer();
+	this->head.store(index + 1, std::memory_order_release);
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::ComponentThread::run()
+{
+	Message message;
+	while (this->running.load(std::memory_order_relaxed))
+	{
+		bool delivered = false;
+		while (this->pop(message))
+		{
+			if (message.callback.isCallable()) {
+				message.callback.call(message.header, message.payload);
+			} else {
+				this->postman->deliverPacket(message.header, message.payload);
+			}
+			delivered = true;
+		}
+		message.payload = SmartPointer();
+
+		for (auto& update : this->updates) {
+			update();
+		}
+
+		if (!delivered) {
+			this->wait();
+		}
+	}
+}
+
+void
+xpcc::ComponentThread::wait()
+{
+	std::unique_lock<std::mutex> lock(this->sleepMutex);
+	this->sleeping.store(true, std::memory_order_seq_cst);
+	if (this->head.load(std::memory_order_relaxed) ==
+			this->tail.load(std::memory_order_seq_cst) &&
+			this->running.load(std::memory_order_relaxed)) {
+		this->wakeup.wait_for(lock, this->period);
+	}
+	this->sleeping.store(false, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::ThreadedPostman::addThread(ComponentThread *thread)
+{
+	this->threads.push_back(thread);
+}
+
+void
+xpcc::ThreadedPostman::start()
+{
+	for (ComponentThread *thread : this->threads) {
+		thread->start();
+	}
+}
+
+void
+xpcc::ThreadedPostman::stop()
+{
+	for (ComponentThread *thread : this->threads) {
+		thread->stop();
+	}
+}
+
+xpcc::ComponentThread *
+xpcc::ThreadedPostman::findThread(uint8_t component) const
+{
+	// components without handlers are only known by their thread
+	for (ComponentThread *thread : this->threads)
+	{
+		if (thread->isExecuting(component) ||
+			thread->getPostman()->isComponentAvailable(component)) {
+			return thread;
+		}
+	}
+	return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+xpcc::ThreadedPostman::DeliverInfo
+xpcc::ThreadedPostman::deliverPacket(const Header &header, const SmartPointer& payload)
+{
+	if (header.destination == 0)
+	{
+		// EVENT, every thread delivers it to its own listeners
+		for (ComponentThread *thread : this->threads) {
+			thread->post(header, payload);
+		}
+		return OK;
+	}
+
+	ComponentThread *thread = this->findThread(header.destination);
+	if (thread == nullptr) {
+		return NO_COMPONENT;
+	}
+	// the handler is called later, errors can no longer be reported
+	return thread->post(header, payload) ? OK : ERROR;
+}
+
+bool
+xpcc::ThreadedPostman::isComponentAvailable(uint8_t component) const
+{
+	return (this->findThread(component) != nullptr);
+}
+
+void
+xpcc::ThreadedPostman::deliverResponse(const ResponseCallback& callback,
+		const Header& header, const SmartPointer& payload)
+{
+	// the destination of the response is the component which called the action
+	ComponentThread *thread = this->findThread(header.destination);
+	if (thread != nullptr) {
+		thread->post(callback, header, payload);
+	}
+	else {
+		// calling the callback here would race with the thread of the component
+		XPCC_LOG_ERROR << XPCC_FILE_INFO << "No thread for component "
+				<< header.destination << ", response dropped" << xpcc::endl;
+	}
+}
+
+bool
+xpcc::ThreadedPostman::isThreaded() const
+{
+	return true;
+}
@@ -103,8 +103,8 @@ namespace xpcc
 		}
 
 	protected:
-		Communicatable * const component;
-		Function const function;
+		Communicatable * component;
+		Function function;
 		/*uint8_t packetSize;*/
 	};
 
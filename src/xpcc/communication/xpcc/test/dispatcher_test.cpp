@@ -544,3 +544,306 @@ DispatcherTest::testResponseRetransmission()
 	
 	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 0U);
 }
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testAcknowledgeOutOfOrder()
+{
+	const uint8_t count = xpcc::Dispatcher::maxPendingMessages;
+	for (uint8_t i = 0; i < count; ++i) {
+		component1->callAction(10, 0x80 + i);
+	}
+	
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), count);
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), count);
+	backend->messagesSend.removeAll();
+	
+	// acknowledge every second message in reverse order
+	for (int16_t i = count - 1; i >= 0; i -= 2)
+	{
+		backend->messagesToReceive.append(
+				Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 1, 10, 0x80 + i),
+						xpcc::SmartPointer()));
+	}
+	
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 0U);
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), count / 2U);
+	
+	// only the messages without ACK are retransmitted
+	TestingClock::time += 500;
+	
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), count / 2U);
+	for (uint8_t i = 0; i < count / 2U; ++i)
+	{
+		TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+				xpcc::Header(xpcc::Header::Type::REQUEST, false, 10, 1, 0x80 + 2 * i));
+		backend->messagesSend.removeFront();
+	}
+}
+
+void
+DispatcherTest::testPendingMessagesOverflow()
+{
+	const uint8_t count = xpcc::Dispatcher::maxPendingMessages;
+	for (uint8_t i = 0; i < count + 1; ++i) {
+		component1->callAction(10, 0x80 + i);
+	}
+	
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), count);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getBack().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 10, 1, 0x80 + count - 1));
+	
+	// entries are freed again after the transmission was aborted
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		TestingClock::time += 500;
+		dispatcher->update();
+	}
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 0U);
+}
+
+// ----------------------------------------------------------------------------
+namespace
+{
+	struct Position
+	{
+		Position(int16_t x, int16_t y, float phi) :
+			x(x), y(y), phi(phi)
+		{
+		}
+
+		int16_t x;
+		int16_t y;
+		float phi;
+	} __attribute__((packed));
+
+	struct Path
+	{
+		Path(uint8_t length) :
+			length(length), points()
+		{
+		}
+
+		uint8_t length;
+		int16_t points[8];
+	};
+
+	/// Records the number of queued messages while it is constructed
+	struct Probe
+	{
+		Probe(const xpcc::Dispatcher *dispatcher) :
+			pending(dispatcher->getNumberOfPendingMessages())
+		{
+		}
+
+		uint16_t pending;
+	};
+}
+
+void
+DispatcherTest::testEmplaceEvent()
+{
+	TEST_ASSERT_TRUE(component2->emplaceEvent<uint32_t>(0x21, 0x12345678U));
+
+	dispatcher->update();
+
+	TEST_ASSERT_EQUALS(timeline->events.getSize(), 1U);
+	TEST_ASSERT_EQUALS(timeline->events.getFront().id, 0x21);
+	TEST_ASSERT_EQUALS(timeline->events.getFront().payload.get<uint32_t>(), 0x12345678U);
+
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 1U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 2, 0x21));
+
+	// constructed from several arguments
+	TEST_ASSERT_TRUE(component2->emplaceEvent<Position>(0x22, 100, -20, 0.5f));
+	dispatcher->update();
+
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	const xpcc::SmartPointer& payload = backend->messagesSend.getBack().payload;
+	TEST_ASSERT_EQUALS(payload.getSize(), sizeof(Position));
+	TEST_ASSERT_EQUALS(payload.get<Position>().x, 100);
+	TEST_ASSERT_EQUALS(payload.get<Position>().y, -20);
+	TEST_ASSERT_EQUALS(payload.get<Position>().phi, 0.5f);
+}
+
+void
+DispatcherTest::testEmplaceActionWithoutHeap()
+{
+	xpcc::SmartPointer::resetStatistics();
+
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	TEST_ASSERT_TRUE(component2->emplaceAction<Path>(10, 0x11, callback, 3));
+	TEST_ASSERT_TRUE(component2->emplaceAction<uint16_t>(10, 0x12, 0x1234));
+
+	xpcc::SmartPointer::Statistics statistics = xpcc::SmartPointer::getStatistics();
+	TEST_ASSERT_EQUALS(statistics.heapAllocations, 0U);
+	TEST_ASSERT_EQUALS(statistics.poolAllocations, 1U);
+
+	dispatcher->update();
+
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 10, 2, 0x11));
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().payload.get<Path>().length, 3);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getBack().payload.get<uint16_t>(), 0x1234U);
+
+	// payloads which do not fit into a pool block are rejected
+	struct Large
+	{
+		uint8_t data[200];
+	};
+	TEST_ASSERT_FALSE(component2->emplaceAction<Large>(10, 0x13));
+	TEST_ASSERT_EQUALS(xpcc::SmartPointer::getStatistics().heapAllocations, 0U);
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 2U);
+}
+
+void
+DispatcherTest::testEmplaceConstructedBeforeQueued()
+{
+	const xpcc::Dispatcher *constDispatcher = dispatcher;
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	TEST_ASSERT_TRUE(component2->emplaceAction<Probe>(10, 0x11, callback, constDispatcher));
+	TEST_ASSERT_TRUE(component2->emplaceEvent<Probe>(0x21, constDispatcher));
+	TEST_ASSERT_EQUALS(dispatcher->getNumberOfPendingMessages(), 2U);
+
+	dispatcher->update();
+
+	// the message was not visible to the dispatcher during construction
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().payload.get<Probe>().pending, 0U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getBack().payload.get<Probe>().pending, 1U);
+}
+
+// ----------------------------------------------------------------------------
+void
+DispatcherTest::testStatistics()
+{
+#if XPCC__DISPATCHER_STATISTICS
+	dispatcher->resetStatistics();
+	
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(10, 0x40, callback);
+	dispatcher->update();
+	
+	TestingClock::time += 3;
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 2, 10, 0x40),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	
+	TestingClock::time += 20;
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::RESPONSE, false, 2, 10, 0x40),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	
+	// internal action calls are answered without ACK
+	component2->callAction(1, 0x12, callback);
+	dispatcher->update();
+	dispatcher->update();
+	
+	const xpcc::DispatcherStatistics& statistics = dispatcher->getStatistics();
+	TEST_ASSERT_EQUALS(statistics.getNumberOfActions(), 2U);
+	TEST_ASSERT_EQUALS(statistics.maximumQueueDepth, 2U);
+	TEST_ASSERT_EQUALS(statistics.droppedMessages, 0U);
+	
+	const xpcc::DispatcherStatistics::Action *action = statistics.getAction(10, 0x40);
+	TEST_ASSERT_TRUE(action != nullptr);
+	TEST_ASSERT_EQUALS(action->requests, 1U);
+	TEST_ASSERT_EQUALS(action->retransmissions, 0U);
+	TEST_ASSERT_EQUALS(action->acknowledge.getCount(), 1U);
+	TEST_ASSERT_EQUALS(action->acknowledge.buckets[1], 1U);
+	TEST_ASSERT_EQUALS(action->acknowledge.maximum, 3U);
+	TEST_ASSERT_EQUALS(action->response.getCount(), 1U);
+	TEST_ASSERT_EQUALS(action->response.buckets[4], 1U);
+	TEST_ASSERT_EQUALS(action->response.maximum, 23U);
+	
+	action = statistics.getAction(1, 0x12);
+	TEST_ASSERT_TRUE(action != nullptr);
+	TEST_ASSERT_EQUALS(action->requests, 1U);
+	TEST_ASSERT_EQUALS(action->acknowledge.getCount(), 0U);
+	TEST_ASSERT_EQUALS(action->response.buckets[0], 1U);
+	
+	TEST_ASSERT_TRUE(statistics.getAction(10, 0x41) == nullptr);
+	
+	// one event per action
+	backend->messagesSend.removeAll();
+	component1->getCommunicator()->publishStatistics(0x50);
+	dispatcher->update();
+	
+	TEST_ASSERT_EQUALS(backend->messagesSend.getSize(), 2U);
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().header,
+			xpcc::Header(xpcc::Header::Type::REQUEST, false, 0, 1, 0x50));
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().payload.getSize(),
+			sizeof(xpcc::DispatcherStatistics::Action));
+	TEST_ASSERT_EQUALS(backend->messagesSend.getFront().payload.get<
+			xpcc::DispatcherStatistics::Action>().response.maximum, 23U);
+#endif
+}
+
+void
+DispatcherTest::testStatisticsTimeouts()
+{
+#if XPCC__DISPATCHER_STATISTICS
+	dispatcher->resetStatistics();
+	
+	// never acknowledged
+	component1->callAction(10, 0xf3);
+	dispatcher->update();
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		TestingClock::time += 500;
+		dispatcher->update();
+	}
+	
+	// acknowledged, but the response is missing
+	xpcc::ResponseCallback callback(component2, &TestingComponent2::responseNoParameter);
+	component2->callAction(10, 0x41, callback);
+	dispatcher->update();
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::REQUEST, true, 2, 10, 0x41),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	
+	TestingClock::time += 100;
+	dispatcher->update();
+	TestingClock::time += 100;
+	dispatcher->update();
+	
+	const xpcc::DispatcherStatistics& statistics = dispatcher->getStatistics();
+	const xpcc::DispatcherStatistics::Action *action = statistics.getAction(10, 0xf3);
+	TEST_ASSERT_TRUE(action != nullptr);
+	TEST_ASSERT_EQUALS(action->requests, 1U);
+	TEST_ASSERT_EQUALS(action->retransmissions, 2U);
+	TEST_ASSERT_EQUALS(action->acknowledgeTimeouts, 1U);
+	TEST_ASSERT_EQUALS(action->acknowledge.getCount(), 0U);
+	
+	action = statistics.getAction(10, 0x41);
+	TEST_ASSERT_TRUE(action != nullptr);
+	TEST_ASSERT_EQUALS(action->acknowledge.getCount(), 1U);
+	TEST_ASSERT_EQUALS(action->responseTimeouts, 1U);
+	TEST_ASSERT_EQUALS(action->response.getCount(), 0U);
+	
+	// late response, counted as timeout and with its latency
+	backend->messagesToReceive.append(
+			Message(xpcc::Header(xpcc::Header::Type::RESPONSE, false, 2, 10, 0x41),
+					xpcc::SmartPointer()));
+	dispatcher->update();
+	TEST_ASSERT_EQUALS(action->responseTimeouts, 1U);
+	TEST_ASSERT_EQUALS(action->response.getCount(), 1U);
+	TEST_ASSERT_EQUALS(action->response.buckets[7], 1U);
+	
+	dispatcher->resetStatistics();
+	TEST_ASSERT_EQUALS(statistics.getNumberOfActions(), 0U);
+	TEST_ASSERT_EQUALS(statistics.maximumQueueDepth, 0U);
+#endif
+}
@@ -127,6 +127,38 @@ public:
 	void
 	testResponseRetransmission();
 	
+	/*
+	 * Step 5:
+	 * Check the handling of many outstanding messages
+	 */
+	void
+	testAcknowledgeOutOfOrder();
+	
+	// Messages exceeding the capacity of the dispatcher are dropped
+	void
+	testPendingMessagesOverflow();
+
+	void
+	testEmplaceEvent();
+
+	void
+	testEmplaceActionWithoutHeap();
+
+	// The payload is constructed before the message is queued
+	void
+	testEmplaceConstructedBeforeQueued();
+	
+	/*
+	 * Step 6:
+	 * Check the latencies and counters of the statistics, only if
+	 * enabled with XPCC__DISPATCHER_STATISTICS
+	 */
+	void
+	testStatistics();
+	
+	void
+	testStatisticsTimeouts();
+	
 private:
 	xpcc::Dispatcher *dispatcher;
 	FakeBackend *backend;
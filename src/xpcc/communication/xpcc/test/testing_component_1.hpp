@@ -46,6 +46,8 @@ public:
 	// expose protected methods
 	using xpcc::AbstractComponent::callAction;
 	using xpcc::AbstractComponent::publishEvent;
+	using xpcc::AbstractComponent::emplaceAction;
+	using xpcc::AbstractComponent::emplaceEvent;
 	
 	// Action id: 0x10
 	void
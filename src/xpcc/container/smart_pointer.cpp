@@ -30,67 +30,368 @@
 
 #include "smart_pointer.hpp"
 
+#include <xpcc/architecture/detect.hpp>
+#include <xpcc_config.hpp>
+
+#if defined(XPCC__OS_HOSTED)
+#	include <atomic>
+#else
+#	include <xpcc/architecture/driver/atomic/lock.hpp>
+#endif
+
+namespace
+{
+	static constexpr uint8_t heapIndex = 0xff;
+
+#if defined(XPCC__OS_HOSTED)
+	typedef std::atomic<uint32_t> Counter;
+#else
+	typedef uint32_t Counter;
+#endif
+
+	Counter inlineAllocations;
+	Counter poolAllocations;
+	Counter heapAllocations;
+
+	inline void
+	count(Counter& counter)
+	{
+#if defined(XPCC__OS_HOSTED)
+		counter.fetch_add(1, std::memory_order_relaxed);
+#else
+		xpcc::atomic::Lock lock;
+		counter++;
+#endif
+	}
+
+	/// On hosted targets copies may be held by different threads
+	inline void
+	retain(uint8_t *block)
+	{
+#if defined(XPCC__OS_HOSTED)
+		__atomic_add_fetch(&block[0], 1, __ATOMIC_RELAXED);
+#else
+		block[0]++;
+#endif
+	}
+
+	/// \return	\c true if the last reference was dropped
+	inline bool
+	releaseReference(uint8_t *block)
+	{
+#if defined(XPCC__OS_HOSTED)
+		return (__atomic_sub_fetch(&block[0], 1, __ATOMIC_ACQ_REL) == 0);
+#else
+		return (--block[0] == 0);
+#endif
+	}
+
+	/**
+	 * Fixed number of blocks with a four byte header and `PayloadSize`
+	 * bytes of payload.
+	 *
+	 * Free blocks form a stack linked through the first two bytes of the
+	 * blocks, indices are stored incremented by one so that zero marks the
+	 * end of the stack. Blocks which were never used are taken from the
+	 * end of the storage. Everything starts zero-initialized, so the pool
+	 * can be used by constructors of other static objects.
+	 *
+	 * On hosted targets the stack is lock-free, the index of the top
+	 * element is stored together with a 16-bit tag against the ABA problem.
+	 * Otherwise interrupts are disabled while modifying the stack.
+	 */
+	template <uint16_t PayloadSize, uint16_t Blocks>
+	class Pool
+	{
+	public:
+		static constexpr uint16_t payloadSize = PayloadSize;
+
+		uint8_t *
+		allocate()
+		{
+#if defined(XPCC__OS_HOSTED)
+			uint32_t top = head.load(std::memory_order_acquire);
+			while ((top & 0xffff) != 0)
+			{
+				uint8_t *block = getBlock((top & 0xffff) - 1);
+				uint32_t next = *reinterpret_cast<uint16_t *>(block) |
+						((top + 0x10000) & 0xffff0000);
+				if (head.compare_exchange_weak(top, next,
+						std::memory_order_acquire, std::memory_order_acquire))
+				{
+					inUse.fetch_add(1, std::memory_order_relaxed);
+					return block;
+				}
+			}
+
+			uint16_t index = unused.load(std::memory_order_relaxed);
+			while (index < Blocks)
+			{
+				if (unused.compare_exchange_weak(index, index + 1,
+						std::memory_order_relaxed))
+				{
+					inUse.fetch_add(1, std::memory_order_relaxed);
+					return getBlock(index);
+				}
+			}
+			return nullptr;
+#else
+			xpcc::atomic::Lock lock;
+
+			uint8_t *block = nullptr;
+			if (head != 0)
+			{
+				block = getBlock(head - 1);
+				head = *reinterpret_cast<uint16_t *>(block);
+			}
+			else if (unused < Blocks) {
+				block = getBlock(unused++);
+			}
+
+			if (block) {
+				inUse++;
+			}
+			return block;
+#endif
+		}
+
+		void
+		free(uint8_t *block)
+		{
+			uint16_t index = (block - reinterpret_cast<uint8_t *>(storage)) / blockSize + 1;
+#if defined(XPCC__OS_HOSTED)
+			uint32_t top = head.load(std::memory_order_relaxed);
+			do {
+				*reinterpret_cast<uint16_t *>(block) = top & 0xffff;
+			}
+			while (!head.compare_exchange_weak(top,
+					index | ((top + 0x10000) & 0xffff0000),
+					std::memory_order_release, std::memory_order_relaxed));
+			inUse.fetch_sub(1, std::memory_order_relaxed);
+#else
+			xpcc::atomic::Lock lock;
+
+			*reinterpret_cast<uint16_t *>(block) = head;
+			head = index;
+			inUse--;
+#endif
+		}
+
+		uint16_t
+		getBlocksInUse() const
+		{
+			return inUse;
+		}
+
+	private:
+		// header + payload, rounded up to keep the payload aligned
+		static constexpr uint16_t blockSize = (4 + PayloadSize + 3) & ~3;
+
+		uint8_t *
+		getBlock(uint16_t index)
+		{
+			return reinterpret_cast<uint8_t *>(storage) + index * blockSize;
+		}
+
+#if defined(XPCC__OS_HOSTED)
+		std::atomic<uint32_t> head;
+		std::atomic<uint16_t> unused;
+		std::atomic<uint16_t> inUse;
+#else
+		uint16_t head;
+		uint16_t unused;
+		uint16_t inUse;
+#endif
+		uint32_t storage[(Blocks * blockSize + 3) / 4];
+	};
+
+	template <uint16_t PayloadSize>
+	class Pool<PayloadSize, 0>
+	{
+	public:
+		static constexpr uint16_t payloadSize = PayloadSize;
+
+		uint8_t *
+		allocate()
+		{
+			return nullptr;
+		}
+
+		void
+		free(uint8_t *)
+		{
+		}
+
+		uint16_t
+		getBlocksInUse() const
+		{
+			return 0;
+		}
+	};
+
+	Pool<16, XPCC__SMART_POINTER_POOL_16> pool16;
+	Pool<32, XPCC__SMART_POINTER_POOL_32> pool32;
+	Pool<64, XPCC__SMART_POINTER_POOL_64> pool64;
+}
+
+// ----------------------------------------------------------------------------
+uint8_t *
+xpcc::SmartPointer::allocate(bool heapAllowed)
+{
+	if (isInline()) {
+		count(inlineAllocations);
+		return storage.data;
+	}
+
+	uint8_t index = heapIndex;
+	uint8_t *block = nullptr;
+	if (size <= pool16.payloadSize && (block = pool16.allocate())) {
+		index = 0;
+	}
+	else if (size <= pool32.payloadSize && (block = pool32.allocate())) {
+		index = 1;
+	}
+	else if (size <= pool64.payloadSize && (block = pool64.allocate())) {
+		index = 2;
+	}
+
+	if (block) {
+		count(poolAllocations);
+	}
+	else if (!heapAllowed) {
+		size = 0;
+		return nullptr;
+	}
+	else {
+		block = new uint8_t[size + 4];
+		count(heapAllocations);
+	}
+
+	block[0] = 1;
+	block[1] = index;
+	storage.ptr = block;
+	return block + 4;
+}
+
+void
+xpcc::SmartPointer::release()
+{
+	if (isInline() || !releaseReference(storage.ptr)) {
+		return;
+	}
+
+	switch (storage.ptr[1])
+	{
+		case 0:
+			pool16.free(storage.ptr);
+			break;
+		case 1:
+			pool32.free(storage.ptr);
+			break;
+		case 2:
+			pool64.free(storage.ptr);
+			break;
+		default:
+			delete[] storage.ptr;
+			break;
+	}
+}
+
 // ----------------------------------------------------------------------------
-// must allocate at least five bytes, so getPointer() does return
-// a valid address
 xpcc::SmartPointer::SmartPointer() :
-	ptr(new uint8_t[5])
+	size(0)
 {
-	ptr[0] = 1;
-	ptr[2] = 0;
-	ptr[3] = 0;
+	allocate();
 }
 
 xpcc::SmartPointer::SmartPointer(const SmartPointer& other) :
-	ptr(other.ptr)
+	storage(other.storage), size(other.size)
 {
-	ptr[0]++;
+	if (!isInline()) {
+		retain(storage.ptr);
+	}
 }
 
-// must allocate at least five bytes, so getPointer() does return
-// a valid address
 xpcc::SmartPointer::SmartPointer(uint16_t size) :
-	ptr(new uint8_t[size ? size + 4 : 5])
+	size(size)
 {
-	ptr[0] = 1;
-	*reinterpret_cast<uint16_t*>(ptr + 2) = size;
+	allocate();
 }
 
 xpcc::SmartPointer::~SmartPointer()
 {
-	if (--ptr[0] == 0) {
-		delete[] ptr;
-	}
+	release();
+}
+
+uint8_t *
+xpcc::SmartPointer::reserve(uint16_t size)
+{
+	release();
+	this->size = size;
+	return allocate(false);
 }
 
 // ----------------------------------------------------------------------------
 bool
 xpcc::SmartPointer::operator == (const SmartPointer& other)
 {
-	return (this->ptr == other.ptr);
+	if (this->size != other.size) {
+		return false;
+	}
+	if (isInline()) {
+		return (std::memcmp(this->storage.data, other.storage.data, size) == 0);
+	}
+	return (this->storage.ptr == other.storage.ptr);
 }
 
 xpcc::SmartPointer&
 xpcc::SmartPointer::operator = (const SmartPointer& other)
 {
-	if (--ptr[0] == 0) {
-		delete[] ptr;
-	}
+	if (this != &other)
+	{
+		release();
 
-	ptr = other.ptr;
-	ptr[0]++;
+		storage = other.storage;
+		size = other.size;
+		if (!isInline()) {
+			retain(storage.ptr);
+		}
+	}
 
 	return *this;
 }
 
+// ----------------------------------------------------------------------------
+xpcc::SmartPointer::Statistics
+xpcc::SmartPointer::getStatistics()
+{
+	Statistics statistics;
+	statistics.inlineAllocations = inlineAllocations;
+	statistics.poolAllocations = poolAllocations;
+	statistics.heapAllocations = heapAllocations;
+	statistics.poolBlocksInUse[0] = pool16.getBlocksInUse();
+	statistics.poolBlocksInUse[1] = pool32.getBlocksInUse();
+	statistics.poolBlocksInUse[2] = pool64.getBlocksInUse();
+	return statistics;
+}
+
+void
+xpcc::SmartPointer::resetStatistics()
+{
+	inlineAllocations = 0;
+	poolAllocations = 0;
+	heapAllocations = 0;
+}
+
 // ----------------------------------------------------------------------------
 xpcc::IOStream&
 xpcc::operator << (xpcc::IOStream& s, const xpcc::SmartPointer& v)
 {
 	s << "0x" << xpcc::hex;
-	for (uint8_t i = 4; i < v.getSize() + 4; i++)
+	const uint8_t *data = v.getPointer();
+	for (uint16_t i = 0; i < v.getSize(); i++)
 	{
-		s << v.ptr[i];
+		s << data[i];
 	}
 	s << xpcc::ascii;
 	return s;
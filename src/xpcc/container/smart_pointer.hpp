@@ -45,15 +45,38 @@ namespace xpcc
 	 * \brief 	Container which destroys itself when the last
 	 * 			copy is destroyed.
 	 *
-	 * This container saves a copy of the given data on the heap. It
-	 * provides the functionality of a shared pointer => pointer object
-	 * records when it is copied - when the last copy is destroyed the
-	 * memory is released.
+	 * Payloads of up to `inlineCapacity` bytes (one CAN frame) are stored
+	 * inside the SmartPointer itself and copied together with it.
+	 *
+	 * Larger payloads are stored in a block taken from one of the
+	 * statically allocated pools (16, 32 and 64 byte payloads). Their size
+	 * is set with `XPCC__SMART_POINTER_POOL_16`, `XPCC__SMART_POINTER_POOL_32`
+	 * and `XPCC__SMART_POINTER_POOL_64` in the project configuration. Only
+	 * if no matching block is available the memory is allocated on the
+	 * heap. The block records when it is copied - when the last copy is
+	 * destroyed the memory is released. On hosted targets the copies of
+	 * one payload may be used in different threads.
+	 *
+	 * Use getStatistics() to check how the payloads are allocated at
+	 * runtime.
 	 *
 	 * \ingroup container
 	 */
 	class SmartPointer
 	{
+	public:
+		/// Payloads up to this size are stored without allocation
+		static constexpr uint16_t inlineCapacity = 8;
+
+		/// Allocation counters, see getStatistics()
+		struct Statistics
+		{
+			uint32_t inlineAllocations;	///< Payloads stored in the SmartPointer
+			uint32_t poolAllocations;	///< Payloads stored in a pool block
+			uint32_t heapAllocations;	///< Payloads allocated on the heap
+			uint16_t poolBlocksInUse[3];	///< Currently used blocks of the 16, 32 and 64 byte pool
+		};
+
 	public:
 		/// default constructor with empty payload
 		SmartPointer();
@@ -70,11 +93,9 @@ namespace xpcc
 		// between constructor and copy constructor!
 		template<typename T>
 		explicit SmartPointer(const T *data)
-		: ptr(new uint8_t[sizeof(T) + 4])
+		: size(sizeof(T))
 		{
-			ptr[0] = 1;
-			*reinterpret_cast<uint16_t*>(ptr + 2) = sizeof(T);
-			std::memcpy(ptr + 4, data, sizeof(T));
+			std::memcpy(allocate(), data, sizeof(T));
 		}
 
 		SmartPointer(const SmartPointer& other);
@@ -84,21 +105,33 @@ namespace xpcc
 		inline const uint8_t *
 		getPointer() const
 		{
-			return ptr + 4;
+			return isInline() ? storage.data : (storage.ptr + 4);
 		}
 
 		inline uint8_t *
 		getPointer()
 		{
-			return ptr + 4;
+			return isInline() ? storage.data : (storage.ptr + 4);
 		}
 
 		inline uint16_t
 		getSize() const
 		{
-			return *reinterpret_cast<uint16_t*>(ptr + 2);
+			return size;
 		}
 
+		/**
+		 * \brief	Replace the payload by uninitialized storage
+		 *
+		 * Used to construct a payload in place. Unlike the constructors
+		 * this never allocates memory on the heap.
+		 *
+		 * \return	Pointer to \p size bytes of storage, \c nullptr if no
+		 * 			pool block is available. The SmartPointer is empty then.
+		 */
+		uint8_t *
+		reserve(uint16_t size);
+
 	public:
 		/**
 		 * Get the value that are stored in the pointer casted to the given type.
@@ -110,7 +143,7 @@ namespace xpcc
 		inline const T&
 		get() const
 		{
-			return *reinterpret_cast<T*>(ptr + 4);
+			return *reinterpret_cast<const T*>(getPointer());
 		}
 
 		/**
@@ -125,7 +158,7 @@ namespace xpcc
 		{
 			if (sizeof(T) == getSize())
 			{
-				value = *reinterpret_cast<T*>(ptr + 4);
+				value = *reinterpret_cast<const T*>(getPointer());
 				return true;
 			}
 			else {
@@ -133,19 +166,60 @@ namespace xpcc
 			}
 		}
 
+		/**
+		 * Pointers to pool or heap memory are equal if they share the same
+		 * memory, inline payloads are compared by value.
+		 */
 		bool
 		operator == (const SmartPointer& other);
 
 		SmartPointer&
 		operator = (const SmartPointer& other);
 
+		/// Snapshot of the allocation counters
+		static Statistics
+		getStatistics();
+
+		/// Reset the allocation counters (not the blocks in use)
+		static void
+		resetStatistics();
+
 	protected:
-		uint8_t * ptr;
+		inline bool
+		isInline() const
+		{
+			return (size <= inlineCapacity);
+		}
+
+		/**
+		 * \brief	Allocate storage for `size` bytes
+		 *
+		 * \return	Pointer to the payload, \c nullptr if \p heapAllowed
+		 * 			is \c false and no pool block is available
+		 */
+		uint8_t *
+		allocate(bool heapAllowed = true);
+
+		/// Drop the reference to the pool or heap memory
+		void
+		release();
+
+	protected:
+		/// Pool and heap memory starts with a four byte header:
+		/// reference counter, pool index and two bytes unused.
+		union
+		{
+			uint8_t * ptr;
+			uint32_t alignment;
+			uint8_t data[inlineCapacity];
+		} storage;
+
+		uint16_t size;
 
 	protected:
 		friend IOStream&
 		operator <<( IOStream&, const SmartPointer&);
-	} xpcc_packed;
+	};
 
 	/**
 	 * \ingroup container
@@ -0,0 +1,146 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/container/smart_pointer.hpp>
+#include <xpcc_config.hpp>
+
+#include "smart_pointer_test.hpp"
+
+namespace
+{
+	struct Packet
+	{
+		uint32_t a;
+		uint32_t b;
+		uint16_t c;
+	};
+}
+
+void
+SmartPointerTest::testInlinePayload()
+{
+	xpcc::SmartPointer::resetStatistics();
+
+	uint32_t value = 0x12345678;
+	xpcc::SmartPointer pointer(&value);
+
+	TEST_ASSERT_EQUALS(pointer.getSize(), 4U);
+	TEST_ASSERT_EQUALS(pointer.get<uint32_t>(), 0x12345678U);
+
+	xpcc::SmartPointer copy(pointer);
+	TEST_ASSERT_TRUE(copy == pointer);
+	TEST_ASSERT_EQUALS(copy.get<uint32_t>(), 0x12345678U);
+
+	xpcc::SmartPointer::Statistics statistics = xpcc::SmartPointer::getStatistics();
+	TEST_ASSERT_EQUALS(statistics.inlineAllocations, 1U);
+	TEST_ASSERT_EQUALS(statistics.poolAllocations, 0U);
+	TEST_ASSERT_EQUALS(statistics.heapAllocations, 0U);
+
+	uint16_t wrongSize;
+	TEST_ASSERT_FALSE(pointer.get(wrongSize));
+}
+
+void
+SmartPointerTest::testPoolPayload()
+{
+	xpcc::SmartPointer::resetStatistics();
+	uint16_t inUse = xpcc::SmartPointer::getStatistics().poolBlocksInUse[0];
+
+	Packet packet = { 1, 2, 3 };
+	{
+		xpcc::SmartPointer pointer(&packet);
+		TEST_ASSERT_EQUALS(pointer.getSize(), sizeof(Packet));
+		TEST_ASSERT_EQUALS(pointer.get<Packet>().b, 2U);
+
+		xpcc::SmartPointer copy(pointer);
+		TEST_ASSERT_TRUE(copy == pointer);
+		TEST_ASSERT_EQUALS(copy.getPointer(), pointer.getPointer());
+
+		xpcc::SmartPointer::Statistics statistics = xpcc::SmartPointer::getStatistics();
+		TEST_ASSERT_EQUALS(statistics.poolAllocations, 1U);
+		TEST_ASSERT_EQUALS(statistics.heapAllocations, 0U);
+		TEST_ASSERT_EQUALS(statistics.poolBlocksInUse[0], inUse + 1);
+	}
+
+	// block is returned with the last copy
+	TEST_ASSERT_EQUALS(xpcc::SmartPointer::getStatistics().poolBlocksInUse[0], inUse);
+}
+
+void
+SmartPointerTest::testPoolExhausted()
+{
+	xpcc::SmartPointer::resetStatistics();
+
+	// payloads larger than the largest pool always use the heap
+	xpcc::SmartPointer large(200);
+	TEST_ASSERT_EQUALS(large.getSize(), 200U);
+	TEST_ASSERT_EQUALS(xpcc::SmartPointer::getStatistics().heapAllocations, 1U);
+
+	// use up all 64 byte blocks
+	xpcc::SmartPointer pointers[XPCC__SMART_POINTER_POOL_64 + 1];
+	for (auto& pointer : pointers) {
+		pointer = xpcc::SmartPointer(60);
+	}
+
+	xpcc::SmartPointer::Statistics statistics = xpcc::SmartPointer::getStatistics();
+	TEST_ASSERT_EQUALS(statistics.poolAllocations, uint32_t(XPCC__SMART_POINTER_POOL_64));
+	TEST_ASSERT_EQUALS(statistics.heapAllocations, 2U);
+}
+
+void
+SmartPointerTest::testAssignment()
+{
+	uint8_t small = 42;
+	uint8_t buffer[30] = { 1, 2, 3 };
+
+	xpcc::SmartPointer a(&small);
+	xpcc::SmartPointer b(&buffer);
+
+	a = b;
+	TEST_ASSERT_EQUALS(a.getSize(), 30U);
+	TEST_ASSERT_TRUE(a == b);
+	TEST_ASSERT_EQUALS(a.getPointer()[2], 3);
+
+	b = xpcc::SmartPointer(&small);
+	TEST_ASSERT_EQUALS(b.getSize(), 1U);
+	TEST_ASSERT_EQUALS(b.get<uint8_t>(), 42);
+	TEST_ASSERT_EQUALS(a.getPointer()[1], 2);
+
+	a = a;
+	TEST_ASSERT_EQUALS(a.getSize(), 30U);
+}
+
+void
+SmartPointerTest::testReserve()
+{
+	xpcc::SmartPointer::resetStatistics();
+
+	uint8_t buffer[30] = { 1, 2, 3 };
+	xpcc::SmartPointer a(&buffer);
+	xpcc::SmartPointer b(a);
+
+	// the shared block stays valid for the other copy
+	uint8_t *data = a.reserve(4);
+	TEST_ASSERT_TRUE(data != nullptr);
+	TEST_ASSERT_TRUE(data == a.getPointer());
+	TEST_ASSERT_EQUALS(a.getSize(), 4U);
+	TEST_ASSERT_EQUALS(b.getPointer()[2], 3);
+
+	data = a.reserve(60);
+	TEST_ASSERT_TRUE(data != nullptr);
+	TEST_ASSERT_EQUALS(a.getSize(), 60U);
+
+	// never taken from the heap
+	TEST_ASSERT_TRUE(a.reserve(200) == nullptr);
+	TEST_ASSERT_EQUALS(a.getSize(), 0U);
+
+	xpcc::SmartPointer::Statistics statistics = xpcc::SmartPointer::getStatistics();
+	TEST_ASSERT_EQUALS(statistics.inlineAllocations, 1U);
+	TEST_ASSERT_EQUALS(statistics.poolAllocations, 2U);
+	TEST_ASSERT_EQUALS(statistics.heapAllocations, 0U);
+}
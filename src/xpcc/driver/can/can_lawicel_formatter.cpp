@@ -13,84 +13,103 @@
 #include <cstring>
 
 
+namespace
+{
+	// value of a hex digit, characters which are no hex digits are
+	// marked with `invalidHex`
+	const uint8_t invalidHex = 0x10;
+	const uint8_t hexTable[256] =
+	{
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+	};
+}
+
 bool
 xpcc::CanLawicelFormatter::convertToCanMessage(const char* in, can::Message& out)
 {
-	bool error = false;
-	uint8_t dlc_pos;
+	return convertFrameToCanMessage(in, std::strlen(in), out);
+}
 
-	if (in[0] == 'R' || in[0] == 'T') {
-		out.flags.extended = true;
-		dlc_pos = 9;
+bool
+xpcc::CanLawicelFormatter::convertFrameToCanMessage(const char* in,
+		std::size_t length, can::Message& out)
+{
+	if (length == 0) {
+		return false;
 	}
-	else {
-		out.flags.extended = false;
-		dlc_pos = 4;
+
+	const bool extended = (in[0] == 'R' || in[0] == 'T');
+	const bool rtr = (in[0] == 'r' || in[0] == 'R');
+	if (!extended && !rtr && in[0] != 't') {
+		return false;
 	}
 
-	if (std::strlen(in) < dlc_pos + 1U)
+	const std::size_t dlcPosition = extended ? 9 : 4;
+	if (length < dlcPosition + 1) {
 		return false;
+	}
 
 	// get the number of data-bytes for this message
-	out.length = in[dlc_pos] - '0';
-	if (out.length > 8)
-		return false;		// too many data-bytes
-
-	if (in[0] == 'r' || in[0] == 'R') {
-		out.flags.rtr = true;
-		if (std::strlen(in) != (dlc_pos + 1U))
-			return false;
-	}
-	else {
-		out.flags.rtr = false;
-		if (std::strlen(in) != (out.length * 2 + dlc_pos + 1U))
-			return false;
+	const uint8_t dlc = static_cast<uint8_t>(in[dlcPosition] - '0');
+	if (dlc > 8) {
+		return false;
 	}
-
-	// read the message-identifier
-	if (out.flags.extended)
-	{
-		uint16_t id;
-		uint16_t id2;
-
-		id  = hexToByte(&in[1], error) << 8;
-		id |= hexToByte(&in[3], error);
-
-		id2  = hexToByte(&in[5], error) << 8;
-		id2 |= hexToByte(&in[7], error);
-
-		out.identifier = (uint32_t) id << 16 | id2;
-
-		// check that id does not exceed 29 bits (0x1fffffff)
-		if(out.identifier > 0x1fffffff)
-			return false;
+	if (length != dlcPosition + 1 + (rtr ? 0 : 2 * dlc)) {
+		return false;
 	}
-	else {
-		uint16_t id;
-
-		id  = charToByte(in[1], error) << 8;
-		id |= hexToByte(&in[2], error);
 
-		out.identifier = id;
+	const uint8_t* input = reinterpret_cast<const uint8_t*>(in);
+	uint8_t check = 0;
 
-		// check that id does not exceed 11 bits (0x7ff)
-		if(out.identifier > 0x7ff)
-			return false;
+	uint32_t identifier = 0;
+	for (std::size_t i = 1; i < dlcPosition; ++i)
+	{
+		const uint8_t nibble = hexTable[input[i]];
+		check |= nibble;
+		identifier = (identifier << 4) | (nibble & 0x0f);
 	}
 
-	// read data if the message is no rtr-frame
-	if (!out.flags.rtr)
+	if (!rtr)
 	{
-		const char *buf = &in[dlc_pos + 1];
-		uint8_t i;
-
-		for (i=0; i < out.length; i++)
+		const uint8_t* data = input + dlcPosition + 1;
+		for (uint8_t i = 0; i < dlc; ++i)
 		{
-			out.data[i] = hexToByte(buf, error);
-			buf += 2;
+			const uint8_t high = hexTable[data[2 * i]];
+			const uint8_t low = hexTable[data[2 * i + 1]];
+			check |= high | low;
+			out.data[i] = (high << 4) | (low & 0x0f);
 		}
 	}
-	return !error;
+
+	if (check & invalidHex) {
+		return false;
+	}
+
+	// check that the id does not exceed 29 respectively 11 bits
+	if (identifier > (extended ? 0x1fffffffUL : 0x7ffUL)) {
+		return false;
+	}
+
+	out.identifier = identifier;
+	out.length = dlc;
+	out.flags.extended = extended;
+	out.flags.rtr = rtr;
+	return true;
 }
 
 
@@ -153,21 +172,6 @@ xpcc::CanLawicelFormatter::convertToString(const can::Message& in, char* out)
 }
 
 
-uint8_t
-xpcc::CanLawicelFormatter::charToByte(const char cc, bool& error)
-{
-	if(cc >= '0' && cc <= '9') {
-		return cc - '0';
-	} else if(cc >= 'A' && cc <= 'F') {
-		return cc - 'A' + 10;
-	} else if(cc >= 'a' && cc <= 'f') {
-		return cc - 'a' + 10;
-	} else {
-		error = true;
-		return 0;
-	}
-}
-
 char
 xpcc::CanLawicelFormatter::byteToHex(uint8_t num)
 {
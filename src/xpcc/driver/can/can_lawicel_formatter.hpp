@@ -10,6 +10,8 @@
 #ifndef XPCC_CAN_LAWICEL_FORMATTER_HPP
 #define XPCC_CAN_LAWICEL_FORMATTER_HPP
 
+#include <cstddef>
+#include <cstring>
 #include <xpcc/architecture/interface/can_message.hpp>
 
 namespace xpcc
@@ -34,19 +36,53 @@ public:
 	static bool
 	convertToCanMessage(const char* in, can::Message& out);
 
+	/**
+	 * Convert a frame of `length` characters, the string needs no
+	 * terminating null.
+	 *
+	 * The hex digits are decoded with a lookup table without any
+	 * branches, invalid characters are only checked once at the end.
+	 */
 	static bool
-	convertToString(const can::Message& in, char* out);
+	convertFrameToCanMessage(const char* in, std::size_t length, can::Message& out);
 
-private:
-	static inline uint8_t
-	hexToByte(const char *s, bool& error)
+	/**
+	 * Convert all frames in a buffer received from a Lawicel adapter.
+	 *
+	 * The frames are terminated by '\r'. `callback(const can::Message&)`
+	 * is called for every valid frame, other answers of the adapter
+	 * (e.g. "z" for a transmitted frame or BEL for an error) and invalid
+	 * frames are skipped.
+	 *
+	 * @return	number of characters processed, the remaining ones
+	 * 			belong to a frame which is not complete yet
+	 */
+	template< typename Callback >
+	static std::size_t
+	convertBuffer(const char* in, std::size_t length, Callback&& callback)
 	{
-		return (charToByte(s[0], error) << 4) | charToByte(s[1], error);
+		const char* begin = in;
+		const char* end = in + length;
+		while (const char* delimiter = static_cast<const char*>(
+				std::memchr(begin, '\r', end - begin)))
+		{
+			while (begin < delimiter && *begin == '\a') {
+				++begin;
+			}
+
+			can::Message message;
+			if (convertFrameToCanMessage(begin, delimiter - begin, message)) {
+				callback(message);
+			}
+			begin = delimiter + 1;
+		}
+		return begin - in;
 	}
 
-	static uint8_t
-	charToByte(const char cc, bool& error);
+	static bool
+	convertToString(const can::Message& in, char* out);
 
+private:
 	static char
 	byteToHex(uint8_t num);
 };
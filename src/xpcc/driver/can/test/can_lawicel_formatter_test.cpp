@@ -203,3 +203,59 @@ CanLawicelFormatterTest::testInvalidInput()
 	// invalid character in id
 	TEST_ASSERT_FALSE(toCanMessage("t0f.3000000", message));
 }
+
+void
+CanLawicelFormatterTest::testFrameWithoutTerminatingNull()
+{
+	const char input[] = "t1232abcdT000016108F8FF00002394883D";
+	xpcc::can::Message message;
+
+	TEST_ASSERT_TRUE(xpcc::CanLawicelFormatter::convertFrameToCanMessage(input, 9, message));
+	TEST_ASSERT_EQUALS(message.identifier, 0x123U);
+	TEST_ASSERT_EQUALS(message.length, 2U);
+	TEST_ASSERT_EQUALS(message.flags.extended, false);
+	TEST_ASSERT_EQUALS(message.data[0], 0xab);
+	TEST_ASSERT_EQUALS(message.data[1], 0xcd);
+
+	TEST_ASSERT_FALSE(xpcc::CanLawicelFormatter::convertFrameToCanMessage(input, 8, message));
+	TEST_ASSERT_FALSE(xpcc::CanLawicelFormatter::convertFrameToCanMessage(input, 0, message));
+
+	TEST_ASSERT_TRUE(xpcc::CanLawicelFormatter::convertFrameToCanMessage("R123456784", 10, message));
+	TEST_ASSERT_EQUALS(message.identifier, 0x12345678U);
+	TEST_ASSERT_EQUALS(message.length, 4U);
+	TEST_ASSERT_EQUALS(message.flags.extended, true);
+	TEST_ASSERT_EQUALS(message.flags.rtr, true);
+
+	// unknown frame type
+	TEST_ASSERT_FALSE(xpcc::CanLawicelFormatter::convertFrameToCanMessage("x1230", 5, message));
+}
+
+void
+CanLawicelFormatterTest::testConvertBuffer()
+{
+	const char input[] = "z\rt1231ab\r\a\at0ff0\rZ\rtxyz0\rT1234567";
+	xpcc::can::Message messages[4];
+	std::size_t count = 0;
+
+	std::size_t processed = xpcc::CanLawicelFormatter::convertBuffer(
+			input, sizeof(input) - 1, [&](const xpcc::can::Message& message) {
+				if (count < 4) {
+					messages[count] = message;
+				}
+				count++;
+			});
+
+	// the incomplete frame at the end remains
+	TEST_ASSERT_EQUALS(processed, sizeof(input) - 1 - 8);
+	TEST_ASSERT_EQUALS(count, 2U);
+	TEST_ASSERT_EQUALS(messages[0].identifier, 0x123U);
+	TEST_ASSERT_EQUALS(messages[0].length, 1U);
+	TEST_ASSERT_EQUALS(messages[0].data[0], 0xab);
+	TEST_ASSERT_EQUALS(messages[1].identifier, 0x0ffU);
+	TEST_ASSERT_EQUALS(messages[1].length, 0U);
+
+	count = 0;
+	TEST_ASSERT_EQUALS(xpcc::CanLawicelFormatter::convertBuffer(input, 0,
+			[&](const xpcc::can::Message&) { count++; }), 0U);
+	TEST_ASSERT_EQUALS(count, 0U);
+}
@@ -67,4 +67,11 @@ public:
 	// check if invalid input is rejected as expected
 	void
 	testInvalidInput();
+
+	void
+	testFrameWithoutTerminatingNull();
+
+	/// several frames and other answers of an adapter in one buffer
+	void
+	testConvertBuffer();
 };
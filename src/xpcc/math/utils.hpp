@@ -35,5 +35,6 @@
 #include "utils/bit_operation.hpp"
 #include "utils/operator.hpp"
 #include "utils/endianness.hpp"
+#include "utils/crc.hpp"
 
 #endif // XPCC_MATH__UTILS_HPP
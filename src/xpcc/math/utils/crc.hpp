@@ -0,0 +1,116 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC_MATH_CRC_HPP
+#define	XPCC_MATH_CRC_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+#include <xpcc/architecture/detect.hpp>
+
+namespace xpcc
+{
+
+/**
+ * Cyclic redundancy checks
+ *
+ * Reflected (LSB first) CRCs of up to 32 bit with a configurable
+ * polynomial, as used by the SAB, SAB2, AMNB and RPR protocols.
+ * Several implementations with different code size and speed are
+ * available:
+ *
+ * - `Bitwise`: no tables, eight shifts per byte.
+ * - `Table16`: a 16 entry table, two lookups per byte.
+ * - `Table256`: a 256 entry table, one lookup per byte.
+ * - `SliceBy8`: eight 256 entry tables, eight bytes per iteration
+ *   when updating a block of data.
+ * - `Hardware`: the CRC unit of the microcontroller, only available if
+ *   the platform provides xpcc::crc::Hardware (e.g. STM32F0, F3 and F7).
+ *
+ * The default method is chosen per target: bitwise for the AVR (where
+ * the protocols use the routines of the avr-libc anyway), the 16 entry
+ * table for the Cortex-M0 with its small flash, the 256 entry table for
+ * the other Cortex-M and slice-by-8 for hosted targets. The tables are
+ * calculated by the compiler and stored in flash (in RAM on the AVR).
+ *
+ * @code
+ * uint16_t crc = 0xffff;
+ * crc = xpcc::crc::Crc16Ibm::update(crc, data, length);
+ * @endcode
+ *
+ * @see		examples/linux/benchmark/crc
+ * @ingroup	math
+ */
+namespace crc
+{
+
+enum class
+Method : uint8_t
+{
+	Bitwise,
+	Table16,
+	Table256,
+	SliceBy8,
+	Hardware,
+};
+
+#if defined(XPCC__CPU_AVR)
+static constexpr Method defaultMethod = Method::Bitwise;
+#elif defined(XPCC__CPU_CORTEX_M0)
+static constexpr Method defaultMethod = Method::Table16;
+#elif defined(XPCC__OS_HOSTED)
+static constexpr Method defaultMethod = Method::SliceBy8;
+#else
+static constexpr Method defaultMethod = Method::Table256;
+#endif
+
+/**
+ * CRC calculated by the hardware
+ *
+ * Only declared here, platforms with a CRC unit with a programmable
+ * polynomial provide the definition with the same interface as
+ * xpcc::crc::Engine.
+ */
+template <typename T, T Polynomial>
+class Hardware;
+
+/**
+ * Reflected CRC
+ *
+ * @tparam	T			`uint8_t`, `uint16_t` or `uint32_t`
+ * @tparam	Polynomial	reversed representation of the polynomial,
+ * 						e.g. 0xA001 for x^16 + x^15 + x^2 + 1
+ * @tparam	M			implementation
+ */
+template <typename T, T Polynomial, Method M = defaultMethod>
+class Engine
+{
+public:
+	/// Add a single byte to the checksum
+	static T
+	update(T crc, uint8_t data);
+
+	/// Add a block of data to the checksum
+	static T
+	update(T crc, const uint8_t *data, std::size_t length);
+};
+
+/// CRC-8 Dallas/Maxim (x^8 + x^5 + x^4 + 1), used by SAB and AMNB
+typedef Engine<uint8_t, 0x8C> Crc8Dallas;
+
+/// CRC-16 IBM/MODBUS (x^16 + x^15 + x^2 + 1), used by SAB2 and RPR
+typedef Engine<uint16_t, 0xA001> Crc16Ibm;
+
+}	// namespace crc
+
+}	// namespace xpcc
+
+#include "crc_impl.hpp"
+
+#endif	// XPCC_MATH_CRC_HPP
@@ -0,0 +1,246 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC_MATH_CRC_HPP
+#	error	"Don't include this file directly, use 'crc.hpp' instead!"
+#endif
+
+namespace xpcc
+{
+
+namespace crc
+{
+
+namespace detail
+{
+
+/// Shift `bits` bits out of the CRC register
+template <typename T, T Polynomial>
+constexpr T
+shift(T crc, uint8_t bits)
+{
+	return (bits == 0) ? crc : shift<T, Polynomial>(
+			(crc & 1) ? T((crc >> 1) ^ Polynomial) : T(crc >> 1), bits - 1);
+}
+
+/// Append a zero byte to the message
+template <typename T, T Polynomial>
+constexpr T
+appendZero(T crc)
+{
+	return T(uint32_t(crc) >> 8) ^ shift<T, Polynomial>(T(crc & 0xff), 8);
+}
+
+/// CRC of `index` followed by `zeros` zero bytes
+template <typename T, T Polynomial>
+constexpr T
+slice(uint8_t index, uint8_t zeros)
+{
+	return (zeros == 0) ? shift<T, Polynomial>(index, 8) :
+			appendZero<T, Polynomial>(slice<T, Polynomial>(index, zeros - 1));
+}
+
+template <uint16_t... I>
+struct Indices
+{
+};
+
+template <uint16_t N, uint16_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...>
+{
+};
+
+template <uint16_t... I>
+struct MakeIndices<0, I...>
+{
+	typedef Indices<I...> type;
+};
+
+/// Result of shifting each possible value of `Bits` bits through the register
+template <typename T, T Polynomial, uint8_t Bits,
+		typename I = typename MakeIndices<(1 << Bits)>::type>
+struct Table;
+
+template <typename T, T Polynomial, uint8_t Bits, uint16_t... I>
+struct Table<T, Polynomial, Bits, Indices<I...> >
+{
+	static const T data[sizeof...(I)];
+};
+
+template <typename T, T Polynomial, uint8_t Bits, uint16_t... I>
+const T Table<T, Polynomial, Bits, Indices<I...> >::data[sizeof...(I)] =
+{
+	shift<T, Polynomial>(T(I), Bits)...
+};
+
+/// Tables for 0 to 7 trailing zero bytes
+template <typename T, T Polynomial, typename I = MakeIndices<256>::type>
+struct SliceTable;
+
+template <typename T, T Polynomial, uint16_t... I>
+struct SliceTable<T, Polynomial, Indices<I...> >
+{
+	static const T data[8][256];
+};
+
+template <typename T, T Polynomial, uint16_t... I>
+const T SliceTable<T, Polynomial, Indices<I...> >::data[8][256] =
+{
+	{ slice<T, Polynomial>(I, 0)... },
+	{ slice<T, Polynomial>(I, 1)... },
+	{ slice<T, Polynomial>(I, 2)... },
+	{ slice<T, Polynomial>(I, 3)... },
+	{ slice<T, Polynomial>(I, 4)... },
+	{ slice<T, Polynomial>(I, 5)... },
+	{ slice<T, Polynomial>(I, 6)... },
+	{ slice<T, Polynomial>(I, 7)... },
+};
+
+template <typename T, T Polynomial, Method M>
+struct Implementation;
+
+template <typename T, T Polynomial>
+struct Implementation<T, Polynomial, Method::Bitwise>
+{
+	static inline T
+	update(T crc, uint8_t data)
+	{
+		crc ^= data;
+		for (uint_fast8_t i = 0; i < 8; ++i)
+		{
+			if (crc & 1) {
+				crc = (crc >> 1) ^ Polynomial;
+			}
+			else {
+				crc >>= 1;
+			}
+		}
+		return crc;
+	}
+};
+
+template <typename T, T Polynomial>
+struct Implementation<T, Polynomial, Method::Table16>
+{
+	static inline T
+	update(T crc, uint8_t data)
+	{
+		const T *table = Table<T, Polynomial, 4>::data;
+
+		crc ^= data;
+		crc = (crc >> 4) ^ table[crc & 0x0f];
+		crc = (crc >> 4) ^ table[crc & 0x0f];
+		return crc;
+	}
+};
+
+template <typename T, T Polynomial>
+struct Implementation<T, Polynomial, Method::Table256>
+{
+	static inline T
+	update(T crc, uint8_t data)
+	{
+		return T(uint32_t(crc) >> 8) ^
+				Table<T, Polynomial, 8>::data[uint8_t(crc ^ data)];
+	}
+};
+
+template <typename T, T Polynomial>
+struct Implementation<T, Polynomial, Method::SliceBy8>
+{
+	static inline T
+	update(T crc, uint8_t data)
+	{
+		return T(uint32_t(crc) >> 8) ^
+				SliceTable<T, Polynomial>::data[0][uint8_t(crc ^ data)];
+	}
+};
+
+}	// namespace detail
+
+// ----------------------------------------------------------------------------
+template <typename T, T Polynomial, Method M>
+T
+Engine<T, Polynomial, M>::update(T crc, uint8_t data)
+{
+	return detail::Implementation<T, Polynomial, M>::update(crc, data);
+}
+
+template <typename T, T Polynomial, Method M>
+T
+Engine<T, Polynomial, M>::update(T crc, const uint8_t *data, std::size_t length)
+{
+	for (std::size_t i = 0; i < length; ++i) {
+		crc = detail::Implementation<T, Polynomial, M>::update(crc, data[i]);
+	}
+	return crc;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, T Polynomial>
+class Engine<T, Polynomial, Method::SliceBy8>
+{
+public:
+	static T
+	update(T crc, uint8_t data)
+	{
+		return detail::Implementation<T, Polynomial, Method::SliceBy8>::update(crc, data);
+	}
+
+	static T
+	update(T crc, const uint8_t *data, std::size_t length)
+	{
+		const T (*table)[256] = detail::SliceTable<T, Polynomial>::data;
+
+		// the register is at most four bytes wide, so it only overlaps
+		// with the first word of each block
+		for (; length >= 8; length -= 8, data += 8)
+		{
+			uint32_t first = uint32_t(crc) ^ (uint32_t(data[0]) |
+					(uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) |
+					(uint32_t(data[3]) << 24));
+			uint32_t second = uint32_t(data[4]) | (uint32_t(data[5]) << 8) |
+					(uint32_t(data[6]) << 16) | (uint32_t(data[7]) << 24);
+
+			crc = table[7][first & 0xff] ^
+					table[6][(first >> 8) & 0xff] ^
+					table[5][(first >> 16) & 0xff] ^
+					table[4][first >> 24] ^
+					table[3][second & 0xff] ^
+					table[2][(second >> 8) & 0xff] ^
+					table[1][(second >> 16) & 0xff] ^
+					table[0][second >> 24];
+		}
+
+		for (; length > 0; --length) {
+			crc = update(crc, *data++);
+		}
+		return crc;
+	}
+};
+
+template <typename T, T Polynomial>
+class Engine<T, Polynomial, Method::Hardware>
+{
+public:
+	static inline T
+	update(T crc, uint8_t data)
+	{
+		return Hardware<T, Polynomial>::update(crc, data);
+	}
+
+	static inline T
+	update(T crc, const uint8_t *data, std::size_t length)
+	{
+		return Hardware<T, Polynomial>::update(crc, data, length);
+	}
+};
+
+}	// namespace crc
+
+}	// namespace xpcc
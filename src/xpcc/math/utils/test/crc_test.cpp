@@ -0,0 +1,104 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/math/utils/crc.hpp>
+
+#include "crc_test.hpp"
+
+using xpcc::crc::Engine;
+using xpcc::crc::Method;
+
+static const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+template <typename T, T Polynomial, Method M>
+static T
+calculate(T crc, const uint8_t *data, std::size_t length)
+{
+	return Engine<T, Polynomial, M>::update(crc, data, length);
+}
+
+template <typename T, T Polynomial, Method M>
+static T
+calculateBytewise(T crc, const uint8_t *data, std::size_t length)
+{
+	for (std::size_t i = 0; i < length; ++i) {
+		crc = Engine<T, Polynomial, M>::update(crc, data[i]);
+	}
+	return crc;
+}
+
+void
+CrcTest::testCrc8()
+{
+	// CRC-8/MAXIM
+	TEST_ASSERT_EQUALS(xpcc::crc::Crc8Dallas::update(0, check, sizeof(check)), 0xA1);
+
+	TEST_ASSERT_EQUALS((calculate<uint8_t, 0x8C, Method::Bitwise>(0, check, sizeof(check))), 0xA1);
+	TEST_ASSERT_EQUALS((calculate<uint8_t, 0x8C, Method::Table16>(0, check, sizeof(check))), 0xA1);
+	TEST_ASSERT_EQUALS((calculate<uint8_t, 0x8C, Method::Table256>(0, check, sizeof(check))), 0xA1);
+	TEST_ASSERT_EQUALS((calculate<uint8_t, 0x8C, Method::SliceBy8>(0, check, sizeof(check))), 0xA1);
+}
+
+void
+CrcTest::testCrc16()
+{
+	// CRC-16/MODBUS
+	TEST_ASSERT_EQUALS(xpcc::crc::Crc16Ibm::update(0xffff, check, sizeof(check)), 0x4B37);
+
+	TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::Bitwise>(0xffff, check, sizeof(check))), 0x4B37);
+	TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::Table16>(0xffff, check, sizeof(check))), 0x4B37);
+	TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::Table256>(0xffff, check, sizeof(check))), 0x4B37);
+	TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::SliceBy8>(0xffff, check, sizeof(check))), 0x4B37);
+
+	// CRC-16/ARC
+	TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::SliceBy8>(0, check, sizeof(check))), 0xBB3D);
+}
+
+void
+CrcTest::testCrc32()
+{
+	// CRC-32 as used by Ethernet and zlib
+	TEST_ASSERT_EQUALS((calculate<uint32_t, 0xEDB88320, Method::Bitwise>(0xffffffff, check, sizeof(check)) ^ 0xffffffff), 0xCBF43926U);
+	TEST_ASSERT_EQUALS((calculate<uint32_t, 0xEDB88320, Method::Table16>(0xffffffff, check, sizeof(check)) ^ 0xffffffff), 0xCBF43926U);
+	TEST_ASSERT_EQUALS((calculate<uint32_t, 0xEDB88320, Method::Table256>(0xffffffff, check, sizeof(check)) ^ 0xffffffff), 0xCBF43926U);
+	TEST_ASSERT_EQUALS((calculate<uint32_t, 0xEDB88320, Method::SliceBy8>(0xffffffff, check, sizeof(check)) ^ 0xffffffff), 0xCBF43926U);
+}
+
+void
+CrcTest::testMethods()
+{
+	uint8_t data[67];
+	uint32_t value = 1;
+	for (std::size_t i = 0; i < sizeof(data); ++i)
+	{
+		value = value * 1103515245 + 12345;
+		data[i] = value >> 16;
+	}
+
+	for (std::size_t length = 0; length <= sizeof(data); ++length)
+	{
+		uint8_t crc8 = calculate<uint8_t, 0x8C, Method::Bitwise>(0, data, length);
+		TEST_ASSERT_EQUALS((calculate<uint8_t, 0x8C, Method::Table16>(0, data, length)), crc8);
+		TEST_ASSERT_EQUALS((calculate<uint8_t, 0x8C, Method::Table256>(0, data, length)), crc8);
+		TEST_ASSERT_EQUALS((calculate<uint8_t, 0x8C, Method::SliceBy8>(0, data, length)), crc8);
+		TEST_ASSERT_EQUALS((calculateBytewise<uint8_t, 0x8C, Method::SliceBy8>(0, data, length)), crc8);
+
+		uint16_t crc16 = calculate<uint16_t, 0xA001, Method::Bitwise>(0xffff, data, length);
+		TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::Table16>(0xffff, data, length)), crc16);
+		TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::Table256>(0xffff, data, length)), crc16);
+		TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::SliceBy8>(0xffff, data, length)), crc16);
+		TEST_ASSERT_EQUALS((calculateBytewise<uint16_t, 0xA001, Method::SliceBy8>(0xffff, data, length)), crc16);
+
+		// unaligned start of the block
+		if (length > 0)
+		{
+			uint16_t crc = calculate<uint16_t, 0xA001, Method::Bitwise>(0xffff, data, 1);
+			TEST_ASSERT_EQUALS((calculate<uint16_t, 0xA001, Method::SliceBy8>(crc, data + 1, length - 1)), crc16);
+		}
+	}
+}
@@ -0,0 +1,26 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class CrcTest : public unittest::TestSuite
+{
+public:
+	void
+	testCrc8();
+
+	void
+	testCrc16();
+
+	void
+	testCrc32();
+
+	/// All methods have to give the same result for any block length
+	void
+	testMethods();
+};
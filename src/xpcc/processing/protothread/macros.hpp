@@ -93,6 +93,46 @@
 #define PT_WAIT_UNTIL(condition) \
 	PT_WAIT_WHILE(!(condition))
 
+/**
+ * Cause protothread to wait **until** given condition is true.
+ *
+ * Executed by an xpcc::rf::Executor the protothread is parked until
+ * `event` is signalled, see RF_WAIT_EVENT_UNTIL().
+ *
+ * \ingroup	protothread
+ * \hideinitializer
+ */
+#define PT_WAIT_EVENT_UNTIL(event, condition) \
+    do { \
+		this->ptState = __LINE__; \
+		case __LINE__: \
+		{ \
+			const uint8_t ptEventCount = (event).getCount(); \
+			if (!(condition)) { \
+				(event).wait(ptEventCount); \
+				return true; \
+			} \
+		} \
+    } while (0)
+
+/**
+ * Cause protothread to wait until `timeout` expired.
+ *
+ * Executed by an xpcc::rf::Executor the protothread is parked meanwhile.
+ *
+ * \ingroup	protothread
+ * \hideinitializer
+ */
+#define PT_WAIT_TIMEOUT(timeout) \
+    do { \
+		this->ptState = __LINE__; \
+		case __LINE__: \
+			if (!(timeout).isExpired()) { \
+				xpcc::rf::Executor::sleep((timeout).remaining()); \
+				return true; \
+			} \
+    } while (0)
+
 /**
  * Cause protothread to wait until given child protothread completes.
  *
@@ -72,6 +72,12 @@ namespace xpcc
 		 * 
 		 * Therefore there's no Mutex implementation, it isn't needed.
 		 * 
+		 * Protothreads executed by an xpcc::rf::Executor are parked while
+		 * waiting with
+		 * \code
+		 * PT_WAIT_EVENT_UNTIL(semaphore.getEvent(), semaphore.acquire());
+		 * \endcode
+		 * 
 		 * \ingroup	protothread
 		 */
 		class Semaphore
@@ -128,10 +134,19 @@ namespace xpcc
 			release()
 			{
 				this->count++;
+				this->event.signal();
+			}
+			
+			/// Signalled on every release()
+			inline xpcc::rf::Event&
+			getEvent()
+			{
+				return this->event;
 			}
 			
 		protected:
 			uint16_t count;
+			xpcc::rf::Event event;
 		};
 	}
 }
@@ -106,9 +106,15 @@
  * }
  * @endcode
  *
+ * With a C++20 compiler resumable functions can also be written as
+ * coroutines, which await the functions above with `CO_CALL()`.
+ * See xpcc::co::Task.
+ *
  * For other examples take a look in the `examples` folder in the XPCC
  * root folder.
  */
 
 #include "resumable/resumable.hpp"
 #include "resumable/nested_resumable.hpp"
+#include "resumable/executor.hpp"
+#include "resumable/coroutine.hpp"
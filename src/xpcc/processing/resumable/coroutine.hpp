@@ -0,0 +1,613 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_RF_COROUTINE_HPP
+#define XPCC_RF_COROUTINE_HPP
+
+// Only available if the compiler supports C++20 coroutines, the rest of
+// xpcc is still C++11. For hosted targets build with
+// `CXXFLAGS=-std=c++20 scons`.
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+
+#include <stdint.h>
+#include <cstddef>
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include <xpcc/architecture/detect.hpp>
+#include <xpcc_config.hpp>
+
+#include "resumable.hpp"
+
+#if defined(XPCC__OS_HOSTED)
+#	include <atomic>
+#else
+#	include <xpcc/architecture/driver/atomic/lock.hpp>
+#endif
+
+#ifndef XPCC__COROUTINE_FRAME_SIZE
+#	define XPCC__COROUTINE_FRAME_SIZE 128
+#endif
+
+#ifndef XPCC__COROUTINE_FRAMES
+#	define XPCC__COROUTINE_FRAMES 8
+#endif
+
+namespace xpcc
+{
+
+/**
+ * C++20 coroutines for resumable functions.
+ *
+ * @see	xpcc::co::Task
+ * @ingroup	resumable
+ */
+namespace co
+{
+
+/**
+ * Static memory for coroutine frames.
+ *
+ * `Frames` blocks of `FrameSize` bytes each. The size of a frame is only
+ * known to the compiler, a coroutine whose frame does not fit into a block
+ * is not started (see Task::isValid()). getLargestFrame() returns the
+ * largest frame requested so far to choose the block size.
+ *
+ * Free blocks form a stack linked through their first bytes, blocks which
+ * were never used are taken from the end of the storage. Everything
+ * starts zero-initialized, so coroutines can be started by constructors
+ * of other static objects.
+ *
+ * Every instantiation has its own storage. The default is set with
+ * `XPCC__COROUTINE_FRAME_SIZE` and `XPCC__COROUTINE_FRAMES` in the
+ * project configuration.
+ *
+ * @ingroup	resumable
+ */
+template< std::size_t FrameSize = XPCC__COROUTINE_FRAME_SIZE,
+		  std::size_t Frames = XPCC__COROUTINE_FRAMES >
+class FramePool
+{
+	static_assert(FrameSize >= sizeof(void *), "Frames must be able to hold a pointer!");
+	static_assert(Frames > 0 && Frames < 65536, "The number of frames must be between 1 and 65535!");
+
+public:
+	/// Size of the blocks, rounded up to keep the frames aligned
+	static constexpr std::size_t frameSize =
+			(FrameSize + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+	static constexpr std::size_t frames = Frames;
+
+	/// @return	`nullptr` if \p size is too large or all blocks are in use
+	static void *
+	allocate(std::size_t size) noexcept
+	{
+		Lock lock;
+
+		if (size > largestFrame) {
+			largestFrame = size;
+		}
+
+		void *frame = nullptr;
+		if (size <= frameSize)
+		{
+			if (head != nullptr)
+			{
+				frame = head;
+				head = *static_cast<void **>(head);
+			}
+			else if (unused < Frames) {
+				frame = storage + (unused++ * frameSize);
+			}
+		}
+
+		if (frame) {
+			framesInUse++;
+		} else {
+			failedAllocations++;
+		}
+		return frame;
+	}
+
+	static void
+	deallocate(void *frame) noexcept
+	{
+		Lock lock;
+
+		*static_cast<void **>(frame) = head;
+		head = frame;
+		framesInUse--;
+	}
+
+	static inline uint16_t
+	getFramesInUse()
+	{
+		return framesInUse;
+	}
+
+	/// Largest frame requested so far, including rejected ones
+	static inline std::size_t
+	getLargestFrame()
+	{
+		return largestFrame;
+	}
+
+	/// Coroutines not started because their frame was too large or all blocks were in use
+	static inline uint16_t
+	getFailedAllocations()
+	{
+		return failedAllocations;
+	}
+
+private:
+#if defined(XPCC__OS_HOSTED)
+	/// Threads may run coroutines using the same pool, allocations are short
+	struct Lock
+	{
+		Lock() {
+			while (flag.test_and_set(std::memory_order_acquire)) {
+			}
+		}
+
+		~Lock() {
+			flag.clear(std::memory_order_release);
+		}
+
+		static inline std::atomic_flag flag = ATOMIC_FLAG_INIT;
+	};
+#else
+	typedef xpcc::atomic::Lock Lock;
+#endif
+
+	alignas(std::max_align_t) static inline uint8_t storage[frameSize * Frames];
+	static inline void *head;
+	static inline uint16_t unused;
+	static inline uint16_t framesInUse;
+	static inline uint16_t failedAllocations;
+	static inline std::size_t largestFrame;
+};
+
+template< typename T, typename Allocator >
+class Task;
+
+/// @cond
+namespace detail
+{
+	struct Promise;
+
+	/**
+	 * Leaf operation a coroutine is suspended in.
+	 *
+	 * Stored in the frame of the suspended coroutine. `poll` is executed
+	 * by Task::run() of the outermost task until it returns `true`, then
+	 * the suspended coroutine is resumed directly, without passing
+	 * through the coroutines awaiting it.
+	 */
+	struct Operation
+	{
+		bool (*poll)(Operation *);
+		std::coroutine_handle<> caller;
+
+		template< typename P >
+		void
+		await_suspend(std::coroutine_handle<P> handle) noexcept;
+	};
+
+	struct Promise
+	{
+		Promise *root = this;			///< promise of the outermost task
+		Operation *operation = nullptr;	///< only used by the root
+		std::coroutine_handle<> continuation;
+
+		std::suspend_always
+		initial_suspend() noexcept
+		{ return {}; }
+
+		struct FinalAwaiter
+		{
+			bool
+			await_ready() noexcept
+			{ return false; }
+
+			template< typename P >
+			std::coroutine_handle<>
+			await_suspend(std::coroutine_handle<P> handle) noexcept
+			{
+				// continue the awaiting coroutine or return to Task::run()
+				std::coroutine_handle<> next = handle.promise().continuation;
+				return next ? next : std::noop_coroutine();
+			}
+
+			void
+			await_resume() noexcept
+			{}
+		};
+
+		FinalAwaiter
+		final_suspend() noexcept
+		{ return {}; }
+
+		void
+		unhandled_exception() noexcept
+		{ std::terminate(); }
+	};
+
+	template< typename P >
+	void
+	Operation::await_suspend(std::coroutine_handle<P> handle) noexcept
+	{
+		caller = handle;
+		handle.promise().root->operation = this;
+	}
+
+	template< typename T >
+	struct ValuePromise : public Promise
+	{
+		T result{};
+
+		void
+		return_value(T value)
+		{ result = std::move(value); }
+	};
+
+	template<>
+	struct ValuePromise<void> : public Promise
+	{
+		void
+		return_void() noexcept
+		{}
+	};
+}
+/// @endcond
+
+/**
+ * Resumable function implemented as C++20 coroutine.
+ *
+ * The `RF_BEGIN()`/`RF_CALL()` macros store a state byte per function and
+ * nesting level, and every run() passes through the switch statements of
+ * all nesting levels until it reaches the innermost function. A `Task`
+ * keeps local variables in its frame and resumes the innermost coroutine
+ * directly. Nesting is only limited by the frames of the allocator.
+ *
+ * Tasks await other tasks, resumable functions with `CO_CALL()` and wait
+ * conditions with `co::waitUntil()`:
+ *
+ * @code
+ * xpcc::co::Task<bool>
+ * readSensor()
+ * {
+ *     uint8_t id = CO_CALL(sensor.readRegister(Register::Id));
+ *     if (id != 0x3f) {
+ *         co_return false;
+ *     }
+ *     while (true)
+ *     {
+ *         timeout.restart(10);
+ *         co_await xpcc::co::waitUntil([&]() { return timeout.isExpired(); });
+ *         co_await filter(CO_CALL(sensor.readData()));
+ *     }
+ * }
+ *
+ * xpcc::co::Task<bool> task = readSensor();
+ * while (task.run()) {
+ *     ...
+ * }
+ * @endcode
+ *
+ * The outermost task is executed with run() like a protothread, it can be
+ * used as xpcc::rf::Task of an xpcc::rf::Executor. Awaited tasks are
+ * executed by the task awaiting them. A task is started by the first
+ * run() or co_await, not when it is created.
+ *
+ * The frames are allocated by `Allocator`, by default a FramePool of the
+ * size set in the project configuration. If no frame is available the
+ * task is not valid and finishes at once with a default constructed
+ * result, like a resumable function returning rf::NestingError.
+ *
+ * @warning	Tasks are not thread-safe. Exceptions are not supported, an
+ * 			exception leaving a task calls std::terminate().
+ * @warning	With GCC 12.2 a coroutine using `co_await` in the condition
+ * 			of an `if` statement crashes with a segmentation fault when
+ * 			it is run. Store the result in a variable first.
+ *
+ * @ingroup	resumable
+ * @tparam	T			result type, must have a default constructor!
+ * @tparam	Allocator	static `allocate(size)` and `deallocate(frame)`
+ */
+template< typename T = void, typename Allocator = FramePool<> >
+class Task
+{
+public:
+	struct promise_type : public detail::ValuePromise<T>
+	{
+		static void *
+		operator new(std::size_t size) noexcept
+		{ return Allocator::allocate(size); }
+
+		static void
+		operator delete(void *frame) noexcept
+		{ Allocator::deallocate(frame); }
+
+		static Task
+		get_return_object_on_allocation_failure() noexcept
+		{ return Task(); }
+
+		Task
+		get_return_object() noexcept
+		{ return Task(Handle::from_promise(*this)); }
+	};
+
+	Task() = default;
+
+	Task(Task&& other) noexcept :
+		handle(std::exchange(other.handle, nullptr))
+	{
+	}
+
+	Task&
+	operator = (Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (handle) {
+				handle.destroy();
+			}
+			handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+
+	~Task()
+	{
+		if (handle) {
+			handle.destroy();
+		}
+	}
+
+	/// `false` if the frame could not be allocated
+	inline bool
+	isValid() const
+	{
+		return bool(handle);
+	}
+
+	inline bool
+	isRunning() const
+	{
+		return handle && !handle.done();
+	}
+
+	/**
+	 * Continue the task until it has to wait.
+	 *
+	 * Polls the operation the innermost coroutine waits for and resumes
+	 * it only when the operation is finished.
+	 *
+	 * @return	`false` when finished
+	 */
+	bool
+	run()
+	{
+		if (!isRunning()) {
+			return false;
+		}
+
+		detail::Operation *operation = handle.promise().operation;
+		if (operation == nullptr) {
+			handle.resume();
+		}
+		else if (operation->poll(operation))
+		{
+			handle.promise().operation = nullptr;
+			operation->caller.resume();
+		}
+		return !handle.done();
+	}
+
+	/// Result of the finished task
+	template< typename U = T >
+	inline typename std::enable_if<!std::is_void<U>::value, U>::type
+	getResult() const
+	{
+		return handle ? handle.promise().result : U();
+	}
+
+	/// @cond
+	struct Awaiter
+	{
+		std::coroutine_handle<promise_type> handle;
+
+		bool
+		await_ready() noexcept
+		{
+			return !handle || handle.done();
+		}
+
+		template< typename P >
+		std::coroutine_handle<>
+		await_suspend(std::coroutine_handle<P> caller) noexcept
+		{
+			handle.promise().continuation = caller;
+			handle.promise().root = caller.promise().root;
+			return handle;
+		}
+
+		T
+		await_resume()
+		{
+			if constexpr (!std::is_void<T>::value) {
+				return handle ? std::move(handle.promise().result) : T();
+			}
+		}
+	};
+
+	Awaiter
+	operator co_await() && noexcept
+	{
+		return Awaiter{handle};
+	}
+	/// @endcond
+
+private:
+	typedef std::coroutine_handle<promise_type> Handle;
+
+	explicit Task(Handle handle) :
+		handle(handle)
+	{
+	}
+
+	Task(const Task&) = delete;
+
+	Task&
+	operator = (const Task&) = delete;
+
+	Handle handle;
+};
+
+/// @cond
+namespace detail
+{
+	template< typename Function >
+	struct CallAwaiter : public Operation
+	{
+		typedef decltype(std::declval<Function&>()().getResult()) Result;
+
+		Function function;
+		Result result{};
+
+		explicit CallAwaiter(Function function) :
+			Operation{&CallAwaiter::update, {}}, function(std::move(function))
+		{
+		}
+
+		static bool
+		update(Operation *operation)
+		{
+			CallAwaiter *self = static_cast<CallAwaiter *>(operation);
+			auto rfResult = self->function();
+			if (rfResult.getState() > xpcc::rf::NestingError) {
+				return false;
+			}
+			self->result = rfResult.getResult();
+			return true;
+		}
+
+		bool
+		await_ready()
+		{ return update(this); }
+
+		Result
+		await_resume()
+		{ return std::move(result); }
+	};
+
+	template< typename Condition >
+	struct WaitAwaiter : public Operation
+	{
+		Condition condition;
+
+		explicit WaitAwaiter(Condition condition) :
+			Operation{&WaitAwaiter::update, {}}, condition(std::move(condition))
+		{
+		}
+
+		static bool
+		update(Operation *operation)
+		{
+			return static_cast<WaitAwaiter *>(operation)->condition();
+		}
+
+		bool
+		await_ready()
+		{ return condition(); }
+
+		void
+		await_resume() noexcept
+		{}
+	};
+
+	struct YieldAwaiter : public Operation
+	{
+		YieldAwaiter() :
+			Operation{&YieldAwaiter::update, {}}
+		{
+		}
+
+		static bool
+		update(Operation *)
+		{ return true; }
+
+		bool
+		await_ready() noexcept
+		{ return false; }
+
+		void
+		await_resume() noexcept
+		{}
+	};
+}
+/// @endcond
+
+/**
+ * Await a resumable function.
+ *
+ * \p function calls the resumable function and returns its
+ * xpcc::ResumableResult. It is called once when awaited and on every
+ * Task::run() afterwards until the resumable function is finished. The
+ * result of co_await is the result of the resumable function, like
+ * `RF_CALL()`.
+ *
+ * @see	CO_CALL()
+ * @ingroup	resumable
+ */
+template< typename Function >
+inline detail::CallAwaiter<Function>
+call(Function function)
+{
+	return detail::CallAwaiter<Function>(std::move(function));
+}
+
+/// Wait until \p condition returns `true`, checked on every Task::run()
+/// @ingroup	resumable
+template< typename Condition >
+inline detail::WaitAwaiter<Condition>
+waitUntil(Condition condition)
+{
+	return detail::WaitAwaiter<Condition>(std::move(condition));
+}
+
+/// Continue on the next Task::run()
+/// @ingroup	resumable
+inline detail::YieldAwaiter
+yield()
+{
+	return detail::YieldAwaiter();
+}
+
+}	// namespace co
+
+}	// namespace xpcc
+
+/**
+ * Await a resumable function inside a xpcc::co::Task.
+ *
+ * @code
+ * uint8_t id = CO_CALL(sensor.readRegister(Register::Id));
+ * @endcode
+ *
+ * @ingroup	resumable
+ * @hideinitializer
+ */
+#define CO_CALL(resumable) \
+	(co_await ::xpcc::co::call([&]() { return resumable; }))
+
+#endif	// __cpp_impl_coroutine
+
+#endif	// XPCC_RF_COROUTINE_HPP
@@ -0,0 +1,297 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "executor.hpp"
+
+#include <xpcc/architecture/driver/atomic/lock.hpp>
+
+xpcc::rf::Task *xpcc::rf::Executor::current = 0;
+
+// ----------------------------------------------------------------------------
+xpcc::rf::Task::Task() :
+	next(0), nextSleeping(0), executor(0), event(0), deadline(),
+	state(IDLE), sleeping(false), waits(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+xpcc::rf::Event::Event() :
+	waiting(0), count(0)
+{
+}
+
+void
+xpcc::rf::Event::signal()
+{
+	atomic::Lock lock;
+
+	count = count + 1;
+
+	Task *task = waiting;
+	waiting = 0;
+	while (task != 0)
+	{
+		Task *next = task->next;
+		task->event = 0;
+		Executor::unpark(task);
+		task->executor->makeReady(task);
+		task = next;
+	}
+}
+
+void
+xpcc::rf::Event::wait(uint8_t count)
+{
+	atomic::Lock lock;
+
+	if (count == this->count) {
+		Executor::park(this, false, 0);
+	}
+	else if (Executor::current != 0) {
+		// signalled meanwhile, but parking twice must still be detected
+		Executor::current->waits++;
+	}
+}
+
+void
+xpcc::rf::Event::wait(uint8_t count, int32_t time)
+{
+	atomic::Lock lock;
+
+	if (count == this->count && time > 0) {
+		Executor::park(this, true, time);
+	}
+	else if (Executor::current != 0) {
+		Executor::current->waits++;
+	}
+}
+
+// ----------------------------------------------------------------------------
+xpcc::rf::Executor::Executor() :
+	readyHead(0), readyTail(0), sleepingHead(0)
+{
+}
+
+bool
+xpcc::rf::Executor::add(Task& task)
+{
+	atomic::Lock lock;
+
+	if (task.state != Task::IDLE) {
+		return false;
+	}
+	task.executor = this;
+	makeReady(&task);
+	return true;
+}
+
+bool
+xpcc::rf::Executor::remove(Task& task)
+{
+	atomic::Lock lock;
+
+	if (task.executor != this) {
+		return false;
+	}
+
+	if (task.state == Task::READY)
+	{
+		Task **position = &readyHead;
+		Task *previous = 0;
+		while (*position != &task) {
+			previous = *position;
+			position = &(*position)->next;
+		}
+		*position = task.next;
+		if (readyTail == &task) {
+			readyTail = previous;
+		}
+	}
+	else if (task.state == Task::WAITING) {
+		unpark(&task);
+	}
+
+	// a running task is not queued again by update()
+	task.state = Task::IDLE;
+	task.executor = 0;
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::rf::Executor::update()
+{
+	if (sleepingHead != 0)
+	{
+		const xpcc::Timestamp now = xpcc::Clock::now();
+
+		atomic::Lock lock;
+		while (sleepingHead != 0 && sleepingHead->deadline <= now)
+		{
+			Task *task = sleepingHead;
+			unpark(task);
+			makeReady(task);
+		}
+	}
+
+	// only the tasks ready now, the others follow on the next call
+	uint16_t count = 0;
+	{
+		atomic::Lock lock;
+		for (Task *task = readyHead; task != 0; task = task->next) {
+			count++;
+		}
+	}
+
+	for (; count > 0; --count)
+	{
+		Task *task;
+		{
+			atomic::Lock lock;
+			task = readyHead;
+			if (task == 0) {
+				// removed by another task
+				break;
+			}
+			readyHead = task->next;
+			if (readyHead == 0) {
+				readyTail = 0;
+			}
+			task->state = Task::RUNNING;
+			task->waits = 0;
+		}
+
+		current = task;
+		const bool running = task->run();
+		current = 0;
+
+		if (!running) {
+			this->remove(*task);
+			continue;
+		}
+
+		atomic::Lock lock;
+		if (task->state == Task::RUNNING) {
+			// not parked, polled again on the next call
+			makeReady(task);
+		}
+		else if (task->state == Task::WAITING && task->waits > 1)
+		{
+			// waits for several events at once
+			unpark(task);
+			makeReady(task);
+		}
+	}
+
+	return (readyHead != 0);
+}
+
+bool
+xpcc::rf::Executor::isPending() const
+{
+	return (readyHead != 0 || sleepingHead != 0);
+}
+
+int32_t
+xpcc::rf::Executor::remaining() const
+{
+	if (readyHead != 0 || sleepingHead == 0) {
+		return 0;
+	}
+	return (sleepingHead->deadline - xpcc::Clock::now()).getTime();
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::rf::Executor::sleep(int32_t time)
+{
+	atomic::Lock lock;
+
+	if (time > 0) {
+		park(0, true, time);
+	}
+	else if (current != 0) {
+		current->waits++;
+	}
+}
+
+void
+xpcc::rf::Executor::park(Event *event, bool timed, int32_t time)
+{
+	Task *task = current;
+	if (task == 0 || task->executor == 0 || task->state == Task::IDLE) {
+		// polled without executor, or removed meanwhile
+		return;
+	}
+
+	task->waits++;
+	if (task->waits > 1) {
+		// handled by update()
+		return;
+	}
+
+	if (event != 0)
+	{
+		task->next = event->waiting;
+		event->waiting = task;
+		task->event = event;
+	}
+
+	if (timed)
+	{
+		task->deadline = xpcc::Clock::now() + xpcc::Timestamp(time);
+
+		Task **position = &task->executor->sleepingHead;
+		while (*position != 0 && (*position)->deadline <= task->deadline) {
+			position = &(*position)->nextSleeping;
+		}
+		task->nextSleeping = *position;
+		*position = task;
+		task->sleeping = true;
+	}
+
+	task->state = Task::WAITING;
+}
+
+void
+xpcc::rf::Executor::unpark(Task *task)
+{
+	if (task->event != 0)
+	{
+		Task **position = &task->event->waiting;
+		while (*position != task) {
+			position = &(*position)->next;
+		}
+		*position = task->next;
+		task->event = 0;
+	}
+
+	if (task->sleeping)
+	{
+		Task **position = &task->executor->sleepingHead;
+		while (*position != task) {
+			position = &(*position)->nextSleeping;
+		}
+		*position = task->nextSleeping;
+		task->sleeping = false;
+	}
+}
+
+void
+xpcc::rf::Executor::makeReady(Task *task)
+{
+	task->state = Task::READY;
+	task->next = 0;
+	if (readyTail == 0) {
+		readyHead = task;
+	}
+	else {
+		readyTail->next = task;
+	}
+	readyTail = task;
+}
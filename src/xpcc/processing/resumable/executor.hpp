@@ -0,0 +1,275 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_RF_EXECUTOR_HPP
+#define XPCC_RF_EXECUTOR_HPP
+
+#include <stdint.h>
+
+#include <xpcc/architecture/driver/clock.hpp>
+#include <xpcc/processing/timer/timestamp.hpp>
+
+namespace xpcc
+{
+
+namespace rf
+{
+
+class Executor;
+class Event;
+
+/**
+ * Unit of work of the xpcc::rf::Executor.
+ *
+ * Usually a protothread which executes the resumable functions of a
+ * driver:
+ *
+ * @code
+ * class Sensor : public xpcc::pt::Protothread, public xpcc::rf::Task
+ * {
+ * public:
+ *     bool
+ *     run()
+ *     {
+ *         PT_BEGIN();
+ *         while (true) {
+ *             PT_CALL(driver.readData());
+ *             PT_WAIT_TIMEOUT(timeout);
+ *             ...
+ *         }
+ *         PT_END();
+ *     }
+ * };
+ * @endcode
+ *
+ * @ingroup	resumable
+ */
+class Task
+{
+public:
+	Task();
+
+	/// @return `false` when finished, the task is removed from the executor
+	virtual bool
+	run() = 0;
+
+private:
+	Task(const Task&) = delete;
+
+	Task&
+	operator = (const Task&) = delete;
+
+	friend class Executor;
+	friend class Event;
+
+	/// @cond
+	enum State : uint8_t
+	{
+		IDLE,		///< not added to an executor
+		READY,
+		RUNNING,
+		WAITING
+	};
+	/// @endcond
+
+	Task *next;				///< ready queue or wait queue of the event
+	Task *nextSleeping;		///< sorted by deadline
+	Executor *executor;
+	Event *event;
+	xpcc::Timestamp deadline;
+	State state;
+	bool sleeping;
+	uint8_t waits;			///< attempts to park during the current run()
+};
+
+/**
+ * Wait queue for tasks of an xpcc::rf::Executor.
+ *
+ * Signalled by the source of an event, e.g. the transfer complete
+ * interrupt of a bus. Resumable functions wait for the event with
+ * RF_WAIT_EVENT_UNTIL(), which parks the task until the event is
+ * signalled:
+ *
+ * @code
+ * // interrupt
+ * transferComplete = true;
+ * event.signal();
+ *
+ * // resumable function
+ * RF_WAIT_EVENT_UNTIL(event, transferComplete);
+ * @endcode
+ *
+ * Each signal() wakes all waiting tasks, which check their condition
+ * again. A signal between checking the condition and parking the task
+ * is not lost, the task is not parked then.
+ *
+ * @ingroup	resumable
+ */
+class Event
+{
+public:
+	Event();
+
+	/// Make all waiting tasks ready. Can be called from interrupts.
+	void
+	signal();
+
+	/// Number of signals, only used to detect signals while checking a condition
+	inline uint8_t
+	getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Park the current task until the event is signalled.
+	 *
+	 * Does nothing if the event was signalled after \p count was read,
+	 * or if the caller is not executed by an Executor.
+	 */
+	void
+	wait(uint8_t count);
+
+	/// Park the current task until the event is signalled or \p time milliseconds passed
+	void
+	wait(uint8_t count, int32_t time);
+
+private:
+	friend class Executor;
+
+	Event(const Event&) = delete;
+
+	Event&
+	operator = (const Event&) = delete;
+
+	Task *waiting;
+	volatile uint8_t count;
+};
+
+/**
+ * Executes tasks only when they are able to continue.
+ *
+ * Resumable functions polled by a main loop check their wait conditions
+ * over and over again, even if all of them wait for bus transfers. Tasks
+ * added to an executor are parked instead when they wait with one of
+ * these macros:
+ *
+ * - RF_WAIT_EVENT_UNTIL(), RF_WAIT_EVENT_WHILE() and
+ *   PT_WAIT_EVENT_UNTIL() until the xpcc::rf::Event is signalled,
+ * - RF_WAIT_TIMEOUT() and PT_WAIT_TIMEOUT() until the timeout expires,
+ * - RF_WAIT_EVENT_UNTIL_TIMEOUT() until either happens.
+ *
+ * Tasks waiting with any other macro are executed on every update(), as
+ * before. Outside of an executor the macros poll as well, so drivers can
+ * use them independent of how they are executed.
+ *
+ * If update() returns `false`, no task is ready and the core can sleep
+ * until the next interrupt or the next deadline. The executor can be
+ * registered with xpcc::GenericTickless for this.
+ *
+ * @code
+ * xpcc::rf::Executor executor;
+ * executor.add(sensor);
+ * executor.add(display);
+ *
+ * while (true)
+ * {
+ *     if (!executor.update()) {
+ *         __WFI();
+ *     }
+ * }
+ * @endcode
+ *
+ * A task is parked only for the single event it waits for. If it checks
+ * several resumables in one wait condition and more than one of them
+ * waits for an event, the task is executed on every update().
+ *
+ * @ingroup	resumable
+ */
+class Executor
+{
+public:
+	Executor();
+
+	/// Add a task, it is executed on the next update()
+	bool
+	add(Task& task);
+
+	/// @return	`false` if the task was not added to this executor
+	bool
+	remove(Task& task);
+
+	/**
+	 * Execute every ready task once.
+	 *
+	 * Tasks signalled or woken up meanwhile are executed on the next
+	 * call.
+	 *
+	 * @return	`true` if tasks are ready
+	 */
+	bool
+	update();
+
+	/// @return	`true` if no task is ready
+	inline bool
+	isIdle() const
+	{
+		return (readyHead == 0);
+	}
+
+	/// @return	`true` if tasks are ready or sleeping, for xpcc::GenericTickless
+	bool
+	isPending() const;
+
+	/// @return	milliseconds until the next task is ready, for xpcc::GenericTickless
+	int32_t
+	remaining() const;
+
+	/// Park the current task for \p time milliseconds
+	static void
+	sleep(int32_t time);
+
+	/// The task executed right now, or `nullptr`
+	static inline Task *
+	getCurrentTask()
+	{
+		return current;
+	}
+
+private:
+	friend class Event;
+
+	Executor(const Executor&) = delete;
+
+	Executor&
+	operator = (const Executor&) = delete;
+
+	/// Park the current task, interrupts must be disabled
+	static void
+	park(Event *event, bool timed, int32_t time);
+
+	/// Remove a waiting task from all queues, interrupts must be disabled
+	static void
+	unpark(Task *task);
+
+	/// Append to the ready queue, interrupts must be disabled
+	void
+	makeReady(Task *task);
+
+	Task *readyHead;
+	Task *readyTail;
+	Task *sleepingHead;
+
+	static Task *current;
+};
+
+}	// namespace rf
+
+}	// namespace xpcc
+
+#endif // XPCC_RF_EXECUTOR_HPP
@@ -11,6 +11,7 @@
 #define XPCC_RF_MACROS_HPP
 
 #include <xpcc/utils/arithmetic_traits.hpp>
+#include "executor.hpp"
 
 #ifdef __DOXYGEN__
 /**
@@ -119,6 +120,81 @@
 #define RF_WAIT_UNTIL(condition) \
 	RF_WAIT_WHILE(!(condition))
 
+/**
+ * Cause resumable function to wait **until** given `condition` is true.
+ *
+ * Executed by an xpcc::rf::Executor the task is parked until `event`
+ * is signalled, the condition is only checked again then. Otherwise the
+ * same as RF_WAIT_UNTIL().
+ *
+ * @ingroup	resumable
+ * @hideinitializer
+ */
+#define RF_WAIT_EVENT_UNTIL(event, condition) \
+		do { \
+			RF_INTERNAL_SET_CASE(__COUNTER__); \
+			{ \
+				const uint8_t rfEventCount = (event).getCount(); \
+				if (!(condition)) { \
+					(event).wait(rfEventCount); \
+					this->popRf(); \
+					return {xpcc::rf::Running}; \
+				} \
+			} \
+		} while(0)
+
+/**
+ * Cause resumable function to wait **while** given `condition` is true,
+ * see RF_WAIT_EVENT_UNTIL().
+ *
+ * @ingroup	resumable
+ * @hideinitializer
+ */
+#define RF_WAIT_EVENT_WHILE(event, condition) \
+	RF_WAIT_EVENT_UNTIL(event, !(condition))
+
+/**
+ * Cause resumable function to wait until `condition` is true or `timeout`
+ * expired.
+ *
+ * Executed by an xpcc::rf::Executor the task is parked until `event`
+ * is signalled or the timeout expires.
+ *
+ * @ingroup	resumable
+ * @hideinitializer
+ */
+#define RF_WAIT_EVENT_UNTIL_TIMEOUT(event, condition, timeout) \
+		do { \
+			RF_INTERNAL_SET_CASE(__COUNTER__); \
+			{ \
+				const uint8_t rfEventCount = (event).getCount(); \
+				if (!(condition) && !(timeout).isExpired()) { \
+					(event).wait(rfEventCount, (timeout).remaining()); \
+					this->popRf(); \
+					return {xpcc::rf::Running}; \
+				} \
+			} \
+		} while(0)
+
+/**
+ * Cause resumable function to wait until `timeout` expired.
+ *
+ * Executed by an xpcc::rf::Executor the task is parked meanwhile.
+ * The timeout must use the xpcc::Clock.
+ *
+ * @ingroup	resumable
+ * @hideinitializer
+ */
+#define RF_WAIT_TIMEOUT(timeout) \
+		do { \
+			RF_INTERNAL_SET_CASE(__COUNTER__); \
+			if (!(timeout).isExpired()) { \
+				xpcc::rf::Executor::sleep((timeout).remaining()); \
+				this->popRf(); \
+				return {xpcc::rf::Running}; \
+			} \
+		} while(0)
+
 /**
  * Calls a resumable function and returns its result.
  *
@@ -0,0 +1,290 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/processing/resumable.hpp>
+
+#include "coroutine_test.hpp"
+
+// Built with C++20 by unittest_hosted_cpp20.cfg, there the tests must not be
+// skipped silently
+#if (__cplusplus > 201703L) && !(defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L))
+#	error "The compiler does not support coroutines with C++20, check the compiler flags!"
+#endif
+
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+
+#include <xpcc/processing/resumable/coroutine.hpp>
+
+namespace
+{
+	typedef xpcc::co::FramePool<256, 4> TestingPool;
+
+	template< typename T = void >
+	using TestingTask = xpcc::co::Task<T, TestingPool>;
+
+	/// Driver with a simulated bus transfer
+	class TestingDriver : public xpcc::NestedResumable<2>
+	{
+	public:
+		TestingDriver() :
+			ready(false), calls(0)
+		{
+		}
+
+		xpcc::ResumableResult<uint8_t>
+		readRegister(uint8_t reg)
+		{
+			RF_BEGIN();
+
+			calls++;
+			RF_WAIT_UNTIL(ready);
+
+			RF_END_RETURN(uint8_t(reg + 1));
+		}
+
+		xpcc::ResumableResult<uint8_t>
+		read(uint8_t reg)
+		{
+			RF_BEGIN();
+
+			calls++;
+			RF_END_RETURN_CALL(readRegister(reg));
+		}
+
+		bool ready;
+		uint16_t calls;
+	};
+
+	TestingTask<int>
+	count(int& started, uint8_t yields)
+	{
+		started++;
+		for (uint8_t i = 0; i < yields; ++i) {
+			co_await xpcc::co::yield();
+		}
+		co_return 42;
+	}
+
+	TestingTask<int>
+	wait(bool& condition, uint16_t& checks, int result)
+	{
+		co_await xpcc::co::waitUntil([&]() { checks++; return condition; });
+		co_return result;
+	}
+
+	TestingTask<>
+	nested(bool& condition, uint16_t& checks, int& sum)
+	{
+		sum += co_await wait(condition, checks, 1);
+		condition = false;
+		sum += co_await wait(condition, checks, 2);
+	}
+
+	TestingTask<int>
+	outer(bool& condition, uint16_t& checks)
+	{
+		int sum = 0;
+		co_await nested(condition, checks, sum);
+		co_return sum + 10;
+	}
+
+	TestingTask<uint8_t>
+	readDriver(TestingDriver& driver)
+	{
+		uint8_t value = CO_CALL(driver.read(4));
+		value += CO_CALL(driver.readRegister(10));
+		co_return value;
+	}
+
+	TestingTask<uint8_t>
+	large(bool& condition)
+	{
+		volatile uint8_t buffer[512];
+		buffer[0] = 3;
+		co_await xpcc::co::waitUntil([&]() { return condition; });
+		co_return buffer[0];
+	}
+
+	TestingTask<int>
+	recursive(uint8_t depth, bool& condition)
+	{
+		if (depth == 0) {
+			co_await xpcc::co::waitUntil([&]() { return condition; });
+			co_return 1;
+		}
+		int result = co_await recursive(depth - 1, condition);
+		co_return result + 1;
+	}
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+void
+CoroutineTest::testRun()
+{
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+	int started = 0;
+	{
+		TestingTask<int> task = count(started, 2);
+		TEST_ASSERT_TRUE(task.isValid());
+		TEST_ASSERT_TRUE(task.isRunning());
+
+		// started by the first run()
+		TEST_ASSERT_EQUALS(started, 0);
+		TEST_ASSERT_TRUE(task.run());
+		TEST_ASSERT_EQUALS(started, 1);
+		TEST_ASSERT_TRUE(task.run());
+		TEST_ASSERT_FALSE(task.run());
+		TEST_ASSERT_FALSE(task.isRunning());
+		TEST_ASSERT_EQUALS(task.getResult(), 42);
+
+		TEST_ASSERT_FALSE(task.run());
+		TEST_ASSERT_EQUALS(started, 1);
+	}
+	TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 0);
+
+	TestingTask<int> task = count(started, 0);
+	TEST_ASSERT_FALSE(task.run());
+	TEST_ASSERT_EQUALS(task.getResult(), 42);
+#endif
+}
+
+void
+CoroutineTest::testNested()
+{
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+	bool condition = false;
+	uint16_t checks = 0;
+	{
+		TestingTask<int> task = outer(condition, checks);
+		TEST_ASSERT_TRUE(task.run());
+		TEST_ASSERT_EQUALS(checks, 1);
+		TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 3);
+
+		// only the condition of the innermost task is checked
+		for (uint8_t i = 0; i < 10; ++i) {
+			TEST_ASSERT_TRUE(task.run());
+		}
+		TEST_ASSERT_EQUALS(checks, 11);
+
+		condition = true;
+		TEST_ASSERT_TRUE(task.run());
+		TEST_ASSERT_EQUALS(checks, 13);
+		TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 3);
+
+		condition = true;
+		TEST_ASSERT_FALSE(task.run());
+		TEST_ASSERT_EQUALS(task.getResult(), 13);
+		TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 1);
+	}
+	TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 0);
+#endif
+}
+
+void
+CoroutineTest::testResumable()
+{
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+	TestingDriver driver;
+	TestingTask<uint8_t> task = readDriver(driver);
+
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_EQUALS(driver.calls, 2);
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_EQUALS(driver.calls, 2);
+
+	// the second resumable function finishes without waiting
+	driver.ready = true;
+	TEST_ASSERT_FALSE(task.run());
+	TEST_ASSERT_EQUALS(driver.calls, 3);
+	TEST_ASSERT_EQUALS(task.getResult(), 5 + 11);
+#endif
+}
+
+void
+CoroutineTest::testWaitUntil()
+{
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+	bool condition = true;
+	uint16_t checks = 0;
+
+	// a true condition does not suspend the task
+	TestingTask<int> task = wait(condition, checks, 7);
+	TEST_ASSERT_FALSE(task.run());
+	TEST_ASSERT_EQUALS(checks, 1);
+	TEST_ASSERT_EQUALS(task.getResult(), 7);
+
+	condition = false;
+	task = wait(condition, checks, 8);
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_EQUALS(checks, 3);
+	condition = true;
+	TEST_ASSERT_FALSE(task.run());
+	TEST_ASSERT_EQUALS(checks, 4);
+	TEST_ASSERT_EQUALS(task.getResult(), 8);
+#endif
+}
+
+void
+CoroutineTest::testAllocationFailure()
+{
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+	const uint16_t failed = TestingPool::getFailedAllocations();
+	bool condition = false;
+
+	// frame larger than the blocks of the pool
+	TestingTask<uint8_t> task = large(condition);
+	TEST_ASSERT_FALSE(task.isValid());
+	TEST_ASSERT_FALSE(task.isRunning());
+	TEST_ASSERT_FALSE(task.run());
+	TEST_ASSERT_EQUALS(task.getResult(), 0);
+	TEST_ASSERT_EQUALS(TestingPool::getFailedAllocations(), failed + 1);
+	TEST_ASSERT_TRUE(TestingPool::getLargestFrame() > 512);
+
+	// the innermost of five tasks does not get one of the four frames
+	TestingTask<int> nested = recursive(4, condition);
+	TEST_ASSERT_FALSE(nested.run());
+	TEST_ASSERT_EQUALS(nested.getResult(), 4);
+	TEST_ASSERT_EQUALS(TestingPool::getFailedAllocations(), failed + 2);
+
+	// all four fit
+	nested = TestingTask<int>();
+	nested = recursive(3, condition);
+	TEST_ASSERT_TRUE(nested.run());
+	TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 4);
+	condition = true;
+	TEST_ASSERT_FALSE(nested.run());
+	TEST_ASSERT_EQUALS(nested.getResult(), 4);
+	TEST_ASSERT_EQUALS(TestingPool::getFailedAllocations(), failed + 2);
+#endif
+}
+
+void
+CoroutineTest::testDestroy()
+{
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+	bool condition = false;
+	{
+		TestingTask<int> task = recursive(2, condition);
+		TEST_ASSERT_TRUE(task.run());
+		TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 3);
+
+		// moving does not affect the suspended tasks
+		TestingTask<int> moved(std::move(task));
+		TEST_ASSERT_FALSE(task.isValid());
+		TEST_ASSERT_FALSE(task.run());
+		TEST_ASSERT_TRUE(moved.run());
+		TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 3);
+	}
+	// destroying the outermost task destroys the awaited ones
+	TEST_ASSERT_EQUALS(TestingPool::getFramesInUse(), 0);
+#endif
+}
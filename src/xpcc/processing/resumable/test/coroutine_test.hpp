@@ -0,0 +1,35 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+/**
+ * The tests only check something if the compiler supports coroutines, run
+ * them with 'scons unittest config=unittest_hosted_cpp20.cfg'.
+ */
+class CoroutineTest : public unittest::TestSuite
+{
+public:
+	void
+	testRun();
+
+	void
+	testNested();
+
+	void
+	testResumable();
+
+	void
+	testWaitUntil();
+
+	void
+	testAllocationFailure();
+
+	void
+	testDestroy();
+};
@@ -0,0 +1,444 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/processing/resumable.hpp>
+#include <xpcc/processing/protothread.hpp>
+#include <xpcc/processing/timer.hpp>
+#include <xpcc/architecture/driver/test/testing_clock.hpp>
+
+#include "executor_test.hpp"
+
+// ----------------------------------------------------------------------------
+/// Driver waiting for the completion of a simulated bus transfer
+class TestingDriver : public xpcc::NestedResumable<1>
+{
+public:
+	TestingDriver() :
+		complete(false), checks(0), signalWhileChecking(false)
+	{
+	}
+
+	xpcc::ResumableResult<bool>
+	transfer()
+	{
+		RF_BEGIN();
+
+		complete = false;
+		RF_WAIT_EVENT_UNTIL(event, isComplete());
+
+		RF_END_RETURN(true);
+	}
+
+	xpcc::ResumableResult<bool>
+	transfer(uint16_t time)
+	{
+		RF_BEGIN();
+
+		complete = false;
+		timeout.restart(time);
+		RF_WAIT_EVENT_UNTIL_TIMEOUT(event, isComplete(), timeout);
+
+		RF_END_RETURN(complete);
+	}
+
+	/// Interrupt of the bus
+	void
+	finish()
+	{
+		complete = true;
+		event.signal();
+	}
+
+	bool
+	isComplete()
+	{
+		checks++;
+		if (signalWhileChecking) {
+			// interrupt between checking and parking
+			signalWhileChecking = false;
+			finish();
+			return false;
+		}
+		return complete;
+	}
+
+	xpcc::rf::Event event;
+	xpcc::Timeout timeout;
+	bool complete;
+	uint16_t checks;
+	bool signalWhileChecking;
+};
+
+class TestingTask : public xpcc::pt::Protothread, public xpcc::rf::Task
+{
+public:
+	TestingTask(TestingDriver& driver) :
+		driver(driver), runs(0), transfers(0)
+	{
+	}
+
+	bool
+	run()
+	{
+		runs++;
+		PT_BEGIN();
+
+		while (transfers < 2)
+		{
+			PT_CALL(driver.transfer());
+			transfers++;
+		}
+
+		PT_END();
+	}
+
+	TestingDriver& driver;
+	uint16_t runs;
+	uint8_t transfers;
+};
+
+// ----------------------------------------------------------------------------
+void
+ExecutorTest::setUp()
+{
+	TestingClock::time = 1000;
+}
+
+void
+ExecutorTest::testEvent()
+{
+	TestingDriver driver;
+	TestingTask task(driver);
+
+	xpcc::rf::Executor executor;
+	TEST_ASSERT_TRUE(executor.isIdle());
+	TEST_ASSERT_TRUE(executor.add(task));
+	TEST_ASSERT_FALSE(executor.add(task));
+	TEST_ASSERT_FALSE(executor.isIdle());
+
+	// parked after checking the condition once
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_EQUALS(task.runs, 1);
+	TEST_ASSERT_EQUALS(driver.checks, 1);
+	TEST_ASSERT_FALSE(executor.isPending());
+
+	// spurious signal, checked once and parked again
+	driver.event.signal();
+	TEST_ASSERT_FALSE(executor.isIdle());
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_EQUALS(task.runs, 2);
+	TEST_ASSERT_EQUALS(driver.checks, 2);
+
+	driver.finish();
+	TEST_ASSERT_FALSE(executor.isIdle());
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_EQUALS(task.transfers, 1);
+	TEST_ASSERT_EQUALS(task.runs, 3);
+
+	driver.finish();
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_EQUALS(task.transfers, 2);
+	TEST_ASSERT_FALSE(task.isRunning());
+
+	// finished tasks are removed
+	TEST_ASSERT_FALSE(executor.remove(task));
+	TEST_ASSERT_TRUE(executor.add(task));
+}
+
+void
+ExecutorTest::testWithoutExecutor()
+{
+	TestingDriver driver;
+	TestingTask task(driver);
+
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_EQUALS(driver.checks, 2);
+
+	driver.complete = true;
+	TEST_ASSERT_TRUE(task.run());
+	TEST_ASSERT_EQUALS(task.transfers, 1);
+
+	// signalling without waiting tasks is allowed
+	driver.finish();
+	TEST_ASSERT_FALSE(task.run());
+	TEST_ASSERT_EQUALS(task.transfers, 2);
+}
+
+void
+ExecutorTest::testSignalWhileChecking()
+{
+	TestingDriver driver;
+	TestingTask task(driver);
+	xpcc::rf::Executor executor;
+	executor.add(task);
+
+	driver.signalWhileChecking = true;
+	TEST_ASSERT_TRUE(executor.update());
+	TEST_ASSERT_EQUALS(task.transfers, 0);
+
+	// the signal is not lost
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_EQUALS(task.transfers, 1);
+}
+
+// ----------------------------------------------------------------------------
+class SleepingTask : public xpcc::pt::Protothread, public xpcc::rf::Task
+{
+public:
+	SleepingTask(uint16_t period) :
+		period(period), runs(0), wakeups(0)
+	{
+	}
+
+	bool
+	run()
+	{
+		runs++;
+		PT_BEGIN();
+
+		while (true)
+		{
+			timeout.restart(period);
+			PT_WAIT_TIMEOUT(timeout);
+			wakeups++;
+		}
+
+		PT_END();
+	}
+
+	xpcc::Timeout timeout;
+	uint16_t period;
+	uint16_t runs;
+	uint16_t wakeups;
+};
+
+void
+ExecutorTest::testTimeout()
+{
+	SleepingTask task1(10);
+	SleepingTask task2(25);
+
+	xpcc::rf::Executor executor;
+	executor.add(task1);
+	executor.add(task2);
+	TEST_ASSERT_TRUE(executor.isPending());
+	TEST_ASSERT_EQUALS(executor.remaining(), 0);
+
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_TRUE(executor.isPending());
+	TEST_ASSERT_EQUALS(executor.remaining(), 10);
+
+	for (uint16_t i = 0; i < 50; ++i)
+	{
+		TestingClock::time += 1;
+		executor.update();
+	}
+	TEST_ASSERT_EQUALS(task1.wakeups, 5);
+	TEST_ASSERT_EQUALS(task2.wakeups, 2);
+	TEST_ASSERT_EQUALS(task1.runs, 6);
+	TEST_ASSERT_EQUALS(task2.runs, 3);
+	TEST_ASSERT_EQUALS(executor.remaining(), 10);
+
+	// works with the tickless mode
+	xpcc::Tickless<1> tickless;
+	tickless.add(executor);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 10U);
+}
+
+void
+ExecutorTest::testEventTimeout()
+{
+	TestingDriver driver;
+
+	class TimeoutTask : public xpcc::pt::Protothread, public xpcc::rf::Task
+	{
+	public:
+		TimeoutTask(TestingDriver& driver) :
+			driver(driver), result(false)
+		{
+		}
+
+		bool
+		run()
+		{
+			PT_BEGIN();
+			result = PT_CALL(driver.transfer(20));
+			PT_END();
+		}
+
+		TestingDriver& driver;
+		bool result;
+	} task(driver);
+
+	xpcc::rf::Executor executor;
+	executor.add(task);
+	executor.update();
+	TEST_ASSERT_EQUALS(executor.remaining(), 20);
+
+	TestingClock::time += 19;
+	executor.update();
+	TEST_ASSERT_TRUE(task.isRunning());
+	TEST_ASSERT_EQUALS(driver.checks, 1);
+
+	TestingClock::time += 1;
+	executor.update();
+	TEST_ASSERT_FALSE(task.isRunning());
+	TEST_ASSERT_FALSE(task.result);
+	TEST_ASSERT_FALSE(executor.isPending());
+
+	// the event removes the task from the sleeping tasks
+	task.restart();
+	executor.add(task);
+	executor.update();
+	driver.finish();
+	executor.update();
+	TEST_ASSERT_FALSE(task.isRunning());
+	TEST_ASSERT_TRUE(task.result);
+	TEST_ASSERT_FALSE(executor.isPending());
+}
+
+// ----------------------------------------------------------------------------
+class ConsumerTask : public xpcc::pt::Protothread, public xpcc::rf::Task
+{
+public:
+	ConsumerTask(xpcc::pt::Semaphore& semaphore) :
+		semaphore(semaphore), runs(0), acquired(0)
+	{
+	}
+
+	bool
+	run()
+	{
+		runs++;
+		PT_BEGIN();
+
+		while (true)
+		{
+			PT_WAIT_EVENT_UNTIL(semaphore.getEvent(), semaphore.acquire());
+			acquired++;
+		}
+
+		PT_END();
+	}
+
+	xpcc::pt::Semaphore& semaphore;
+	uint16_t runs;
+	uint16_t acquired;
+};
+
+void
+ExecutorTest::testSemaphore()
+{
+	xpcc::pt::Semaphore semaphore(1);
+	ConsumerTask task1(semaphore);
+	ConsumerTask task2(semaphore);
+
+	xpcc::rf::Executor executor;
+	executor.add(task1);
+	executor.add(task2);
+
+	executor.update();
+	TEST_ASSERT_EQUALS(task1.acquired, 1);
+	TEST_ASSERT_EQUALS(task2.acquired, 0);
+
+	executor.update();
+	executor.update();
+	TEST_ASSERT_EQUALS(task1.runs, 1);
+	TEST_ASSERT_EQUALS(task2.runs, 1);
+
+	// both are woken up, only one gets it
+	semaphore.release();
+	executor.update();
+	TEST_ASSERT_EQUALS(task1.acquired + task2.acquired, 2);
+	TEST_ASSERT_EQUALS(task1.runs, 2);
+	TEST_ASSERT_EQUALS(task2.runs, 2);
+	TEST_ASSERT_TRUE(executor.isIdle());
+}
+
+// ----------------------------------------------------------------------------
+/// Uses the polling macros, executed on every update
+class PollingTask : public xpcc::pt::Protothread, public xpcc::rf::Task
+{
+public:
+	PollingTask() :
+		runs(0), flag(false)
+	{
+	}
+
+	bool
+	run()
+	{
+		runs++;
+		PT_BEGIN();
+		PT_WAIT_UNTIL(flag);
+		PT_END();
+	}
+
+	uint16_t runs;
+	bool flag;
+};
+
+void
+ExecutorTest::testPolling()
+{
+	TestingDriver driver;
+	TestingTask task(driver);
+	PollingTask polling;
+
+	xpcc::rf::Executor executor;
+	executor.add(task);
+	executor.add(polling);
+
+	for (uint8_t i = 0; i < 10; ++i) {
+		TEST_ASSERT_TRUE(executor.update());
+	}
+	TEST_ASSERT_EQUALS(polling.runs, 10);
+	TEST_ASSERT_EQUALS(task.runs, 1);
+
+	polling.flag = true;
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_EQUALS(polling.runs, 11);
+	TEST_ASSERT_FALSE(polling.isRunning());
+}
+
+void
+ExecutorTest::testRemove()
+{
+	TestingDriver driver;
+	TestingTask task1(driver);
+	TestingTask task2(driver);
+	SleepingTask task3(10);
+
+	xpcc::rf::Executor executor;
+	TEST_ASSERT_FALSE(executor.remove(task1));
+
+	executor.add(task1);
+	executor.add(task2);
+	executor.add(task3);
+	TEST_ASSERT_TRUE(executor.remove(task2));
+
+	// task1 waits for the event, task3 sleeps
+	executor.update();
+	TEST_ASSERT_EQUALS(task1.runs, 1);
+	TEST_ASSERT_EQUALS(task2.runs, 0);
+	TEST_ASSERT_EQUALS(task3.runs, 1);
+
+	TEST_ASSERT_TRUE(executor.remove(task1));
+	TEST_ASSERT_TRUE(executor.remove(task3));
+	TEST_ASSERT_FALSE(executor.isPending());
+
+	driver.finish();
+	TestingClock::time += 100;
+	TEST_ASSERT_FALSE(executor.update());
+	TEST_ASSERT_EQUALS(task1.runs, 1);
+	TEST_ASSERT_EQUALS(task3.runs, 1);
+}
@@ -33,3 +33,6 @@
 #include "rtos/mutex.hpp"
 #include "rtos/semaphore.hpp"
 #include "rtos/queue.hpp"
+#include "rtos/event_count.hpp"
+#include "rtos/spsc_queue.hpp"
+#include "rtos/mpmc_queue.hpp"
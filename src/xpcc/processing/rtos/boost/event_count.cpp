@@ -0,0 +1,107 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../event_count.hpp"
+
+#include <chrono>
+
+#ifdef XPCC__OS_LINUX
+#	include <sys/syscall.h>
+#	include <linux/futex.h>
+#	include <time.h>
+#	include <unistd.h>
+#	include <climits>
+
+namespace
+{
+	long
+	futex(std::atomic<uint32_t> *address, int operation, uint32_t value,
+			const timespec *timeout = nullptr)
+	{
+		return syscall(SYS_futex, reinterpret_cast<uint32_t *>(address),
+				operation, value, timeout, nullptr, 0);
+	}
+}
+#endif
+
+constexpr xpcc::rtos::EventCount::Timeout xpcc::rtos::EventCount::infinite;
+
+// ----------------------------------------------------------------------------
+xpcc::rtos::EventCount::EventCount() :
+	epoch(0), waiters(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::rtos::EventCount::wait(uint32_t key, Timeout& timeout)
+{
+	const auto start = std::chrono::steady_clock::now();
+	
+	// mark that a thread sleeps, fails if notify() was called meanwhile
+	const uint32_t sleeping = key | 1;
+	if (key == sleeping || epoch.compare_exchange_strong(key, sleeping,
+			std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+#ifdef XPCC__OS_LINUX
+		if (timeout == infinite) {
+			futex(&epoch, FUTEX_WAIT_PRIVATE, sleeping);
+		}
+		else
+		{
+			timespec time;
+			time.tv_sec = timeout / 1000;
+			time.tv_nsec = (timeout % 1000) * 1000000;
+			futex(&epoch, FUTEX_WAIT_PRIVATE, sleeping, &time);
+		}
+#else
+		boost::unique_lock<boost::mutex> lock(mutex);
+		if (epoch.load(std::memory_order_relaxed) == sleeping)
+		{
+			if (timeout == infinite) {
+				condition.wait(lock);
+			}
+			else {
+				condition.timed_wait(lock, boost::posix_time::milliseconds(timeout));
+			}
+		}
+#endif
+	}
+	waiters.fetch_sub(1, std::memory_order_relaxed);
+	
+	if (timeout != infinite)
+	{
+		// rounded up, so that repeated early returns cannot wait forever
+		const uint32_t elapsed = (std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - start).count() + 999) / 1000;
+		timeout = (elapsed < timeout) ? (timeout - elapsed) : 0;
+	}
+}
+
+void
+xpcc::rtos::EventCount::wake()
+{
+	// a thread which read the old value does not go to sleep anymore
+	uint32_t value = epoch.load(std::memory_order_relaxed);
+	while (!epoch.compare_exchange_weak(value, (value + 2) & ~uint32_t(1),
+			std::memory_order_seq_cst, std::memory_order_relaxed)) {
+	}
+	if ((value & 1) == 0) {
+		return;
+	}
+	
+#ifdef XPCC__OS_LINUX
+	futex(&epoch, FUTEX_WAKE_PRIVATE, INT_MAX);
+#else
+	{
+		// sleeping threads checked the epoch while holding the mutex
+		boost::lock_guard<boost::mutex> lock(mutex);
+	}
+	condition.notify_all();
+#endif
+}
@@ -0,0 +1,130 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_BOOST__EVENT_COUNT_HPP
+#define XPCC_BOOST__EVENT_COUNT_HPP
+
+#ifndef XPCC_RTOS__EVENT_COUNT_HPP
+#	error "Don't include this file directly, use <xpcc/processing/rtos/event_count.hpp>"
+#endif
+
+#include <stdint.h>
+#include <atomic>
+
+#ifndef XPCC__OS_LINUX
+#	include <boost/thread/mutex.hpp>
+#	include <boost/thread/condition_variable.hpp>
+#endif
+
+namespace xpcc
+{
+	namespace rtos
+	{
+		/**
+		 * Lets threads sleep until a lock-free data structure changes.
+		 * 
+		 * The waiting thread registers with prepareWait(), checks its
+		 * condition again and only then calls wait(). A notify() after
+		 * prepareWait() is never lost, wait() returns at once then:
+		 * 
+		 * \code
+		 * while (!queue.tryGet(item))
+		 * {
+		 *     uint32_t key = event.prepareWait();
+		 *     if (queue.tryGet(item)) {
+		 *         event.cancelWait();
+		 *         break;
+		 *     }
+		 *     event.wait(key, timeout);
+		 * }
+		 * \endcode
+		 * 
+		 * notify() costs a memory fence and a load as long as no thread
+		 * waits. Waiting threads sleep in a futex on Linux, on other hosts
+		 * in a condition variable. A thread going to sleep marks the
+		 * epoch, only then notify() makes a system call. It wakes all
+		 * sleeping threads, those which find nothing to do sleep again.
+		 * 
+		 * \ingroup	boost_rtos
+		 */
+		class EventCount
+		{
+		public:
+			/// Timeout in milliseconds
+			typedef uint32_t Timeout;
+			
+			static constexpr Timeout infinite = Timeout(-1);
+			
+			EventCount();
+			
+			/// Register as waiting thread, \return key for wait()
+			inline uint32_t
+			prepareWait()
+			{
+				waiters.fetch_add(1, std::memory_order_seq_cst);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				return epoch.load(std::memory_order_acquire);
+			}
+			
+			/// The condition became true after prepareWait()
+			inline void
+			cancelWait()
+			{
+				waiters.fetch_sub(1, std::memory_order_relaxed);
+			}
+			
+			/**
+			 * Sleep until notify() is called after prepareWait().
+			 * 
+			 * Might return early, the condition has to be checked again.
+			 * 
+			 * \param	timeout	reduced by the time waited
+			 */
+			void
+			wait(uint32_t key, Timeout& timeout);
+			
+			/// Wake the waiting threads
+			inline void
+			notify()
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (waiters.load(std::memory_order_relaxed) != 0) {
+					wake();
+				}
+			}
+			
+			inline void
+			notifyFromInterrupt()
+			{
+				notify();
+			}
+			
+		private:
+			// disable copy constructor
+			EventCount(const EventCount&);
+			
+			// disable assignment operator
+			EventCount&
+			operator = (const EventCount&);
+			
+			void
+			wake();
+			
+			/// Bit 0 is set while threads sleep, incremented in steps of two
+			std::atomic<uint32_t> epoch;
+			std::atomic<uint32_t> waiters;
+			
+#ifndef XPCC__OS_LINUX
+			boost::mutex mutex;
+			boost::condition_variable condition;
+#endif
+		};
+	}
+}
+
+#endif // XPCC_BOOST__EVENT_COUNT_HPP
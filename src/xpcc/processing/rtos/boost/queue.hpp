@@ -36,10 +36,10 @@
 #endif
 
 #include <stdint.h>
-#include <deque>
+#include <cstddef>
 
 #include <boost/thread/mutex.hpp>
-#include <xpcc/container/deque.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 namespace xpcc
 {
@@ -48,6 +48,14 @@ namespace xpcc
 		/**
 		 * Thread-safe Queue.
 		 * 
+		 * Ring buffer of fixed length, allocated once by the constructor.
+		 * All operations take a mutex. append() and prepend() wait until
+		 * space is available, peek() and get() until an item is available,
+		 * at most \p timeout milliseconds.
+		 * 
+		 * If no item has to be prepended or peeked, SpscQueue and MpmcQueue
+		 * are faster, they do not take a lock.
+		 * 
 		 * \ingroup	rtos_boost
 		 */
 		template<typename T>
@@ -101,12 +109,25 @@ namespace xpcc
 			Queue&
 			operator = (const Queue& other);
 			
-			mutable boost::timed_mutex mutex;
+			/// Wait until `condition` is notified and `predicate()` is true
+			template<typename Predicate>
+			static bool
+			wait(boost::unique_lock<boost::mutex>& lock,
+					boost::condition_variable& condition,
+					uint32_t timeout, Predicate predicate);
+			
+			mutable boost::mutex mutex;
+			mutable boost::condition_variable notEmpty;
+			mutable boost::condition_variable notFull;
 			
 			uint32_t maxSize;
-			std::deque<T> deque;
+			uint32_t first;
+			uint32_t size;
+			T *buffer;
 		};
 	}
 }
 
+#include "queue_impl.hpp"
+
 #endif // XPCC_BOOST__QUEUE_HPP
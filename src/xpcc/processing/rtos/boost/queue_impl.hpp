@@ -34,92 +34,112 @@
 
 template <typename T>
 xpcc::rtos::Queue<T>::Queue(uint32_t length) :
-	maxSize(length)
+	maxSize(length), first(0), size(0), buffer(new T[length])
 {
 }
 
 template <typename T>
 xpcc::rtos::Queue<T>::~Queue()
 {
+	delete[] buffer;
+}
+
+template <typename T>
+template <typename Predicate>
+bool
+xpcc::rtos::Queue<T>::wait(boost::unique_lock<boost::mutex>& lock,
+		boost::condition_variable& condition, uint32_t timeout, Predicate predicate)
+{
+	if (timeout == uint32_t(-1)) {
+		condition.wait(lock, predicate);
+		return true;
+	}
+	return condition.timed_wait(lock,
+			boost::posix_time::milliseconds(timeout), predicate);
 }
 
 template <typename T>
 std::size_t
 xpcc::rtos::Queue<T>::getSize() const
 {
-	boost::lock_guard<boost::timed_mutex> lock(mutex);
-	deque.size();
+	boost::lock_guard<boost::mutex> lock(mutex);
+	return size;
 }
 
 template <typename T>
 bool
-xpcc::rtos::Queue<T>::append(const T& item, uint32_t timeout = -1)
+xpcc::rtos::Queue<T>::append(const T& item, uint32_t timeout)
 {
-	if (!mutex.timed_lock(boost::posix_time::milliseconds(timeout)) ||
-			deque.size() >= maxSize) {
-		return false;
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		if (!wait(lock, notFull, timeout, [this]() { return size < maxSize; })) {
+			return false;
+		}
+		
+		uint32_t index = first + size;
+		if (index >= maxSize) {
+			index -= maxSize;
+		}
+		buffer[index] = item;
+		size++;
 	}
-	
-	deque.push_back(item);
-	mutex.unlock();
+	notEmpty.notify_one();
+	return true;
 }
 
 template <typename T>
 bool
-xpcc::rtos::Queue<T>::prepend(const T& item, uint32_t timeout = -1)
+xpcc::rtos::Queue<T>::prepend(const T& item, uint32_t timeout)
 {
-	if (!mutex.timed_lock(boost::posix_time::milliseconds(timeout))) {
-		return false;
-	}
-	
-	if (deque.empty()) {
-		mutex.unlock();
-		return false;
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		if (!wait(lock, notFull, timeout, [this]() { return size < maxSize; })) {
+			return false;
+		}
+		
+		first = (first == 0) ? (maxSize - 1) : (first - 1);
+		buffer[first] = item;
+		size++;
 	}
-	
-	deque.push_front(item);
-	mutex.unlock();
-	
-	return false;
+	notEmpty.notify_one();
+	return true;
 }
 
 // ----------------------------------------------------------------------------
 template <typename T>
 bool
-xpcc::rtos::Queue<T>::peek(T& item, uint32_t timeout = -1) const
+xpcc::rtos::Queue<T>::peek(T& item, uint32_t timeout) const
 {
-	if (!mutex.timed_lock(boost::posix_time::milliseconds(timeout))) {
-		return false;
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		if (!wait(lock, notEmpty, timeout, [this]() { return size > 0; })) {
+			return false;
+		}
+		
+		item = buffer[first];
 	}
-	
-	if (deque.empty()) {
-		mutex.unlock();
-		return false;
-	}
-	
-	item = deque.front();
-	
-	mutex.unlock();
+	// the notification might have been meant for a thread waiting in get()
+	notEmpty.notify_one();
 	return true;
 }
 
 template <typename T>
 bool
-xpcc::rtos::Queue<T>::get(T& item, uint32_t timeout = -1)
+xpcc::rtos::Queue<T>::get(T& item, uint32_t timeout)
 {
-	if (!mutex.timed_lock(boost::posix_time::milliseconds(timeout))) {
-		return false;
-	}
-	
-	if (deque.empty()) {
-		mutex.unlock();
-		return false;
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		if (!wait(lock, notEmpty, timeout, [this]() { return size > 0; })) {
+			return false;
+		}
+		
+		item = buffer[first];
+		if (++first >= maxSize) {
+			first = 0;
+		}
+		size--;
 	}
-	
-	item = deque.front();
-	deque.pop_front();
-	
-	mutex.unlock();
+	notFull.notify_one();
 	return true;
 }
 
@@ -128,19 +148,19 @@ template <typename T>
 inline bool
 xpcc::rtos::Queue<T>::appendFromInterrupt(const T& item)
 {
-	return append(item);
+	return append(item, 0);
 }
 
 template <typename T>
 inline bool
 xpcc::rtos::Queue<T>::prependFromInterrupt(const T& item)
 {
-	return prepend(item);
+	return prepend(item, 0);
 }
 
 template <typename T>
 inline bool
 xpcc::rtos::Queue<T>::getFromInterrupt(T& item)
 {
-	return get(item);
+	return get(item, 0);
 }
@@ -0,0 +1,20 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_RTOS__EVENT_COUNT_HPP
+#define XPCC_RTOS__EVENT_COUNT_HPP
+
+#include <xpcc/architecture/utils.hpp>
+
+#ifdef XPCC__OS_HOSTED
+#	include "boost/event_count.hpp"
+#elif defined(XPCC__CPU_CORTEX_M3) || defined(XPCC__CPU_CORTEX_M4)
+#	include "freertos/event_count.hpp"
+#endif
+
+#endif // XPCC_RTOS__EVENT_COUNT_HPP
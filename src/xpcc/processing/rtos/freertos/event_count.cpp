@@ -0,0 +1,71 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include "../event_count.hpp"
+
+#include <freertos/task.h>
+
+constexpr xpcc::rtos::EventCount::Timeout xpcc::rtos::EventCount::infinite;
+
+// ----------------------------------------------------------------------------
+xpcc::rtos::EventCount::EventCount() :
+	epoch(0), waiters(0)
+{
+	// Surplus counts only cause early returns of wait()
+	this->semaphore = xSemaphoreCreateCounting(0xffff, 0);
+}
+
+xpcc::rtos::EventCount::~EventCount()
+{
+	// As semaphores are based on queues we use the queue functions to delete
+	// the semaphore
+	vQueueDelete(this->semaphore);
+}
+
+// ----------------------------------------------------------------------------
+void
+xpcc::rtos::EventCount::wait(uint32_t key, Timeout& timeout)
+{
+	if (epoch.load(std::memory_order_relaxed) == key)
+	{
+		xTimeOutType start;
+		vTaskSetTimeOutState(&start);
+		
+		xSemaphoreTake(this->semaphore, timeout);
+		
+		if (timeout != infinite &&
+				xTaskCheckForTimeOut(&start, &timeout) == pdTRUE) {
+			timeout = 0;
+		}
+	}
+	waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void
+xpcc::rtos::EventCount::wake()
+{
+	epoch.fetch_add(1, std::memory_order_seq_cst);
+	xSemaphoreGive(this->semaphore);
+}
+
+void
+xpcc::rtos::EventCount::notifyFromInterrupt()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiters.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+	epoch.fetch_add(1, std::memory_order_seq_cst);
+	
+	portBASE_TYPE threadWoken = pdFALSE;
+	xSemaphoreGiveFromISR(this->semaphore, &threadWoken);
+	
+	// Request a context switch when the IRQ ends if a higher priorty has
+	// been woken.
+	portEND_SWITCHING_ISR(threadWoken);
+}
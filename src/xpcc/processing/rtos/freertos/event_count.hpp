@@ -0,0 +1,108 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_FREERTOS__EVENT_COUNT_HPP
+#define XPCC_FREERTOS__EVENT_COUNT_HPP
+
+#ifndef XPCC_RTOS__EVENT_COUNT_HPP
+#	error "Don't include this file directly, use <xpcc/processing/rtos/event_count.hpp>"
+#endif
+
+#include <stdint.h>
+#include <atomic>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace xpcc
+{
+	namespace rtos
+	{
+		/**
+		 * Lets threads sleep until a lock-free data structure changes.
+		 * 
+		 * The waiting thread registers with prepareWait(), checks its
+		 * condition again and only then calls wait(). A notify() after
+		 * prepareWait() is never lost, wait() returns at once then.
+		 * 
+		 * notify() costs a memory barrier and a load as long as no thread
+		 * waits. Waiting threads block on a counting semaphore, which is
+		 * only given when a thread is registered.
+		 * 
+		 * \ingroup	freertos
+		 */
+		class EventCount
+		{
+		public:
+			/// Timeout in scheduler ticks
+			typedef portTickType Timeout;
+			
+			static constexpr Timeout infinite = portMAX_DELAY;
+			
+			EventCount();
+			
+			~EventCount();
+			
+			/// Register as waiting thread, \return key for wait()
+			inline uint32_t
+			prepareWait()
+			{
+				waiters.fetch_add(1, std::memory_order_seq_cst);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				return epoch.load(std::memory_order_acquire);
+			}
+			
+			/// The condition became true after prepareWait()
+			inline void
+			cancelWait()
+			{
+				waiters.fetch_sub(1, std::memory_order_relaxed);
+			}
+			
+			/**
+			 * Block until notify() is called after prepareWait().
+			 * 
+			 * Might return early, the condition has to be checked again.
+			 * 
+			 * \param	timeout	reduced by the time waited
+			 */
+			void
+			wait(uint32_t key, Timeout& timeout);
+			
+			/// Wake one waiting thread
+			inline void
+			notify()
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (waiters.load(std::memory_order_relaxed) != 0) {
+					wake();
+				}
+			}
+			
+			void
+			notifyFromInterrupt();
+			
+		private:
+			// disable copy constructor
+			EventCount(const EventCount&);
+			
+			// disable assignment operator
+			EventCount&
+			operator = (const EventCount&);
+			
+			void
+			wake();
+			
+			std::atomic<uint32_t> epoch;
+			std::atomic<uint32_t> waiters;
+			xSemaphoreHandle semaphore;
+		};
+	}
+}
+
+#endif // XPCC_FREERTOS__EVENT_COUNT_HPP
@@ -0,0 +1,126 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_RTOS__MPMC_QUEUE_HPP
+#define XPCC_RTOS__MPMC_QUEUE_HPP
+
+#include <stdint.h>
+#include <cstddef>
+#include <atomic>
+
+#include "event_count.hpp"
+
+namespace xpcc
+{
+	namespace rtos
+	{
+		/**
+		 * Lock-free bounded queue for any number of producer and consumer
+		 * threads.
+		 * 
+		 * A ring buffer of `N` items, no memory is allocated. Every item
+		 * has a sequence number which tells producers and consumers if it
+		 * is free or filled in the current round. A thread claims an item
+		 * by advancing the shared write or read position with a single
+		 * compare-and-swap, then copies the item and publishes it by
+		 * updating the sequence number.
+		 * 
+		 * A thread suspended between claiming and publishing an item
+		 * delays the consumer of this item, the other items are not
+		 * affected.
+		 * 
+		 * append() and get() block like in SpscQueue, the non-blocking
+		 * path takes no lock and makes no system call. There is no
+		 * prepend() and peek(), use xpcc::rtos::Queue if you need them.
+		 * 
+		 * \tparam	T	item type, must have a default constructor
+		 * \tparam	N	number of items, must be a power of two
+		 * 
+		 * \ingroup	rtos
+		 */
+		template<typename T, std::size_t N>
+		class MpmcQueue
+		{
+			static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two!");
+			static_assert(N <= (1UL << 30), "N must not exceed 2^30!");
+			
+		public:
+			typedef EventCount::Timeout Timeout;
+			
+			MpmcQueue();
+			
+			/// Number of items, only approximate while other threads are active
+			std::size_t
+			getSize() const;
+			
+			static constexpr std::size_t
+			getMaxSize()
+			{
+				return N;
+			}
+			
+			bool
+			isEmpty() const;
+			
+			bool
+			append(const T& item, Timeout timeout = EventCount::infinite);
+			
+			bool
+			get(T& item, Timeout timeout = EventCount::infinite);
+			
+			/// Never blocks
+			bool
+			appendFromInterrupt(const T& item);
+			
+			/// Never blocks
+			bool
+			getFromInterrupt(T& item);
+			
+		private:
+			// disable copy constructor
+			MpmcQueue(const MpmcQueue&);
+			
+			// disable assignment operator
+			MpmcQueue&
+			operator = (const MpmcQueue&);
+			
+			bool
+			tryAppend(const T& item);
+			
+			bool
+			tryGet(T& item);
+			
+			struct Cell
+			{
+				/// position + 1 when filled, position + N when free again
+				std::atomic<uint32_t> sequence;
+				T item;
+			};
+			
+			std::atomic<uint32_t> writePosition;
+#ifdef XPCC__OS_HOSTED
+			// separate cache lines for producers and consumers
+			uint8_t producerPadding[64 - sizeof(uint32_t)];
+#endif
+			
+			std::atomic<uint32_t> readPosition;
+#ifdef XPCC__OS_HOSTED
+			uint8_t consumerPadding[64 - sizeof(uint32_t)];
+#endif
+			
+			EventCount notEmpty;
+			EventCount notFull;
+			
+			Cell cells[N];
+		};
+	}
+}
+
+#include "mpmc_queue_impl.hpp"
+
+#endif // XPCC_RTOS__MPMC_QUEUE_HPP
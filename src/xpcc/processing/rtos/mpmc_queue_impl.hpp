@@ -0,0 +1,168 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_RTOS__MPMC_QUEUE_HPP
+#	error "Don't use this file directly, use 'mpmc_queue.hpp' instead!"
+#endif
+
+template <typename T, std::size_t N>
+xpcc::rtos::MpmcQueue<T, N>::MpmcQueue() :
+	writePosition(0), readPosition(0)
+{
+	for (uint32_t i = 0; i < N; ++i) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template <typename T, std::size_t N>
+std::size_t
+xpcc::rtos::MpmcQueue<T, N>::getSize() const
+{
+	const uint32_t read = readPosition.load(std::memory_order_acquire);
+	const int32_t size = int32_t(writePosition.load(std::memory_order_acquire) - read);
+	if (size < 0) {
+		return 0;
+	}
+	return (std::size_t(size) > N) ? N : size;
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::MpmcQueue<T, N>::isEmpty() const
+{
+	return (getSize() == 0);
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::MpmcQueue<T, N>::tryAppend(const T& item)
+{
+	uint32_t position = writePosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Cell& cell = cells[position & (N - 1)];
+		const int32_t difference = int32_t(
+				cell.sequence.load(std::memory_order_acquire) - position);
+		if (difference == 0)
+		{
+			if (writePosition.compare_exchange_weak(position, position + 1,
+					std::memory_order_relaxed))
+			{
+				cell.item = item;
+				cell.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			// not yet read in the previous round
+			return false;
+		}
+		else {
+			position = writePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::MpmcQueue<T, N>::tryGet(T& item)
+{
+	uint32_t position = readPosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Cell& cell = cells[position & (N - 1)];
+		const int32_t difference = int32_t(
+				cell.sequence.load(std::memory_order_acquire) - (position + 1));
+		if (difference == 0)
+		{
+			if (readPosition.compare_exchange_weak(position, position + 1,
+					std::memory_order_relaxed))
+			{
+				item = cell.item;
+				cell.sequence.store(position + N, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			// not yet written in this round
+			return false;
+		}
+		else {
+			position = readPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::MpmcQueue<T, N>::append(const T& item, Timeout timeout)
+{
+	while (!tryAppend(item))
+	{
+		if (timeout == 0) {
+			return false;
+		}
+		
+		const uint32_t key = notFull.prepareWait();
+		if (tryAppend(item)) {
+			notFull.cancelWait();
+			break;
+		}
+		notFull.wait(key, timeout);
+	}
+	
+	notEmpty.notify();
+	return true;
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::MpmcQueue<T, N>::get(T& item, Timeout timeout)
+{
+	while (!tryGet(item))
+	{
+		if (timeout == 0) {
+			return false;
+		}
+		
+		const uint32_t key = notEmpty.prepareWait();
+		if (tryGet(item)) {
+			notEmpty.cancelWait();
+			break;
+		}
+		notEmpty.wait(key, timeout);
+	}
+	
+	notFull.notify();
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::MpmcQueue<T, N>::appendFromInterrupt(const T& item)
+{
+	if (!tryAppend(item)) {
+		return false;
+	}
+	notEmpty.notifyFromInterrupt();
+	return true;
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::MpmcQueue<T, N>::getFromInterrupt(T& item)
+{
+	if (!tryGet(item)) {
+		return false;
+	}
+	notFull.notifyFromInterrupt();
+	return true;
+}
@@ -0,0 +1,139 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_RTOS__SPSC_QUEUE_HPP
+#define XPCC_RTOS__SPSC_QUEUE_HPP
+
+#include <stdint.h>
+#include <cstddef>
+#include <atomic>
+
+#include "event_count.hpp"
+
+namespace xpcc
+{
+	namespace rtos
+	{
+		/**
+		 * Lock-free bounded queue for one producer and one consumer thread.
+		 * 
+		 * A ring buffer of `N` items, no memory is allocated. The producer
+		 * only writes the head index, the consumer only the tail index.
+		 * Both keep a copy of the other index and only read the shared one
+		 * if the copy says the queue is full or empty, so the cache lines
+		 * move between the cores only once per batch of items.
+		 * 
+		 * append() and get() block until there is space or an item, at
+		 * most \p timeout (milliseconds with boost, ticks with FreeRTOS).
+		 * With a timeout of zero they return at once. Threads sleep in an
+		 * xpcc::rtos::EventCount, the non-blocking path takes no lock and
+		 * makes no system call.
+		 * 
+		 * \code
+		 * xpcc::rtos::SpscQueue<Sample, 64> queue;
+		 * 
+		 * // producer thread
+		 * queue.append(sample);
+		 * 
+		 * // consumer thread
+		 * Sample sample;
+		 * if (queue.get(sample, 100)) {
+		 *     ...
+		 * }
+		 * \endcode
+		 * 
+		 * \warning	Only one thread may call append() and one thread
+		 * 			get() and peek(). Use MpmcQueue otherwise.
+		 * 
+		 * \tparam	T	item type, must have a default constructor
+		 * \tparam	N	number of items, must be a power of two
+		 * 
+		 * \ingroup	rtos
+		 */
+		template<typename T, std::size_t N>
+		class SpscQueue
+		{
+			static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two!");
+			static_assert(N <= (1UL << 31), "N must not exceed 2^31!");
+			
+		public:
+			typedef EventCount::Timeout Timeout;
+			
+			SpscQueue();
+			
+			/// Number of items, only approximate while the other thread is active
+			std::size_t
+			getSize() const;
+			
+			static constexpr std::size_t
+			getMaxSize()
+			{
+				return N;
+			}
+			
+			bool
+			isEmpty() const;
+			
+			bool
+			append(const T& item, Timeout timeout = EventCount::infinite);
+			
+			/// Copy the oldest item without removing it, never blocks
+			bool
+			peek(T& item) const;
+			
+			bool
+			get(T& item, Timeout timeout = EventCount::infinite);
+			
+			/// Never blocks
+			bool
+			appendFromInterrupt(const T& item);
+			
+			/// Never blocks
+			bool
+			getFromInterrupt(T& item);
+			
+		private:
+			// disable copy constructor
+			SpscQueue(const SpscQueue&);
+			
+			// disable assignment operator
+			SpscQueue&
+			operator = (const SpscQueue&);
+			
+			bool
+			tryAppend(const T& item);
+			
+			bool
+			tryGet(T& item);
+			
+			// written by the producer
+			std::atomic<uint32_t> head;
+			uint32_t cachedTail;
+#ifdef XPCC__OS_HOSTED
+			// separate cache lines for producer and consumer
+			uint8_t producerPadding[64 - 2 * sizeof(uint32_t)];
+#endif
+			
+			// written by the consumer
+			std::atomic<uint32_t> tail;
+			uint32_t cachedHead;
+#ifdef XPCC__OS_HOSTED
+			uint8_t consumerPadding[64 - 2 * sizeof(uint32_t)];
+#endif
+			
+			EventCount notEmpty;
+			EventCount notFull;
+			
+			T buffer[N];
+		};
+	}
+}
+
+#include "spsc_queue_impl.hpp"
+
+#endif // XPCC_RTOS__SPSC_QUEUE_HPP
@@ -0,0 +1,149 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_RTOS__SPSC_QUEUE_HPP
+#	error "Don't use this file directly, use 'spsc_queue.hpp' instead!"
+#endif
+
+template <typename T, std::size_t N>
+xpcc::rtos::SpscQueue<T, N>::SpscQueue() :
+	head(0), cachedTail(0), tail(0), cachedHead(0)
+{
+}
+
+template <typename T, std::size_t N>
+std::size_t
+xpcc::rtos::SpscQueue<T, N>::getSize() const
+{
+	return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::isEmpty() const
+{
+	return (getSize() == 0);
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::tryAppend(const T& item)
+{
+	const uint32_t position = head.load(std::memory_order_relaxed);
+	if (position - cachedTail == N)
+	{
+		cachedTail = tail.load(std::memory_order_acquire);
+		if (position - cachedTail == N) {
+			return false;
+		}
+	}
+	
+	buffer[position & (N - 1)] = item;
+	head.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::tryGet(T& item)
+{
+	const uint32_t position = tail.load(std::memory_order_relaxed);
+	if (position == cachedHead)
+	{
+		cachedHead = head.load(std::memory_order_acquire);
+		if (position == cachedHead) {
+			return false;
+		}
+	}
+	
+	item = buffer[position & (N - 1)];
+	tail.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::append(const T& item, Timeout timeout)
+{
+	while (!tryAppend(item))
+	{
+		if (timeout == 0) {
+			return false;
+		}
+		
+		const uint32_t key = notFull.prepareWait();
+		if (tryAppend(item)) {
+			notFull.cancelWait();
+			break;
+		}
+		notFull.wait(key, timeout);
+	}
+	
+	notEmpty.notify();
+	return true;
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::peek(T& item) const
+{
+	const uint32_t position = tail.load(std::memory_order_relaxed);
+	if (position == head.load(std::memory_order_acquire)) {
+		return false;
+	}
+	
+	item = buffer[position & (N - 1)];
+	return true;
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::get(T& item, Timeout timeout)
+{
+	while (!tryGet(item))
+	{
+		if (timeout == 0) {
+			return false;
+		}
+		
+		const uint32_t key = notEmpty.prepareWait();
+		if (tryGet(item)) {
+			notEmpty.cancelWait();
+			break;
+		}
+		notEmpty.wait(key, timeout);
+	}
+	
+	notFull.notify();
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::appendFromInterrupt(const T& item)
+{
+	if (!tryAppend(item)) {
+		return false;
+	}
+	notEmpty.notifyFromInterrupt();
+	return true;
+}
+
+template <typename T, std::size_t N>
+bool
+xpcc::rtos::SpscQueue<T, N>::getFromInterrupt(T& item)
+{
+	if (!tryGet(item)) {
+		return false;
+	}
+	notFull.notifyFromInterrupt();
+	return true;
+}
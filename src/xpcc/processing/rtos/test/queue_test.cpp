@@ -0,0 +1,237 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <xpcc/processing/rtos.hpp>
+
+#include "queue_test.hpp"
+
+namespace
+{
+	template< typename Queue >
+	void
+	checkRounds(unittest::TestSuite&, Queue& queue)
+	{
+		// several rounds through the ring buffer with different fill levels
+		uint32_t appended = 0;
+		uint32_t received = 0;
+		for (uint8_t round = 0; round < 10; ++round)
+		{
+			for (uint8_t i = 0; i < 3; ++i) {
+				TEST_ASSERT_TRUE(queue.append(appended++, 0));
+			}
+			TEST_ASSERT_EQUALS(queue.getSize(), 3U);
+			for (uint8_t i = 0; i < 3; ++i)
+			{
+				uint32_t item = 0;
+				TEST_ASSERT_TRUE(queue.get(item, 0));
+				TEST_ASSERT_EQUALS(item, received++);
+			}
+			TEST_ASSERT_TRUE(queue.isEmpty());
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+void
+QueueTest::testQueue()
+{
+	xpcc::rtos::Queue<uint32_t> queue(3);
+	TEST_ASSERT_EQUALS(queue.getSize(), 0U);
+
+	uint32_t item = 0;
+	TEST_ASSERT_FALSE(queue.get(item, 0));
+	TEST_ASSERT_FALSE(queue.peek(item, 0));
+
+	TEST_ASSERT_TRUE(queue.append(2));
+	TEST_ASSERT_TRUE(queue.append(3));
+	TEST_ASSERT_TRUE(queue.prepend(1));
+	TEST_ASSERT_EQUALS(queue.getSize(), 3U);
+	TEST_ASSERT_FALSE(queue.append(4, 0));
+	TEST_ASSERT_FALSE(queue.prependFromInterrupt(0));
+
+	TEST_ASSERT_TRUE(queue.peek(item));
+	TEST_ASSERT_EQUALS(item, 1U);
+	for (uint32_t i = 1; i <= 3; ++i)
+	{
+		TEST_ASSERT_TRUE(queue.get(item));
+		TEST_ASSERT_EQUALS(item, i);
+	}
+	TEST_ASSERT_FALSE(queue.getFromInterrupt(item));
+
+	// wrap around at the front
+	TEST_ASSERT_TRUE(queue.prepend(5));
+	TEST_ASSERT_TRUE(queue.prepend(4));
+	TEST_ASSERT_TRUE(queue.appendFromInterrupt(6));
+	for (uint32_t i = 4; i <= 6; ++i)
+	{
+		TEST_ASSERT_TRUE(queue.get(item));
+		TEST_ASSERT_EQUALS(item, i);
+	}
+}
+
+void
+QueueTest::testSpscQueue()
+{
+	xpcc::rtos::SpscQueue<uint32_t, 4> queue;
+	TEST_ASSERT_EQUALS(queue.getMaxSize(), 4U);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+
+	uint32_t item = 0;
+	TEST_ASSERT_FALSE(queue.get(item, 0));
+	TEST_ASSERT_FALSE(queue.peek(item));
+
+	for (uint32_t i = 0; i < 4; ++i) {
+		TEST_ASSERT_TRUE(queue.append(i));
+	}
+	TEST_ASSERT_FALSE(queue.append(4, 0));
+	TEST_ASSERT_FALSE(queue.appendFromInterrupt(4));
+	TEST_ASSERT_EQUALS(queue.getSize(), 4U);
+
+	TEST_ASSERT_TRUE(queue.peek(item));
+	TEST_ASSERT_EQUALS(item, 0U);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		TEST_ASSERT_TRUE(queue.getFromInterrupt(item));
+		TEST_ASSERT_EQUALS(item, i);
+	}
+	TEST_ASSERT_FALSE(queue.getFromInterrupt(item));
+
+	checkRounds(*this, queue);
+}
+
+void
+QueueTest::testMpmcQueue()
+{
+	xpcc::rtos::MpmcQueue<uint32_t, 4> queue;
+	TEST_ASSERT_EQUALS(queue.getMaxSize(), 4U);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+
+	uint32_t item = 0;
+	TEST_ASSERT_FALSE(queue.get(item, 0));
+
+	for (uint32_t i = 0; i < 4; ++i) {
+		TEST_ASSERT_TRUE(queue.append(i));
+	}
+	TEST_ASSERT_FALSE(queue.append(4, 0));
+	TEST_ASSERT_FALSE(queue.appendFromInterrupt(4));
+	TEST_ASSERT_EQUALS(queue.getSize(), 4U);
+
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		TEST_ASSERT_TRUE(queue.getFromInterrupt(item));
+		TEST_ASSERT_EQUALS(item, i);
+	}
+	TEST_ASSERT_FALSE(queue.getFromInterrupt(item));
+
+	checkRounds(*this, queue);
+}
+
+void
+QueueTest::testTimeout()
+{
+	xpcc::rtos::SpscQueue<uint32_t, 2> spsc;
+	xpcc::rtos::MpmcQueue<uint32_t, 2> mpmc;
+	xpcc::rtos::Queue<uint32_t> queue(2);
+
+	uint32_t item;
+	auto start = std::chrono::steady_clock::now();
+	TEST_ASSERT_FALSE(spsc.get(item, 20));
+	TEST_ASSERT_FALSE(mpmc.get(item, 20));
+	TEST_ASSERT_FALSE(queue.get(item, 20));
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	TEST_ASSERT_TRUE(elapsed >= std::chrono::milliseconds(60));
+	TEST_ASSERT_TRUE(elapsed < std::chrono::milliseconds(1000));
+
+	// an item appended while waiting is received
+	std::thread producer([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		spsc.append(7);
+	});
+	TEST_ASSERT_TRUE(spsc.get(item, 1000));
+	TEST_ASSERT_EQUALS(item, 7U);
+	producer.join();
+
+	// blocked by a full queue until the consumer gets an item
+	mpmc.append(1);
+	mpmc.append(2);
+	std::thread consumer([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		uint32_t item;
+		mpmc.get(item);
+	});
+	TEST_ASSERT_TRUE(mpmc.append(3, 1000));
+	consumer.join();
+	TEST_ASSERT_EQUALS(mpmc.getSize(), 2U);
+}
+
+void
+QueueTest::testSpscThreads()
+{
+	static constexpr uint32_t items = 100000;
+	xpcc::rtos::SpscQueue<uint32_t, 8> queue;
+
+	std::thread producer([&]() {
+		for (uint32_t i = 0; i < items; ++i) {
+			queue.append(i);
+		}
+	});
+
+	uint32_t errors = 0;
+	for (uint32_t i = 0; i < items; ++i)
+	{
+		uint32_t item = 0;
+		if (!queue.get(item, 1000) || item != i) {
+			errors++;
+		}
+	}
+	producer.join();
+
+	TEST_ASSERT_EQUALS(errors, 0U);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+}
+
+void
+QueueTest::testMpmcThreads()
+{
+	static constexpr uint32_t threads = 4;
+	static constexpr uint32_t items = 25000;
+	xpcc::rtos::MpmcQueue<uint32_t, 8> queue;
+
+	std::atomic<uint64_t> sum(0);
+	std::atomic<uint32_t> received(0);
+	std::vector<std::thread> workers;
+	for (uint32_t t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&, t]() {
+			for (uint32_t i = 0; i < items; ++i) {
+				queue.append(t * items + i + 1);
+			}
+		});
+		workers.emplace_back([&]() {
+			uint32_t item;
+			while (queue.get(item, 200)) {
+				sum += item;
+				received++;
+			}
+		});
+	}
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+
+	// every item is received exactly once
+	const uint64_t total = uint64_t(threads * items);
+	TEST_ASSERT_EQUALS(received.load(), threads * items);
+	TEST_ASSERT_TRUE(sum.load() == total * (total + 1) / 2);
+	TEST_ASSERT_TRUE(queue.isEmpty());
+}
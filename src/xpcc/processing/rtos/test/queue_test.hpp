@@ -0,0 +1,31 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <unittest/testsuite.hpp>
+
+class QueueTest : public unittest::TestSuite
+{
+public:
+	void
+	testQueue();
+
+	void
+	testSpscQueue();
+
+	void
+	testMpmcQueue();
+
+	void
+	testTimeout();
+
+	void
+	testSpscThreads();
+
+	void
+	testMpmcThreads();
+};
@@ -30,35 +30,98 @@
 
 #include "scheduler.hpp"
 
+// ----------------------------------------------------------------------------
+xpcc::Scheduler::Task::Task() :
+	nextTimer(0), previousTimer(0), nextReady(0),
+	period(0), expires(0), priority(0), state(IDLE)
+{
+}
+
 // ----------------------------------------------------------------------------
 xpcc::Scheduler::Scheduler() :
-	taskList(0), readyList(0), currentPriority(0)
+	wheel(), readyQueue(), readyMap(0), tick(0), currentPriority(0)
 {
 }
 
 // ----------------------------------------------------------------------------
-void
+bool
 xpcc::Scheduler::scheduleTask(Task& task,
 		uint16_t period,
 		Priority priority)
 {
-	TaskListItem *item = new TaskListItem(task, period, priority);
-	
-	if (taskList == 0) {
-		taskList = item;
+	atomic::Lock lock;
+
+	if (task.state != Task::IDLE) {
+		return false;
+	}
+
+	task.period = period;
+	task.priority = priority;
+	task.state = Task::WAITING;
+
+	// executed on the period-th call of schedule() from now on
+	task.expires = tick + period - 1;
+	addTimer(&task);
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::Scheduler::removeTask(Task& task)
+{
+	atomic::Lock lock;
+
+	if (task.state == Task::IDLE) {
+		return false;
+	}
+
+	if (task.state == Task::READY) {
+		removeReady(&task);
+	}
+	removeTimer(&task);
+	task.state = Task::IDLE;
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+bool
+xpcc::Scheduler::setPriority(Task& task, Priority priority)
+{
+	atomic::Lock lock;
+
+	if (task.state == Task::IDLE) {
+		return false;
+	}
+
+	if (task.state == Task::READY)
+	{
+		removeReady(&task);
+		task.priority = priority;
+		addReady(&task);
 	}
 	else {
-		item->nextTask = taskList;
-		taskList = item;
+		task.priority = priority;
 	}
+	return true;
 }
 
 // ----------------------------------------------------------------------------
-/*bool
-xpcc::Scheduler::removeTask(const Task& task)
+void
+xpcc::Scheduler::removeReady(Task *task)
 {
+	const uint8_t level = getReadyLevel(task->priority);
+
+	Task **position = &readyQueue[level];
+	while (*position != task) {
+		position = &(*position)->nextReady;
+	}
+	*position = task->nextReady;
+
+	if (readyQueue[level] == 0) {
+		readyMap &= ~(uint32_t(1) << level);
+	}
+	task->state = Task::WAITING;
 }
-*/
 
 // ----------------------------------------------------------------------------
 void
@@ -66,3 +129,51 @@ xpcc::Scheduler::schedule()
 {
 	this->scheduleInterupt();
 }
+
+void
+xpcc::Scheduler::schedule(uint32_t ticks)
+{
+	atomic::Lock lock;
+
+	while (ticks-- > 0) {
+		updateTimers();
+	}
+	runReadyTasks();
+}
+
+// ----------------------------------------------------------------------------
+uint32_t
+xpcc::Scheduler::getTicksUntilNextTask() const
+{
+	atomic::Lock lock;
+
+	uint32_t ticks = 0;
+	for (uint8_t level = 0; level < wheelLevels; ++level)
+	{
+		// The slots of a level expire in order, starting with the current
+		// one. The current slot of the other levels is cascaded with the
+		// tick processed next if the indices of all lower levels are zero,
+		// otherwise it was already cascaded and is skipped.
+		const uint8_t current = (tick >> (slotBits * level)) & slotMask;
+		const uint16_t lowerBits = (uint16_t(1) << (slotBits * level)) - 1;
+		const uint8_t first = ((tick & lowerBits) == 0) ? 0 : 1;
+		for (uint8_t i = first; i < first + slotsPerLevel; ++i)
+		{
+			const Task *task = wheel[level][(current + i) & slotMask];
+			if (task == 0) {
+				continue;
+			}
+
+			// only the tasks in the first used slot can expire first
+			for (; task != 0; task = task->nextTimer)
+			{
+				const uint32_t remaining = uint16_t(task->expires - tick) + uint32_t(1);
+				if (ticks == 0 || remaining < ticks) {
+					ticks = remaining;
+				}
+			}
+			break;
+		}
+	}
+	return ticks;
+}
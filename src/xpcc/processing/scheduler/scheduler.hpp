@@ -48,6 +48,22 @@ namespace xpcc
 	 * with the highest priority is executed. It will only change tasks if a
 	 * task with a higher priority becomes ready or the current task ends.
 	 *
+	 * The waiting tasks are kept in a hierarchical timer wheel with four
+	 * levels of 16 slots, each level covering 16 times the period of the
+	 * previous one. A tick only looks at the tasks in one slot of the first
+	 * level, every 16th tick the tasks of one slot of the next level are
+	 * moved down. The cost of a tick is therefore independent of the number
+	 * of waiting tasks.
+	 *
+	 * Ready tasks are queued in 32 priority levels (`priority / 8`), a
+	 * bitmap marks the levels with ready tasks. Inside a level the tasks
+	 * are ordered by priority, tasks with the same priority in the order
+	 * they became ready.
+	 *
+	 * The scheduler does not allocate memory, all bookkeeping is stored in
+	 * the tasks. A task may only be scheduled by one scheduler at a time.
+	 * Tasks with priority zero are never executed.
+	 *
 	 * \image	html	scheduler.png
 	 *
 	 * \warning	Works for ATmega, but currently not for the ATxmega!
@@ -66,58 +82,151 @@ namespace xpcc
 		class Task
 		{
 		public:
+			Task();
+
 			virtual void
 			run() = 0;
+
+		private:
+			friend class Scheduler;
+
+			Task(const Task&) = delete;
+
+			Task&
+			operator = (const Task&) = delete;
+
+			/// @cond
+			enum State : uint8_t
+			{
+				IDLE,		///< not scheduled
+				WAITING,
+				READY,
+				RUNNING
+			};
+			/// @endcond
+
+			Task *nextTimer;
+			Task **previousTimer;	///< pointer to the slot or the `nextTimer` pointing to this task
+			Task *nextReady;
+
+			uint16_t period;
+			uint16_t expires;		///< tick of the next execution
+			Priority priority;
+			State state;
 		};
 
 	public:
 		Scheduler();
 
-		void
+		/**
+		 * Execute \p task every \p period calls of schedule().
+		 *
+		 * A period of zero is equivalent to 65536.
+		 *
+		 * \return	\c false if the task is already scheduled
+		 */
+		bool
 		scheduleTask(Task& task,
 					 uint16_t period,
 					 Priority priority = 127);
 
-		// TODO	Implement this function
-		/*bool
-		removeTask(const Task& task);*/
+		/**
+		 * Stop executing \p task.
+		 *
+		 * A task may remove itself. If it is currently ready it is not
+		 * executed anymore.
+		 *
+		 * \return	\c false if the task was not scheduled
+		 */
+		bool
+		removeTask(Task& task);
+
+		/**
+		 * Change the priority of a scheduled task.
+		 *
+		 * Takes effect on the next execution of the task, or at once if
+		 * the task is ready.
+		 *
+		 * \return	\c false if the task was not scheduled
+		 */
+		bool
+		setPriority(Task& task, Priority priority);
 
 		void
 		schedule();
 
+		/**
+		 * Process \p ticks ticks at once.
+		 *
+		 * Used when the tick interrupt was disabled while the core was
+		 * sleeping, see xpcc::GenericTickless. The tasks expiring
+		 * during these ticks are executed once, in the order of their
+		 * priority.
+		 */
+		void
+		schedule(uint32_t ticks);
+
 		xpcc_always_inline void
 		scheduleInterupt();
 
+		/**
+		 * Number of calls of schedule() until the next task becomes ready.
+		 *
+		 * \return	1 to 65536, or 0 if no task is scheduled
+		 */
+		uint32_t
+		getTicksUntilNextTask() const;
+
 	private:
-		struct TaskListItem
+		static constexpr uint8_t wheelLevels = 4;
+		static constexpr uint8_t slotBits = 4;
+		static constexpr uint8_t slotsPerLevel = 1 << slotBits;
+		static constexpr uint8_t slotMask = slotsPerLevel - 1;
+		static constexpr uint8_t readyLevels = 32;
+
+		static_assert(wheelLevels * slotBits == 16,
+				"The timer wheel must cover the range of the period");
+
+		/// Insert the task into the wheel according to `task->expires`
+		inline void
+		addTimer(Task *task);
+
+		inline void
+		removeTimer(Task *task);
+
+		/// Move the tasks of the current slot of \p level to the lower levels
+		inline uint8_t
+		cascade(uint8_t level);
+
+		/// Advance the wheel by one tick and queue the expired tasks
+		inline void
+		updateTimers();
+
+		inline void
+		runReadyTasks();
+
+		inline void
+		addReady(Task *task);
+
+		void
+		removeReady(Task *task);
+
+		static inline uint8_t
+		getReadyLevel(Priority priority)
 		{
-			TaskListItem(Task& task,
-						 uint16_t period,
-						 Priority priority) :
-				nextTask(0), nextReady(0), task(task),
-				period(period), time(period), priority(priority),
-				state(WAITING)
-			{
-			}
+			return priority >> 3;
+		}
 
-			TaskListItem *nextTask;
-			TaskListItem *nextReady;
+		/// Highest level with ready tasks, `readyMap` must not be zero
+		inline uint8_t
+		getHighestReadyLevel() const;
 
-			Task& task;
-			uint16_t period;
-			uint16_t time;
-			Priority priority;
-			/// @cond
-			enum {
-				RUNNING,
-				READY,
-				WAITING
-			} state;
-			/// @endcond
-		};
+		Task *wheel[wheelLevels][slotsPerLevel];
+		Task *readyQueue[readyLevels];
+		uint32_t readyMap;
 
-		TaskListItem *taskList;
-		TaskListItem *readyList;
+		/// Tick processed by the next call of schedule()
+		uint16_t tick;
 
 		Priority currentPriority;
 	};
@@ -32,79 +32,168 @@
 	#error	"Don't include this file directly, use 'scheduler.hpp' instead!"
 #endif
 
-/* item is element of two lists (schedule list and ready list).
- * ready list is order by its priority.
- * 
+/* Every task is element of two lists, a slot of the timer wheel and
+ * possibly the ready queue of its priority level.
+ *
  * ALGORITHM:
  * ----------------------------------------------------------------------------
- * foreach item
- *     decrement
- *     if time = 0
- *         reload time
- *         set as ready
- * 
- * foreach item is ready (ordered by priority)
+ * if slot index of level 0 wrapped around
+ *     move tasks of the current slot of level 1 (2, 3) down
+ *
+ * foreach item in current slot of level 0
+ *     reinsert with next expiry time
+ *     set as ready
+ *
+ * while highest ready priority > current priority
  *     run item
  *     mark as waiting
  * ----------------------------------------------------------------------------
  */
 inline void
-xpcc::Scheduler::scheduleInterupt()
+xpcc::Scheduler::addTimer(Task *task)
+{
+	// Distance to the tick processed next. Tasks expiring on this tick
+	// are processed with it, even if it was already cascaded.
+	const uint16_t delta = task->expires - tick;
+	uint8_t level = 0;
+	while (level < (wheelLevels - 1) &&
+			delta >= (uint16_t(1) << (slotBits * (level + 1)))) {
+		level++;
+	}
+
+	Task **slot = &wheel[level][(task->expires >> (slotBits * level)) & slotMask];
+	task->nextTimer = *slot;
+	if (task->nextTimer != 0) {
+		task->nextTimer->previousTimer = &task->nextTimer;
+	}
+	task->previousTimer = slot;
+	*slot = task;
+}
+
+inline void
+xpcc::Scheduler::removeTimer(Task *task)
+{
+	*task->previousTimer = task->nextTimer;
+	if (task->nextTimer != 0) {
+		task->nextTimer->previousTimer = task->previousTimer;
+	}
+}
+
+inline uint8_t
+xpcc::Scheduler::cascade(uint8_t level)
 {
-	if (taskList == 0) {
-		// nothing to schedule right now
-		return;
+	const uint8_t index = (tick >> (slotBits * level)) & slotMask;
+
+	Task *task = wheel[level][index];
+	wheel[level][index] = 0;
+	while (task != 0)
+	{
+		Task *next = task->nextTimer;
+		addTimer(task);
+		task = next;
+	}
+	return index;
+}
+
+inline void
+xpcc::Scheduler::addReady(Task *task)
+{
+	const uint8_t level = getReadyLevel(task->priority);
+
+	// only tasks of the same level are compared, usually none
+	Task **position = &readyQueue[level];
+	while ((*position != 0) && ((*position)->priority >= task->priority)) {
+		position = &(*position)->nextReady;
 	}
-	
-	// update all tasks
-	TaskListItem *item = taskList;
-	do {
-		item->time--;
-		if (item->time == 0) {
-			item->time = item->period;
-			
-			// add to ready list
-			if ((readyList == 0) ||
-				(readyList->priority < item->priority))
-			{
-				item->nextReady = readyList;
-				readyList = item;
-			}
-			else {
-				TaskListItem *list = readyList;
-				
-				while (1)
-				{
-					if ((list->nextReady == 0) ||
-						(list->nextReady->priority < item->priority))
-					{
-						item->nextReady = list->nextReady;
-						list->nextReady = item;
-						break;
-					}
-					list = list->nextReady;
-				}
-			}
-			item->state = TaskListItem::READY;
+	task->nextReady = *position;
+	*position = task;
+
+	readyMap |= uint32_t(1) << level;
+	task->state = Task::READY;
+}
+
+inline uint8_t
+xpcc::Scheduler::getHighestReadyLevel() const
+{
+	// unsigned long has at least 32 bits
+	return (sizeof(unsigned long) * 8 - 1) - __builtin_clzl(readyMap);
+}
+
+// ----------------------------------------------------------------------------
+inline void
+xpcc::Scheduler::updateTimers()
+{
+	const uint8_t index = tick & slotMask;
+	if (index == 0)
+	{
+		// the remaining levels only need to be checked if the index
+		// of the previous level wrapped around
+		uint8_t level = 1;
+		while (level < wheelLevels && cascade(level) == 0) {
+			level++;
 		}
 	}
-	while ((item = item->nextTask) != 0);
-	
-	// now execute the tasks which are ready
-	while (((item = xpcc::accessor::asVolatile(readyList)) != 0) &&
-			(item->priority > currentPriority))
+	tick++;
+
+	Task *item = wheel[0][index];
+	wheel[0][index] = 0;
+	while (item != 0)
 	{
-		item->state = TaskListItem::RUNNING;
-		readyList = item->nextReady;
+		Task *next = item->nextTimer;
+
+		item->expires += item->period;
+		addTimer(item);
+
+		// a task which is still waiting to be executed is not queued twice
+		if (item->state != Task::READY) {
+			addReady(item);
+		}
+		item = next;
+	}
+}
+
+inline void
+xpcc::Scheduler::runReadyTasks()
+{
+	Task *item;
+	while (xpcc::accessor::asVolatile(readyMap) != 0)
+	{
+		const uint8_t level = getHighestReadyLevel();
+		item = readyQueue[level];
+		if (item->priority <= currentPriority) {
+			break;
+		}
+
+		readyQueue[level] = item->nextReady;
+		if (readyQueue[level] == 0) {
+			readyMap &= ~(uint32_t(1) << level);
+		}
+
+		item->state = Task::RUNNING;
+		const Priority previousPriority = currentPriority;
 		currentPriority = item->priority;
 		{
-			xpcc::atomic::Unlock();
-			
+			xpcc::atomic::Unlock unlock;
+
 			// the actual execution of the task happens with interrupts
 			// enabled
-			item->task.run();
+			item->run();
+		}
+		currentPriority = previousPriority;
+
+		// the task might have been removed or become ready again
+		if (item->state == Task::RUNNING) {
+			item->state = Task::WAITING;
 		}
-		currentPriority = 0;
-		item->state = TaskListItem::WAITING;
 	}
 }
+
+// ----------------------------------------------------------------------------
+inline void
+xpcc::Scheduler::scheduleInterupt()
+{
+	updateTimers();
+
+	// now execute the tasks which are ready
+	runReadyTasks();
+}
@@ -107,3 +107,271 @@ SchedulerTest::testScheduler()
 	TEST_ASSERT_EQUALS(task3.order, 3);
 	TEST_ASSERT_EQUALS(task4.order, 1);
 }
+
+// ----------------------------------------------------------------------------
+
+class CountingTask : public xpcc::Scheduler::Task
+{
+public:
+	CountingTask() :
+		runs(0), lastRun(0), errors(0), period(0), tick(0)
+	{
+	}
+
+	virtual void
+	run()
+	{
+		if (*tick != lastRun + period) {
+			errors++;
+		}
+		lastRun = *tick;
+		runs++;
+	}
+
+	uint32_t runs;
+	uint32_t lastRun;
+	uint32_t errors;
+	uint32_t period;
+	const uint32_t *tick;
+};
+
+void
+SchedulerTest::testPeriods()
+{
+	// covers every level of the timer wheel and the transitions between them
+	static const uint16_t periods[] = {
+		1, 2, 15, 16, 17, 100, 255, 256, 257, 1000, 4095, 4096, 4097,
+		10000, 40000, 65535, 0
+	};
+	static const uint8_t numberOfTasks = sizeof(periods) / sizeof(periods[0]);
+
+	xpcc::Scheduler scheduler;
+	CountingTask tasks[numberOfTasks];
+
+	uint32_t tick = 0;
+	for (uint8_t i = 0; i < numberOfTasks; ++i)
+	{
+		tasks[i].period = (periods[i] == 0) ? 65536 : periods[i];
+		tasks[i].tick = &tick;
+		TEST_ASSERT_TRUE(scheduler.scheduleTask(tasks[i], periods[i], i + 1));
+	}
+	TEST_ASSERT_FALSE(scheduler.scheduleTask(tasks[0], 10));
+
+	// more than two turns of the outermost level
+	const uint32_t ticks = 140000;
+	for (tick = 1; tick <= ticks; ++tick) {
+		scheduler.schedule();
+	}
+
+	for (uint8_t i = 0; i < numberOfTasks; ++i)
+	{
+		TEST_ASSERT_EQUALS(tasks[i].errors, 0U);
+		TEST_ASSERT_EQUALS(tasks[i].runs, ticks / tasks[i].period);
+	}
+}
+
+void
+SchedulerTest::testRemoveTask()
+{
+	xpcc::Scheduler scheduler;
+
+	uint32_t tick = 0;
+	CountingTask task1;
+	CountingTask task2;
+	task1.tick = &tick;
+	task2.tick = &tick;
+	task1.period = 300;
+	task2.period = 300;
+
+	TEST_ASSERT_FALSE(scheduler.removeTask(task1));
+
+	scheduler.scheduleTask(task1, 300);
+	scheduler.scheduleTask(task2, 300);
+	for (tick = 1; tick < 300; ++tick) {
+		scheduler.schedule();
+	}
+
+	TEST_ASSERT_TRUE(scheduler.removeTask(task1));
+	TEST_ASSERT_FALSE(scheduler.removeTask(task1));
+
+	for (; tick <= 600; ++tick) {
+		scheduler.schedule();
+	}
+	TEST_ASSERT_EQUALS(task1.runs, 0U);
+	TEST_ASSERT_EQUALS(task2.runs, 2U);
+
+	// a removed task can be scheduled again
+	task1.lastRun = 600;
+	task1.period = 5;
+	TEST_ASSERT_TRUE(scheduler.scheduleTask(task1, 5));
+	for (; tick <= 610; ++tick) {
+		scheduler.schedule();
+	}
+	TEST_ASSERT_EQUALS(task1.runs, 2U);
+	TEST_ASSERT_EQUALS(task1.errors, 0U);
+}
+
+// ----------------------------------------------------------------------------
+
+/// Changes the priority of another task or removes it while running
+class ModifyingTask : public xpcc::Scheduler::Task
+{
+public:
+	ModifyingTask(xpcc::Scheduler& scheduler, xpcc::Scheduler::Task& other) :
+		scheduler(scheduler), other(other), remove(false), order(0)
+	{
+	}
+
+	virtual void
+	run()
+	{
+		if (remove) {
+			scheduler.removeTask(other);
+		}
+		else {
+			scheduler.setPriority(other, 250);
+		}
+		order = count++;
+	}
+
+	xpcc::Scheduler& scheduler;
+	xpcc::Scheduler::Task& other;
+	bool remove;
+	uint8_t order;
+};
+
+void
+SchedulerTest::testSetPriority()
+{
+	xpcc::Scheduler scheduler;
+
+	TestTask task1;
+	TestTask task2;
+	TestTask task3;
+	ModifyingTask modifier(scheduler, task1);
+
+	TEST_ASSERT_FALSE(scheduler.setPriority(task1, 20));
+
+	scheduler.scheduleTask(task1, 2, 10);
+	scheduler.scheduleTask(task2, 2, 11);
+	scheduler.scheduleTask(task3, 2, 100);
+	scheduler.scheduleTask(modifier, 2, 200);
+
+	// task1 is ready when the modifier raises its priority
+	count = 1;
+	scheduler.schedule();
+	scheduler.schedule();
+	TEST_ASSERT_EQUALS(modifier.order, 1);
+	TEST_ASSERT_EQUALS(task1.order, 2);
+	TEST_ASSERT_EQUALS(task3.order, 3);
+	TEST_ASSERT_EQUALS(task2.order, 4);
+
+	TEST_ASSERT_TRUE(scheduler.setPriority(task1, 5));
+	TEST_ASSERT_TRUE(scheduler.setPriority(task3, 1));
+
+	count = 1;
+	scheduler.schedule();
+	scheduler.schedule();
+	TEST_ASSERT_EQUALS(modifier.order, 1);
+	TEST_ASSERT_EQUALS(task1.order, 2);
+	TEST_ASSERT_EQUALS(task2.order, 3);
+	TEST_ASSERT_EQUALS(task3.order, 4);
+
+	// a ready task removed by another task is not executed anymore
+	modifier.remove = true;
+	scheduler.setPriority(task1, 5);
+	task1.order = 0;
+	count = 1;
+	scheduler.schedule();
+	scheduler.schedule();
+	TEST_ASSERT_EQUALS(modifier.order, 1);
+	TEST_ASSERT_EQUALS(task1.order, 0);
+	TEST_ASSERT_EQUALS(task2.order, 2);
+	TEST_ASSERT_EQUALS(task3.order, 3);
+}
+
+void
+SchedulerTest::testTicksUntilNextTask()
+{
+	xpcc::Scheduler scheduler;
+	TEST_ASSERT_EQUALS(scheduler.getTicksUntilNextTask(), 0U);
+
+	uint32_t tick = 0;
+	CountingTask task1;
+	CountingTask task2;
+	CountingTask task3;
+	task1.tick = &tick;
+	task2.tick = &tick;
+	task3.tick = &tick;
+	task1.period = 5000;
+	task2.period = 300;
+	task3.period = 0;
+
+	scheduler.scheduleTask(task1, 5000);
+	TEST_ASSERT_EQUALS(scheduler.getTicksUntilNextTask(), 5000U);
+	scheduler.scheduleTask(task2, 300);
+	TEST_ASSERT_EQUALS(scheduler.getTicksUntilNextTask(), 300U);
+	scheduler.scheduleTask(task3, 0);
+
+	// jump from deadline to deadline
+	uint32_t jumps = 0;
+	while (tick < 20000)
+	{
+		uint32_t ticks = scheduler.getTicksUntilNextTask();
+		TEST_ASSERT_TRUE(ticks > 0 && ticks <= 300);
+		tick += ticks;
+		scheduler.schedule(ticks);
+		jumps++;
+	}
+	TEST_ASSERT_EQUALS(tick, 20000U);
+	TEST_ASSERT_EQUALS(jumps, 66U + 3U);
+	TEST_ASSERT_EQUALS(task1.runs, 4U);
+	TEST_ASSERT_EQUALS(task2.runs, 66U);
+	TEST_ASSERT_EQUALS(task1.errors, 0U);
+	TEST_ASSERT_EQUALS(task2.errors, 0U);
+
+	scheduler.removeTask(task2);
+	TEST_ASSERT_EQUALS(scheduler.getTicksUntilNextTask(), 25000U - 20000U);
+	scheduler.removeTask(task1);
+	TEST_ASSERT_EQUALS(scheduler.getTicksUntilNextTask(), 65536U - 20000U);
+}
+
+void
+SchedulerTest::testTicksUntilNextTaskBeforeCascade()
+{
+	// (period of the earlier task, period of the later task, ticks to
+	// the first cascade of the earlier task), the earlier task is in the
+	// current slot of level 1 and 2, which is not yet cascaded
+	static const uint16_t periods[][3] = {
+		{ 0x1d, 0x24, 0x10 },
+		{ 0x11d, 0x224, 0x100 },
+	};
+
+	for (const auto& entry : periods)
+	{
+		xpcc::Scheduler scheduler;
+		uint32_t tick = 0;
+		CountingTask task1;
+		CountingTask task2;
+		task1.tick = &tick;
+		task2.tick = &tick;
+		task1.period = entry[0];
+		task2.period = entry[1];
+
+		scheduler.scheduleTask(task1, entry[0]);
+		scheduler.scheduleTask(task2, entry[1]);
+
+		tick += entry[2];
+		scheduler.schedule(entry[2]);
+		TEST_ASSERT_EQUALS(task1.runs, 0U);
+
+		uint32_t ticks = scheduler.getTicksUntilNextTask();
+		TEST_ASSERT_EQUALS(ticks, uint32_t(entry[0] - entry[2]));
+
+		tick += ticks;
+		scheduler.schedule(ticks);
+		TEST_ASSERT_EQUALS(task1.runs, 1U);
+		TEST_ASSERT_EQUALS(task1.errors, 0U);
+		TEST_ASSERT_EQUALS(task2.runs, 0U);
+	}
+}
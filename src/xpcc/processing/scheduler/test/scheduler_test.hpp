@@ -35,4 +35,19 @@ class SchedulerTest : public unittest::TestSuite
 public:
 	void
 	testScheduler();
+
+	void
+	testPeriods();
+
+	void
+	testRemoveTask();
+
+	void
+	testSetPriority();
+
+	void
+	testTicksUntilNextTask();
+
+	void
+	testTicksUntilNextTaskBeforeCascade();
 };
@@ -132,6 +132,10 @@ public:
 	inline bool
 	isStopped() const;
 
+	/// @return `true` if the timer is running, `execute()` returns `true` on expiration
+	inline bool
+	isPending() const;
+
 private:
 	TimestampType period;
 	GenericTimeout<Clock, TimestampType> timeout;
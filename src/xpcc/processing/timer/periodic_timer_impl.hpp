@@ -53,6 +53,13 @@ xpcc::GenericPeriodicTimer<Clock, TimestampType>::isStopped() const
 	return timeout.isStopped();
 }
 
+template< class Clock , typename TimestampType >
+bool
+xpcc::GenericPeriodicTimer<Clock, TimestampType>::isPending() const
+{
+	return timeout.isPending();
+}
+
 template< class Clock , typename TimestampType >
 bool
 xpcc::GenericPeriodicTimer<Clock, TimestampType>::execute()
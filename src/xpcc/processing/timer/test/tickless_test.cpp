@@ -0,0 +1,168 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#include <xpcc/processing/timer.hpp>
+#include <xpcc/architecture/driver/clock_dummy.hpp>
+
+#include "tickless_test.hpp"
+
+typedef xpcc::GenericTimeout<xpcc::ClockDummy, xpcc::Timestamp> Timeout;
+typedef xpcc::GenericPeriodicTimer<xpcc::ClockDummy, xpcc::Timestamp> PeriodicTimer;
+typedef xpcc::GenericTickless<xpcc::ClockDummy, xpcc::Timestamp, 3> Tickless;
+
+namespace
+{
+	class TestTask : public xpcc::Scheduler::Task
+	{
+	public:
+		TestTask() :
+			runs(0), lastRun(0)
+		{
+		}
+
+		virtual void
+		run()
+		{
+			runs++;
+			lastRun = xpcc::ClockDummy::now().getTime();
+		}
+
+		uint32_t runs;
+		uint32_t lastRun;
+	};
+}
+
+// ----------------------------------------------------------------------------
+void
+TicklessTest::setUp()
+{
+	xpcc::ClockDummy::setTime(1000);
+}
+
+void
+TicklessTest::testTimeouts()
+{
+	Tickless tickless;
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), Tickless::maximumTime);
+
+	Timeout timeout1;
+	Timeout timeout2(200);
+	PeriodicTimer timer(50);
+	Timeout timeout3;
+
+	TEST_ASSERT_TRUE(tickless.add(timeout1));
+	TEST_ASSERT_TRUE(tickless.add(timeout2));
+	TEST_ASSERT_TRUE(tickless.add(timer));
+	TEST_ASSERT_FALSE(tickless.add(timeout3));
+
+	// stopped timeouts are ignored
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 50U);
+
+	xpcc::ClockDummy::setTime(1060);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 0U);
+	TEST_ASSERT_TRUE(timer.execute());
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 40U);
+
+	timeout1.restart(10);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 10U);
+
+	// an executed timeout does not keep the core awake
+	xpcc::ClockDummy::setTime(1075);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 0U);
+	TEST_ASSERT_TRUE(timeout1.execute());
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 25U);
+
+	TEST_ASSERT_TRUE(tickless.remove(timer));
+	TEST_ASSERT_FALSE(tickless.remove(timer));
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 125U);
+
+	TEST_ASSERT_TRUE(tickless.add(timeout3));
+	timeout3.restart(5);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 5U);
+}
+
+void
+TicklessTest::testScheduler()
+{
+	xpcc::Scheduler scheduler;
+	TestTask task1;
+	TestTask task2;
+
+	Tickless tickless;
+	tickless.attach(scheduler, 10);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), Tickless::maximumTime);
+
+	scheduler.scheduleTask(task1, 3);
+	scheduler.scheduleTask(task2, 100);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 30U);
+
+	xpcc::ClockDummy::setTime(1025);
+	tickless.update();
+	TEST_ASSERT_EQUALS(task1.runs, 0U);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 5U);
+
+	xpcc::ClockDummy::setTime(1031);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 0U);
+	tickless.update();
+	TEST_ASSERT_EQUALS(task1.runs, 1U);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 29U);
+
+	// Ticks are counted from the attachment, not from the last update.
+	// Tasks expiring several times while sleeping are executed once.
+	xpcc::ClockDummy::setTime(2000);
+	tickless.update();
+	TEST_ASSERT_EQUALS(task1.runs, 2U);
+	TEST_ASSERT_EQUALS(task2.runs, 1U);
+	TEST_ASSERT_EQUALS(tickless.getTimeUntilNextDeadline(), 20U);
+}
+
+void
+TicklessTest::testSleep()
+{
+	xpcc::Scheduler scheduler;
+	TestTask task;
+
+	Timeout timeout(95);
+	Tickless tickless;
+	tickless.add(timeout);
+	tickless.attach(scheduler, 1);
+	scheduler.scheduleTask(task, 40);
+
+	uint32_t wakeups = 0;
+	auto sleepFor = [&wakeups](uint32_t time) {
+		wakeups++;
+		xpcc::ClockDummy::setTime(xpcc::ClockDummy::now().getTime() + time);
+	};
+
+	TEST_ASSERT_TRUE(tickless.sleep(sleepFor));
+	TEST_ASSERT_EQUALS(xpcc::ClockDummy::now().getTime(), 1040U);
+	TEST_ASSERT_TRUE(tickless.sleep(sleepFor));
+	TEST_ASSERT_EQUALS(task.runs, 1U);
+	TEST_ASSERT_EQUALS(task.lastRun, 1040U);
+	TEST_ASSERT_EQUALS(xpcc::ClockDummy::now().getTime(), 1080U);
+	TEST_ASSERT_TRUE(tickless.sleep(sleepFor));
+	TEST_ASSERT_EQUALS(xpcc::ClockDummy::now().getTime(), 1095U);
+
+	// the expired timeout has to be handled first
+	TEST_ASSERT_FALSE(tickless.sleep(sleepFor));
+	TEST_ASSERT_TRUE(timeout.execute());
+
+	TEST_ASSERT_TRUE(tickless.sleep(sleepFor));
+	TEST_ASSERT_EQUALS(xpcc::ClockDummy::now().getTime(), 1120U);
+	TEST_ASSERT_EQUALS(task.runs, 2U);
+	TEST_ASSERT_EQUALS(wakeups, 4U);
+
+	// too close to sleep
+	xpcc::ClockDummy::setTime(1159);
+	TEST_ASSERT_FALSE(tickless.sleep(sleepFor));
+	TEST_ASSERT_EQUALS(task.runs, 3U);
+	TEST_ASSERT_EQUALS(wakeups, 4U);
+
+	TEST_ASSERT_TRUE(tickless.sleep(sleepFor, 1));
+	TEST_ASSERT_EQUALS(xpcc::ClockDummy::now().getTime(), 1160U);
+}
@@ -0,0 +1,166 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef XPCC_TICKLESS_HPP
+#define XPCC_TICKLESS_HPP
+
+#include <stdint.h>
+
+#include <xpcc/architecture/driver/clock.hpp>
+#include <xpcc/processing/scheduler/scheduler.hpp>
+#include <xpcc/utils/arithmetic_traits.hpp>
+
+#include "timestamp.hpp"
+
+namespace xpcc
+{
+
+/**
+ * Sleep until the next timeout or scheduler task is due.
+ *
+ * Instead of waking up on every tick to run the scheduler and to poll the
+ * software timers, the application computes the time until the next
+ * deadline, programs a wakeup timer for it and lets the core sleep.
+ * Interrupts wake the core as usual.
+ *
+ * The timeouts and periodic timers to be considered are registered with
+ * add(). A xpcc::Scheduler is attached with its tick period, it is then
+ * executed by sleep() for all ticks elapsed since the last call instead
+ * of from the tick interrupt.
+ *
+ * Putting the core to sleep is target specific. The function passed to
+ * sleep() has to program the wakeup, sleep, and advance the `Clock` by
+ * the time slept before returning:
+ *
+ * @code
+ * xpcc::Tickless<4> tickless;
+ * tickless.add(blinkTimer);
+ * tickless.add(radioTimeout);
+ * tickless.attach(scheduler, 1);
+ *
+ * while (true)
+ * {
+ *     if (blinkTimer.execute()) {
+ *         Led::toggle();
+ *     }
+ *     // ...
+ *     tickless.sleep([](uint32_t milliseconds) {
+ *         LowPowerTimer::startOneShot(milliseconds);
+ *         __WFI();
+ *         Clock::increment(LowPowerTimer::getElapsed());
+ *     });
+ * }
+ * @endcode
+ *
+ * A timeout which is only checked with `isExpired()` keeps the core awake
+ * after its expiration until it is restarted or stopped. Timeouts checked
+ * with `execute()` are ignored after they executed.
+ *
+ * @tparam	Clock
+ * 		Used clock, the same as for the registered timers.
+ * @tparam	TimestampType
+ * 		Timestamp of the registered timers.
+ * @tparam	Capacity
+ * 		Maximum number of registered timers.
+ *
+ * @ingroup	software_timer
+ */
+template< class Clock, typename TimestampType = xpcc::Timestamp, uint8_t Capacity = 8 >
+class GenericTickless
+{
+public:
+	typedef typename TimestampType::Type Type;
+	typedef typename TimestampType::SignedType SignedType;
+
+	/// Longest time slept at once, half the range of the timestamp
+	static constexpr Type maximumTime = xpcc::ArithmeticTraits<SignedType>::max;
+
+public:
+	GenericTickless();
+
+	/**
+	 * Register a timeout or periodic timer.
+	 *
+	 * @return	`false` if all places are occupied
+	 */
+	template< class Timer >
+	bool
+	add(const Timer& timer);
+
+	/// @return	`false` if the timer was not registered
+	template< class Timer >
+	bool
+	remove(const Timer& timer);
+
+	/**
+	 * Execute the scheduler from sleep() instead of a timer interrupt.
+	 *
+	 * @param	tickPeriod	time between two calls of Scheduler::schedule()
+	 * 						in units of the `Clock`
+	 */
+	void
+	attach(Scheduler& scheduler, Type tickPeriod);
+
+	/**
+	 * Execute the scheduler for the ticks elapsed since the last call.
+	 *
+	 * Called by sleep(), only needed separately if the scheduler tasks
+	 * must run before the application polls its timers.
+	 */
+	void
+	update();
+
+	/// @return	time until the next deadline, 0 if one is due, `maximumTime` if there is none
+	Type
+	getTimeUntilNextDeadline() const;
+
+	/**
+	 * Execute the scheduler and sleep until the next deadline.
+	 *
+	 * @param	sleepFor	function called with the time to sleep, see above.
+	 * 						The core may wake up earlier.
+	 * @param	minimumTime	do not sleep if the next deadline is closer
+	 *
+	 * @return	`false` if the next deadline was too close to sleep
+	 */
+	template< typename Function >
+	bool
+	sleep(Function sleepFor, Type minimumTime = 2);
+
+private:
+	/// @return `false` if the timer will not expire anymore
+	typedef bool (*RemainingFunction)(const void *timer, SignedType& remaining);
+
+	template< class Timer >
+	static bool
+	getRemaining(const void *timer, SignedType& remaining);
+
+	struct Entry
+	{
+		const void *timer;
+		RemainingFunction remaining;
+	};
+
+	Entry entries[Capacity];
+	uint8_t count;
+
+	Scheduler *scheduler;
+	Type tickPeriod;
+	TimestampType lastTick;
+};
+
+/// Tickless operation with the system clock and millisecond timers
+/// @ingroup	software_timer
+template< uint8_t Capacity = 8 >
+using Tickless = GenericTickless< ::xpcc::Clock, Timestamp, Capacity >;
+
+}	// namespace xpcc
+
+#include "tickless_impl.hpp"
+
+#endif // XPCC_TICKLESS_HPP
@@ -0,0 +1,149 @@
+/* Copyright (c) 2016, Roboterclub Aachen e.V.
+ * All Rights Reserved.
+ *
+ * The file is part of the xpcc library and is released under the 3-clause BSD
+ * license. See the file `LICENSE` for the full license governing this code.
+ */
+// ----------------------------------------------------------------------------
+
+#ifndef	XPCC_TICKLESS_HPP
+#	error	"Don't include this file directly, use 'tickless.hpp' instead!"
+#endif
+
+template< class Clock, typename TimestampType, uint8_t Capacity >
+constexpr typename xpcc::GenericTickless<Clock, TimestampType, Capacity>::Type
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::maximumTime;
+
+template< class Clock, typename TimestampType, uint8_t Capacity >
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::GenericTickless() :
+	count(0), scheduler(0), tickPeriod(1), lastTick()
+{
+}
+
+// ----------------------------------------------------------------------------
+template< class Clock, typename TimestampType, uint8_t Capacity >
+template< class Timer >
+bool
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::add(const Timer& timer)
+{
+	if (count >= Capacity) {
+		return false;
+	}
+	entries[count].timer = &timer;
+	entries[count].remaining = &getRemaining<Timer>;
+	count++;
+	return true;
+}
+
+template< class Clock, typename TimestampType, uint8_t Capacity >
+template< class Timer >
+bool
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::remove(const Timer& timer)
+{
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		if (entries[i].timer == &timer)
+		{
+			count--;
+			entries[i] = entries[count];
+			return true;
+		}
+	}
+	return false;
+}
+
+template< class Clock, typename TimestampType, uint8_t Capacity >
+template< class Timer >
+bool
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::getRemaining(
+		const void *timer, SignedType& remaining)
+{
+	const Timer *t = static_cast<const Timer *>(timer);
+	if (!t->isPending()) {
+		return false;
+	}
+	remaining = t->remaining();
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+template< class Clock, typename TimestampType, uint8_t Capacity >
+void
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::attach(
+		Scheduler& scheduler, Type tickPeriod)
+{
+	this->scheduler = &scheduler;
+	this->tickPeriod = (tickPeriod > 0) ? tickPeriod : 1;
+	lastTick = Clock::template now<TimestampType>();
+}
+
+template< class Clock, typename TimestampType, uint8_t Capacity >
+void
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::update()
+{
+	if (scheduler == 0) {
+		return;
+	}
+
+	const Type elapsed = (Clock::template now<TimestampType>() - lastTick).getTime();
+	const Type ticks = elapsed / tickPeriod;
+	if (ticks > 0)
+	{
+		lastTick = lastTick + TimestampType(ticks * tickPeriod);
+		scheduler->schedule(ticks);
+	}
+}
+
+// ----------------------------------------------------------------------------
+template< class Clock, typename TimestampType, uint8_t Capacity >
+typename xpcc::GenericTickless<Clock, TimestampType, Capacity>::Type
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::getTimeUntilNextDeadline() const
+{
+	Type time = maximumTime;
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		SignedType remaining;
+		if (entries[i].remaining(entries[i].timer, remaining))
+		{
+			if (remaining <= 0) {
+				return 0;
+			}
+			if (Type(remaining) < time) {
+				time = remaining;
+			}
+		}
+	}
+
+	if (scheduler != 0)
+	{
+		const uint32_t ticks = scheduler->getTicksUntilNextTask();
+		if (ticks > 0 && ticks <= maximumTime / tickPeriod)
+		{
+			// the current tick has partly elapsed already
+			const Type elapsed = (Clock::template now<TimestampType>() - lastTick).getTime();
+			const Type next = ticks * tickPeriod;
+			if (next <= elapsed) {
+				return 0;
+			}
+			if (next - elapsed < time) {
+				time = next - elapsed;
+			}
+		}
+	}
+	return time;
+}
+
+template< class Clock, typename TimestampType, uint8_t Capacity >
+template< typename Function >
+bool
+xpcc::GenericTickless<Clock, TimestampType, Capacity>::sleep(Function sleepFor, Type minimumTime)
+{
+	update();
+
+	const Type time = getTimeUntilNextDeadline();
+	if (time < minimumTime) {
+		return false;
+	}
+	sleepFor(time);
+	return true;
+}
@@ -145,6 +145,10 @@ public:
 	inline bool
 	isArmed() const;
 
+	/// @return `true` if the timeout is running and `execute()` has not yet returned `true`
+	inline bool
+	isPending() const;
+
 private:
 	inline bool
 	checkExpiration() const;
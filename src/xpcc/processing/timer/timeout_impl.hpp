@@ -102,6 +102,13 @@ xpcc::GenericTimeout<Clock, TimestampType>::isExpired() const
 	return getState() == TimeoutState::Expired;
 }
 
+template< class Clock, class TimestampType >
+bool
+xpcc::GenericTimeout<Clock, TimestampType>::isPending() const
+{
+	return (state != STOPPED) and not (state & EXECUTED);
+}
+
 // ----------------------------------------------------------------------------
 template< class Clock, class TimestampType >
 bool
@@ -32,6 +32,9 @@ import os
 import builder_base
 import filter.cpp as filter
 
+# Priority classes of xpcc::CanConnector, 0 is the highest priority
+PRIORITIES = { 'high': 0, 'normal': 1, 'low': 2 }
+
 class IdentifierBuilder(builder_base.Builder):
 	
 	VERSION = "0.1"
@@ -64,11 +67,32 @@ class IdentifierBuilder(builder_base.Builder):
 		for component in self.tree.components.iter(abstract=False):
 			components.append(component.flattened())
 		
+		# only priorities different from 'normal' are listed
+		actionPriorities = []
+		for component in components:
+			for action in component.actions:
+				if action.priority != 'normal':
+					actionPriorities.append({
+						'component': component,
+						'action': action,
+						'priority': PRIORITIES[action.priority]
+					})
+		
+		eventPriorities = []
+		for event in self.tree.events:
+			if event.priority != 'normal':
+				eventPriorities.append({
+					'event': event,
+					'priority': PRIORITIES[event.priority]
+				})
+		
 		substitutions = {
 			'domains' : self.tree.domains,
 			'components': components,
 			'actions': self.tree.components.actions,
 			'events': self.tree.events,
+			'actionPriorities': actionPriorities,
+			'eventPriorities': eventPriorities,
 			'namespace': namespace
 		}
 					
@@ -29,6 +29,7 @@
 # -----------------------------------------------------------------------------
 
 import os
+import math
 import builder_base
 import filter.cpp as filter
 
@@ -36,6 +37,28 @@ import filter.cpp as filter
 def filter_lower(value):
 	return value.lower().replace(" ", "_")
 
+def table(items, key=lambda item: item.id):
+	""" Arrange items in a list directly indexed by their identifier
+
+	Returns the identifier of the first entry and the list, unused
+	identifiers in between are filled with None.
+	"""
+	if len(items) == 0:
+		return 0, []
+	first = min(key(item) for item in items)
+	last = max(key(item) for item in items)
+	entries = [None] * (last - first + 1)
+	for item in items:
+		entries[key(item) - first] = item
+	return first, entries
+
+def comparisons(cases):
+	""" Worst case number of comparisons of a switch statement
+
+	Sparse switch statements are compiled into a binary decision tree.
+	"""
+	return int(math.ceil(math.log(cases + 1, 2)))
+
 # -----------------------------------------------------------------------------
 class PostmanBuilder(builder_base.Builder):
 
@@ -52,6 +75,13 @@ class PostmanBuilder(builder_base.Builder):
 				dest = "namespace",
 				default = "robot",
 				help = "Namespace of the generated identifiers.")
+		optparser.add_option(
+				"--dispatch",
+				dest = "dispatch",
+				default = "switch",
+				help = "Dispatch of received packets: 'switch' (nested switch " \
+					   "statements) or 'table' (constant tables indexed by " \
+					   "component and action identifier).")
 
 	def generate(self):
 		# check the commandline options
@@ -65,6 +95,10 @@ class PostmanBuilder(builder_base.Builder):
 		else:
 			raise builder_base.BuilderException("You need to provide a namespace!")
 
+		dispatch = self.options.dispatch or "switch"
+		if dispatch not in ["switch", "table"]:
+			raise builder_base.BuilderException("Dispatch has to be either 'switch' or 'table'!")
+
 		cppFilter = {
 			'camelcase': filter_lower,
 			'camelCase': filter.variableName,
@@ -81,12 +115,35 @@ class PostmanBuilder(builder_base.Builder):
 		# resumable function information
 		resumableActions = 0;
 		resumableActionsWithPayload = 0;
+		buffers = {}
 		for component in components:
 			for action in component.actions:
 				if action.call == "resumable":
+					actionBuffer = resumableActions
+					payloadBuffer = None
 					resumableActions += 1
 					if action.parameterType is not None:
+						payloadBuffer = resumableActionsWithPayload
 						resumableActionsWithPayload += 1
+					buffers[(component.name, action.name)] = (actionBuffer, payloadBuffer)
+
+		# dispatch tables indexed by the identifiers
+		firstComponent, componentTable = table(components)
+		for index, component in enumerate(componentTable):
+			if component is not None:
+				first, actions = table(list(component.actions))
+				actions = [None if action is None else {
+						'action': action,
+						'buffer': buffers.get((component.name, action.name))
+					} for action in actions]
+				componentTable[index] = {
+					'component': component,
+					'firstAction': first,
+					'actions': actions,
+				}
+		firstEvent, eventTable = table(list(container.events.subscribe))
+
+		report = self.report(components, container)
 
 		substitutions = {
 			'resumables': resumableActions,
@@ -95,7 +152,13 @@ class PostmanBuilder(builder_base.Builder):
 			'events': self.tree.events,
 			'container': container,
 			'eventSubscriptions': container.subscriptions,
-			'namespace': namespace
+			'namespace': namespace,
+			'dispatchTable': (dispatch == "table"),
+			'firstComponent': firstComponent,
+			'componentTable': componentTable,
+			'firstEvent': firstEvent,
+			'eventTable': eventTable,
+			'report': report,
 		}
 
 		file = os.path.join(self.options.outpath, 'postman.hpp')
@@ -104,6 +167,58 @@ class PostmanBuilder(builder_base.Builder):
 		file = os.path.join(self.options.outpath, 'postman.cpp')
 		self.write(file, self.template('templates/postman.cpp.tpl', filter=cppFilter).render(substitutions) + "\n")
 
+		file = os.path.join(self.options.outpath, 'postman_report.txt')
+		self.write(file, self.template('templates/postman_report.txt.tpl', filter=cppFilter).render(substitutions) + "\n")
+
+	def report(self, components, container):
+		""" Static estimation of the worst case dispatch cost per component
+
+		For the switch dispatch the number of comparisons is estimated from
+		the number of cases, the table dispatch needs a constant number of
+		range checks and loads. The table size is given for 16 bit (AVR)
+		and 32 bit (ARM, hosted) function pointers.
+		"""
+		def payloadSize(type):
+			return 0 if type is None else type.size
+
+		components = sorted(components, key=lambda component: component.id)
+		componentSwitch = comparisons(len(components))
+
+		report = {'components': [], 'events': []}
+		for component in components:
+			actions = list(component.actions)
+			ids = [action.id for action in actions]
+			entries = (max(ids) - min(ids) + 1) if len(ids) > 0 else 0
+			report['components'].append({
+				'name': component.name,
+				'id': component.id,
+				'actions': len(actions),
+				'resumables': component.resumables,
+				'switch': componentSwitch + comparisons(len(actions)),
+				'entries': entries,
+				'bytes16': entries * 2,
+				'bytes32': entries * 4,
+				'payload': max([payloadSize(action.parameterType) for action in actions] + [0]),
+				'subscriptions': len(list(component.events.subscribe)),
+			})
+
+		events = list(container.events.subscribe)
+		eventSwitch = comparisons(len(events))
+		for event in sorted(events, key=lambda event: event.id):
+			report['events'].append({
+				'name': event.name,
+				'id': event.id,
+				'listeners': len(container.subscriptions.get(event.name, [])),
+				'switch': eventSwitch,
+				'payload': payloadSize(event.type),
+			})
+
+		first, entries = table(components)
+		report['componentEntries'] = len(entries)
+		first, entries = table(events)
+		report['eventEntries'] = len(entries)
+		return report
+
 # -----------------------------------------------------------------------------
 if __name__ == '__main__':
 	PostmanBuilder().run()
@@ -37,6 +37,20 @@ namespace {{ namespace }}
 				{{ namespace }}::event::Identifier::{{ event.name | CAMELCASE }},
 				packet);
 		}
+
+		/** Construct the payload in place, see xpcc::Communicator::emplaceEvent() */
+		template<typename... Args>
+		static inline bool
+		{{ ("emplace " ~ event.name) | camelCase }}(
+				xpcc::Communicator *communicator,
+				const Args&... args)
+		{
+			return communicator->emplaceEvent<
+				{%- if event.type.isBuiltIn %}{{ event.type.name | CamelCase }}
+				{%- else %}{{ namespace }}::packet::{{ event.type.name | CamelCase }}{% endif %}>(
+				{{ namespace }}::event::Identifier::{{ event.name | CAMELCASE }},
+				args...);
+		}
 		{% else -%}
 		{% if event.description %}/** {{ event.description | xpcc.wordwrap(72) | xpcc.indent(2) }}*/{% endif %}
 		static inline void
@@ -101,6 +115,35 @@ namespace {{ namespace }}
 				packet,
 				responseCallback);
 		}
+
+		{%- set type = (action.parameterType.name | CamelCase) if action.parameterType.isBuiltIn else namespace ~ "::packet::" ~ (action.parameterType.name | CamelCase) %}
+
+		/** Construct the payload in place, see xpcc::Communicator::emplaceAction() */
+		template<typename... Args>
+		static inline bool
+		{{ ("emplace " ~ action.name) | camelCase }} (
+				xpcc::Communicator *communicator,
+				const Args&... args)
+		{
+			return communicator->emplaceAction<{{ type }}>(
+				{{ namespace }}::component::Identifier::{{ component.name | CAMELCASE }},
+				{{ namespace }}::action::Identifier::{{ action.name | CAMELCASE }},
+				args...);
+		}
+
+		template<typename... Args>
+		static inline bool
+		{{ ("emplace " ~ action.name) | camelCase }} (
+				xpcc::Communicator *communicator,
+				xpcc::ResponseCallback& responseCallback,
+				const Args&... args)
+		{
+			return communicator->emplaceAction<{{ type }}>(
+				{{ namespace }}::component::Identifier::{{ component.name | CAMELCASE }},
+				{{ namespace }}::action::Identifier::{{ action.name | CAMELCASE }},
+				responseCallback,
+				args...);
+		}
 		{% else -%}
 		static inline void
 		{{ action.name | camelCase }} (xpcc::Communicator *communicator) {
@@ -19,6 +19,24 @@ namespace component
 	{%- endfor %}
 }
 
+// ----------------------------------------------------------------------------
+{#- arrays must not be empty, the unused element is never accessed #}
+{%- set subscriptions = container.events.subscribe | list %}
+const uint8_t Postman::componentIdentifiers[{{ components | length if components | length > 0 else 1 }}] =
+{
+{%- for component in components %}
+	{{ namespace }}::component::{{ component.name | CAMELCASE }},
+{%- endfor %}
+};
+
+const uint8_t Postman::eventIdentifiers[{{ subscriptions | length if subscriptions | length > 0 else 1 }}] =
+{
+{%- for event in subscriptions %}
+	{{ namespace }}::event::{{ event.name | CAMELCASE }},
+{%- endfor %}
+};
+
+{% if not dispatchTable -%}
 // ----------------------------------------------------------------------------
 xpcc::Postman::DeliverInfo
 Postman::deliverPacket(const xpcc::Header& header, const xpcc::SmartPointer& payload)
@@ -133,6 +151,210 @@ Postman::isComponentAvailable(uint8_t component) const
 	}
 }
 
+{% else -%}
+// ----------------------------------------------------------------------------
+/*
+ * Dispatch tables indexed by (component, action) respectively event identifier.
+ *
+ * The payload is handed to the components as a view into the SmartPointer,
+ * its size is compared against the packet size which is checked against the
+ * XML definition at compile time.
+ */
+struct Postman::Dispatch
+{
+	typedef xpcc::Postman::DeliverInfo
+	(*Action)(Postman& postman, const xpcc::Header& header, const xpcc::SmartPointer& payload);
+
+	typedef void
+	(*Event)(const xpcc::Header& header, const xpcc::SmartPointer& payload);
+
+	struct Component
+	{
+		const Action *actions;
+		uint8_t firstAction;
+		uint16_t numberOfActions;
+		bool available;
+	};
+
+	/// Zero-copy view of the payload, `nullptr` if the size does not match
+	template <typename T>
+	static inline const T*
+	view(const xpcc::SmartPointer& payload)
+	{
+		return (payload.getSize() == sizeof(T)) ? &payload.get<T>() : nullptr;
+	}
+{%- for entry in componentTable %}
+	{%- if entry != None %}
+		{%- set component = entry.component %}
+		{%- for slot in entry.actions %}
+			{%- if slot != None %}
+				{%- set action = slot.action %}
+				{%- if action.parameterType != None %}
+					{%- set typePrefix = "" if action.parameterType.isBuiltIn else namespace ~ "::packet::" %}
+					{%- set type = typePrefix ~ (action.parameterType.name | CamelCase) %}
+				{%- endif %}
+
+	static xpcc::Postman::DeliverInfo
+	{{ component.name | camelCase }}{{ action.name | CamelCase }}(Postman&{% if action.call == "resumable" %} postman{% endif %}, const xpcc::Header& header, const xpcc::SmartPointer&{% if action.parameterType != None %} payload{% endif %})
+	{
+				{%- if action.parameterType != None %}
+		static_assert(sizeof({{ type }}) == {{ action.parameterType.size }},
+				"Size of '{{ action.parameterType.name }}' does not match the XML definition!");
+		const {{ type }} *data = view<{{ type }}>(payload);
+		if (data == nullptr) {
+			return ERROR;
+		}
+				{%- endif %}
+		xpcc::ResponseHandle response(header);
+				{%- if action.call == "resumable" %}
+		if (postman.actionBuffer[{{ slot.buffer[0] }}].destination != 0) {
+			component::{{ component.name | camelCase }}.getCommunicator()->sendNegativeResponse(response);
+		}
+		else if (postman.component_{{ component.name | camelCase }}_action{{ action.name | CamelCase }}(response{% if action.parameterType != None %}, *data{% endif %}) == xpcc::rf::Running) {
+			postman.actionBuffer[{{ slot.buffer[0] }}] = ActionBuffer(header);
+					{%- if action.parameterType != None %}
+			postman.payloadBuffer[{{ slot.buffer[1] }}] = PayloadBuffer(payload);
+					{%- endif %}
+		}
+				{%- else %}
+		component::{{ component.name | camelCase }}.action{{ action.name | CamelCase }}(response{% if action.parameterType != None %}, data{% endif %});
+				{%- endif %}
+		return OK;
+	}
+			{%- endif %}
+		{%- endfor %}
+	{%- endif %}
+{%- endfor %}
+{%- for event in eventTable %}
+	{%- if event != None %}
+		{%- set type = events[event.name].type %}
+
+	static void
+	event{{ event.name | CamelCase }}(const xpcc::Header& header, const xpcc::SmartPointer&{% if type != None %} payload{% endif %})
+	{
+		{%- if type != None %}
+		static_assert(sizeof({{ namespace }}::packet::{{ type.name | CamelCase }}) == {{ type.size }},
+				"Size of '{{ type.name }}' does not match the XML definition!");
+		const {{ namespace }}::packet::{{ type.name | CamelCase }} *data = view<{{ namespace }}::packet::{{ type.name | CamelCase }}>(payload);
+		if (data == nullptr) {
+			return;
+		}
+		{%- endif %}
+		{%- for component in eventSubscriptions[event.name] %}
+		component::{{ component.name | camelCase }}.event{{ event.name | CamelCase }}(header{% if type != None %}, data{% endif %});
+		{%- endfor %}
+	}
+	{%- endif %}
+{%- endfor %}
+{% for entry in componentTable %}
+	{%- if entry != None and entry.actions | length > 0 %}
+	static constexpr Action {{ entry.component.name | camelCase }}Actions[] =
+	{
+		{%- for slot in entry.actions %}
+			{%- if slot != None %}
+		&{{ entry.component.name | camelCase }}{{ slot.action.name | CamelCase }},
+			{%- else %}
+		nullptr,
+			{%- endif %}
+		{%- endfor %}
+	};
+	{%- endif %}
+{%- endfor %}
+
+	static constexpr uint8_t firstComponent = {{ firstComponent }};
+	static constexpr uint16_t numberOfComponents = {{ componentTable | length }};
+	{%- if componentTable | length > 0 %}
+	static constexpr Component components[] =
+	{
+		{%- for entry in componentTable %}
+			{%- if entry == None %}
+		{ nullptr, 0, 0, false },
+			{%- elif entry.actions | length > 0 %}
+		{ {{ entry.component.name | camelCase }}Actions, {{ entry.firstAction }}, {{ entry.actions | length }}, true },
+			{%- else %}
+		{ nullptr, 0, 0, true },
+			{%- endif %}
+		{%- endfor %}
+	};
+	{%- endif %}
+
+	static constexpr uint8_t firstEvent = {{ firstEvent }};
+	static constexpr uint16_t numberOfEvents = {{ eventTable | length }};
+	{%- if eventTable | length > 0 %}
+	static constexpr Event events[] =
+	{
+		{%- for event in eventTable %}
+			{%- if event != None %}
+		&event{{ event.name | CamelCase }},
+			{%- else %}
+		nullptr,
+			{%- endif %}
+		{%- endfor %}
+	};
+	{%- endif %}
+};
+{% for entry in componentTable %}
+	{%- if entry != None and entry.actions | length > 0 %}
+constexpr Postman::Dispatch::Action Postman::Dispatch::{{ entry.component.name | camelCase }}Actions[];
+	{%- endif %}
+{%- endfor %}
+{%- if componentTable | length > 0 %}
+constexpr Postman::Dispatch::Component Postman::Dispatch::components[];
+{%- endif %}
+{%- if eventTable | length > 0 %}
+constexpr Postman::Dispatch::Event Postman::Dispatch::events[];
+{%- endif %}
+
+// ----------------------------------------------------------------------------
+xpcc::Postman::DeliverInfo
+Postman::deliverPacket(const xpcc::Header& header, const xpcc::SmartPointer& payload)
+{
+	if (header.destination == 0)
+	{
+		// Events
+{%- if eventTable | length > 0 %}
+		uint8_t index = header.packetIdentifier - Dispatch::firstEvent;
+		if (index < Dispatch::numberOfEvents and Dispatch::events[index] != nullptr) {
+			Dispatch::events[index](header, payload);
+		}
+{%- endif %}
+		return OK;
+	}
+{%- if componentTable | length > 0 %}
+
+	uint8_t index = header.destination - Dispatch::firstComponent;
+	if (index >= Dispatch::numberOfComponents or !Dispatch::components[index].available) {
+		return NO_COMPONENT;
+	}
+
+	const Dispatch::Component& component = Dispatch::components[index];
+	uint8_t action = header.packetIdentifier - component.firstAction;
+	if (action >= component.numberOfActions or component.actions[action] == nullptr) {
+		return NO_ACTION;
+	}
+
+	return component.actions[action](*this, header, payload);
+{%- else %}
+
+	(void) payload;
+	return NO_COMPONENT;
+{%- endif %}
+}
+
+// ----------------------------------------------------------------------------
+bool
+Postman::isComponentAvailable(uint8_t component) const
+{
+{%- if componentTable | length > 0 %}
+	uint8_t index = component - Dispatch::firstComponent;
+	return (index < Dispatch::numberOfComponents and Dispatch::components[index].available);
+{%- else %}
+	(void) component;
+	return false;
+{%- endif %}
+}
+
+{% endif -%}
 void
 Postman::update()
 {
@@ -24,6 +24,15 @@ public:
 	void
 	update();
 
+	/// Identifiers of the components of this container, e.g. to program
+	/// the acceptance filters with xpcc::CanConnector::setFilters()
+	static const uint8_t componentIdentifiers[];
+	static constexpr uint8_t numberOfComponents = {{ components | length }};
+
+	/// Identifiers of the events the components of this container subscribed to
+	static const uint8_t eventIdentifiers[];
+	static constexpr uint8_t numberOfEvents = {{ container.events.subscribe | list | length }};
+
 {%- if resumables > 0 %}
 private:
 	struct
@@ -61,7 +70,7 @@ private:
 		{ payload = xpcc::SmartPointer(); }
 
 		xpcc::SmartPointer payload;
-	};	// 2B (AVR), 4B (ARM) + 3B HEAP
+	};	// 10B (AVR), 12B (ARM), payloads > 8B in a pool block
 
 	static constexpr uint8_t resumablePayloads = {{ resumablePayloads }};
 	PayloadBuffer payloadBuffer[resumablePayloads];
@@ -69,6 +78,10 @@ private:
 {%- endif %}
 
 private:
+{%- if dispatchTable %}
+	/// Dispatch tables, see postman.cpp
+	struct Dispatch;
+{% endif %}
 {%- for component in components %}
 	{%- for action in component.actions %}
 		{%- if action.call == "resumable" %}
@@ -0,0 +1,25 @@
+WARNING: This file is generated automatically from postman_report.txt.tpl
+Do not edit! Please modify the corresponding XML file instead.
+
+Static dispatch report for container '{{ container.name }}'
+
+Worst case cost of delivering a packet with the switch dispatch (number of
+comparisons of the nested switch statements compiled into a binary decision
+tree) and the table dispatch (two range checks and two table loads, independent
+of the number of actions). Table sizes are given for 16 bit (AVR) and 32 bit
+(ARM, hosted) function pointers, the payload is the largest action parameter.
+
+Dispatch: {{ "table" if dispatchTable else "switch" }}
+
+component                       id    actions  resumable  switch  table entries  bytes (16/32)  payload  subscriptions
+{%- for component in report.components %}
+{{ "%-30s  0x%02x  %7d  %9d  %6d  %13d  %6d/%-6d  %7d  %13d" | format(component.name, component.id, component.actions, component.resumables, component.switch, component.entries, component.bytes16, component.bytes32, component.payload, component.subscriptions) }}
+{%- endfor %}
+
+event                           id    listeners  switch  payload
+{%- for event in report.events %}
+{{ "%-30s  0x%02x  %9d  %6d  %7d" | format(event.name, event.id, event.listeners, event.switch, event.payload) }}
+{%- endfor %}
+
+component table entries: {{ report.componentEntries }}
+event table entries:     {{ report.eventEntries }}
@@ -8,6 +8,8 @@
 #ifndef	{{ namespace | upper }}_IDENTIFIER_HPP
 #define	{{ namespace | upper }}_IDENTIFIER_HPP
 
+#include <stdint.h>
+
 namespace {{ namespace }}
 {
 	namespace domain
@@ -101,6 +103,46 @@ namespace {{ namespace }}
 			}
 		}
 	}
+	
+	/**
+	 * Transmission priority of the packets (0 = high, 1 = normal, 2 = low),
+	 * see xpcc::CanConnector::setPriorityFunctions().
+	 */
+	namespace priority
+	{
+		/// Priority of an action call and its responses
+		inline uint8_t
+		action(uint8_t componentId, uint8_t actionId)
+		{
+		{%- for item in actionPriorities %}
+			if (componentId == {{ namespace }}::component::{{ item.component.name | enumElement }} &&
+				actionId == {{ namespace }}::action::{{ item.action.name | enumElement }}) {
+				return {{ item.priority }};
+			}
+		{%- else %}
+			(void) componentId;
+			(void) actionId;
+		{%- endfor %}
+			return 1;
+		}
+		
+		inline uint8_t
+		event(uint8_t eventId)
+		{
+		{%- if eventPriorities %}
+			switch (eventId)
+			{
+			{%- for item in eventPriorities %}
+				case {{ namespace }}::event::{{ item.event.name | enumElement }}: return {{ item.priority }};
+			{%- endfor %}
+				default: return 1;
+			}
+		{%- else %}
+			(void) eventId;
+			return 1;
+		{%- endif %}
+		}
+	}
 }	// namespace {{ namespace }}
 
 #endif	// {{ namespace | upper }}_IDENTIFIER_HPP
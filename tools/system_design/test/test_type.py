@@ -0,0 +1,49 @@
+#!/usr/bin/env python2
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) 2016, Roboterclub Aachen e.V.
+# All Rights Reserved.
+#
+# The file is part of the xpcc library and is released under the 3-clause BSD
+# license. See the file `LICENSE` for the full license governing this code.
+# -----------------------------------------------------------------------------
+
+import os
+import sys
+import unittest
+
+basepath = os.path.dirname(os.path.abspath(__file__))
+sys.path = [os.path.join(basepath, '..')] + sys.path
+from xmlparser.parser import Parser
+
+dtdPath = os.path.join(basepath, '../../../examples/communication/xml')
+
+class ArrayMemberTest(unittest.TestCase):
+
+	def setUp(self):
+		parser = Parser()
+		parser.parse(os.path.join(basepath, 'array_member.xml'), dtdPath)
+		self.tree = parser.tree
+
+	def test_subtype_count(self):
+		element = self.tree.types['path'].elements[1]
+		self.assertTrue(element.subtype.isArray)
+		self.assertEqual(element.subtype.count, 4)
+		self.assertEqual(element.subtype.name, 'point')
+
+	def test_typedef_size(self):
+		self.assertEqual(self.tree.types['Name'].size, 8)
+
+	def test_struct_size(self):
+		# uint8_t + 4 * (2 * int16_t) + char[8]
+		self.assertEqual(self.tree.types['point'].size, 4)
+		self.assertEqual(self.tree.types['path'].size, 1 + 4 * 4 + 8)
+
+	def test_parameter_size(self):
+		# used for the static_assert of the table dispatch
+		action = self.tree.components['driver'].actions['follow path']
+		self.assertEqual(action.parameterType.size, 25)
+		self.assertEqual(self.tree.events['path'].type.size, 25)
+
+if __name__ == '__main__':
+	unittest.main()
@@ -21,6 +21,11 @@ class Action(object):
 		self.call = node.get('call')
 		if self.call not in ["once", "resumable"]:
 			self.call = "once"
+		
+		# transmission priority of the call and its responses
+		self.priority = node.get('priority')
+		if self.priority is None:
+			self.priority = "normal"
 
 	def __get_type(self, node, name, tree):
 		type = node.get(name)
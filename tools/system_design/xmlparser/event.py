@@ -23,6 +23,7 @@ class Event(object):
 		self.description = None
 		self.rate = None
 		self.type = None
+		self.priority = None
 		
 	
 	def evaluate(self, tree):
@@ -32,6 +33,7 @@ class Event(object):
 		self.id = xml_utils.get_identifier(self.node)
 		self.description = xml_utils.get_description(self.node)
 		self.rate = self.node.get('rate')
+		self.priority = self.node.get('priority') or "normal"
 		
 		type = self.node.get('type')
 		if type is None:
@@ -263,7 +263,7 @@ class SubType:
 		if value.endswith(']'):
 			self.isArray = True
 			self.name, number = value.split('[')
-			self.count = number[:-1]
+			self.count = int(number[:-1])
 		else:
 			self.isArray = False
 			self.count = 1
@@ -307,7 +307,7 @@ class Struct(BaseType):
 				subtype.create_hierarchy()
 			
 			self.level = subtype.level
-			self.size = subtype.size
+			self.size = subtype.size * self.subtype.count
 		
 		def __str__(self):
 			return "%s : %s" % (self.name, self.subtype)
@@ -482,7 +482,7 @@ class Typedef(BaseType):
 			subtype.create_hierarchy()
 		
 		self.level = subtype.level + 1
-		self.size = subtype.size
+		self.size = subtype.size * self.subtype.count
 	
 	def dump(self):
 		return "%s : typedef|%i [%i]\n  -> %s" % (self.name, self.level, self.size, self.subtype)